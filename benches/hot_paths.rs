@@ -0,0 +1,305 @@
+//! Benchmarks of the hot paths of zkFuzz over the circuits in `tests/sample`.
+//!
+//! Run with `cargo bench`, or `cargo bench -- <filter>` for a single group. Baselines are kept
+//! by Criterion under `target/criterion`, so a regression shows up as a change from the last
+//! run on the same machine.
+
+#[path = "../tests/utils.rs"]
+mod utils;
+
+use std::str::FromStr;
+
+use criterion::{black_box, criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion};
+use num_bigint_dig::{BigInt, RandBigInt};
+use num_traits::Zero;
+use rand::rngs::StdRng;
+use rand::{Rng, SeedableRng};
+use rustc_hash::{FxHashMap, FxHashSet};
+
+use program_structure::ast::{Expression, ExpressionInfixOpcode};
+use program_structure::program_archive::ProgramArchive;
+
+use zkfuzz::executor::debug_ast::DebuggableExpressionInfixOpcode;
+use zkfuzz::executor::symbolic_execution::SymbolicExecutor;
+use zkfuzz::executor::symbolic_setting::{
+    get_default_setting_for_concrete_execution, get_default_setting_for_symbolic_execution,
+};
+use zkfuzz::executor::symbolic_value::{
+    evaluate_binary_op, extract_variables, SymbolicName, SymbolicValue,
+};
+use zkfuzz::mutator::mutation_config::MutationConfig;
+use zkfuzz::mutator::mutation_test::mutation_test_search;
+use zkfuzz::mutator::mutation_test_crossover_fn::random_crossover;
+use zkfuzz::mutator::mutation_test_evolution_fn::simple_evolution;
+use zkfuzz::mutator::mutation_test_trace_fitness_fn::evaluate_trace_fitness_by_error;
+use zkfuzz::mutator::mutation_test_trace_initialization_fn::initialize_population_with_operator_or_const_replacement;
+use zkfuzz::mutator::mutation_test_trace_mutation_fn::mutate_trace_with_operator_or_const_replacement;
+use zkfuzz::mutator::mutation_test_trace_selection_fn::{roulette_selection, RouletteWheel};
+use zkfuzz::mutator::mutation_test_update_input_fn::update_input_population_with_random_sampling;
+use zkfuzz::mutator::utils::{
+    emulate_symbolic_trace, evaluate_symbolic_value, BaseVerificationConfig,
+};
+
+use crate::utils::{execute, prepare_symbolic_library};
+
+const PRIME: &str = "21888242871839275222246405745257275088548364400416034343698204186575808495617";
+
+/// Circuits of increasing size on which the emulation and simplification are measured.
+const CIRCUITS: [&str; 5] = [
+    "test_vuln_iszero",
+    "test_lessthan",
+    "test_montgomerydouble",
+    "test_multiplexer_with_decoder_and_escalar_product",
+    "test_long_loop",
+];
+
+/// Under-constrained circuits on which the time to a counterexample is measured.
+const VULNERABLE_CIRCUITS: [&str; 2] = ["test_vuln_iszero", "test_vuln_average"];
+
+fn prime() -> BigInt {
+    BigInt::from_str(PRIME).unwrap()
+}
+
+/// Symbolically executes the main component of the sample circuit `name`, and passes the
+/// executor to `f`.
+fn with_executed_circuit<F>(name: &str, f: F)
+where
+    F: FnOnce(&mut SymbolicExecutor, &ProgramArchive),
+{
+    let prime = prime();
+    let (mut symbolic_library, program_archive) =
+        prepare_symbolic_library(format!("./tests/sample/{}.circom", name), prime.clone());
+    let setting = get_default_setting_for_symbolic_execution(prime, false);
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+    f(&mut sexe, &program_archive);
+}
+
+fn main_template_name(program_archive: &ProgramArchive) -> String {
+    match &program_archive.initial_template_call {
+        Expression::Call { id, .. } => id.clone(),
+        _ => unimplemented!(),
+    }
+}
+
+/// Returns a fixed assignment of small values to the inputs of the main component.
+fn sample_input(
+    sexe: &SymbolicExecutor,
+    program_archive: &ProgramArchive,
+) -> FxHashMap<SymbolicName, BigInt> {
+    let template_id = sexe.symbolic_library.name2id[&main_template_name(program_archive)];
+    let input_ids = &sexe.symbolic_library.template_library[&template_id].input_ids;
+    let mut rng = StdRng::seed_from_u64(42);
+    extract_variables(&sexe.cur_state.symbolic_trace)
+        .into_iter()
+        .filter(|name| name.owner.len() == 1 && input_ids.contains(&name.id))
+        .map(|name| (name, BigInt::from(rng.gen_range(0, 16))))
+        .collect()
+}
+
+fn bench_emulate_symbolic_trace(c: &mut Criterion) {
+    let mut group = c.benchmark_group("emulate_symbolic_trace");
+    for name in CIRCUITS {
+        with_executed_circuit(name, |sexe, program_archive| {
+            let prime = prime();
+            let trace = sexe.cur_state.symbolic_trace.clone();
+            let input = sample_input(sexe, program_archive);
+            let runtime_mutable_positions = FxHashMap::default();
+            group.bench_function(BenchmarkId::from_parameter(name), |b| {
+                b.iter_batched(
+                    || input.clone(),
+                    |mut assignment| {
+                        emulate_symbolic_trace(
+                            &prime,
+                            &trace,
+                            &runtime_mutable_positions,
+                            &mut assignment,
+                            sexe.symbolic_library,
+                        )
+                    },
+                    BatchSize::SmallInput,
+                )
+            });
+        });
+    }
+    group.finish();
+}
+
+fn bench_evaluate_symbolic_value(c: &mut Criterion) {
+    let mut group = c.benchmark_group("evaluate_symbolic_value");
+    for name in CIRCUITS {
+        with_executed_circuit(name, |sexe, program_archive| {
+            let prime = prime();
+            let side_constraints = sexe.cur_state.side_constraints.clone();
+            let mut assignment = sample_input(sexe, program_archive);
+            let _ = emulate_symbolic_trace(
+                &prime,
+                &sexe.cur_state.symbolic_trace,
+                &FxHashMap::default(),
+                &mut assignment,
+                sexe.symbolic_library,
+            );
+            group.bench_function(BenchmarkId::from_parameter(name), |b| {
+                b.iter(|| {
+                    for constraint in &side_constraints {
+                        black_box(evaluate_symbolic_value(
+                            &prime,
+                            constraint,
+                            &assignment,
+                            sexe.symbolic_library,
+                        ));
+                    }
+                })
+            });
+        });
+    }
+    group.finish();
+}
+
+fn bench_simplify_variables(c: &mut Criterion) {
+    let mut group = c.benchmark_group("simplify_variables");
+    for name in CIRCUITS {
+        with_executed_circuit(name, |sexe, _| {
+            let trace = sexe.cur_state.symbolic_trace.clone();
+            group.bench_function(BenchmarkId::from_parameter(name), |b| {
+                b.iter(|| {
+                    let mut memo = FxHashSet::default();
+                    for value in &trace {
+                        black_box(sexe.simplify_variables(
+                            value,
+                            usize::MAX,
+                            true,
+                            false,
+                            &mut memo,
+                        ));
+                    }
+                })
+            });
+        });
+    }
+    group.finish();
+}
+
+fn bench_evaluate_binary_op(c: &mut Criterion) {
+    let prime = prime();
+    let mut rng = StdRng::seed_from_u64(42);
+    let lhs = SymbolicValue::ConstantInt(rng.gen_bigint_range(&BigInt::zero(), &prime));
+    let rhs = SymbolicValue::ConstantInt(rng.gen_bigint_range(&BigInt::zero(), &prime));
+
+    let mut group = c.benchmark_group("evaluate_binary_op");
+    for (label, op) in [
+        ("add", ExpressionInfixOpcode::Add),
+        ("mul", ExpressionInfixOpcode::Mul),
+        ("div", ExpressionInfixOpcode::Div),
+        ("pow", ExpressionInfixOpcode::Pow),
+        ("lesser", ExpressionInfixOpcode::Lesser),
+        ("bit_and", ExpressionInfixOpcode::BitAnd),
+    ] {
+        let op = DebuggableExpressionInfixOpcode(op);
+        group.bench_function(label, |b| {
+            b.iter(|| evaluate_binary_op(black_box(&lhs), black_box(&rhs), &prime, &op))
+        });
+    }
+    group.finish();
+}
+
+fn bench_roulette_selection(c: &mut Criterion) {
+    let prime = prime();
+    let mut rng = StdRng::seed_from_u64(42);
+    let mut group = c.benchmark_group("roulette_selection");
+    for population_size in [30, 300] {
+        let population: Vec<usize> = (0..population_size).collect();
+        let fitness_scores: Vec<BigInt> = (0..population_size)
+            .map(|_| -rng.gen_bigint_range(&BigInt::zero(), &prime))
+            .collect();
+        let wheel = RouletteWheel::new(&fitness_scores);
+        group.bench_function(BenchmarkId::new("build", population_size), |b| {
+            b.iter(|| RouletteWheel::new(black_box(&fitness_scores)))
+        });
+        group.bench_function(BenchmarkId::new("draw", population_size), |b| {
+            b.iter(|| *roulette_selection(&population, &wheel, &mut rng))
+        });
+    }
+    group.finish();
+}
+
+/// Measures the time to a counterexample of the genetic search with fixed seeds.
+fn bench_time_to_counterexample(c: &mut Criterion) {
+    let mut group = c.benchmark_group("time_to_counterexample");
+    group.sample_size(10);
+    for name in VULNERABLE_CIRCUITS {
+        with_executed_circuit(name, |sexe, program_archive| {
+            let prime = prime();
+            let (template_param_names, template_param_values) =
+                match &program_archive.initial_template_call {
+                    Expression::Call { id, args, .. } => (
+                        program_archive.templates[id].get_name_of_params().clone(),
+                        args.clone(),
+                    ),
+                    _ => unimplemented!(),
+                };
+            let verification_base_config = BaseVerificationConfig {
+                target_template_name: main_template_name(program_archive),
+                prime: prime.clone(),
+                range: prime.clone(),
+                quick_mode: false,
+                heuristics_mode: false,
+                progress_interval: 10000,
+                num_threads: 1,
+                search_start: BigInt::zero(),
+                search_end: None,
+                witness_oracle: None,
+                template_param_names,
+                template_param_values,
+            };
+            let symbolic_trace = sexe.cur_state.symbolic_trace.clone();
+            let side_constraints = sexe.cur_state.side_constraints.clone();
+
+            let setting = get_default_setting_for_concrete_execution(prime, false);
+            let mut conc_executor = SymbolicExecutor::new(&mut sexe.symbolic_library, &setting);
+            conc_executor.feed_arguments(
+                &verification_base_config.template_param_names,
+                &verification_base_config.template_param_values,
+            );
+
+            let mut seed = 0;
+            group.bench_function(BenchmarkId::from_parameter(name), |b| {
+                b.iter(|| {
+                    // Cycle through a fixed set of seeds, so that the measurement does not
+                    // hinge on a single lucky or unlucky run.
+                    seed = seed % 10 + 1;
+                    let mutation_config = MutationConfig {
+                        seed,
+                        ..MutationConfig::default()
+                    };
+                    black_box(mutation_test_search(
+                        &mut conc_executor,
+                        &symbolic_trace,
+                        &side_constraints,
+                        &verification_base_config,
+                        &mutation_config,
+                        initialize_population_with_operator_or_const_replacement,
+                        update_input_population_with_random_sampling,
+                        evaluate_trace_fitness_by_error,
+                        simple_evolution,
+                        mutate_trace_with_operator_or_const_replacement,
+                        random_crossover,
+                        roulette_selection,
+                    ))
+                })
+            });
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_emulate_symbolic_trace,
+    bench_evaluate_symbolic_value,
+    bench_simplify_variables,
+    bench_evaluate_binary_op,
+    bench_roulette_selection,
+    bench_time_to_counterexample,
+);
+criterion_main!(benches);
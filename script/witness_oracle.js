@@ -0,0 +1,72 @@
+#!/usr/bin/env node
+// Keeps the WASM witness calculator generated by `circom --wasm --sym` loaded, and answers the
+// requests of `zkfuzz --witness_oracle`, one JSON line per input assignment.
+//
+// Usage:
+//   zkfuzz <circuit>.circom --search_mode=heuristics \
+//     --witness_oracle "node script/witness_oracle.js <circuit>_js/<circuit>.wasm <circuit>.sym"
+
+const fs = require("fs");
+const path = require("path");
+const readline = require("readline");
+
+// `log` calls of the circuit must not interleave with the responses.
+console.log = console.error;
+
+const [wasmPath, symPath] = process.argv.slice(2);
+const builder = require(path.resolve(path.dirname(wasmPath), "witness_calculator.js"));
+
+// Witness index of each signal of the circuit, under its full dotted name (e.g.
+// `main.c[0].out`), skipping those removed by the simplification.
+const witnessIndices = [];
+for (const line of fs.readFileSync(symPath, "utf8").split("\n")) {
+  const [, witnessIdx, , name] = line.split(",");
+  if (name !== undefined && Number(witnessIdx) >= 0) {
+    witnessIndices.push([name, Number(witnessIdx)]);
+  }
+}
+
+// Turns `{"main.in[1]": v1, "main.in[0]": v0}` into `{"in": [v0, v1]}`.
+function toCircomInput(request) {
+  const signals = {};
+  for (const [name, value] of Object.entries(request)) {
+    const [, base, subscripts] = name.match(/^main\.([^[]+)(.*)$/);
+    const indices = [...subscripts.matchAll(/\[(\d+)\]/g)].map((m) => Number(m[1]));
+    (signals[base] = signals[base] || []).push([indices, value]);
+  }
+  const input = {};
+  for (const [base, elements] of Object.entries(signals)) {
+    if (elements.length === 1 && elements[0][0].length === 0) {
+      input[base] = elements[0][1];
+      continue;
+    }
+    elements.sort(([lhs], [rhs]) => {
+      const i = lhs.findIndex((index, j) => index !== rhs[j]);
+      return i < 0 ? 0 : lhs[i] - rhs[i];
+    });
+    input[base] = elements.map(([, value]) => value);
+  }
+  return input;
+}
+
+async function main() {
+  const witnessCalculator = await builder(fs.readFileSync(wasmPath));
+  for await (const line of readline.createInterface({ input: process.stdin })) {
+    let response;
+    try {
+      const witness = await witnessCalculator.calculateWitness(
+        toCircomInput(JSON.parse(line)),
+        true
+      );
+      response = {};
+      for (const [name, witnessIdx] of witnessIndices) {
+        response[name] = witness[witnessIdx].toString();
+      }
+    } catch (e) {
+      response = { error: String((e && e.message) || e) };
+    }
+    process.stdout.write(JSON.stringify(response) + "\n");
+  }
+}
+
+main();
@@ -0,0 +1,365 @@
+//! Batch mode: fuzzes the circuits listed in a manifest within a single process.
+//!
+//! Each distinct circuit file is parsed, type-checked, and registered in a symbolic library
+//! only once, however many targets (e.g., different main templates or parameters) refer to it,
+//! and the targets are then searched concurrently by a pool of workers, which share the cores
+//! among them. Every result is written as it arrives to a single JSON-lines file, one line per
+//! target, in the same shape as the counterexamples saved by `--save_output`.
+
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::panic;
+use std::path::PathBuf;
+use std::str::FromStr;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::thread;
+use std::time;
+
+use colored::Colorize;
+use num_bigint_dig::BigInt;
+use rustc_hash::FxHashMap;
+use serde::Deserialize;
+use serde_json::{json, Value};
+
+use program_structure::ast::{Expression, Meta};
+use program_structure::program_archive::ProgramArchive;
+
+use crate::executor::symbolic_execution::SymbolicExecutor;
+use crate::executor::symbolic_setting::get_default_setting_for_symbolic_execution;
+use crate::executor::symbolic_state::freeze_symbolic_trace;
+use crate::executor::symbolic_value::SymbolicLibrary;
+use crate::input_user::Input;
+use crate::metrics;
+use crate::metrics::Phase;
+use crate::mutator::mutation_config::load_config_from_json;
+use crate::mutator::mutation_test::resolve_num_threads;
+use crate::mutator::unused_outputs::check_unused_outputs;
+use crate::mutator::utils::{CounterExample, VerificationResult};
+use crate::{
+    build_symbolic_library, build_verification_config, load_whitelist, parser_user,
+    prepare_main_template, search_counter_example, type_analysis_user,
+};
+
+/// The manifest of a batch run.
+#[derive(Deserialize)]
+struct BatchManifest {
+    /// Path to the JSON-lines file to which the results are written.
+    output: String,
+    /// Number of targets searched concurrently, where `0` stands for all available cores.
+    #[serde(default)]
+    num_workers: usize,
+    targets: Vec<BatchTarget>,
+}
+
+/// A circuit to fuzz. Unset fields fall back to the main component of `file` and to the
+/// command-line options.
+#[derive(Deserialize)]
+struct BatchTarget {
+    file: String,
+    #[serde(default)]
+    main_template: Option<String>,
+    /// Integer arguments of `main_template`.
+    #[serde(default)]
+    params: Option<Vec<String>>,
+    #[serde(default)]
+    search_mode: Option<String>,
+    #[serde(default)]
+    path_to_mutation_setting: Option<String>,
+    /// Overrides `time_budget_secs` of the mutation configuration.
+    #[serde(default)]
+    time_budget_secs: Option<u64>,
+}
+
+/// A circuit file, parsed and registered once for all the targets that refer to it.
+struct ParsedFile {
+    symbolic_library: SymbolicLibrary,
+    template_params: FxHashMap<String, Vec<String>>,
+    main_template: String,
+    main_args: Vec<Expression>,
+}
+
+/// Runs the batch described by the manifest given by `--path_to_batch_manifest`.
+pub fn run_batch(user_input: &mut Input) -> Result<(), ()> {
+    let manifest: BatchManifest = match File::open(user_input.path_to_batch_manifest())
+        .map_err(|e| e.to_string())
+        .and_then(|file| serde_json::from_reader(file).map_err(|e| e.to_string()))
+    {
+        Ok(manifest) => manifest,
+        Err(e) => {
+            eprintln!("{} {}", "Cannot read the batch manifest:".red(), e);
+            return Err(());
+        }
+    };
+    let output = match File::create(&manifest.output) {
+        Ok(file) => Mutex::new(BufWriter::new(file)),
+        Err(e) => {
+            eprintln!("{} {}", "Cannot create the batch output:".red(), e);
+            return Err(());
+        }
+    };
+
+    let whitelist = load_whitelist(user_input);
+    let mut files: Vec<String> = manifest.targets.iter().map(|t| t.file.clone()).collect();
+    files.sort();
+    files.dedup();
+    let parsed_files: FxHashMap<String, Result<ParsedFile, String>> = files
+        .into_iter()
+        .map(|file| {
+            eprintln!("{} {}", "📂 Loading".green(), file.cyan());
+            user_input.input_program = PathBuf::from(&file);
+            let parsed = parse_file(user_input).map(|program_archive| {
+                let (main_template, main_args) = match &program_archive.initial_template_call {
+                    Expression::Call { id, args, .. } => (id.clone(), args.clone()),
+                    _ => unimplemented!(),
+                };
+                // The library serves all the main templates of the targets of the file.
+                let mut root_templates: Vec<String> = manifest
+                    .targets
+                    .iter()
+                    .filter(|target| target.file == file)
+                    .map(|target| {
+                        target
+                            .main_template
+                            .clone()
+                            .unwrap_or(main_template.clone())
+                    })
+                    .collect();
+                root_templates.sort();
+                root_templates.dedup();
+                ParsedFile {
+                    symbolic_library: build_symbolic_library(
+                        &program_archive,
+                        &root_templates,
+                        &whitelist,
+                        user_input,
+                    ),
+                    template_params: program_archive
+                        .templates
+                        .iter()
+                        .map(|(name, template)| {
+                            (name.clone(), template.get_name_of_params().clone())
+                        })
+                        .collect(),
+                    main_template,
+                    main_args,
+                }
+            });
+            (file, parsed)
+        })
+        .collect();
+
+    let user_input: &Input = user_input;
+    let next_target = AtomicUsize::new(0);
+    let num_workers = resolve_num_threads(manifest.num_workers).min(manifest.targets.len().max(1));
+    // The workers share the cores, instead of each target using all of them.
+    let num_threads_per_target = (resolve_num_threads(0) / num_workers).max(1);
+    thread::scope(|s| {
+        for _ in 0..num_workers {
+            s.spawn(|| loop {
+                let index = next_target.fetch_add(1, Ordering::Relaxed);
+                let target = match manifest.targets.get(index) {
+                    Some(target) => target,
+                    None => break,
+                };
+                let start_time = time::Instant::now();
+                // A failing target must not stop the others.
+                let result = match &parsed_files[&target.file] {
+                    Ok(parsed_file) => panic::catch_unwind(panic::AssertUnwindSafe(|| {
+                        run_target(
+                            user_input,
+                            parsed_file,
+                            target,
+                            index,
+                            num_threads_per_target,
+                            start_time,
+                        )
+                    }))
+                    .unwrap_or_else(|_| Err("the search panicked".to_string())),
+                    Err(e) => Err(e.clone()),
+                };
+                let json_output = result.unwrap_or_else(|e| {
+                    json!({
+                        "0_target_path": target.file,
+                        "1_main_template": target.main_template,
+                        "3_execution_time": format!("{:?}", start_time.elapsed()),
+                        "9_error": e,
+                    })
+                });
+
+                eprintln!(
+                    "{} {} ({} / {})",
+                    "✅ Finished".green(),
+                    target.file.cyan(),
+                    index + 1,
+                    manifest.targets.len()
+                );
+                let mut output = output.lock().unwrap();
+                writeln!(output, "{}", json_output).expect("Unable to write data");
+                output.flush().expect("Unable to write data");
+            });
+        }
+    });
+
+    eprintln!("{} {}", "💾 Saved the results to:", manifest.output.cyan());
+    Ok(())
+}
+
+/// Parses and type-checks the circuit given by `user_input`.
+fn parse_file(user_input: &Input) -> Result<ProgramArchive, String> {
+    let mut program_archive = {
+        let _timer = metrics::time(Phase::Parsing);
+        parser_user::parse_project(user_input)
+            .map_err(|_| "the circuit cannot be parsed".to_string())?
+    };
+    {
+        let _timer = metrics::time(Phase::TypeAnalysis);
+        type_analysis_user::analyse_project(&mut program_archive)
+            .map_err(|_| "the circuit does not type-check".to_string())?;
+    }
+    Ok(program_archive)
+}
+
+/// Searches for a counterexample of a single target, and returns its result as a JSON object.
+///
+/// The target uses at most `num_threads_per_target` threads, and the checkpoint and island
+/// directory of its mutation configuration get the suffix of the `index`-th target, so that
+/// the concurrent searches of the batch do not resume from or stop each other.
+fn run_target(
+    user_input: &Input,
+    parsed_file: &ParsedFile,
+    target: &BatchTarget,
+    index: usize,
+    num_threads_per_target: usize,
+    start_time: time::Instant,
+) -> Result<Value, String> {
+    let main_template = target
+        .main_template
+        .clone()
+        .unwrap_or_else(|| parsed_file.main_template.clone());
+    let param_names = parsed_file
+        .template_params
+        .get(&main_template)
+        .ok_or_else(|| format!("unknown template {}", main_template))?;
+    let param_values = match &target.params {
+        Some(params) => params
+            .iter()
+            .map(|param| {
+                BigInt::from_str(param)
+                    .map(|value| Expression::Number(Meta::new(0, 0), value))
+                    .map_err(|_| format!("invalid parameter {}", param))
+            })
+            .collect::<Result<Vec<_>, _>>()?,
+        None if main_template == parsed_file.main_template => parsed_file.main_args.clone(),
+        None if param_names.is_empty() => Vec::new(),
+        None => return Err(format!("missing parameters of {}", main_template)),
+    };
+    if param_values.len() != param_names.len() {
+        return Err(format!(
+            "{} takes {} parameters",
+            main_template,
+            param_names.len()
+        ));
+    }
+    let search_mode = target
+        .search_mode
+        .clone()
+        .unwrap_or_else(|| user_input.search_mode());
+
+    let mut symbolic_library = parsed_file.symbolic_library.clone();
+    let base_config = get_default_setting_for_symbolic_execution(
+        BigInt::from_str(&user_input.debug_prime()).unwrap(),
+        user_input.constraint_assert_dissabled_flag(),
+    );
+    let mut sym_executor = SymbolicExecutor::new(&mut symbolic_library, &base_config);
+    prepare_main_template(
+        &mut sym_executor,
+        &main_template,
+        param_names,
+        &param_values,
+        user_input.flag_symbolic_template_params,
+    );
+    let body = sym_executor.symbolic_library.template_library
+        [&sym_executor.symbolic_library.name2id[&main_template]]
+        .body
+        .clone();
+    {
+        let _timer = metrics::time(Phase::SymbolicExecution);
+        sym_executor.execute(&body, 0);
+    }
+
+    let mut verification_base_config = build_verification_config(
+        user_input,
+        &search_mode,
+        &main_template,
+        param_names.clone(),
+        param_values,
+    );
+    verification_base_config.num_threads =
+        resolve_num_threads(verification_base_config.num_threads).min(num_threads_per_target);
+    let mut new_base_config = base_config.clone();
+    new_base_config.off_trace = true;
+    sym_executor.setting = &new_base_config;
+
+    let mut counter_example = {
+        let _timer = metrics::time(Phase::UnusedOutputs);
+        check_unused_outputs(&mut sym_executor, &verification_base_config)
+    };
+    let mut auxiliary_result = json!({});
+    if counter_example.is_none() && search_mode != "off" {
+        let symbolic_trace = freeze_symbolic_trace(sym_executor.cur_state.symbolic_trace.clone());
+        let side_constraints =
+            freeze_symbolic_trace(sym_executor.cur_state.side_constraints.clone());
+        let path_to_mutation_setting = target
+            .path_to_mutation_setting
+            .clone()
+            .unwrap_or_else(|| user_input.path_to_mutation_setting());
+        (counter_example, auxiliary_result) = search_counter_example(
+            &mut sym_executor.symbolic_library,
+            &symbolic_trace,
+            &side_constraints,
+            &verification_base_config,
+            user_input.constraint_assert_dissabled_flag(),
+            &search_mode,
+            || {
+                let mut mutation_config = load_config_from_json(&path_to_mutation_setting).unwrap();
+                if let Some(time_budget_secs) = target.time_budget_secs {
+                    mutation_config.time_budget_secs = time_budget_secs;
+                }
+                mutation_config.num_threads =
+                    resolve_num_threads(mutation_config.num_threads).min(num_threads_per_target);
+                if !mutation_config.checkpoint_path.is_empty() {
+                    mutation_config.checkpoint_path =
+                        format!("{}.target{}", mutation_config.checkpoint_path, index);
+                }
+                if !mutation_config.island_dir.is_empty() {
+                    mutation_config.island_dir =
+                        format!("{}/target{}", mutation_config.island_dir, index);
+                }
+                mutation_config
+            },
+        );
+    }
+
+    let ce = counter_example.unwrap_or_else(|| CounterExample {
+        flag: VerificationResult::WellConstrained,
+        target_output: None,
+        assignment: FxHashMap::default(),
+    });
+    let ce_meta = FxHashMap::from_iter([
+        ("0_target_path".to_string(), target.file.clone()),
+        ("1_main_template".to_string(), main_template),
+        ("2_search_mode".to_string(), search_mode),
+        (
+            "3_execution_time".to_string(),
+            format!("{:?}", start_time.elapsed()),
+        ),
+        (
+            "4_git_hash_of_zkfuzz".to_string(),
+            format!("{}", option_env!("GIT_HASH").unwrap_or("unknown")),
+        ),
+    ]);
+    let mut json_output = ce.to_json_with_meta(&sym_executor.symbolic_library.id2name, &ce_meta);
+    json_output["8_auxiliary_result"] = auxiliary_result;
+    Ok(json_output)
+}
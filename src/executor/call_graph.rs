@@ -0,0 +1,178 @@
+//! The templates and functions reachable from the main component of a circuit.
+//!
+//! A circuit usually includes whole libraries, e.g., circomlib, while its main component only
+//! instantiates a handful of their templates. Registering a template or a function lowers and
+//! copies its body, so only the reachable ones are registered in the symbolic library.
+
+use rustc_hash::FxHashSet;
+
+use program_structure::ast::{Access, Expression, Statement};
+use program_structure::program_archive::ProgramArchive;
+
+/// The names of the templates and functions reachable from the main component, sorted.
+pub struct ReachableCallables {
+    pub templates: Vec<String>,
+    pub functions: Vec<String>,
+}
+
+/// Collects the templates and functions that the templates `root_templates`, instantiated
+/// with the arguments `root_args`, call directly or not.
+///
+/// A template is reached by a component instantiation, anonymous or not, and a function by a
+/// call, in any expression of a reached body. The arguments of `log` calls are skipped, since
+/// the symbolic executor does not evaluate them.
+pub fn collect_reachable_callables(
+    program_archive: &ProgramArchive,
+    root_templates: &[String],
+    root_args: &[Expression],
+) -> ReachableCallables {
+    let mut pending: Vec<String> = root_templates.to_vec();
+    for arg in root_args {
+        collect_callees_of_expression(arg, &mut pending);
+    }
+
+    let mut templates = FxHashSet::default();
+    let mut functions = FxHashSet::default();
+    while let Some(name) = pending.pop() {
+        if let Some(template) = program_archive.templates.get(&name) {
+            if templates.insert(name) {
+                collect_callees_of_statement(template.get_body(), &mut pending);
+            }
+        } else if let Some(function) = program_archive.functions.get(&name) {
+            if functions.insert(name) {
+                collect_callees_of_statement(function.get_body(), &mut pending);
+            }
+        }
+    }
+
+    let mut templates: Vec<String> = templates.into_iter().collect();
+    templates.sort();
+    let mut functions: Vec<String> = functions.into_iter().collect();
+    functions.sort();
+    ReachableCallables {
+        templates,
+        functions,
+    }
+}
+
+fn collect_callees_of_statement(stmt: &Statement, callees: &mut Vec<String>) {
+    match stmt {
+        Statement::IfThenElse {
+            cond,
+            if_case,
+            else_case,
+            ..
+        } => {
+            collect_callees_of_expression(cond, callees);
+            collect_callees_of_statement(if_case, callees);
+            if let Some(else_case) = else_case {
+                collect_callees_of_statement(else_case, callees);
+            }
+        }
+        Statement::While { cond, stmt, .. } => {
+            collect_callees_of_expression(cond, callees);
+            collect_callees_of_statement(stmt, callees);
+        }
+        Statement::Return { value, .. } => collect_callees_of_expression(value, callees),
+        Statement::InitializationBlock {
+            initializations, ..
+        } => {
+            for stmt in initializations {
+                collect_callees_of_statement(stmt, callees);
+            }
+        }
+        Statement::Declaration { dimensions, .. } => {
+            for dim in dimensions {
+                collect_callees_of_expression(dim, callees);
+            }
+        }
+        Statement::Substitution { access, rhe, .. } => {
+            collect_callees_of_accesses(access, callees);
+            collect_callees_of_expression(rhe, callees);
+        }
+        Statement::MultSubstitution { lhe, rhe, .. } => {
+            collect_callees_of_expression(lhe, callees);
+            collect_callees_of_expression(rhe, callees);
+        }
+        Statement::UnderscoreSubstitution { rhe, .. } => {
+            collect_callees_of_expression(rhe, callees)
+        }
+        Statement::ConstraintEquality { lhe, rhe, .. } => {
+            collect_callees_of_expression(lhe, callees);
+            collect_callees_of_expression(rhe, callees);
+        }
+        Statement::LogCall { .. } => {}
+        Statement::Block { stmts, .. } => {
+            for stmt in stmts {
+                collect_callees_of_statement(stmt, callees);
+            }
+        }
+        Statement::Assert { arg, .. } => collect_callees_of_expression(arg, callees),
+    }
+}
+
+fn collect_callees_of_expression(expr: &Expression, callees: &mut Vec<String>) {
+    match expr {
+        Expression::InfixOp { lhe, rhe, .. } => {
+            collect_callees_of_expression(lhe, callees);
+            collect_callees_of_expression(rhe, callees);
+        }
+        Expression::PrefixOp { rhe, .. } | Expression::ParallelOp { rhe, .. } => {
+            collect_callees_of_expression(rhe, callees)
+        }
+        Expression::InlineSwitchOp {
+            cond,
+            if_true,
+            if_false,
+            ..
+        } => {
+            collect_callees_of_expression(cond, callees);
+            collect_callees_of_expression(if_true, callees);
+            collect_callees_of_expression(if_false, callees);
+        }
+        Expression::Variable { access, .. } => collect_callees_of_accesses(access, callees),
+        Expression::Number(..) => {}
+        Expression::Call { id, args, .. } => {
+            callees.push(id.clone());
+            for arg in args {
+                collect_callees_of_expression(arg, callees);
+            }
+        }
+        // Buses are neither templates nor functions, but their arguments may call functions.
+        Expression::BusCall { args, .. } => {
+            for arg in args {
+                collect_callees_of_expression(arg, callees);
+            }
+        }
+        Expression::AnonymousComp {
+            id,
+            params,
+            signals,
+            ..
+        } => {
+            callees.push(id.clone());
+            for expr in params.iter().chain(signals) {
+                collect_callees_of_expression(expr, callees);
+            }
+        }
+        Expression::ArrayInLine { values, .. } | Expression::Tuple { values, .. } => {
+            for value in values {
+                collect_callees_of_expression(value, callees);
+            }
+        }
+        Expression::UniformArray {
+            value, dimension, ..
+        } => {
+            collect_callees_of_expression(value, callees);
+            collect_callees_of_expression(dimension, callees);
+        }
+    }
+}
+
+fn collect_callees_of_accesses(accesses: &[Access], callees: &mut Vec<String>) {
+    for access in accesses {
+        if let Access::ArrayAccess(expr) = access {
+            collect_callees_of_expression(expr, callees);
+        }
+    }
+}
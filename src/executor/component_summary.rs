@@ -0,0 +1,338 @@
+//! Summaries of executed component instances.
+//!
+//! Executing a component instance produces a trace and side constraints that only depend on
+//! its template, its template arguments, the values bound to its inputs, and its owner name.
+//! Instances that agree on everything but the owner name, such as the elements of an array of
+//! `IsZero` or the `Num2Bits(254)` instantiated in each iteration of a loop, are therefore
+//! summarized once: the summary holds the result of the first execution with the
+//! owner name stripped, and later instances are instantiated by renaming instead of executing
+//! the template again.
+//!
+//! Function calls within a component are named after a counter shared by the whole library,
+//! so summaries store these counters relative to their values when the first instance was
+//! executed, and instantiation advances them as the execution would.
+
+use std::sync::Arc;
+
+use rustc_hash::FxHashMap;
+
+use crate::executor::symbolic_setting::SymbolicExecutorSetting;
+use crate::executor::symbolic_value::{
+    OwnerName, QuadraticPoly, SymbolicAccess, SymbolicName, SymbolicValue, SymbolicValueRef,
+};
+
+/// Identifies the component instances that share a summary.
+///
+/// The template arguments and input values are kept up to a consistent renaming of their
+/// variables, so that instances fed by different signals of the same shape share a key. An
+/// instance whose result refers to these variables is not summarized (see
+/// `ComponentSummary::new`), so the renaming never merges instances with different results.
+#[derive(Clone, PartialEq, Eq, Hash)]
+pub struct ComponentSummaryKey {
+    template_id: usize,
+    args: Vec<SymbolicValue>,
+    /// The inputs, in the order of their names.
+    inputs: Vec<(SymbolicName, Option<SymbolicValue>)>,
+    setting: SymbolicExecutorSetting,
+}
+
+impl ComponentSummaryKey {
+    /// Returns the key of a component instance.
+    pub fn new(
+        template_id: usize,
+        args: &[SymbolicValueRef],
+        inputs_binding_map: &FxHashMap<SymbolicName, Option<SymbolicValue>>,
+        setting: &SymbolicExecutorSetting,
+    ) -> Self {
+        let empty_owner = Arc::new(Vec::new());
+        let no_offsets = FxHashMap::default();
+        let mut renamer = Renamer {
+            prefix: &empty_owner,
+            counter_offsets: &no_offsets,
+            mode: RenameMode::Canonicalize(FxHashMap::default()),
+            new_values: FxHashMap::default(),
+            new_owners: FxHashMap::default(),
+        };
+        // Renaming into canonical names cannot fail.
+        let args = args
+            .iter()
+            .map(|arg| renamer.rename_value(arg).unwrap())
+            .collect();
+        let mut inputs: Vec<_> = inputs_binding_map.iter().collect();
+        inputs.sort_by(|a, b| a.0.cmp(b.0));
+        let inputs = inputs
+            .into_iter()
+            .map(|(name, value)| {
+                (
+                    name.clone(),
+                    value
+                        .as_ref()
+                        .map(|value| renamer.rename_value(value).unwrap()),
+                )
+            })
+            .collect();
+        ComponentSummaryKey {
+            template_id,
+            args,
+            inputs,
+            setting: setting.clone(),
+        }
+    }
+}
+
+/// The result of the execution of a component instance, independent of its owner name.
+pub struct ComponentSummary {
+    symbolic_trace: Vec<SymbolicValueRef>,
+    side_constraints: Vec<SymbolicValueRef>,
+    execution_failed: bool,
+    /// The increment of the counter of each function called during the execution.
+    function_counter_increments: FxHashMap<usize, usize>,
+}
+
+impl ComponentSummary {
+    /// Summarizes the execution of the instance owned by `owner_name`.
+    ///
+    /// # Parameters
+    /// - `owner_name`: The owner name of the instance.
+    /// - `symbolic_trace`: The trace of the instance.
+    /// - `side_constraints`: The side constraints of the instance.
+    /// - `execution_failed`: Whether the execution failed.
+    /// - `function_counter_before`: The function counters before the execution.
+    /// - `function_counter_after`: The function counters after the execution.
+    ///
+    /// # Returns
+    /// The summary, or `None` if the result refers to names outside of the instance, e.g., when
+    /// non-constant input values were substituted into it.
+    pub fn new(
+        owner_name: &Arc<Vec<OwnerName>>,
+        symbolic_trace: &[SymbolicValueRef],
+        side_constraints: &[SymbolicValueRef],
+        execution_failed: bool,
+        function_counter_before: &FxHashMap<usize, usize>,
+        function_counter_after: &FxHashMap<usize, usize>,
+    ) -> Option<Self> {
+        let mut renamer = Renamer {
+            prefix: owner_name,
+            counter_offsets: function_counter_before,
+            mode: RenameMode::Strip,
+            new_values: FxHashMap::default(),
+            new_owners: FxHashMap::default(),
+        };
+        Some(ComponentSummary {
+            symbolic_trace: renamer.rename_all(symbolic_trace)?,
+            side_constraints: renamer.rename_all(side_constraints)?,
+            execution_failed,
+            function_counter_increments: function_counter_after
+                .iter()
+                .map(|(id, after)| (*id, after - function_counter_before.get(id).unwrap_or(&0)))
+                .filter(|(_, increment)| *increment > 0)
+                .collect(),
+        })
+    }
+
+    /// Instantiates the summary for the instance owned by `owner_name`, advancing
+    /// `function_counter` as its execution would.
+    ///
+    /// # Returns
+    /// The trace, the side constraints, and whether the execution failed.
+    pub fn instantiate(
+        &self,
+        owner_name: &Arc<Vec<OwnerName>>,
+        function_counter: &mut FxHashMap<usize, usize>,
+    ) -> (Vec<SymbolicValueRef>, Vec<SymbolicValueRef>, bool) {
+        let (symbolic_trace, side_constraints) = {
+            let mut renamer = Renamer {
+                prefix: owner_name,
+                counter_offsets: function_counter,
+                mode: RenameMode::Prepend,
+                new_values: FxHashMap::default(),
+                new_owners: FxHashMap::default(),
+            };
+            // Renaming into a prefix cannot fail.
+            (
+                renamer.rename_all(&self.symbolic_trace).unwrap(),
+                renamer.rename_all(&self.side_constraints).unwrap(),
+            )
+        };
+        for (id, increment) in &self.function_counter_increments {
+            *function_counter.entry(*id).or_default() += increment;
+        }
+        (symbolic_trace, side_constraints, self.execution_failed)
+    }
+}
+
+enum RenameMode {
+    /// Removes `prefix` from every owner name, which fails on names that do not start with it,
+    /// and subtracts `counter_offsets` from the counters of function calls.
+    Strip,
+    /// Prepends `prefix` to every owner name and adds `counter_offsets` to the counters of
+    /// function calls.
+    Prepend,
+    /// Replaces every variable with one numbered by its first occurrence.
+    Canonicalize(FxHashMap<SymbolicName, usize>),
+}
+
+/// Moves the names of a summary between an instance and the stripped form. Values and owner
+/// names shared in the input stay shared in the output.
+struct Renamer<'a> {
+    prefix: &'a Arc<Vec<OwnerName>>,
+    counter_offsets: &'a FxHashMap<usize, usize>,
+    mode: RenameMode,
+    new_values: FxHashMap<*const SymbolicValue, SymbolicValueRef>,
+    new_owners: FxHashMap<*const Vec<OwnerName>, Arc<Vec<OwnerName>>>,
+}
+
+impl<'a> Renamer<'a> {
+    fn rename_all(&mut self, values: &[SymbolicValueRef]) -> Option<Vec<SymbolicValueRef>> {
+        values.iter().map(|value| self.rename_ref(value)).collect()
+    }
+
+    fn rename_ref(&mut self, value: &SymbolicValueRef) -> Option<SymbolicValueRef> {
+        if let Some(new_value) = self.new_values.get(&Arc::as_ptr(value)) {
+            return Some(new_value.clone());
+        }
+        let new_value = Arc::new(self.rename_value(value)?);
+        self.new_values
+            .insert(Arc::as_ptr(value), new_value.clone());
+        Some(new_value)
+    }
+
+    fn rename_polys(&mut self, polys: &[QuadraticPoly]) -> Option<Vec<QuadraticPoly>> {
+        polys
+            .iter()
+            .map(|(name, [a, b, c])| {
+                Some((
+                    self.rename_name(name)?,
+                    [
+                        self.rename_ref(a)?,
+                        self.rename_ref(b)?,
+                        self.rename_ref(c)?,
+                    ],
+                ))
+            })
+            .collect()
+    }
+
+    fn rename_value(&mut self, value: &SymbolicValue) -> Option<SymbolicValue> {
+        let new_value = match value {
+            SymbolicValue::NOP | SymbolicValue::ConstantInt(_) | SymbolicValue::ConstantBool(_) => {
+                value.clone()
+            }
+            SymbolicValue::Variable(name) => SymbolicValue::Variable(self.rename_name(name)?),
+            SymbolicValue::Assign(lhs, rhs, is_safe, polys) => SymbolicValue::Assign(
+                self.rename_ref(lhs)?,
+                self.rename_ref(rhs)?,
+                *is_safe,
+                match polys {
+                    Some((numerators, denominators)) => Some((
+                        self.rename_polys(numerators)?,
+                        self.rename_polys(denominators)?,
+                    )),
+                    None => None,
+                },
+            ),
+            SymbolicValue::AssignEq(lhs, rhs) => {
+                SymbolicValue::AssignEq(self.rename_ref(lhs)?, self.rename_ref(rhs)?)
+            }
+            SymbolicValue::AssignTemplParam(lhs, rhs) => {
+                SymbolicValue::AssignTemplParam(self.rename_ref(lhs)?, self.rename_ref(rhs)?)
+            }
+            SymbolicValue::AssignCall(lhs, rhs, is_mutable) => {
+                SymbolicValue::AssignCall(self.rename_ref(lhs)?, self.rename_ref(rhs)?, *is_mutable)
+            }
+            SymbolicValue::BinaryOp(lhs, op, rhs) => {
+                SymbolicValue::BinaryOp(self.rename_ref(lhs)?, op.clone(), self.rename_ref(rhs)?)
+            }
+            SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+                SymbolicValue::AuxBinaryOp(self.rename_ref(lhs)?, op.clone(), self.rename_ref(rhs)?)
+            }
+            SymbolicValue::Conditional(cond, then_val, else_val) => SymbolicValue::Conditional(
+                self.rename_ref(cond)?,
+                self.rename_ref(then_val)?,
+                self.rename_ref(else_val)?,
+            ),
+            SymbolicValue::UnaryOp(op, expr) => {
+                SymbolicValue::UnaryOp(op.clone(), self.rename_ref(expr)?)
+            }
+            SymbolicValue::Array(elements) => SymbolicValue::Array(self.rename_all(elements)?),
+            SymbolicValue::UniformArray(elem, size) => {
+                SymbolicValue::UniformArray(self.rename_ref(elem)?, self.rename_ref(size)?)
+            }
+            SymbolicValue::Call(id, args) => SymbolicValue::Call(*id, self.rename_all(args)?),
+        };
+        Some(new_value)
+    }
+
+    fn rename_access(
+        &mut self,
+        access: &Option<Vec<SymbolicAccess>>,
+    ) -> Option<Option<Vec<SymbolicAccess>>> {
+        match access {
+            Some(access) => Some(Some(
+                access
+                    .iter()
+                    .map(|acc| match acc {
+                        SymbolicAccess::ComponentAccess(_) => Some(acc.clone()),
+                        SymbolicAccess::ArrayAccess(value) => {
+                            Some(SymbolicAccess::ArrayAccess(self.rename_value(value)?))
+                        }
+                    })
+                    .collect::<Option<_>>()?,
+            )),
+            None => Some(None),
+        }
+    }
+
+    fn rename_owner(&mut self, owner: &Arc<Vec<OwnerName>>) -> Option<Arc<Vec<OwnerName>>> {
+        if let Some(new_owner) = self.new_owners.get(&Arc::as_ptr(owner)) {
+            return Some(new_owner.clone());
+        }
+        let is_stripping = matches!(self.mode, RenameMode::Strip);
+        let local = if is_stripping {
+            if owner.len() < self.prefix.len() || owner[..self.prefix.len()] != self.prefix[..] {
+                return None;
+            }
+            &owner[self.prefix.len()..]
+        } else {
+            &owner[..]
+        };
+
+        let mut new_owner = if is_stripping {
+            Vec::with_capacity(local.len())
+        } else {
+            let mut new_owner = Vec::with_capacity(self.prefix.len() + local.len());
+            new_owner.extend(self.prefix.iter().cloned());
+            new_owner
+        };
+        for owner_name in local {
+            let counter = match self.counter_offsets.get(&owner_name.id) {
+                Some(offset) if is_stripping => owner_name.counter.checked_sub(*offset)?,
+                Some(offset) => owner_name.counter + offset,
+                None => owner_name.counter,
+            };
+            new_owner.push(OwnerName {
+                id: owner_name.id,
+                access: self.rename_access(&owner_name.access)?,
+                counter,
+            });
+        }
+
+        let new_owner = Arc::new(new_owner);
+        self.new_owners
+            .insert(Arc::as_ptr(owner), new_owner.clone());
+        Some(new_owner)
+    }
+
+    fn rename_name(&mut self, name: &SymbolicName) -> Option<SymbolicName> {
+        if let RenameMode::Canonicalize(indices) = &mut self.mode {
+            let next_index = indices.len();
+            let index = *indices.entry(name.clone()).or_insert(next_index);
+            return Some(SymbolicName::new(index, self.prefix.clone(), None));
+        }
+        Some(SymbolicName::new(
+            name.id,
+            self.rename_owner(&name.owner)?,
+            self.rename_access(&name.access)?,
+        ))
+    }
+}
@@ -0,0 +1,717 @@
+use std::cell::{OnceCell, RefCell};
+
+use num_bigint_dig::{BigInt, Sign};
+use num_traits::{One, Signed, Zero};
+
+use crate::executor::utils::extended_euclidean;
+
+const NUM_LIMBS: usize = 4;
+
+type Limbs = [u64; NUM_LIMBS];
+
+/// An element of a `MontgomeryField`, stored in Montgomery form (`a * 2^256 mod p`).
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub struct FieldElement(Limbs);
+
+/// Arithmetic modulo an odd prime below `2^256`, on stack-allocated 4×64-bit limbs in
+/// Montgomery form.
+///
+/// This covers the BN254 and BLS12-381 scalar fields as well as smaller primes such as
+/// goldilocks. Multiplication uses the CIOS method with one extra carry word, so the modulus
+/// may use all 256 bits.
+#[derive(Clone, Debug)]
+pub struct MontgomeryField {
+    modulus: Limbs,
+    /// `-modulus^{-1} mod 2^64`
+    inv: u64,
+    /// `2^256 mod modulus`, i.e., the Montgomery form of one.
+    one: Limbs,
+    /// `2^512 mod modulus`, used to convert into Montgomery form.
+    r2: Limbs,
+    /// `modulus - 2`, the exponent of the Fermat inversion.
+    modulus_minus_two: Limbs,
+}
+
+impl MontgomeryField {
+    /// Returns `None` if `prime` is not an odd number in `(2, 2^256)`, or is not a probable
+    /// prime, since the inversion relies on Fermat's little theorem. The `BigInt` arithmetic
+    /// is then kept, which inverts with the extended Euclidean algorithm.
+    pub fn new(prime: &BigInt) -> Option<Self> {
+        if prime <= &BigInt::from(2)
+            || prime.bits() > 64 * NUM_LIMBS
+            || (prime % 2).is_zero()
+            || !is_probable_prime(prime)
+        {
+            return None;
+        }
+
+        let modulus = to_limbs(prime);
+        // Newton's iteration doubles the number of correct low bits of `p^{-1}` each round,
+        // starting from 3 bits for `x = p`.
+        let mut x = modulus[0];
+        for _ in 0..6 {
+            x = x.wrapping_mul(2u64.wrapping_sub(modulus[0].wrapping_mul(x)));
+        }
+
+        Some(MontgomeryField {
+            modulus,
+            inv: x.wrapping_neg(),
+            one: to_limbs(&((BigInt::one() << 256) % prime)),
+            r2: to_limbs(&((BigInt::one() << 512) % prime)),
+            modulus_minus_two: to_limbs(&(prime - BigInt::from(2))),
+        })
+    }
+
+    pub fn zero(&self) -> FieldElement {
+        FieldElement([0; NUM_LIMBS])
+    }
+
+    pub fn one(&self) -> FieldElement {
+        FieldElement(self.one)
+    }
+
+    pub fn is_zero(&self, a: &FieldElement) -> bool {
+        a.0 == [0; NUM_LIMBS]
+    }
+
+    /// Converts `value`, which may be negative or not reduced, into Montgomery form.
+    pub fn from_bigint(&self, value: &BigInt, prime: &BigInt) -> FieldElement {
+        let mut reduced = value % prime;
+        if reduced.is_negative() {
+            reduced += prime;
+        }
+        FieldElement(self.mul_limbs(&to_limbs(&reduced), &self.r2))
+    }
+
+    /// Converts `a` back into the canonical representative in `[0, p)`.
+    pub fn to_bigint(&self, a: &FieldElement) -> BigInt {
+        from_limbs(&self.mul_limbs(&a.0, &[1, 0, 0, 0]))
+    }
+
+    pub fn add(&self, a: &FieldElement, b: &FieldElement) -> FieldElement {
+        let (sum, carry) = add_limbs(&a.0, &b.0);
+        if carry || !lt_limbs(&sum, &self.modulus) {
+            FieldElement(sub_limbs(&sum, &self.modulus).0)
+        } else {
+            FieldElement(sum)
+        }
+    }
+
+    pub fn sub(&self, a: &FieldElement, b: &FieldElement) -> FieldElement {
+        let (diff, borrow) = sub_limbs(&a.0, &b.0);
+        if borrow {
+            FieldElement(add_limbs(&diff, &self.modulus).0)
+        } else {
+            FieldElement(diff)
+        }
+    }
+
+    pub fn mul(&self, a: &FieldElement, b: &FieldElement) -> FieldElement {
+        FieldElement(self.mul_limbs(&a.0, &b.0))
+    }
+
+    /// Raises `base` to `exp`, given as little-endian limbs.
+    fn pow_limbs(&self, base: &FieldElement, exp: &[u64]) -> FieldElement {
+        let mut result = self.one();
+        let mut is_started = false;
+        for limb in exp.iter().rev() {
+            for bit in (0..64).rev() {
+                if is_started {
+                    result = self.mul(&result, &result);
+                }
+                if (limb >> bit) & 1 == 1 {
+                    result = self.mul(&result, base);
+                    is_started = true;
+                }
+            }
+        }
+        result
+    }
+
+    /// Raises `base` to a non-negative `exp`.
+    pub fn pow(&self, base: &FieldElement, exp: &BigInt) -> FieldElement {
+        let (_, bytes) = exp.to_bytes_le();
+        let exp_limbs: Vec<u64> = bytes
+            .chunks(8)
+            .map(|chunk| {
+                let mut buf = [0u8; 8];
+                buf[..chunk.len()].copy_from_slice(chunk);
+                u64::from_le_bytes(buf)
+            })
+            .collect();
+        self.pow_limbs(base, &exp_limbs)
+    }
+
+    /// Returns `a^{-1}`, or zero if `a` is zero.
+    pub fn inverse(&self, a: &FieldElement) -> FieldElement {
+        self.pow_limbs(a, &self.modulus_minus_two)
+    }
+
+    /// Inverts every element of `values` in place with a single field inversion
+    /// (Montgomery's trick). Zeros are left as they are.
+    pub fn batch_inverse(&self, values: &mut [FieldElement]) {
+        let mut prefix_products = Vec::with_capacity(values.len());
+        let mut acc = self.one();
+        for v in values.iter() {
+            prefix_products.push(acc);
+            if !self.is_zero(v) {
+                acc = self.mul(&acc, v);
+            }
+        }
+
+        let mut acc_inv = self.inverse(&acc);
+        for (v, prefix) in values.iter_mut().zip(prefix_products.into_iter()).rev() {
+            if !self.is_zero(v) {
+                let inv = self.mul(&acc_inv, &prefix);
+                acc_inv = self.mul(&acc_inv, v);
+                *v = inv;
+            }
+        }
+    }
+
+    /// Computes `a * b * 2^{-256} mod p`.
+    fn mul_limbs(&self, a: &Limbs, b: &Limbs) -> Limbs {
+        let p = &self.modulus;
+        let mut t = [0u64; NUM_LIMBS + 2];
+        for i in 0..NUM_LIMBS {
+            let mut carry = 0;
+            for j in 0..NUM_LIMBS {
+                (t[j], carry) = mac(t[j], a[j], b[i], carry);
+            }
+            let (sum, overflow) = t[NUM_LIMBS].overflowing_add(carry);
+            t[NUM_LIMBS] = sum;
+            t[NUM_LIMBS + 1] = overflow as u64;
+
+            let m = t[0].wrapping_mul(self.inv);
+            let (_, mut carry) = mac(t[0], m, p[0], 0);
+            for j in 1..NUM_LIMBS {
+                (t[j - 1], carry) = mac(t[j], m, p[j], carry);
+            }
+            let (sum, overflow) = t[NUM_LIMBS].overflowing_add(carry);
+            t[NUM_LIMBS - 1] = sum;
+            t[NUM_LIMBS] = t[NUM_LIMBS + 1] + overflow as u64;
+        }
+
+        let result = [t[0], t[1], t[2], t[3]];
+        if t[NUM_LIMBS] != 0 || !lt_limbs(&result, p) {
+            sub_limbs(&result, p).0
+        } else {
+            result
+        }
+    }
+}
+
+/// The constants of the Tonelli-Shanks square root modulo an odd prime `p`, where
+/// `p - 1 = q * 2^s` with `q` odd.
+#[derive(Clone, Debug)]
+struct SqrtConstants {
+    /// `(p - 1) / 2`, the exponent of Euler's criterion.
+    euler_exp: BigInt,
+    q: BigInt,
+    /// `(q + 1) / 2`
+    half_q_plus_one: BigInt,
+    s: usize,
+    /// `z^q` for the smallest quadratic non-residue `z >= 2`.
+    c: BigInt,
+}
+
+impl SqrtConstants {
+    fn new(prime: &BigInt) -> Self {
+        let one = BigInt::one();
+        let euler_exp = (prime - &one) >> 1;
+        let mut q = prime - &one;
+        let mut s = 0;
+        while (&q & &one).is_zero() {
+            q >>= 1;
+            s += 1;
+        }
+        let mut z = BigInt::from(2u32);
+        while modpow_bigint(&z, &euler_exp, prime) == one {
+            z += &one;
+        }
+        SqrtConstants {
+            c: modpow_bigint(&z, &q, prime),
+            half_q_plus_one: (&q + &one) >> 1,
+            euler_exp,
+            q,
+            s,
+        }
+    }
+}
+
+/// Field arithmetic for a fixed prime, dispatching to `MontgomeryField` when the prime allows it
+/// and to `BigInt` otherwise.
+///
+/// All operations return the same values as the original `BigInt` implementations. The
+/// constants of the square root are found on its first use, and kept with the backend.
+#[derive(Clone, Debug)]
+pub struct FieldBackend {
+    prime: BigInt,
+    half_prime: BigInt,
+    montgomery: Option<MontgomeryField>,
+    sqrt_constants: OnceCell<SqrtConstants>,
+}
+
+impl FieldBackend {
+    pub fn new(prime: &BigInt) -> Self {
+        FieldBackend {
+            prime: prime.clone(),
+            half_prime: prime / BigInt::from(2),
+            montgomery: MontgomeryField::new(prime),
+            sqrt_constants: OnceCell::new(),
+        }
+    }
+
+    /// Returns a `BigInt`-only backend, regardless of the prime.
+    pub fn new_bigint(prime: &BigInt) -> Self {
+        FieldBackend {
+            prime: prime.clone(),
+            half_prime: prime / BigInt::from(2),
+            montgomery: None,
+            sqrt_constants: OnceCell::new(),
+        }
+    }
+
+    pub fn prime(&self) -> &BigInt {
+        &self.prime
+    }
+
+    /// Returns `p / 2`, rounded down.
+    pub fn half_prime(&self) -> &BigInt {
+        &self.half_prime
+    }
+
+    pub fn montgomery(&self) -> Option<&MontgomeryField> {
+        self.montgomery.as_ref()
+    }
+
+    pub fn name(&self) -> &'static str {
+        if self.montgomery.is_some() {
+            "Montgomery (4x64)"
+        } else {
+            "BigInt"
+        }
+    }
+
+    /// Computes `base^exp mod p`. A negative `base` keeps the sign of its remainder, and a
+    /// non-positive `exp` yields one.
+    pub fn modpow(&self, base: &BigInt, exp: &BigInt) -> BigInt {
+        match &self.montgomery {
+            Some(field) if !base.is_negative() && exp.is_positive() => {
+                field.to_bigint(&field.pow(&field.from_bigint(base, &self.prime), exp))
+            }
+            _ => modpow_bigint(base, exp, &self.prime),
+        }
+    }
+
+    /// Computes `lv / rv mod p` in `[0, p)`, or zero if either operand is zero.
+    pub fn moddiv(&self, lv: &BigInt, rv: &BigInt) -> BigInt {
+        if lv.is_zero() || rv.is_zero() {
+            return BigInt::zero();
+        }
+        match &self.montgomery {
+            Some(field) => {
+                // Multiples of `p`, and divisors the original implementation shifts into the
+                // field only once, keep their original result.
+                let rv_element = field.from_bigint(rv, &self.prime);
+                if field.is_zero(&rv_element) || (rv.is_negative() && -rv >= self.prime) {
+                    return moddiv_bigint(lv, rv, &self.prime);
+                }
+                let lv_element = field.from_bigint(lv, &self.prime);
+                field.to_bigint(&field.mul(&lv_element, &field.inverse(&rv_element)))
+            }
+            None => moddiv_bigint(lv, rv, &self.prime),
+        }
+    }
+
+    /// Computes `values[i]^{-1} mod p` for every element with a single field inversion.
+    /// Elements that are zero modulo `p` map to zero.
+    pub fn batch_inverse(&self, values: &[BigInt]) -> Vec<BigInt> {
+        match &self.montgomery {
+            Some(field) => {
+                let mut elements: Vec<_> = values
+                    .iter()
+                    .map(|v| field.from_bigint(v, &self.prime))
+                    .collect();
+                field.batch_inverse(&mut elements);
+                elements.iter().map(|e| field.to_bigint(e)).collect()
+            }
+            None => values
+                .iter()
+                .map(|v| {
+                    if (v % &self.prime).is_zero() {
+                        BigInt::zero()
+                    } else {
+                        moddiv_bigint(&BigInt::one(), v, &self.prime)
+                    }
+                })
+                .collect(),
+        }
+    }
+}
+
+impl FieldBackend {
+    /// Returns `Some(x)` such that `x^2 = n mod p`, or `None` if no solution exists, as
+    /// `tonelli_shanks` on the prime of the backend does.
+    ///
+    /// For an odd prime and `n` in `(-p, p)`, the 2-adic decomposition of `p - 1` and the
+    /// quadratic non-residue are reused across calls, and the field operations run in
+    /// Montgomery form when the prime allows it.
+    pub fn sqrt(&self, n: &BigInt) -> Option<BigInt> {
+        let n = if n.is_negative() {
+            n + &self.prime
+        } else {
+            n.clone()
+        };
+        if n.is_zero() {
+            return Some(BigInt::zero());
+        }
+        if n.is_negative() || n >= self.prime || (&self.prime % 2).is_zero() {
+            return tonelli_shanks_bigint(n, &self.prime);
+        }
+
+        let one = BigInt::one();
+        let constants = self
+            .sqrt_constants
+            .get_or_init(|| SqrtConstants::new(&self.prime));
+        if self.modpow(&n, &constants.euler_exp) != one {
+            return None;
+        }
+        match &self.montgomery {
+            Some(field) => {
+                let n = field.from_bigint(&n, &self.prime);
+                let one = field.one();
+                let mut m = constants.s;
+                let mut c = field.from_bigint(&constants.c, &self.prime);
+                let mut t = field.pow(&n, &constants.q);
+                let mut r = field.pow(&n, &constants.half_q_plus_one);
+                while t != one {
+                    let mut i = 0;
+                    let mut temp = t;
+                    while temp != one {
+                        temp = field.mul(&temp, &temp);
+                        i += 1;
+                        if i == m {
+                            return None;
+                        }
+                    }
+                    let mut b = c;
+                    for _ in 0..(m - i - 1) {
+                        b = field.mul(&b, &b);
+                    }
+                    m = i;
+                    c = field.mul(&b, &b);
+                    t = field.mul(&t, &c);
+                    r = field.mul(&r, &b);
+                }
+                Some(field.to_bigint(&r))
+            }
+            None => {
+                let p = &self.prime;
+                let mut m = constants.s;
+                let mut c = constants.c.clone();
+                let mut t = modpow_bigint(&n, &constants.q, p);
+                let mut r = modpow_bigint(&n, &constants.half_q_plus_one, p);
+                while t != one {
+                    let mut i = 0;
+                    let mut temp = t.clone();
+                    while temp != one {
+                        temp = (&temp * &temp) % p;
+                        i += 1;
+                        if i == m {
+                            return None;
+                        }
+                    }
+                    let mut b = c;
+                    for _ in 0..(m - i - 1) {
+                        b = (&b * &b) % p;
+                    }
+                    m = i;
+                    c = (&b * &b) % p;
+                    t = (t * &c) % p;
+                    r = (r * b) % p;
+                }
+                Some(r)
+            }
+        }
+    }
+
+    /// Returns a root of each quadratic polynomial `coeffs[0] + coeffs[1] * x + coeffs[2] * x^2`,
+    /// as `solve_quadratic_modulus_equation` does for each of them, with a single field
+    /// inversion for all the divisions.
+    pub fn solve_quadratics(&self, coefficients: &[[BigInt; 3]]) -> Vec<Option<BigInt>> {
+        // The roots as fractions, computed like `solve_quadratic_modulus_equation` does.
+        let fractions: Vec<Option<(BigInt, BigInt)>> = coefficients
+            .iter()
+            .map(|coeffs| {
+                if coeffs[2].is_zero() && coeffs[1].is_zero() {
+                    None
+                } else if coeffs[2].is_zero() {
+                    Some((-&coeffs[0], coeffs[1].clone()))
+                } else {
+                    let d = (&coeffs[1] * &coeffs[1] - BigInt::from(4) * &coeffs[2] * &coeffs[0])
+                        % &self.prime;
+                    self.sqrt(&d)
+                        .map(|r| (-&coeffs[1] + r, BigInt::from(2) * &coeffs[2]))
+                }
+            })
+            .collect();
+
+        // `moddiv` is the product with the inverse when the denominator has one and is
+        // shifted into the field by a single addition; other divisions are done one by one.
+        let is_invertible = |denominator: &BigInt| {
+            !(denominator % &self.prime).is_zero()
+                && !(denominator.is_negative() && -denominator >= self.prime)
+        };
+        let denominators: Vec<BigInt> = fractions
+            .iter()
+            .flatten()
+            .filter(|(_, denominator)| is_invertible(denominator))
+            .map(|(_, denominator)| denominator.clone())
+            .collect();
+        let mut inverses = self.batch_inverse(&denominators).into_iter();
+        fractions
+            .into_iter()
+            .map(|fraction| {
+                fraction.map(|(numerator, denominator)| {
+                    if is_invertible(&denominator) {
+                        let mut root = (numerator * inverses.next().unwrap()) % &self.prime;
+                        if root.is_negative() {
+                            root += &self.prime;
+                        }
+                        root
+                    } else {
+                        self.moddiv(&numerator, &denominator)
+                    }
+                })
+            })
+            .collect()
+    }
+}
+
+thread_local! {
+    static FIELD_BACKEND: RefCell<Option<FieldBackend>> = RefCell::new(None);
+}
+
+/// Runs `f` with the field backend of `prime`.
+///
+/// The backend is selected once from the prime and cached per thread; it is rebuilt only when
+/// a different prime is requested.
+pub fn with_field_backend<R>(prime: &BigInt, f: impl FnOnce(&FieldBackend) -> R) -> R {
+    FIELD_BACKEND.with(|cell| {
+        let mut cell = cell.borrow_mut();
+        if cell
+            .as_ref()
+            .map_or(true, |backend| backend.prime() != prime)
+        {
+            *cell = Some(FieldBackend::new(prime));
+        }
+        f(cell.as_ref().unwrap())
+    })
+}
+
+/// The Tonelli-Shanks square root of `n`, without any precomputation, for the inputs outside
+/// of the domain of `FieldBackend::sqrt`.
+fn tonelli_shanks_bigint(n: BigInt, p: &BigInt) -> Option<BigInt> {
+    let one = BigInt::one();
+    let two = BigInt::from(2u32);
+
+    if p == &two {
+        return Some(n % p);
+    }
+
+    // Check if n is a quadratic residue mod p using Euler's criterion:
+    // n^((p-1)/2) mod p should be 1.
+    let exp = (p - &one) >> 1; // (p - 1) / 2
+    if modpow_bigint(&n, &exp, p) != one {
+        return None;
+    }
+
+    // Factor p - 1 as q * 2^s with q odd.
+    let mut q = p - &one;
+    let mut s = 0;
+    while (&q & &one) == BigInt::zero() {
+        q >>= 1;
+        s += 1;
+    }
+
+    // Find a quadratic non-residue z modulo p.
+    let mut z = BigInt::from(2u32);
+    while modpow_bigint(&z, &exp, p) == one {
+        z += &one;
+    }
+
+    let mut m = s;
+    let mut c = modpow_bigint(&z, &q, p);
+    let mut t = modpow_bigint(&n, &q, p);
+    let mut r = modpow_bigint(&n, &((&q + &one) >> 1), p);
+
+    // Main loop: repeat until t ≡ 1 (mod p).
+    while t != one {
+        // Find the smallest i (0 < i < m) such that t^(2^i) ≡ 1 mod p.
+        let mut i = 0;
+        let mut temp = t.clone();
+        while temp != one {
+            temp = modpow_bigint(&temp, &two, p);
+            i += 1;
+            if i == m {
+                return None; // Should not happen if n is a residue.
+            }
+        }
+
+        // Compute b = c^(2^(m-i-1)) mod p.
+        let exponent = BigInt::from(1u32) << (m - i - 1);
+        let b = modpow_bigint(&c, &exponent, p);
+
+        m = i;
+        c = modpow_bigint(&b, &two, p);
+        t = (t * &c) % p;
+        r = (r * b) % p;
+    }
+
+    Some(r)
+}
+
+/// Bases of the Miller-Rabin test, which make it exact below `3.3 * 10^24`.
+const MILLER_RABIN_BASES: [u32; 12] = [2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37];
+
+/// The Miller-Rabin test of an odd `n > 2` with the bases `MILLER_RABIN_BASES`.
+fn is_probable_prime(n: &BigInt) -> bool {
+    let one = BigInt::one();
+    let n_minus_one = n - &one;
+    let mut d = n_minus_one.clone();
+    let mut s = 0;
+    while (&d & &one).is_zero() {
+        d >>= 1;
+        s += 1;
+    }
+
+    'bases: for base in MILLER_RABIN_BASES {
+        let base = BigInt::from(base);
+        if n == &base {
+            return true;
+        }
+        if (n % &base).is_zero() {
+            return false;
+        }
+        let mut x = modpow_bigint(&base, &d, n);
+        if x == one || x == n_minus_one {
+            continue;
+        }
+        for _ in 1..s {
+            x = (&x * &x) % n;
+            if x == n_minus_one {
+                continue 'bases;
+            }
+        }
+        return false;
+    }
+    true
+}
+
+fn modpow_bigint(base: &BigInt, exp: &BigInt, modulus: &BigInt) -> BigInt {
+    let mut result = BigInt::from(1);
+    let mut base = base % modulus; // Reduce base mod modulus initially
+    let mut exp = exp.clone();
+
+    while exp > BigInt::from(0) {
+        // If exp is odd, multiply base with result
+        if &exp % 2 == BigInt::from(1) {
+            result = (result * &base) % modulus;
+        }
+        // Square the base and halve the exponent
+        base = (&base * &base) % modulus;
+        exp /= 2;
+    }
+    result
+}
+
+fn moddiv_bigint(lv: &BigInt, rv: &BigInt, modulus: &BigInt) -> BigInt {
+    if lv.is_zero() || rv.is_zero() {
+        return BigInt::zero();
+    }
+
+    let mut r = modulus.clone();
+    let mut new_r = rv.clone();
+    if r.is_negative() {
+        r += modulus;
+    }
+    if new_r.is_negative() {
+        new_r += modulus;
+    }
+
+    let (_, _, mut rv_inv) = extended_euclidean(r, new_r);
+    rv_inv %= modulus;
+    if rv_inv.is_negative() {
+        rv_inv += modulus;
+    }
+
+    let mut result = (lv * rv_inv) % modulus;
+    if result.is_negative() {
+        result += modulus;
+    }
+    result
+}
+
+/// Converts a non-negative integer below `2^256` into little-endian limbs.
+fn to_limbs(value: &BigInt) -> Limbs {
+    let (_, bytes) = value.to_bytes_le();
+    let mut limbs = [0u64; NUM_LIMBS];
+    for (i, chunk) in bytes.chunks(8).take(NUM_LIMBS).enumerate() {
+        let mut buf = [0u8; 8];
+        buf[..chunk.len()].copy_from_slice(chunk);
+        limbs[i] = u64::from_le_bytes(buf);
+    }
+    limbs
+}
+
+fn from_limbs(limbs: &Limbs) -> BigInt {
+    let mut bytes = [0u8; 8 * NUM_LIMBS];
+    for (i, limb) in limbs.iter().enumerate() {
+        bytes[8 * i..8 * (i + 1)].copy_from_slice(&limb.to_le_bytes());
+    }
+    BigInt::from_bytes_le(Sign::Plus, &bytes)
+}
+
+/// Returns the low and high words of `a + b * c + carry`.
+#[inline(always)]
+fn mac(a: u64, b: u64, c: u64, carry: u64) -> (u64, u64) {
+    let t = (a as u128) + (b as u128) * (c as u128) + (carry as u128);
+    (t as u64, (t >> 64) as u64)
+}
+
+#[inline(always)]
+fn add_limbs(a: &Limbs, b: &Limbs) -> (Limbs, bool) {
+    let mut result = [0u64; NUM_LIMBS];
+    let mut carry = false;
+    for i in 0..NUM_LIMBS {
+        let (s1, c1) = a[i].overflowing_add(b[i]);
+        let (s2, c2) = s1.overflowing_add(carry as u64);
+        result[i] = s2;
+        carry = c1 || c2;
+    }
+    (result, carry)
+}
+
+#[inline(always)]
+fn sub_limbs(a: &Limbs, b: &Limbs) -> (Limbs, bool) {
+    let mut result = [0u64; NUM_LIMBS];
+    let mut borrow = false;
+    for i in 0..NUM_LIMBS {
+        let (d1, b1) = a[i].overflowing_sub(b[i]);
+        let (d2, b2) = d1.overflowing_sub(borrow as u64);
+        result[i] = d2;
+        borrow = b1 || b2;
+    }
+    (result, borrow)
+}
+
+#[inline(always)]
+fn lt_limbs(a: &Limbs, b: &Limbs) -> bool {
+    for i in (0..NUM_LIMBS).rev() {
+        if a[i] != b[i] {
+            return a[i] < b[i];
+        }
+    }
+    false
+}
@@ -0,0 +1,273 @@
+//! Hash-consing of symbolic values.
+//!
+//! Traces of large circuits repeat the same sub-expressions many times, e.g., the same bit
+//! decomposition or the same round constant in every round of a hash, and each occurrence is
+//! built as a fresh tree. `SymbolicValueInterner` maps structurally equal values to a single
+//! shared node, so that every distinct expression is stored once.
+//!
+//! The children of an interned node are interned themselves, so two interned nodes are equal
+//! exactly when they are the same node. Interning a node therefore hashes and compares only the
+//! node itself and the addresses of its children, instead of whole subtrees.
+
+use std::hash::{Hash, Hasher};
+use std::mem;
+use std::sync::Arc;
+
+use rustc_hash::FxHashSet;
+
+use crate::executor::symbolic_value::{QuadraticPoly, SymbolicValue, SymbolicValueRef};
+
+/// Maps structurally equal symbolic values to a single shared node.
+#[derive(Default, Clone)]
+pub struct SymbolicValueInterner {
+    nodes: FxHashSet<ShallowNode>,
+    /// Addresses of the interned nodes, which stay unique as long as `nodes` holds them.
+    interned: FxHashSet<usize>,
+}
+
+impl SymbolicValueInterner {
+    /// Returns the shared node structurally equal to `value`.
+    pub fn intern(&mut self, value: &SymbolicValue) -> SymbolicValueRef {
+        let node = self.intern_children(value);
+        self.intern_node(node)
+    }
+
+    /// Returns the shared node structurally equal to `value`, which is `value` itself if it has
+    /// already been interned.
+    pub fn intern_ref(&mut self, value: &SymbolicValueRef) -> SymbolicValueRef {
+        if self.interned.contains(&(Arc::as_ptr(value) as usize)) {
+            return value.clone();
+        }
+        self.intern(value)
+    }
+
+    /// Returns the number of distinct interned nodes.
+    pub fn len(&self) -> usize {
+        self.nodes.len()
+    }
+
+    /// Returns whether no node has been interned.
+    pub fn is_empty(&self) -> bool {
+        self.nodes.is_empty()
+    }
+
+    /// Forgets all the interned nodes.
+    pub fn clear(&mut self) {
+        self.nodes.clear();
+        self.interned.clear();
+    }
+
+    fn intern_node(&mut self, node: SymbolicValue) -> SymbolicValueRef {
+        let key = ShallowNode(Arc::new(node));
+        if let Some(existing) = self.nodes.get(&key) {
+            return existing.0.clone();
+        }
+        let node = key.0.clone();
+        self.interned.insert(Arc::as_ptr(&node) as usize);
+        self.nodes.insert(key);
+        node
+    }
+
+    fn intern_polys(&mut self, polys: &[QuadraticPoly]) -> Vec<QuadraticPoly> {
+        polys
+            .iter()
+            .map(|(name, [a, b, c])| {
+                (
+                    name.clone(),
+                    [self.intern_ref(a), self.intern_ref(b), self.intern_ref(c)],
+                )
+            })
+            .collect()
+    }
+
+    /// Returns a copy of `value` whose children are interned.
+    fn intern_children(&mut self, value: &SymbolicValue) -> SymbolicValue {
+        match value {
+            SymbolicValue::NOP
+            | SymbolicValue::ConstantInt(_)
+            | SymbolicValue::ConstantBool(_)
+            | SymbolicValue::Variable(_) => value.clone(),
+            SymbolicValue::Assign(lhs, rhs, is_safe, polys) => SymbolicValue::Assign(
+                self.intern_ref(lhs),
+                self.intern_ref(rhs),
+                *is_safe,
+                polys.as_ref().map(|(numerators, denominators)| {
+                    (
+                        self.intern_polys(numerators),
+                        self.intern_polys(denominators),
+                    )
+                }),
+            ),
+            SymbolicValue::AssignEq(lhs, rhs) => {
+                SymbolicValue::AssignEq(self.intern_ref(lhs), self.intern_ref(rhs))
+            }
+            SymbolicValue::AssignTemplParam(lhs, rhs) => {
+                SymbolicValue::AssignTemplParam(self.intern_ref(lhs), self.intern_ref(rhs))
+            }
+            SymbolicValue::AssignCall(lhs, rhs, is_mutable) => {
+                SymbolicValue::AssignCall(self.intern_ref(lhs), self.intern_ref(rhs), *is_mutable)
+            }
+            SymbolicValue::BinaryOp(lhs, op, rhs) => {
+                SymbolicValue::BinaryOp(self.intern_ref(lhs), op.clone(), self.intern_ref(rhs))
+            }
+            SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+                SymbolicValue::AuxBinaryOp(self.intern_ref(lhs), op.clone(), self.intern_ref(rhs))
+            }
+            SymbolicValue::Conditional(cond, then_val, else_val) => SymbolicValue::Conditional(
+                self.intern_ref(cond),
+                self.intern_ref(then_val),
+                self.intern_ref(else_val),
+            ),
+            SymbolicValue::UnaryOp(op, expr) => {
+                SymbolicValue::UnaryOp(op.clone(), self.intern_ref(expr))
+            }
+            SymbolicValue::Array(elements) => {
+                SymbolicValue::Array(elements.iter().map(|e| self.intern_ref(e)).collect())
+            }
+            SymbolicValue::UniformArray(elem, size) => {
+                SymbolicValue::UniformArray(self.intern_ref(elem), self.intern_ref(size))
+            }
+            SymbolicValue::Call(id, args) => {
+                SymbolicValue::Call(*id, args.iter().map(|arg| self.intern_ref(arg)).collect())
+            }
+        }
+    }
+}
+
+/// A node whose children are interned, hashed and compared by the addresses of its children.
+struct ShallowNode(SymbolicValueRef);
+
+fn hash_ptr<H: Hasher>(value: &SymbolicValueRef, state: &mut H) {
+    Arc::as_ptr(value).hash(state);
+}
+
+fn hash_polys<H: Hasher>(polys: &[QuadraticPoly], state: &mut H) {
+    polys.len().hash(state);
+    for (name, coefficients) in polys {
+        name.hash(state);
+        for coefficient in coefficients {
+            hash_ptr(coefficient, state);
+        }
+    }
+}
+
+fn eq_polys(lhs: &[QuadraticPoly], rhs: &[QuadraticPoly]) -> bool {
+    lhs.len() == rhs.len()
+        && lhs.iter().zip(rhs.iter()).all(|((ln, lc), (rn, rc))| {
+            ln == rn && lc.iter().zip(rc.iter()).all(|(l, r)| Arc::ptr_eq(l, r))
+        })
+}
+
+fn eq_ptrs(lhs: &[SymbolicValueRef], rhs: &[SymbolicValueRef]) -> bool {
+    lhs.len() == rhs.len() && lhs.iter().zip(rhs.iter()).all(|(l, r)| Arc::ptr_eq(l, r))
+}
+
+impl Hash for ShallowNode {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        let value: &SymbolicValue = &self.0;
+        mem::discriminant(value).hash(state);
+        match value {
+            SymbolicValue::NOP => {}
+            SymbolicValue::ConstantInt(v) => v.hash(state),
+            SymbolicValue::ConstantBool(b) => b.hash(state),
+            SymbolicValue::Variable(name) => name.hash(state),
+            SymbolicValue::Assign(lhs, rhs, is_safe, polys) => {
+                hash_ptr(lhs, state);
+                hash_ptr(rhs, state);
+                is_safe.hash(state);
+                if let Some((numerators, denominators)) = polys {
+                    hash_polys(numerators, state);
+                    hash_polys(denominators, state);
+                }
+            }
+            SymbolicValue::AssignEq(lhs, rhs) | SymbolicValue::AssignTemplParam(lhs, rhs) => {
+                hash_ptr(lhs, state);
+                hash_ptr(rhs, state);
+            }
+            SymbolicValue::AssignCall(lhs, rhs, is_mutable) => {
+                hash_ptr(lhs, state);
+                hash_ptr(rhs, state);
+                is_mutable.hash(state);
+            }
+            SymbolicValue::BinaryOp(lhs, op, rhs) | SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+                hash_ptr(lhs, state);
+                op.hash(state);
+                hash_ptr(rhs, state);
+            }
+            SymbolicValue::Conditional(cond, then_val, else_val) => {
+                hash_ptr(cond, state);
+                hash_ptr(then_val, state);
+                hash_ptr(else_val, state);
+            }
+            SymbolicValue::UnaryOp(op, expr) => {
+                op.hash(state);
+                hash_ptr(expr, state);
+            }
+            SymbolicValue::Array(elements) => {
+                elements.len().hash(state);
+                for elem in elements {
+                    hash_ptr(elem, state);
+                }
+            }
+            SymbolicValue::UniformArray(elem, size) => {
+                hash_ptr(elem, state);
+                hash_ptr(size, state);
+            }
+            SymbolicValue::Call(id, args) => {
+                id.hash(state);
+                args.len().hash(state);
+                for arg in args {
+                    hash_ptr(arg, state);
+                }
+            }
+        }
+    }
+}
+
+impl PartialEq for ShallowNode {
+    fn eq(&self, other: &Self) -> bool {
+        match (&*self.0, &*other.0) {
+            (SymbolicValue::NOP, SymbolicValue::NOP) => true,
+            (SymbolicValue::ConstantInt(l), SymbolicValue::ConstantInt(r)) => l == r,
+            (SymbolicValue::ConstantBool(l), SymbolicValue::ConstantBool(r)) => l == r,
+            (SymbolicValue::Variable(l), SymbolicValue::Variable(r)) => l == r,
+            (SymbolicValue::Assign(ll, lr, ls, lp), SymbolicValue::Assign(rl, rr, rs, rp)) => {
+                Arc::ptr_eq(ll, rl)
+                    && Arc::ptr_eq(lr, rr)
+                    && ls == rs
+                    && match (lp, rp) {
+                        (Some((ln, ld)), Some((rn, rd))) => eq_polys(ln, rn) && eq_polys(ld, rd),
+                        (None, None) => true,
+                        _ => false,
+                    }
+            }
+            (SymbolicValue::AssignEq(ll, lr), SymbolicValue::AssignEq(rl, rr))
+            | (SymbolicValue::AssignTemplParam(ll, lr), SymbolicValue::AssignTemplParam(rl, rr)) => {
+                Arc::ptr_eq(ll, rl) && Arc::ptr_eq(lr, rr)
+            }
+            (SymbolicValue::AssignCall(ll, lr, lm), SymbolicValue::AssignCall(rl, rr, rm)) => {
+                Arc::ptr_eq(ll, rl) && Arc::ptr_eq(lr, rr) && lm == rm
+            }
+            (SymbolicValue::BinaryOp(ll, lo, lr), SymbolicValue::BinaryOp(rl, ro, rr))
+            | (SymbolicValue::AuxBinaryOp(ll, lo, lr), SymbolicValue::AuxBinaryOp(rl, ro, rr)) => {
+                lo == ro && Arc::ptr_eq(ll, rl) && Arc::ptr_eq(lr, rr)
+            }
+            (SymbolicValue::Conditional(lc, lt, le), SymbolicValue::Conditional(rc, rt, re)) => {
+                Arc::ptr_eq(lc, rc) && Arc::ptr_eq(lt, rt) && Arc::ptr_eq(le, re)
+            }
+            (SymbolicValue::UnaryOp(lo, le), SymbolicValue::UnaryOp(ro, re)) => {
+                lo == ro && Arc::ptr_eq(le, re)
+            }
+            (SymbolicValue::Array(l), SymbolicValue::Array(r)) => eq_ptrs(l, r),
+            (SymbolicValue::UniformArray(le, ls), SymbolicValue::UniformArray(re, rs)) => {
+                Arc::ptr_eq(le, re) && Arc::ptr_eq(ls, rs)
+            }
+            (SymbolicValue::Call(li, la), SymbolicValue::Call(ri, ra)) => {
+                li == ri && eq_ptrs(la, ra)
+            }
+            _ => false,
+        }
+    }
+}
+
+impl Eq for ShallowNode {}
@@ -1,7 +1,12 @@
+pub mod call_graph;
+pub mod component_summary;
 pub mod coverage;
 pub mod debug_ast;
+pub mod field;
+pub mod hash_cons;
 pub mod symbolic_execution;
 pub mod symbolic_setting;
 pub mod symbolic_state;
 pub mod symbolic_value;
+pub mod trace_cache;
 pub mod utils;
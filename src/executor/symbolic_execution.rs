@@ -1,6 +1,8 @@
 use core::panic;
 use std::cmp::max;
-use std::rc::Rc;
+use std::mem;
+use std::slice;
+use std::sync::Arc;
 
 use colored::Colorize;
 use log::trace;
@@ -14,6 +16,7 @@ use program_structure::ast::{
     VariableType,
 };
 
+use crate::executor::component_summary::{ComponentSummary, ComponentSummaryKey};
 use crate::executor::coverage::CoverageTracker;
 use crate::executor::debug_ast::{
     DebugAccess, DebuggableAssignOp, DebuggableExpression, DebuggableExpressionInfixOpcode,
@@ -46,6 +49,14 @@ impl SymbolicStore {
     }
 }
 
+/// A pending unit of work of `SymbolicExecutor::execute`.
+enum Frame<'s> {
+    /// Executes the statements from the given index to the end of the sequence.
+    Statements(&'s [DebuggableStatement], usize),
+    /// Leaves the initialization block whose statements have just been executed.
+    LeaveInitializationBlock,
+}
+
 /// A symbolic execution engine for analyzing and executing statements symbolically.
 ///
 /// The `SymbolicExecutor` maintains multiple execution states, handles branching logic,
@@ -172,8 +183,8 @@ impl<'a> SymbolicExecutor<'a> {
                 self.simplify_variables(&evaled_a, usize::MAX, true, false, &mut memo);
             let sym_name = SymbolicName::new(name2id[n], self.cur_state.owner_name.clone(), None);
             let cond = SymbolicValue::AssignTemplParam(
-                Rc::new(SymbolicValue::Variable(sym_name.clone())),
-                Rc::new(simplified_a.clone()),
+                Arc::new(SymbolicValue::Variable(sym_name.clone())),
+                Arc::new(simplified_a.clone()),
             );
             self.cur_state.set_sym_val(sym_name, simplified_a);
             if self.setting.keep_track_constraints {
@@ -188,12 +199,29 @@ impl<'a> SymbolicExecutor<'a> {
     /// This method starts execution from a specified block index, updating internal states
     /// and handling control structures like if-else and loops appropriately.
     ///
+    /// Statements are driven by an explicit stack of frames rather than by recursion, so that
+    /// the native stack does not grow with the number of executed statements or loop
+    /// iterations; only calls of functions and components, which run in their own executor,
+    /// recurse.
+    ///
     /// # Arguments
     ///
     /// * `statements` - A vector of extended statements representing program logic to execute symbolically.
     /// * `cur_bid` - Current block index to start execution from.
-    pub fn execute(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
-        if cur_bid < statements.len() {
+    pub fn execute(&mut self, statements: &[DebuggableStatement], cur_bid: usize) {
+        let mut frames = vec![Frame::Statements(statements, cur_bid)];
+        while let Some(frame) = frames.pop() {
+            let (statements, cur_bid) = match frame {
+                Frame::Statements(statements, cur_bid) => (statements, cur_bid),
+                Frame::LeaveInitializationBlock => {
+                    self.cur_state.is_within_initialization_block = false;
+                    continue;
+                }
+            };
+            if cur_bid >= statements.len() {
+                continue;
+            }
+
             self.symbolic_store.max_depth =
                 max(self.symbolic_store.max_depth, self.cur_state.get_depth());
 
@@ -203,56 +231,71 @@ impl<'a> SymbolicExecutor<'a> {
                     | DebuggableStatement::Block { .. } => {}
                     _ => {
                         if !self.cur_state.is_within_initialization_block {
-                            self.execute(statements, cur_bid + 1);
-                            return;
+                            frames.push(Frame::Statements(statements, cur_bid + 1));
+                            continue;
                         }
                     }
                 }
             }
 
+            // The rest of the sequence runs after the nested statements pushed below, except
+            // for a loop whose condition holds, which is evaluated again after its body.
             match &statements[cur_bid] {
-                DebuggableStatement::InitializationBlock { .. } => {
-                    self.handle_initialization_block(statements, cur_bid);
+                DebuggableStatement::InitializationBlock {
+                    initializations, ..
+                } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
+                    frames.push(Frame::LeaveInitializationBlock);
+                    frames.push(Frame::Statements(initializations, 0));
+                    self.cur_state.is_within_initialization_block = true;
                 }
-                DebuggableStatement::Block { .. } => {
-                    self.handle_block(statements, cur_bid);
+                DebuggableStatement::Block { meta, stmts, .. } => {
+                    self.trace_if_enabled(meta);
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
+                    frames.push(Frame::Statements(stmts, 0));
                 }
                 DebuggableStatement::IfThenElse { .. } => {
-                    self.handle_if_then_else(statements, cur_bid);
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
+                    if let Some(branch) = self.handle_if_then_else(statements, cur_bid) {
+                        frames.push(Frame::Statements(slice::from_ref(branch), 0));
+                    }
                 }
                 DebuggableStatement::While { .. } => {
-                    self.handle_while(statements, cur_bid);
+                    if let Some(body) = self.handle_while(statements, cur_bid) {
+                        frames.push(Frame::Statements(statements, cur_bid));
+                        frames.push(Frame::Statements(slice::from_ref(body), 0));
+                    } else {
+                        frames.push(Frame::Statements(statements, cur_bid + 1));
+                    }
                 }
                 DebuggableStatement::Return { .. } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
                     self.handle_return(statements, cur_bid);
                 }
                 DebuggableStatement::Declaration { meta, .. } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
                     self.handle_declaration(statements, cur_bid, meta.elem_id);
                 }
                 DebuggableStatement::Substitution { .. } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
                     self.handle_substitution(statements, cur_bid);
                 }
                 DebuggableStatement::MultSubstitution { .. } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
                     self.handle_multi_substitution(statements, cur_bid);
                 }
                 DebuggableStatement::ConstraintEquality { .. } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
                     self.handle_constraint_equality(statements, cur_bid);
                 }
                 DebuggableStatement::Assert { .. } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
                     self.handle_assert(statements, cur_bid);
                 }
-                DebuggableStatement::UnderscoreSubstitution {
-                    meta,
-                    op: _,
-                    rhe: _,
-                    ..
-                } => {
-                    self.trace_if_enabled(&meta);
-                    self.execute(statements, cur_bid + 1);
-                }
-                DebuggableStatement::LogCall { meta, .. } => {
-                    self.trace_if_enabled(&meta);
-                    self.execute(statements, cur_bid + 1);
+                DebuggableStatement::UnderscoreSubstitution { meta, .. }
+                | DebuggableStatement::LogCall { meta, .. } => {
+                    frames.push(Frame::Statements(statements, cur_bid + 1));
+                    self.trace_if_enabled(meta);
                 }
                 DebuggableStatement::Ret => {
                     self.handle_ret();
@@ -433,7 +476,9 @@ impl<'a> SymbolicExecutor<'a> {
                         } else {
                             let new_sym_val = self.cur_state.get_sym_val_or_make_symvar(&sym_name);
                             memo.insert(sym_val.clone());
-                            memo.insert(new_sym_val.clone());
+                            if let SymbolicValue::Variable(..) = new_sym_val {
+                                memo.insert(new_sym_val.clone());
+                            }
                             if new_sym_val != *sym_val {
                                 return self.simplify_variables(
                                     &new_sym_val,
@@ -477,7 +522,11 @@ impl<'a> SymbolicExecutor<'a> {
                     if self.is_concrete_mode && !memo.contains(&sym_val) {
                         let new_sym_val = self.cur_state.get_sym_val_or_make_symvar(&sym_name);
                         memo.insert(sym_val.clone());
-                        memo.insert(new_sym_val.clone());
+                        // Only variables are looked up, so other values would only cost deep
+                        // hashing.
+                        if let SymbolicValue::Variable(..) = new_sym_val {
+                            memo.insert(new_sym_val.clone());
+                        }
                         if new_sym_val != *sym_val {
                             self.simplify_variables(
                                 &new_sym_val,
@@ -546,21 +595,21 @@ impl<'a> SymbolicExecutor<'a> {
                         )
                     }
                     _ => SymbolicValue::Conditional(
-                        Rc::new(self.simplify_variables(
+                        Arc::new(self.simplify_variables(
                             cond,
                             elem_id,
                             only_constatant_simplification,
                             only_variable_simplification,
                             memo,
                         )),
-                        Rc::new(self.simplify_variables(
+                        Arc::new(self.simplify_variables(
                             then_val,
                             elem_id,
                             only_constatant_simplification,
                             only_variable_simplification,
                             memo,
                         )),
-                        Rc::new(self.simplify_variables(
+                        Arc::new(self.simplify_variables(
                             else_val,
                             elem_id,
                             only_constatant_simplification,
@@ -581,20 +630,24 @@ impl<'a> SymbolicExecutor<'a> {
                 match &simplified_sym_val {
                     SymbolicValue::ConstantInt(rv) => match prefix_op.0 {
                         ExpressionPrefixOpcode::Sub => SymbolicValue::ConstantInt(-1 * rv),
-                        _ => SymbolicValue::UnaryOp(prefix_op.clone(), Rc::new(simplified_sym_val)),
+                        _ => {
+                            SymbolicValue::UnaryOp(prefix_op.clone(), Arc::new(simplified_sym_val))
+                        }
                     },
                     SymbolicValue::ConstantBool(rv) => match prefix_op.0 {
                         ExpressionPrefixOpcode::BoolNot => SymbolicValue::ConstantBool(!rv),
-                        _ => SymbolicValue::UnaryOp(prefix_op.clone(), Rc::new(simplified_sym_val)),
+                        _ => {
+                            SymbolicValue::UnaryOp(prefix_op.clone(), Arc::new(simplified_sym_val))
+                        }
                     },
-                    _ => SymbolicValue::UnaryOp(prefix_op.clone(), Rc::new(simplified_sym_val)),
+                    _ => SymbolicValue::UnaryOp(prefix_op.clone(), Arc::new(simplified_sym_val)),
                 }
             }
             SymbolicValue::Array(elements) => SymbolicValue::Array(
                 elements
                     .iter()
                     .map(|e| {
-                        Rc::new(self.simplify_variables(
+                        Arc::new(self.simplify_variables(
                             e,
                             elem_id,
                             only_constatant_simplification,
@@ -606,14 +659,14 @@ impl<'a> SymbolicExecutor<'a> {
             ),
             SymbolicValue::UniformArray(element, count) => {
                 let uarray = SymbolicValue::UniformArray(
-                    Rc::new(self.simplify_variables(
+                    Arc::new(self.simplify_variables(
                         element,
                         elem_id,
                         only_constatant_simplification,
                         only_variable_simplification,
                         memo,
                     )),
-                    Rc::new(self.simplify_variables(
+                    Arc::new(self.simplify_variables(
                         count,
                         elem_id,
                         only_constatant_simplification,
@@ -621,14 +674,14 @@ impl<'a> SymbolicExecutor<'a> {
                         memo,
                     )),
                 );
-                // self.convert_uniform_array_to_array(Rc::new(uarray), elem_id)
+                // self.convert_uniform_array_to_array(Arc::new(uarray), elem_id)
                 uarray
             }
             SymbolicValue::Call(func_id, args) => SymbolicValue::Call(
                 *func_id,
                 args.iter()
                     .map(|arg| {
-                        Rc::new(self.simplify_variables(
+                        Arc::new(self.simplify_variables(
                             arg,
                             elem_id,
                             only_constatant_simplification,
@@ -705,11 +758,11 @@ impl<'a> SymbolicExecutor<'a> {
             DebuggableExpression::InfixOp { lhe, infix_op, rhe } => {
                 let lhs = self.evaluate_expression(lhe, elem_id);
                 let rhs = self.evaluate_expression(rhe, elem_id);
-                SymbolicValue::BinaryOp(Rc::new(lhs), infix_op.clone(), Rc::new(rhs))
+                SymbolicValue::BinaryOp(Arc::new(lhs), infix_op.clone(), Arc::new(rhs))
             }
             DebuggableExpression::PrefixOp { prefix_op, rhe } => {
                 let expr = self.evaluate_expression(rhe, elem_id);
-                SymbolicValue::UnaryOp(prefix_op.clone(), Rc::new(expr))
+                SymbolicValue::UnaryOp(prefix_op.clone(), Arc::new(expr))
             }
             DebuggableExpression::InlineSwitchOp {
                 cond,
@@ -720,23 +773,23 @@ impl<'a> SymbolicExecutor<'a> {
                 let true_branch = self.evaluate_expression(if_true, elem_id);
                 let false_branch = self.evaluate_expression(if_false, elem_id);
                 SymbolicValue::Conditional(
-                    Rc::new(condition),
-                    Rc::new(true_branch),
-                    Rc::new(false_branch),
+                    Arc::new(condition),
+                    Arc::new(true_branch),
+                    Arc::new(false_branch),
                 )
             }
             DebuggableExpression::ParallelOp { rhe, .. } => self.evaluate_expression(rhe, elem_id),
             DebuggableExpression::ArrayInLine { values } => {
                 let elements = values
                     .iter()
-                    .map(|v| Rc::new(self.evaluate_expression(v, elem_id)))
+                    .map(|v| Arc::new(self.evaluate_expression(v, elem_id)))
                     .collect();
                 SymbolicValue::Array(elements)
             }
             DebuggableExpression::Tuple { values } => {
                 let elements = values
                     .iter()
-                    .map(|v| Rc::new(self.evaluate_expression(v, elem_id)))
+                    .map(|v| Arc::new(self.evaluate_expression(v, elem_id)))
                     .collect();
                 SymbolicValue::Array(elements)
             }
@@ -745,7 +798,10 @@ impl<'a> SymbolicExecutor<'a> {
             } => {
                 let evaluated_value = self.evaluate_expression(value, elem_id);
                 let evaluated_dimension = self.evaluate_expression(dimension, elem_id);
-                SymbolicValue::UniformArray(Rc::new(evaluated_value), Rc::new(evaluated_dimension))
+                SymbolicValue::UniformArray(
+                    Arc::new(evaluated_value),
+                    Arc::new(evaluated_dimension),
+                )
             }
             DebuggableExpression::Call { id, args, .. } => {
                 let evaluated_args: Vec<_> = args
@@ -756,7 +812,7 @@ impl<'a> SymbolicExecutor<'a> {
                 let simplified_args = evaluated_args
                     .iter()
                     .map(|arg| {
-                        Rc::new(self.simplify_variables(&arg, elem_id, false, false, &mut memo))
+                        Arc::new(self.simplify_variables(&arg, elem_id, false, false, &mut memo))
                     })
                     .collect();
                 if self.symbolic_library.template_library.contains_key(id) {
@@ -773,7 +829,7 @@ impl<'a> SymbolicExecutor<'a> {
                         counter: subse.symbolic_library.function_counter[id],
                         access: None,
                     });
-                    subse.cur_state.owner_name = Rc::new(updated_owner_list);
+                    subse.cur_state.owner_name = Arc::new(updated_owner_list);
                     subse
                         .symbolic_library
                         .function_counter
@@ -846,64 +902,11 @@ impl<'a> SymbolicExecutor<'a> {
 }
 
 impl<'a> SymbolicExecutor<'a> {
-    /// Handles the execution of an initialization block within a set of statements.
-    ///
-    /// This function identifies and processes an `InitializationBlock` from a list of statements.
-    /// All initializations within the block are executed sequentially before continuing with the rest
-    /// of the statements.
-    ///
-    /// # Parameters
-    /// - `statements`: A vector of `DebuggableStatement` containing the program statements to execute.
-    /// - `cur_bid`: The current statement index (block ID) to evaluate.
-    ///
-    /// # Behavior
-    /// - Sets the state flag to indicate that execution is within an initialization block.
-    /// - Executes each initialization statement in the block.
-    /// - Resets the state flag and proceeds to the next statement after the block.
-    fn handle_initialization_block(
-        &mut self,
-        statements: &Vec<DebuggableStatement>,
-        cur_bid: usize,
-    ) {
-        if let DebuggableStatement::InitializationBlock {
-            initializations, ..
-        } = &statements[cur_bid]
-        {
-            self.cur_state.is_within_initialization_block = true;
-
-            for init in initializations {
-                self.execute(&vec![init.clone()], 0);
-            }
-
-            self.cur_state.is_within_initialization_block = false;
-            self.execute(statements, cur_bid + 1);
-        }
-    }
-
-    /// Handles the execution of a generic code block within a set of statements.
-    ///
-    /// This function identifies a `Block` from a list of statements, traces its metadata if enabled,
-    /// and recursively executes the statements within the block.
-    ///
-    /// # Parameters
-    /// - `statements`: A vector of `DebuggableStatement` containing the program statements to execute.
-    /// - `cur_bid`: The current statement index (block ID) to evaluate.
-    ///
-    /// # Behavior
-    /// - Executes all statements within the block, starting at index 0.
-    /// - Continues execution with the next statement after the block.
-    fn handle_block(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
-        if let DebuggableStatement::Block { meta, stmts, .. } = &statements[cur_bid] {
-            self.trace_if_enabled(&meta);
-            self.execute(&stmts, 0);
-            self.execute(statements, cur_bid + 1);
-        }
-    }
-
     /// Handles the execution of an `if-then-else` statement within a set of statements.
     ///
     /// This function evaluates the condition of an `IfThenElse` statement and determines
     /// which branch (if-case or else-case) to execute. It also tracks branch coverage if enabled.
+    /// The branch is executed by `execute`, followed by the next statement.
     ///
     /// # Parameters
     /// - `statements`: A vector of `DebuggableStatement` containing the program statements to execute.
@@ -911,12 +914,15 @@ impl<'a> SymbolicExecutor<'a> {
     ///
     /// # Behavior
     /// - Evaluates the condition and simplifies it.
-    /// - If the condition resolves to `true`, the if-case is executed.
-    /// - If the condition resolves to `false` and an else-case exists, the else-case is executed.
+    /// - If the condition resolves to `true`, the if-case is returned.
+    /// - If the condition resolves to `false` and an else-case exists, the else-case is returned.
     /// - If the condition cannot be simplified to a constant boolean, symbolic loops are flagged in the state.
     /// - Branch coverage is recorded if enabled.
-    /// - Continues execution with the next statement after the `if-then-else`.
-    fn handle_if_then_else(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
+    fn handle_if_then_else<'s>(
+        &mut self,
+        statements: &'s [DebuggableStatement],
+        cur_bid: usize,
+    ) -> Option<&'s DebuggableStatement> {
         if let DebuggableStatement::IfThenElse {
             meta,
             cond,
@@ -937,21 +943,23 @@ impl<'a> SymbolicExecutor<'a> {
                     if self.enable_coverage_tracking {
                         self.coverage_tracker.record_branch(meta.elem_id, true);
                     }
-                    self.execute(&vec![*if_case.clone()], 0);
+                    Some(&**if_case)
                 }
                 SymbolicValue::ConstantBool(false) => {
                     if let Some(stmt) = else_case {
                         if self.enable_coverage_tracking {
                             self.coverage_tracker.record_branch(meta.elem_id, false);
                         }
-                        self.execute(&vec![*stmt.clone()], 0);
                     }
+                    else_case.as_deref()
                 }
                 _ => {
                     self.cur_state.contains_symbolic_loop = true;
+                    None
                 }
             }
-            self.execute(statements, cur_bid + 1);
+        } else {
+            None
         }
     }
 
@@ -973,8 +981,7 @@ impl<'a> SymbolicExecutor<'a> {
     /// - Sets the symbolic value of the assigned variables in the current state.
     /// - Handles assignments resulting from function calls.
     /// - If the left-hand side involves component access, it updates the relevant component variables.
-    /// - Executes the next statement after processing the substitution.
-    fn handle_substitution(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
+    fn handle_substitution(&mut self, statements: &[DebuggableStatement], cur_bid: usize) {
         if let DebuggableStatement::Substitution {
             meta,
             var,
@@ -1087,11 +1094,10 @@ impl<'a> SymbolicExecutor<'a> {
                     );
                 }
             }
-            self.execute(statements, cur_bid + 1);
         }
     }
 
-    fn handle_multi_substitution(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
+    fn handle_multi_substitution(&mut self, statements: &[DebuggableStatement], cur_bid: usize) {
         if let DebuggableStatement::MultSubstitution {
             meta, lhe, op, rhe, ..
         } = &statements[cur_bid]
@@ -1111,16 +1117,16 @@ impl<'a> SymbolicExecutor<'a> {
                 match op {
                     DebuggableAssignOp(AssignOp::AssignConstraintSignal) => {
                         let cont = SymbolicValue::AssignEq(
-                            Rc::new(simplified_lhe_val),
-                            Rc::new(simplified_rhe_val),
+                            Arc::new(simplified_lhe_val),
+                            Arc::new(simplified_rhe_val),
                         );
                         self.cur_state.push_symbolic_trace(&cont);
                         self.cur_state.push_side_constraint(&cont);
                     }
                     DebuggableAssignOp(AssignOp::AssignSignal) => {
                         let cont = SymbolicValue::Assign(
-                            Rc::new(simplified_lhe_val),
-                            Rc::new(simplified_rhe_val),
+                            Arc::new(simplified_lhe_val),
+                            Arc::new(simplified_rhe_val),
                             self.symbolic_library.template_library[&self.cur_state.template_id]
                                 .is_safe,
                             None,
@@ -1130,16 +1136,14 @@ impl<'a> SymbolicExecutor<'a> {
                     _ => {}
                 }
             }
-
-            self.execute(statements, cur_bid + 1);
         }
     }
 
     /// Handles the execution of a `While` loop statement during symbolic evaluation.
     ///
     /// This function evaluates the condition of a `While` loop and determines whether to execute the
-    /// loop body, exit the loop, or handle symbolic loops. It performs symbolic execution for each
-    /// iteration and ensures the current program state is updated appropriately.
+    /// loop body, exit the loop, or handle symbolic loops. `execute` runs the returned body and then
+    /// evaluates the `While` statement again, so that each iteration takes no additional stack.
     ///
     /// # Parameters
     /// - `statements`: A vector of `DebuggableStatement` representing the program's statements.
@@ -1148,11 +1152,15 @@ impl<'a> SymbolicExecutor<'a> {
     /// # Behavior
     /// - Symbolically evaluates the loop condition (`cond`) and simplifies it.
     /// - If the condition evaluates to a constant boolean:
-    ///   - `true`: Executes the loop body (`stmt`) and re-evaluates the `While` statement.
-    ///   - `false`: Skips the loop body and proceeds to the next statement.
+    ///   - `true`: Returns the loop body (`stmt`).
+    ///   - `false`: Returns `None`, so that execution proceeds to the next statement.
     /// - If the condition cannot be fully resolved (symbolic loop), marks the current state as containing
-    ///   a symbolic loop and skips the loop execution.
-    fn handle_while(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
+    ///   a symbolic loop and returns `None`, skipping the loop execution.
+    fn handle_while<'s>(
+        &mut self,
+        statements: &'s [DebuggableStatement],
+        cur_bid: usize,
+    ) -> Option<&'s DebuggableStatement> {
         if let DebuggableStatement::While {
             meta, cond, stmt, ..
         } = &statements[cur_bid]
@@ -1166,20 +1174,21 @@ impl<'a> SymbolicExecutor<'a> {
 
             if let SymbolicValue::ConstantBool(flag) = evaled_condition {
                 if flag {
-                    self.execute(&vec![*stmt.clone()], 0);
-                    self.execute(statements, cur_bid);
+                    Some(&**stmt)
                 } else {
-                    self.execute(statements, cur_bid + 1);
+                    None
                 }
             } else {
                 self.cur_state.contains_symbolic_loop = true;
                 // symbolic loop can occur only within functions that always do not produce any constraints.
-                self.execute(statements, cur_bid + 1);
+                None
             }
+        } else {
+            None
         }
     }
 
-    fn handle_return(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
+    fn handle_return(&mut self, statements: &[DebuggableStatement], cur_bid: usize) {
         if let DebuggableStatement::Return { meta, value, .. } = &statements[cur_bid] {
             self.trace_if_enabled(&meta);
             let tmp_val = self.evaluate_expression(value, meta.elem_id);
@@ -1201,7 +1210,6 @@ impl<'a> SymbolicExecutor<'a> {
                 SymbolicName::new(usize::MAX, self.cur_state.owner_name.clone(), None),
                 return_value,
             );
-            self.execute(statements, cur_bid + 1);
         }
     }
 
@@ -1224,13 +1232,12 @@ impl<'a> SymbolicExecutor<'a> {
     ///   - Assigns an initial symbolic value to the variable.
     /// - Evaluates the variable's dimensions using the current template or function library context
     ///   and stores them in the `id2dimensions` map.
-    /// - Proceeds to execute the next statement in the program.
     ///
     /// # Panics
     /// - If the dimension expressions for the variable cannot be found in the template or function library.
     fn handle_declaration(
         &mut self,
-        statements: &Vec<DebuggableStatement>,
+        statements: &[DebuggableStatement],
         cur_bid: usize,
         elem_id: usize,
     ) {
@@ -1278,8 +1285,6 @@ impl<'a> SymbolicExecutor<'a> {
                 self.mindim = std::cmp::min(self.mindim, *md);
             }
             self.id2dimensions.insert(*id, dims);
-
-            self.execute(statements, cur_bid + 1);
         }
     }
 
@@ -1305,7 +1310,6 @@ impl<'a> SymbolicExecutor<'a> {
     ///     - Simplifies the equality condition to check its truth value.
     ///     - Marks the program state as failed if the condition is found to be false.
     ///     - Stores the violated condition and its associated metadata for debugging.
-    /// - Proceeds to execute the next statement in the program.
     ///
     /// # Configuration Options
     /// - `keep_track_constraints`: If true, constraints are tracked for debugging or analysis.
@@ -1314,11 +1318,7 @@ impl<'a> SymbolicExecutor<'a> {
     /// # State Updates
     /// - If the condition evaluates to `false` and constraints are not tracked, the program state is marked
     ///   as failed, and the violated condition is stored for later reporting.
-    fn handle_constraint_equality(
-        &mut self,
-        statements: &Vec<DebuggableStatement>,
-        cur_bid: usize,
-    ) {
+    fn handle_constraint_equality(&mut self, statements: &[DebuggableStatement], cur_bid: usize) {
         if let DebuggableStatement::ConstraintEquality { meta, lhe, rhe } = &statements[cur_bid] {
             self.trace_if_enabled(&meta);
 
@@ -1332,9 +1332,9 @@ impl<'a> SymbolicExecutor<'a> {
                 self.simplify_variables(&rhe_val, meta.elem_id, false, true, &mut memo_right);
 
             let cond = SymbolicValue::BinaryOp(
-                Rc::new(simplified_lhe_val),
+                Arc::new(simplified_lhe_val),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Eq),
-                Rc::new(simplified_rhe_val),
+                Arc::new(simplified_rhe_val),
             );
 
             if self.setting.keep_track_constraints {
@@ -1350,20 +1350,18 @@ impl<'a> SymbolicExecutor<'a> {
                     if let SymbolicValue::ConstantBool(false) = simplified_cond {
                         self.cur_state.is_failed = true;
                         let original_cond = SymbolicValue::BinaryOp(
-                            Rc::new(lhe_val),
+                            Arc::new(lhe_val),
                             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Eq),
-                            Rc::new(rhe_val),
+                            Arc::new(rhe_val),
                         );
                         self.violated_condition = Some((meta.elem_id, original_cond));
                     }
                 }
             }
-
-            self.execute(statements, cur_bid + 1);
         }
     }
 
-    fn handle_assert(&mut self, statements: &Vec<DebuggableStatement>, cur_bid: usize) {
+    fn handle_assert(&mut self, statements: &[DebuggableStatement], cur_bid: usize) {
         if let DebuggableStatement::Assert { meta, arg, .. } = &statements[cur_bid] {
             self.trace_if_enabled(&meta);
             let expr = self.evaluate_expression(&arg, meta.elem_id);
@@ -1372,7 +1370,6 @@ impl<'a> SymbolicExecutor<'a> {
             if self.setting.keep_track_constraints {
                 self.cur_state.push_symbolic_trace(&condition);
             }
-            self.execute(statements, cur_bid + 1);
         }
     }
 
@@ -1391,7 +1388,7 @@ impl<'a> SymbolicExecutor<'a> {
 impl<'a> SymbolicExecutor<'a> {
     fn convert_uniform_array_to_array(
         &mut self,
-        uniform_array: Rc<SymbolicValue>,
+        uniform_array: Arc<SymbolicValue>,
         elem_id: usize,
     ) -> SymbolicValue {
         let (elem, counts) = decompose_uniform_array(uniform_array);
@@ -1510,9 +1507,12 @@ impl<'a> SymbolicExecutor<'a> {
 
             if let SymbolicValue::Array(ref arr) = base_array {
                 if !arr.is_empty() {
-                    base_array =
-                        (*update_nested_array(&pos, &Rc::new(base_array), &Rc::new(elem.clone())))
-                            .clone();
+                    base_array = (*update_nested_array(
+                        &pos,
+                        &Arc::new(base_array),
+                        &Arc::new(elem.clone()),
+                    ))
+                    .clone();
                 }
             }
         }
@@ -1555,7 +1555,7 @@ impl<'a> SymbolicExecutor<'a> {
         &mut self,
         op: &DebuggableAssignOp,
         callee_id: &usize,
-        args: &Vec<Rc<SymbolicValue>>,
+        args: &Vec<Arc<SymbolicValue>>,
         component_or_return_name: &SymbolicName,
         right_call: &SymbolicValue,
     ) {
@@ -1583,8 +1583,8 @@ impl<'a> SymbolicExecutor<'a> {
             }
         } else {
             let cont = SymbolicValue::AssignCall(
-                Rc::new(SymbolicValue::Variable(component_or_return_name.clone())),
-                Rc::new(right_call.clone()),
+                Arc::new(SymbolicValue::Variable(component_or_return_name.clone())),
+                Arc::new(right_call.clone()),
                 is_mutable,
             );
             self.cur_state.push_symbolic_trace(&cont);
@@ -1625,7 +1625,7 @@ impl<'a> SymbolicExecutor<'a> {
     fn initialize_template_component(
         &mut self,
         callee_template_id: &usize,
-        args: &Vec<Rc<SymbolicValue>>,
+        args: &Vec<Arc<SymbolicValue>>,
         component_name: &SymbolicName,
     ) {
         let mut subse_setting = self.setting.clone();
@@ -1721,7 +1721,7 @@ impl<'a> SymbolicExecutor<'a> {
             for (sym_pos, sym_val) in symbolic_positions.iter().zip(symbolic_values.iter()) {
                 let mut inp_name = SymbolicName::new(
                     component_name,
-                    Rc::new(Vec::new()),
+                    Arc::new(Vec::new()),
                     if post_dims.is_empty() {
                         None
                     } else {
@@ -1865,8 +1865,8 @@ impl<'a> SymbolicExecutor<'a> {
             match op {
                 DebuggableAssignOp(AssignOp::AssignConstraintSignal) => {
                     let cont = SymbolicValue::AssignEq(
-                        Rc::new(SymbolicValue::Variable(var_name.clone())),
-                        Rc::new(value.clone()),
+                        Arc::new(SymbolicValue::Variable(var_name.clone())),
+                        Arc::new(value.clone()),
                     );
                     self.cur_state.push_symbolic_trace(&cont);
                     self.cur_state.push_side_constraint(&cont);
@@ -1931,8 +1931,8 @@ impl<'a> SymbolicExecutor<'a> {
                     };
 
                     let cont = SymbolicValue::Assign(
-                        Rc::new(SymbolicValue::Variable(var_name.clone())),
-                        Rc::new(value.clone()),
+                        Arc::new(SymbolicValue::Variable(var_name.clone())),
+                        Arc::new(value.clone()),
                         self.symbolic_library.template_library[&self.cur_state.template_id].is_safe,
                         zero_div_info,
                     );
@@ -1972,7 +1972,7 @@ impl<'a> SymbolicExecutor<'a> {
         if let Some(component) = self.symbolic_store.components_store.get_mut(base_name) {
             let inp_name = SymbolicName::new(
                 component_name,
-                Rc::new(Vec::new()),
+                Arc::new(Vec::new()),
                 if post_dims.is_empty() {
                     None
                 } else {
@@ -2078,6 +2078,8 @@ impl<'a> SymbolicExecutor<'a> {
     /// - `pre_dims`: A vector of symbolic accesses representing pre-computed dimensions or indices for the component.
     ///
     /// # Behavior
+    /// - If an instance of the same template with the same arguments and inputs has already been summarized
+    ///   (see `component_summary`), instantiates its summary under the current owner list instead of executing it.
     /// - Initializes a new symbolic executor for the component, inheriting and updating the owner list for context.
     /// - Configures the component with its template parameters and input bindings.
     /// - Executes the body of the component as defined in the template library.
@@ -2085,6 +2087,7 @@ impl<'a> SymbolicExecutor<'a> {
     ///   - Merges the symbol binding map of the component back into the parent executor.
     /// - Propagates symbolic traces and side constraints generated during the component's execution.
     /// - If the component's template specifies `is_lessthan`, generates and appends a "less-than" constraint.
+    /// - Summarizes the execution for later instances, unless `propagate_assignments` is enabled.
     /// - Optionally logs detailed execution traces if tracing is enabled in the settings.
     ///
     /// # Notes
@@ -2098,7 +2101,6 @@ impl<'a> SymbolicExecutor<'a> {
         pre_dims: &Vec<SymbolicAccess>,
     ) {
         if !self.symbolic_store.components_store[component_name].is_done {
-            let mut subse = SymbolicExecutor::new(&mut self.symbolic_library, self.setting);
             let mut updated_owner_list = (*self.cur_state.owner_name).clone();
             updated_owner_list.push(OwnerName {
                 id: component_id,
@@ -2109,7 +2111,70 @@ impl<'a> SymbolicExecutor<'a> {
                     Some(pre_dims.clone())
                 },
             });
-            subse.cur_state.owner_name = Rc::new(updated_owner_list);
+            let owner_name = Arc::new(updated_owner_list);
+
+            // Summaries only cover the trace, so instances whose bindings are propagated, or
+            // whose owner name cannot be told apart from a function call, are always executed.
+            let component = &self.symbolic_store.components_store[component_name];
+            let summary_key = if self.setting.propagate_assignments
+                || self
+                    .symbolic_library
+                    .function_library
+                    .contains_key(&component_id)
+            {
+                None
+            } else {
+                Some(ComponentSummaryKey::new(
+                    component.template_id,
+                    &component.args,
+                    &component.inputs_binding_map,
+                    self.setting,
+                ))
+            };
+            if let Some(summary) = summary_key
+                .as_ref()
+                .and_then(|key| self.symbolic_library.component_summaries.get(key))
+                .cloned()
+            {
+                let template_id = component.template_id;
+                if !self.setting.off_trace {
+                    trace!("{}", "===========================".cyan());
+                    trace!(
+                        "📞 Call {} (summarized)",
+                        self.symbolic_library.id2name[&template_id]
+                    );
+                }
+
+                let (symbolic_trace, side_constraints, execution_failed) =
+                    summary.instantiate(&owner_name, &mut self.symbolic_library.function_counter);
+                let interner = &mut self.cur_state.value_interner;
+                self.cur_state
+                    .symbolic_trace
+                    .extend(symbolic_trace.iter().map(|v| interner.intern_ref(v)));
+                self.cur_state
+                    .side_constraints
+                    .extend(side_constraints.iter().map(|v| interner.intern_ref(v)));
+                self.execution_failed = execution_failed;
+
+                if self.symbolic_library.template_library[&template_id].is_lessthan {
+                    let cond =
+                        generate_lessthan_constraint(&self.symbolic_library.name2id, owner_name);
+                    self.cur_state.push_symbolic_trace(&cond);
+                }
+
+                if !self.setting.off_trace {
+                    trace!("{}", "===========================".cyan());
+                }
+                return;
+            }
+
+            let function_counter_before = summary_key
+                .as_ref()
+                .map(|_| self.symbolic_library.function_counter.clone());
+            let mut subse = SymbolicExecutor::new(&mut self.symbolic_library, self.setting);
+            subse.cur_state.owner_name = owner_name;
+            // Share sub-expressions across components, too.
+            subse.cur_state.value_interner = mem::take(&mut self.cur_state.value_interner);
 
             let templ = &subse.symbolic_library.template_library
                 [&self.symbolic_store.components_store[component_name].template_id];
@@ -2152,6 +2217,24 @@ impl<'a> SymbolicExecutor<'a> {
             let is_lessthan = templ.is_lessthan;
             subse.execute(&templ.body.clone(), 0);
 
+            if let (Some(key), Some(function_counter_before)) =
+                (summary_key, function_counter_before)
+            {
+                if let Some(summary) = ComponentSummary::new(
+                    &subse.cur_state.owner_name,
+                    &subse.cur_state.symbolic_trace,
+                    &subse.cur_state.side_constraints,
+                    subse.execution_failed,
+                    &function_counter_before,
+                    &subse.symbolic_library.function_counter,
+                ) {
+                    subse
+                        .symbolic_library
+                        .component_summaries
+                        .insert(key, Arc::new(summary));
+                }
+            }
+
             self.cur_state
                 .symbolic_trace
                 .append(&mut subse.cur_state.symbolic_trace);
@@ -2159,6 +2242,7 @@ impl<'a> SymbolicExecutor<'a> {
                 .side_constraints
                 .append(&mut subse.cur_state.side_constraints);
             self.execution_failed = subse.execution_failed;
+            self.cur_state.value_interner = mem::take(&mut subse.cur_state.value_interner);
             if self.setting.propagate_assignments {
                 for (k, v) in subse.cur_state.symbol_binding_map.iter() {
                     self.cur_state.set_rc_sym_val(k.clone(), v.clone());
@@ -2304,7 +2388,7 @@ impl<'a> SymbolicExecutor<'a> {
                 ),
                 SymbolicName::new(
                     component_name.unwrap(),
-                    Rc::new(owner_name),
+                    Arc::new(owner_name),
                     if post_dims.is_empty() {
                         None
                     } else {
@@ -2395,7 +2479,7 @@ impl<'a> SymbolicExecutor<'a> {
         uarray: &SymbolicValue,
         elem_id: usize,
     ) -> SymbolicValue {
-        let (_, dims) = decompose_uniform_array(Rc::new(uarray.clone()));
+        let (_, dims) = decompose_uniform_array(Arc::new(uarray.clone()));
         let mut concrete_dims = Vec::new();
         for c in dims.iter() {
             let mut memo = FxHashSet::default();
@@ -2412,7 +2496,7 @@ impl<'a> SymbolicExecutor<'a> {
 
         let positions = generate_cartesian_product_indices(&concrete_dims);
 
-        let mut sym_array = self.convert_uniform_array_to_array(Rc::new(uarray.clone()), elem_id);
+        let mut sym_array = self.convert_uniform_array_to_array(Arc::new(uarray.clone()), elem_id);
 
         let is_signal = if let Some(template) = self
             .symbolic_library
@@ -2451,10 +2535,10 @@ impl<'a> SymbolicExecutor<'a> {
             {
                 self.cur_state.symbol_binding_map[&var_name_p].clone()
             } else {
-                Rc::new(SymbolicValue::Variable(var_name_p))
+                Arc::new(SymbolicValue::Variable(var_name_p))
             };
 
-            sym_array = (*update_nested_array(&p, &Rc::new(sym_array), &sval)).clone();
+            sym_array = (*update_nested_array(&p, &Arc::new(sym_array), &sval)).clone();
         }
 
         sym_array
@@ -1,6 +1,6 @@
 use num_bigint_dig::BigInt;
 
-#[derive(Clone)]
+#[derive(Clone, PartialEq, Eq, Hash)]
 pub struct SymbolicExecutorSetting {
     pub prime: BigInt,
     pub only_initialization_blocks: bool,
@@ -1,10 +1,12 @@
-use std::rc::Rc;
+use std::sync::Arc;
 
 use colored::Colorize;
 use rustc_hash::FxHashMap;
 
+use crate::executor::hash_cons::SymbolicValueInterner;
 use crate::executor::symbolic_value::{
-    OwnerName, SymbolicAccess, SymbolicName, SymbolicValue, SymbolicValueRef,
+    precompute_hashes_of_symbolic_value, OwnerName, SymbolicAccess, SymbolicName, SymbolicValue,
+    SymbolicValueRef,
 };
 use crate::executor::utils::italic;
 
@@ -12,11 +14,34 @@ pub type SymbolBindingMap = FxHashMap<SymbolicName, SymbolicValueRef>;
 pub type SymbolicTrace = Vec<SymbolicValueRef>;
 pub type SymbolicConstraints = Vec<SymbolicValueRef>;
 
+/// A finished symbolic trace (or constraint set) that is shared read-only, e.g., among
+/// worker threads. It dereferences to `SymbolicTrace`.
+pub type FrozenSymbolicTrace = Arc<SymbolicTrace>;
+
+/// Freezes a finished symbolic trace so that it can be shared without deep copies.
+///
+/// The hashes of all symbolic names within the trace are computed upfront, so that
+/// readers of the frozen trace never need to update the cached hashes.
+///
+/// # Arguments
+///
+/// * `trace` - The finished symbolic trace.
+///
+/// # Returns
+///
+/// The frozen trace.
+pub fn freeze_symbolic_trace(trace: SymbolicTrace) -> FrozenSymbolicTrace {
+    for value in trace.iter() {
+        precompute_hashes_of_symbolic_value(value);
+    }
+    Arc::new(trace)
+}
+
 /// Represents the state of symbolic execution, holding symbolic values,
 /// trace constraints, side constraints, and depth information.
 #[derive(Clone)]
 pub struct SymbolicState {
-    pub owner_name: Rc<Vec<OwnerName>>,
+    pub owner_name: Arc<Vec<OwnerName>>,
     pub template_id: usize,
     pub is_within_initialization_block: bool,
     pub contains_symbolic_loop: bool,
@@ -25,6 +50,8 @@ pub struct SymbolicState {
     pub symbolic_trace: SymbolicTrace,
     pub side_constraints: SymbolicConstraints,
     pub is_failed: bool,
+    /// Shares the structurally equal sub-expressions of the trace and the side constraints.
+    pub value_interner: SymbolicValueInterner,
 }
 
 impl SymbolicState {
@@ -35,7 +62,7 @@ impl SymbolicState {
     /// A new instance of `SymbolicState` with empty fields.
     pub fn new() -> Self {
         SymbolicState {
-            owner_name: Rc::new(Vec::new()),
+            owner_name: Arc::new(Vec::new()),
             template_id: usize::MAX,
             is_within_initialization_block: false,
             contains_symbolic_loop: false,
@@ -44,6 +71,7 @@ impl SymbolicState {
             symbolic_trace: SymbolicTrace::new(),
             side_constraints: SymbolicConstraints::new(),
             is_failed: false,
+            value_interner: SymbolicValueInterner::default(),
         }
     }
 
@@ -55,7 +83,7 @@ impl SymbolicState {
     ///
     /// * `owner_name` - The `OwnerName` to be added.
     pub fn add_owner(&mut self, owner_name: &OwnerName) {
-        let updated_owner_list = Rc::make_mut(&mut self.owner_name);
+        let updated_owner_list = Arc::make_mut(&mut self.owner_name);
         updated_owner_list.push(owner_name.clone());
     }
 
@@ -114,7 +142,7 @@ impl SymbolicState {
     /// * `sym_name` - The name of the variable.
     /// * `sym_val` - The symbolic value to associate with the variable.
     pub fn set_sym_val(&mut self, sym_name: SymbolicName, sym_val: SymbolicValue) {
-        self.symbol_binding_map.insert(sym_name, Rc::new(sym_val));
+        self.symbol_binding_map.insert(sym_name, Arc::new(sym_val));
     }
 
     /// Sets a reference-counted symbolic value for a given variable name in the state.
@@ -154,7 +182,8 @@ impl SymbolicState {
     ///
     /// * `constraint` - The symbolic value representing the constraint.
     pub fn push_symbolic_trace(&mut self, constraint: &SymbolicValue) {
-        self.symbolic_trace.push(Rc::new(constraint.clone()));
+        let constraint = self.value_interner.intern(constraint);
+        self.symbolic_trace.push(constraint);
     }
 
     /// Adds a side constraint to the current state.
@@ -163,7 +192,8 @@ impl SymbolicState {
     ///
     /// * `constraint` - The symbolic value representing the constraint.
     pub fn push_side_constraint(&mut self, constraint: &SymbolicValue) {
-        self.side_constraints.push(Rc::new(constraint.clone()));
+        let constraint = self.value_interner.intern(constraint);
+        self.side_constraints.push(constraint);
     }
 
     /// Formats the symbolic state for lookup and display.
@@ -1,8 +1,8 @@
-use std::cell::RefCell;
 use std::cmp::Ordering;
 use std::collections::VecDeque;
 use std::hash::{Hash, Hasher};
-use std::rc::Rc;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering as AtomicOrdering};
+use std::sync::Arc;
 
 use colored::Colorize;
 use num_bigint_dig::BigInt;
@@ -13,11 +13,13 @@ use rustc_hash::{FxHashMap, FxHashSet, FxHasher};
 
 use program_structure::ast::{ExpressionInfixOpcode, SignalType, Statement, VariableType};
 
+use crate::executor::component_summary::{ComponentSummary, ComponentSummaryKey};
 use crate::executor::debug_ast::{
     DebuggableExpression, DebuggableExpressionInfixOpcode, DebuggableExpressionPrefixOpcode,
     DebuggableStatement,
 };
-use crate::executor::utils::{extended_euclidean, generate_cartesian_product_indices, modpow};
+use crate::executor::field::with_field_backend;
+use crate::executor::utils::{generate_cartesian_product_indices, moddiv, modpow};
 
 /// Represents the access type within a symbolic expression, such as component or array access.
 #[derive(Clone, PartialEq, Eq, Hash, Debug)]
@@ -69,21 +71,56 @@ pub enum ExecutionResult<T> {
     Failure,
 }
 
+/// A lazily computed hash value that can be shared across threads.
+///
+/// The value is published with release ordering before the `is_set` flag, so a reader
+/// that observes the flag also observes the hash.
+#[derive(Debug, Default)]
+struct CachedHash {
+    value: AtomicU64,
+    is_set: AtomicBool,
+}
+
+impl CachedHash {
+    fn get(&self) -> Option<u64> {
+        if self.is_set.load(AtomicOrdering::Acquire) {
+            Some(self.value.load(AtomicOrdering::Relaxed))
+        } else {
+            None
+        }
+    }
+
+    fn set(&self, hash: u64) {
+        self.value.store(hash, AtomicOrdering::Relaxed);
+        self.is_set.store(true, AtomicOrdering::Release);
+    }
+}
+
+impl Clone for CachedHash {
+    fn clone(&self) -> Self {
+        let cloned = CachedHash::default();
+        if let Some(hash) = self.get() {
+            cloned.set(hash);
+        }
+        cloned
+    }
+}
+
 #[derive(Clone, Debug)]
 pub struct SymbolicName {
     pub id: usize,
-    pub owner: Rc<Vec<OwnerName>>,
+    pub owner: Arc<Vec<OwnerName>>,
     pub access: Option<Vec<SymbolicAccess>>,
-    precomputed_hash: RefCell<Option<u64>>,
+    precomputed_hash: CachedHash,
 }
 
 impl SymbolicName {
-    pub fn new(id: usize, owner: Rc<Vec<OwnerName>>, access: Option<Vec<SymbolicAccess>>) -> Self {
+    pub fn new(id: usize, owner: Arc<Vec<OwnerName>>, access: Option<Vec<SymbolicAccess>>) -> Self {
         SymbolicName {
             id,
             owner,
             access,
-            precomputed_hash: RefCell::new(None),
+            precomputed_hash: CachedHash::default(),
         }
     }
 
@@ -136,17 +173,18 @@ impl SymbolicName {
     }
 
     pub fn update_hash(&self) {
-        *self.precomputed_hash.borrow_mut() = Some(self.compute_hash());
+        self.precomputed_hash.set(self.compute_hash());
     }
 
     fn get_or_update_hash(&self) -> u64 {
         // Check if the hash has been computed already.
-        if let Some(hash) = *self.precomputed_hash.borrow() {
+        if let Some(hash) = self.precomputed_hash.get() {
             hash
         } else {
             // Compute the hash and store it.
-            self.update_hash();
-            (*self.precomputed_hash.borrow()).unwrap()
+            let hash = self.compute_hash();
+            self.precomputed_hash.set(hash);
+            hash
         }
     }
 }
@@ -154,8 +192,8 @@ impl SymbolicName {
 impl PartialEq for SymbolicName {
     fn eq(&self, other: &Self) -> bool {
         // Check if precomputed hashes are available for both instances
-        let self_hash = *self.precomputed_hash.borrow();
-        let other_hash = *other.precomputed_hash.borrow();
+        let self_hash = self.precomputed_hash.get();
+        let other_hash = other.precomputed_hash.get();
 
         // If both hashes are available and not `None`, compare the hashes
         if let (Some(self_hash), Some(other_hash)) = (self_hash, other_hash) {
@@ -171,13 +209,13 @@ impl Eq for SymbolicName {}
 impl Hash for SymbolicName {
     fn hash<H: Hasher>(&self, state: &mut H) {
         // Use cached hash if available
-        let cached_hash = *self.precomputed_hash.borrow();
+        let cached_hash = self.precomputed_hash.get();
         if let Some(hash) = cached_hash {
             hash.hash(state);
         } else {
             // Compute and cache the hash value
             let hash = self.compute_hash();
-            *self.precomputed_hash.borrow_mut() = Some(hash);
+            self.precomputed_hash.set(hash);
             hash.hash(state);
         }
     }
@@ -377,7 +415,7 @@ impl SymbolicValue {
     }
 }
 
-pub type SymbolicValueRef = Rc<SymbolicValue>;
+pub type SymbolicValueRef = Arc<SymbolicValue>;
 
 /// Represents a symbolic template used in the symbolic execution process.
 #[derive(Default, Clone)]
@@ -418,6 +456,8 @@ pub struct SymbolicLibrary {
     pub name2id: FxHashMap<String, usize>,
     pub id2name: FxHashMap<usize, String>,
     pub function_counter: FxHashMap<usize, usize>,
+    /// Summaries of the component instances executed so far, shared by later instances.
+    pub component_summaries: FxHashMap<ComponentSummaryKey, Arc<ComponentSummary>>,
 }
 
 fn gather_variables_for_template(
@@ -467,6 +507,21 @@ impl SymbolicLibrary {
         }
     }
 
+    /// Runs `f` on this library and then restores the function counters, the only state that
+    /// executing the library mutates.
+    ///
+    /// This gives `f` the same view as running against a fresh clone of the library, without
+    /// copying the template and function bodies.
+    pub fn with_scoped_function_counter<R>(
+        &mut self,
+        f: impl FnOnce(&mut SymbolicLibrary) -> R,
+    ) -> R {
+        let function_counter = self.function_counter.clone();
+        let result = f(self);
+        self.function_counter = function_counter;
+        result
+    }
+
     /// Registers a library template by extracting input signals from the provided block statement body.
     ///
     /// # Arguments
@@ -635,7 +690,7 @@ pub fn access_multidimensional_array(
 pub fn register_array_elements<T>(
     name: usize,
     dims: &Vec<usize>,
-    owner: Option<Rc<Vec<OwnerName>>>,
+    owner: Option<Arc<Vec<OwnerName>>>,
     elements_of_component: &mut FxHashMap<SymbolicName, Option<T>>,
 ) {
     let positions = generate_cartesian_product_indices(dims);
@@ -645,7 +700,7 @@ pub fn register_array_elements<T>(
             SymbolicName::new(
                 name.clone(),
                 if owner.is_none() {
-                    Rc::new(Vec::new())
+                    Arc::new(Vec::new())
                 } else {
                     owner.clone().unwrap()
                 },
@@ -660,7 +715,7 @@ pub fn register_array_elements<T>(
                     SymbolicName::new(
                         name.clone(),
                         if owner.is_none() {
-                            Rc::new(Vec::new())
+                            Arc::new(Vec::new())
                         } else {
                             owner.clone().unwrap()
                         },
@@ -673,7 +728,7 @@ pub fn register_array_elements<T>(
                     SymbolicName::new(
                         name.clone(),
                         if owner.is_none() {
-                            Rc::new(Vec::new())
+                            Arc::new(Vec::new())
                         } else {
                             owner.clone().unwrap()
                         },
@@ -730,7 +785,8 @@ pub fn enumerate_array(value: &SymbolicValue) -> Vec<(Vec<usize>, &SymbolicValue
 }
 
 pub fn val_for_relational_operators(z: &BigInt, p: &BigInt) -> BigInt {
-    if &(p / BigInt::from(2) + BigInt::one()) <= z && z < p {
+    // `p / 2 + 1 <= z` is `p / 2 < z`, and `p / 2` is cached by the field backend.
+    if with_field_backend(p, |field| field.half_prime() < z) && z < p {
         z - p
     } else {
         z.clone()
@@ -792,229 +848,141 @@ pub fn evaluate_binary_op(
     prime: &BigInt,
     op: &DebuggableExpressionInfixOpcode,
 ) -> SymbolicValue {
-    let (normalized_lhs, normalized_rhs) = match &op.0 {
-        // Convert booleans to integers for arithmetic or bitwise operators
-        ExpressionInfixOpcode::Add
-        | ExpressionInfixOpcode::Sub
-        | ExpressionInfixOpcode::Mul
-        | ExpressionInfixOpcode::Pow
-        | ExpressionInfixOpcode::Div
-        | ExpressionInfixOpcode::IntDiv
-        | ExpressionInfixOpcode::Mod
-        | ExpressionInfixOpcode::BitOr
-        | ExpressionInfixOpcode::BitAnd
-        | ExpressionInfixOpcode::BitXor
-        | ExpressionInfixOpcode::ShiftL
-        | ExpressionInfixOpcode::ShiftR
-        | ExpressionInfixOpcode::Lesser
-        | ExpressionInfixOpcode::Greater
-        | ExpressionInfixOpcode::LesserEq
-        | ExpressionInfixOpcode::GreaterEq
-        | ExpressionInfixOpcode::Eq
-        | ExpressionInfixOpcode::NotEq => {
-            (normalize_to_int(lhs, prime), normalize_to_int(rhs, prime))
-        }
-        // Keep booleans as they are for logical operators
-        ExpressionInfixOpcode::BoolAnd | ExpressionInfixOpcode::BoolOr => {
-            (normalize_to_bool(lhs, prime), normalize_to_bool(rhs, prime))
-        } //_ => (lhs.clone(), rhs.clone()), // Default case
-    };
-
-    match (&normalized_lhs, &normalized_rhs) {
-        (SymbolicValue::ConstantInt(lv), SymbolicValue::ConstantInt(rv)) => match &op.0 {
-            ExpressionInfixOpcode::Add => SymbolicValue::ConstantInt((lv + rv) % prime),
-            ExpressionInfixOpcode::Sub => {
-                let mut tmp = (lv - rv) % prime;
-                if tmp.is_negative() {
-                    tmp += prime;
-                }
-                SymbolicValue::ConstantInt(tmp)
-            }
-            ExpressionInfixOpcode::Mul => SymbolicValue::ConstantInt((lv * rv) % prime),
-            ExpressionInfixOpcode::Pow => SymbolicValue::ConstantInt(modpow(lv, rv, prime)),
-            ExpressionInfixOpcode::Div => {
-                if lv.is_zero() || rv.is_zero() {
-                    SymbolicValue::ConstantInt(BigInt::zero())
-                } else {
-                    let mut r = prime.clone();
-                    let mut new_r = rv.clone();
-                    if r.is_negative() {
-                        r += prime;
-                    }
-                    if new_r.is_negative() {
-                        new_r += prime;
-                    }
-
-                    let (_, _, mut rv_inv) = extended_euclidean(r, new_r);
-                    rv_inv %= prime;
-                    if rv_inv.is_negative() {
-                        rv_inv += prime;
-                    }
-
-                    SymbolicValue::ConstantInt((lv * rv_inv) % prime)
-                }
-            }
-            ExpressionInfixOpcode::IntDiv => {
-                SymbolicValue::ConstantInt(if lv.is_zero() || rv.is_zero() {
-                    BigInt::zero()
-                } else {
-                    lv / rv
-                })
-            }
-            ExpressionInfixOpcode::Mod => {
-                SymbolicValue::ConstantInt(if lv.is_zero() || rv.is_zero() {
-                    BigInt::zero()
-                } else {
-                    lv % rv
-                })
-            }
-            ExpressionInfixOpcode::BitOr => SymbolicValue::ConstantInt(lv | rv),
-            ExpressionInfixOpcode::BitAnd => SymbolicValue::ConstantInt(lv & rv),
-            ExpressionInfixOpcode::BitXor => SymbolicValue::ConstantInt(lv ^ rv),
-            ExpressionInfixOpcode::ShiftL => {
-                SymbolicValue::ConstantInt(lv << rv.to_usize().unwrap())
-            }
-            ExpressionInfixOpcode::ShiftR => {
-                SymbolicValue::ConstantInt(lv >> rv.to_usize().unwrap())
-            }
-            ExpressionInfixOpcode::Lesser => SymbolicValue::ConstantBool(
-                val_for_relational_operators(&(lv % prime), prime)
-                    < val_for_relational_operators(&(rv % prime), prime),
-            ),
-            ExpressionInfixOpcode::Greater => SymbolicValue::ConstantBool(
-                val_for_relational_operators(&(lv % prime), prime)
-                    > val_for_relational_operators(&(rv % prime), prime),
-            ),
-            ExpressionInfixOpcode::LesserEq => SymbolicValue::ConstantBool(
-                val_for_relational_operators(&(lv % prime), prime)
-                    <= val_for_relational_operators(&(rv % prime), prime),
-            ),
-            ExpressionInfixOpcode::GreaterEq => SymbolicValue::ConstantBool(
-                val_for_relational_operators(&(lv % prime), prime)
-                    >= val_for_relational_operators(&(rv % prime), prime),
-            ),
-            ExpressionInfixOpcode::Eq => SymbolicValue::ConstantBool(lv % prime == rv % prime),
-            ExpressionInfixOpcode::NotEq => SymbolicValue::ConstantBool(lv % prime != rv % prime),
-            _ => todo!("{:?} is currently not supported", op),
-        },
-        (SymbolicValue::ConstantBool(lv), SymbolicValue::ConstantBool(rv)) => match &op.0 {
-            ExpressionInfixOpcode::BoolAnd => SymbolicValue::ConstantBool(*lv && *rv),
-            ExpressionInfixOpcode::BoolOr => SymbolicValue::ConstantBool(*lv || *rv),
-            _ => todo!("{:?} is currently not supported", op),
-        },
-        _ => SymbolicValue::BinaryOp(Rc::new(normalized_lhs), op.clone(), Rc::new(normalized_rhs)),
-    }
+    evaluate_normalized_binary_op(lhs, rhs, prime, op, false)
 }
 
+/// Evaluates a binary operation like `evaluate_binary_op`, except that relational operators
+/// compare the operands reduced modulo `prime` as they are, without mapping the upper half of
+/// the field to negative values.
 pub fn evaluate_binary_op_integer_mode(
     lhs: &SymbolicValue,
     rhs: &SymbolicValue,
     prime: &BigInt,
     op: &DebuggableExpressionInfixOpcode,
 ) -> SymbolicValue {
-    let (normalized_lhs, normalized_rhs) = match &op.0 {
-        // Convert booleans to integers for arithmetic or bitwise operators
-        ExpressionInfixOpcode::Add
-        | ExpressionInfixOpcode::Sub
-        | ExpressionInfixOpcode::Mul
-        | ExpressionInfixOpcode::Pow
-        | ExpressionInfixOpcode::Div
-        | ExpressionInfixOpcode::IntDiv
-        | ExpressionInfixOpcode::Mod
-        | ExpressionInfixOpcode::BitOr
-        | ExpressionInfixOpcode::BitAnd
-        | ExpressionInfixOpcode::BitXor
-        | ExpressionInfixOpcode::ShiftL
-        | ExpressionInfixOpcode::ShiftR
-        | ExpressionInfixOpcode::Lesser
-        | ExpressionInfixOpcode::Greater
-        | ExpressionInfixOpcode::LesserEq
-        | ExpressionInfixOpcode::GreaterEq
-        | ExpressionInfixOpcode::Eq
-        | ExpressionInfixOpcode::NotEq => {
-            (normalize_to_int(lhs, prime), normalize_to_int(rhs, prime))
-        }
+    evaluate_normalized_binary_op(lhs, rhs, prime, op, true)
+}
+
+fn evaluate_normalized_binary_op(
+    lhs: &SymbolicValue,
+    rhs: &SymbolicValue,
+    prime: &BigInt,
+    op: &DebuggableExpressionInfixOpcode,
+    is_integer_mode: bool,
+) -> SymbolicValue {
+    let (normalized_lhs, normalized_rhs) = if is_boolean_infix_op(&op.0) {
         // Keep booleans as they are for logical operators
-        ExpressionInfixOpcode::BoolAnd | ExpressionInfixOpcode::BoolOr => {
-            (normalize_to_bool(lhs, prime), normalize_to_bool(rhs, prime))
-        } //_ => (lhs.clone(), rhs.clone()), // Default case
+        (normalize_to_bool(lhs, prime), normalize_to_bool(rhs, prime))
+    } else {
+        // Convert booleans to integers for arithmetic or bitwise operators
+        (normalize_to_int(lhs, prime), normalize_to_int(rhs, prime))
     };
 
     match (&normalized_lhs, &normalized_rhs) {
-        (SymbolicValue::ConstantInt(lv), SymbolicValue::ConstantInt(rv)) => match &op.0 {
-            ExpressionInfixOpcode::Add => SymbolicValue::ConstantInt((lv + rv) % prime),
-            ExpressionInfixOpcode::Sub => {
-                let mut tmp = (lv - rv) % prime;
-                if tmp.is_negative() {
-                    tmp += prime;
-                }
-                SymbolicValue::ConstantInt(tmp)
-            }
-            ExpressionInfixOpcode::Mul => SymbolicValue::ConstantInt((lv * rv) % prime),
-            ExpressionInfixOpcode::Pow => SymbolicValue::ConstantInt(modpow(lv, rv, prime)),
-            ExpressionInfixOpcode::Div => {
-                if lv.is_zero() || rv.is_zero() {
-                    SymbolicValue::ConstantInt(BigInt::zero())
-                } else {
-                    let mut r = prime.clone();
-                    let mut new_r = rv.clone();
-                    if r.is_negative() {
-                        r += prime;
-                    }
-                    if new_r.is_negative() {
-                        new_r += prime;
-                    }
+        (SymbolicValue::ConstantInt(lv), SymbolicValue::ConstantInt(rv)) => {
+            evaluate_binary_op_of_integers(lv, rv, prime, op, is_integer_mode)
+        }
+        (SymbolicValue::ConstantBool(lv), SymbolicValue::ConstantBool(rv)) => {
+            evaluate_binary_op_of_booleans(*lv, *rv, op)
+        }
+        _ => SymbolicValue::BinaryOp(
+            Arc::new(normalized_lhs),
+            op.clone(),
+            Arc::new(normalized_rhs),
+        ),
+    }
+}
 
-                    let (_, _, mut rv_inv) = extended_euclidean(r, new_r);
-                    rv_inv %= prime;
-                    if rv_inv.is_negative() {
-                        rv_inv += prime;
-                    }
+/// Returns `true` for the logical operators, whose operands are normalized to booleans.
+pub fn is_boolean_infix_op(op: &ExpressionInfixOpcode) -> bool {
+    matches!(
+        op,
+        ExpressionInfixOpcode::BoolAnd | ExpressionInfixOpcode::BoolOr
+    )
+}
 
-                    SymbolicValue::ConstantInt((lv * rv_inv) % prime)
-                }
-            }
-            ExpressionInfixOpcode::IntDiv => {
-                SymbolicValue::ConstantInt(if lv.is_zero() || rv.is_zero() {
-                    BigInt::zero()
-                } else {
-                    lv / rv
-                })
-            }
-            ExpressionInfixOpcode::Mod => {
-                SymbolicValue::ConstantInt(if lv.is_zero() || rv.is_zero() {
-                    BigInt::zero()
-                } else {
-                    lv % rv
-                })
-            }
-            ExpressionInfixOpcode::BitOr => SymbolicValue::ConstantInt(lv | rv),
-            ExpressionInfixOpcode::BitAnd => SymbolicValue::ConstantInt(lv & rv),
-            ExpressionInfixOpcode::BitXor => SymbolicValue::ConstantInt(lv ^ rv),
-            ExpressionInfixOpcode::ShiftL => {
-                SymbolicValue::ConstantInt(lv << rv.to_usize().unwrap())
-            }
-            ExpressionInfixOpcode::ShiftR => {
-                SymbolicValue::ConstantInt(lv >> rv.to_usize().unwrap())
-            }
-            ExpressionInfixOpcode::Lesser => SymbolicValue::ConstantBool(lv % prime < rv % prime),
-            ExpressionInfixOpcode::Greater => SymbolicValue::ConstantBool(lv % prime > rv % prime),
-            ExpressionInfixOpcode::LesserEq => {
-                SymbolicValue::ConstantBool(lv % prime <= rv % prime)
-            }
-            ExpressionInfixOpcode::GreaterEq => {
-                SymbolicValue::ConstantBool(lv % prime >= rv % prime)
+/// Applies a non-logical binary operator to two integers normalized by `normalize_to_int`.
+///
+/// # Parameters
+/// - `lv`, `rv`: The normalized operands.
+/// - `prime`: The prime modulus.
+/// - `op`: The operator.
+/// - `is_integer_mode`: If `true`, relational operators compare the operands modulo `prime`
+///   directly; otherwise, they compare them via `val_for_relational_operators`.
+///
+/// # Returns
+/// A `ConstantInt` for arithmetic and bitwise operators, and a `ConstantBool` for relational ones.
+pub fn evaluate_binary_op_of_integers(
+    lv: &BigInt,
+    rv: &BigInt,
+    prime: &BigInt,
+    op: &DebuggableExpressionInfixOpcode,
+    is_integer_mode: bool,
+) -> SymbolicValue {
+    match &op.0 {
+        ExpressionInfixOpcode::Add => SymbolicValue::ConstantInt((lv + rv) % prime),
+        ExpressionInfixOpcode::Sub => {
+            let mut tmp = (lv - rv) % prime;
+            if tmp.is_negative() {
+                tmp += prime;
             }
-            ExpressionInfixOpcode::Eq => SymbolicValue::ConstantBool(lv % prime == rv % prime),
-            ExpressionInfixOpcode::NotEq => SymbolicValue::ConstantBool(lv % prime != rv % prime),
-            _ => todo!("{:?} is currently not supported", op),
-        },
-        (SymbolicValue::ConstantBool(lv), SymbolicValue::ConstantBool(rv)) => match &op.0 {
-            ExpressionInfixOpcode::BoolAnd => SymbolicValue::ConstantBool(*lv && *rv),
-            ExpressionInfixOpcode::BoolOr => SymbolicValue::ConstantBool(*lv || *rv),
-            _ => todo!("{:?} is currently not supported", op),
-        },
-        _ => SymbolicValue::BinaryOp(Rc::new(normalized_lhs), op.clone(), Rc::new(normalized_rhs)),
+            SymbolicValue::ConstantInt(tmp)
+        }
+        ExpressionInfixOpcode::Mul => SymbolicValue::ConstantInt((lv * rv) % prime),
+        ExpressionInfixOpcode::Pow => SymbolicValue::ConstantInt(modpow(lv, rv, prime)),
+        ExpressionInfixOpcode::Div => SymbolicValue::ConstantInt(moddiv(lv, rv, prime)),
+        ExpressionInfixOpcode::IntDiv => {
+            SymbolicValue::ConstantInt(if lv.is_zero() || rv.is_zero() {
+                BigInt::zero()
+            } else {
+                lv / rv
+            })
+        }
+        ExpressionInfixOpcode::Mod => SymbolicValue::ConstantInt(if lv.is_zero() || rv.is_zero() {
+            BigInt::zero()
+        } else {
+            lv % rv
+        }),
+        ExpressionInfixOpcode::BitOr => SymbolicValue::ConstantInt(lv | rv),
+        ExpressionInfixOpcode::BitAnd => SymbolicValue::ConstantInt(lv & rv),
+        ExpressionInfixOpcode::BitXor => SymbolicValue::ConstantInt(lv ^ rv),
+        ExpressionInfixOpcode::ShiftL => SymbolicValue::ConstantInt(lv << rv.to_usize().unwrap()),
+        ExpressionInfixOpcode::ShiftR => SymbolicValue::ConstantInt(lv >> rv.to_usize().unwrap()),
+        ExpressionInfixOpcode::Lesser
+        | ExpressionInfixOpcode::Greater
+        | ExpressionInfixOpcode::LesserEq
+        | ExpressionInfixOpcode::GreaterEq => {
+            let (l, r) = if is_integer_mode {
+                (lv % prime, rv % prime)
+            } else {
+                (
+                    val_for_relational_operators(&(lv % prime), prime),
+                    val_for_relational_operators(&(rv % prime), prime),
+                )
+            };
+            SymbolicValue::ConstantBool(match &op.0 {
+                ExpressionInfixOpcode::Lesser => l < r,
+                ExpressionInfixOpcode::Greater => l > r,
+                ExpressionInfixOpcode::LesserEq => l <= r,
+                _ => l >= r,
+            })
+        }
+        ExpressionInfixOpcode::Eq => SymbolicValue::ConstantBool(lv % prime == rv % prime),
+        ExpressionInfixOpcode::NotEq => SymbolicValue::ConstantBool(lv % prime != rv % prime),
+        _ => todo!("{:?} is currently not supported", op),
+    }
+}
+
+/// Applies a logical binary operator to two booleans.
+pub fn evaluate_binary_op_of_booleans(
+    lv: bool,
+    rv: bool,
+    op: &DebuggableExpressionInfixOpcode,
+) -> SymbolicValue {
+    match &op.0 {
+        ExpressionInfixOpcode::BoolAnd => SymbolicValue::ConstantBool(lv && rv),
+        ExpressionInfixOpcode::BoolOr => SymbolicValue::ConstantBool(lv || rv),
+        _ => todo!("{:?} is currently not supported", op),
     }
 }
 
@@ -1043,57 +1011,57 @@ pub fn normalize_to_bool(val: &SymbolicValue, prime: &BigInt) -> SymbolicValue {
 
 pub fn generate_lessthan_constraint(
     name2id: &FxHashMap<String, usize>,
-    owner_name: Rc<Vec<OwnerName>>,
+    owner_name: Arc<Vec<OwnerName>>,
 ) -> SymbolicValue {
-    let in_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let in_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         name2id["in"],
         owner_name.clone(),
         Some(vec![SymbolicAccess::ArrayAccess(
             SymbolicValue::ConstantInt(BigInt::zero()),
         )]),
     )));
-    let in_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let in_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         name2id["in"],
         owner_name.clone(),
         Some(vec![SymbolicAccess::ArrayAccess(
             SymbolicValue::ConstantInt(BigInt::one()),
         )]),
     )));
-    let lessthan_out = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let lessthan_out = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         name2id["out"],
         owner_name,
         None,
     )));
     let cond_1 = SymbolicValue::BinaryOp(
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::ConstantInt(BigInt::one())),
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::ConstantInt(BigInt::one())),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Eq),
             lessthan_out.clone(),
         )),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::BoolAnd),
-        Rc::new(SymbolicValue::AuxBinaryOp(
+        Arc::new(SymbolicValue::AuxBinaryOp(
             in_0.clone(),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Lesser),
             in_1.clone(),
         )),
     );
     let cond_0 = SymbolicValue::BinaryOp(
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Eq),
             lessthan_out.clone(),
         )),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::BoolAnd),
-        Rc::new(SymbolicValue::AuxBinaryOp(
+        Arc::new(SymbolicValue::AuxBinaryOp(
             in_0,
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::GreaterEq),
             in_1,
         )),
     );
     SymbolicValue::BinaryOp(
-        Rc::new(cond_1),
+        Arc::new(cond_1),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::BoolOr),
-        Rc::new(cond_0),
+        Arc::new(cond_0),
     )
 }
 
@@ -1146,7 +1114,7 @@ pub fn initialize_symbolic_nested_array_with_value(
         vec![initial_value; dims[0]]
     } else {
         vec![
-            Rc::new(SymbolicValue::Array(
+            Arc::new(SymbolicValue::Array(
                 initialize_symbolic_nested_array_with_value(&dims[1..], initial_value.clone())
             ));
             dims[0]
@@ -1166,7 +1134,7 @@ pub fn update_nested_array(
         } else {
             new_arr[dims[0]] = update_nested_array(&dims[1..], &arr[dims[0]], value);
         }
-        Rc::new(SymbolicValue::Array(new_arr))
+        Arc::new(SymbolicValue::Array(new_arr))
     } else {
         array.clone()
     }
@@ -1235,6 +1203,62 @@ pub fn extract_variables_from_symbolic_value(
     }
 }
 
+/// Recursively computes and caches the hashes of all symbolic names within a symbolic value.
+///
+/// After this call, hashing or comparing the names of `value` only reads the cached hashes,
+/// which allows the value to be shared read-only among threads without any writes.
+///
+/// # Parameters
+/// - `value`: The `SymbolicValue` to analyze.
+pub fn precompute_hashes_of_symbolic_value(value: &SymbolicValue) {
+    match value {
+        SymbolicValue::Variable(sym_name) => {
+            for owner in sym_name.owner.iter() {
+                if let Some(access) = &owner.access {
+                    precompute_hashes_of_symbolic_access(access);
+                }
+            }
+            if let Some(access) = &sym_name.access {
+                precompute_hashes_of_symbolic_access(access);
+            }
+            sym_name.update_hash();
+        }
+        SymbolicValue::Assign(lhs, rhs, _, _)
+        | SymbolicValue::AssignEq(lhs, rhs)
+        | SymbolicValue::AssignTemplParam(lhs, rhs)
+        | SymbolicValue::AssignCall(lhs, rhs, _)
+        | SymbolicValue::BinaryOp(lhs, _, rhs)
+        | SymbolicValue::AuxBinaryOp(lhs, _, rhs) => {
+            precompute_hashes_of_symbolic_value(&lhs);
+            precompute_hashes_of_symbolic_value(&rhs);
+        }
+        SymbolicValue::UnaryOp(_, expr) => precompute_hashes_of_symbolic_value(&expr),
+        SymbolicValue::Array(elements) | SymbolicValue::Call(_, elements) => {
+            for elem in elements {
+                precompute_hashes_of_symbolic_value(&elem);
+            }
+        }
+        SymbolicValue::UniformArray(value, size) => {
+            precompute_hashes_of_symbolic_value(&value);
+            precompute_hashes_of_symbolic_value(&size);
+        }
+        SymbolicValue::Conditional(cond, then_val, else_val) => {
+            precompute_hashes_of_symbolic_value(&cond);
+            precompute_hashes_of_symbolic_value(&then_val);
+            precompute_hashes_of_symbolic_value(&else_val);
+        }
+        _ => {}
+    }
+}
+
+fn precompute_hashes_of_symbolic_access(access: &[SymbolicAccess]) {
+    for acc in access {
+        if let SymbolicAccess::ArrayAccess(value) = acc {
+            precompute_hashes_of_symbolic_value(value);
+        }
+    }
+}
+
 pub fn get_coefficient_of_polynomials(
     expr: &SymbolicValue,
     target_name: &SymbolicName,
@@ -1242,16 +1266,16 @@ pub fn get_coefficient_of_polynomials(
 ) -> [SymbolicValueRef; 3] {
     match &expr {
         SymbolicValue::ConstantInt(_) => {
-            let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
-            [Rc::new(expr.clone()), zero.clone(), zero]
+            let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+            [Arc::new(expr.clone()), zero.clone(), zero]
         }
         SymbolicValue::Variable(name) => {
-            let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+            let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
             if name == target_name {
-                let one = Rc::new(SymbolicValue::ConstantInt(BigInt::one()));
+                let one = Arc::new(SymbolicValue::ConstantInt(BigInt::one()));
                 [zero.clone(), one, zero]
             } else {
-                [Rc::new(expr.clone()), zero.clone(), zero]
+                [Arc::new(expr.clone()), zero.clone(), zero]
             }
         }
         SymbolicValue::BinaryOp(lhs, op, rhs) => match &op.0 {
@@ -1259,19 +1283,19 @@ pub fn get_coefficient_of_polynomials(
                 let left = get_coefficient_of_polynomials(lhs, target_name, prime);
                 let right = get_coefficient_of_polynomials(rhs, target_name, prime);
                 [
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(evaluate_binary_op(
                         &left[0],
                         &right[0],
                         prime,
                         &DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
                     )),
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(evaluate_binary_op(
                         &left[1],
                         &right[1],
                         prime,
                         &DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
                     )),
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(evaluate_binary_op(
                         &left[2],
                         &right[2],
                         prime,
@@ -1283,19 +1307,19 @@ pub fn get_coefficient_of_polynomials(
                 let left = get_coefficient_of_polynomials(lhs, target_name, prime);
                 let right = get_coefficient_of_polynomials(rhs, target_name, prime);
                 [
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(evaluate_binary_op(
                         &left[0],
                         &right[0],
                         prime,
                         &DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Sub),
                     )),
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(evaluate_binary_op(
                         &left[1],
                         &right[1],
                         prime,
                         &DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Sub),
                     )),
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(evaluate_binary_op(
                         &left[2],
                         &right[2],
                         prime,
@@ -1347,14 +1371,14 @@ pub fn get_coefficient_of_polynomials(
                 );
 
                 [
-                    Rc::new(c0),
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(c0),
+                    Arc::new(evaluate_binary_op(
                         &c1,
                         &c2,
                         prime,
                         &DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
                     )),
-                    Rc::new(evaluate_binary_op(
+                    Arc::new(evaluate_binary_op(
                         &evaluate_binary_op(
                             &c3,
                             &c4,
@@ -1368,13 +1392,13 @@ pub fn get_coefficient_of_polynomials(
                 ]
             }
             _ => {
-                let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
-                [Rc::new(expr.clone()), zero.clone(), zero]
+                let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+                [Arc::new(expr.clone()), zero.clone(), zero]
             }
         },
         _ => {
-            let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
-            [Rc::new(expr.clone()), zero.clone(), zero]
+            let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+            [Arc::new(expr.clone()), zero.clone(), zero]
         }
     }
 }
@@ -0,0 +1,696 @@
+//! On-disk cache of the symbolic trace and side constraints of a circuit.
+//!
+//! Symbolic execution of the main template dominates the start-up time of zkFuzz on large
+//! circuits, while its result only depends on the sources, the prime, and a few flags. The
+//! cache stores that result in a compact binary format, keyed by a hash of those inputs, so
+//! that repeated runs (e.g., with different seeds) skip straight to the search phase. Since
+//! the hash only names the entry, the entry also stores the inputs themselves, with a digest
+//! and the length of every source, and is only used if they are unchanged.
+//!
+//! Symbolic values are stored as a DAG: a value shared through the same `Arc` in memory is
+//! written once and referred to by index afterwards, and loading restores the same sharing.
+
+use std::fs;
+use std::fs::File;
+use std::hash::Hasher;
+use std::io;
+use std::io::{BufReader, BufWriter, Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+
+use num_bigint_dig::{BigInt, Sign};
+use rustc_hash::{FxHashMap, FxHasher};
+
+use program_structure::ast::{ExpressionInfixOpcode, ExpressionPrefixOpcode};
+
+use crate::executor::debug_ast::{
+    DebuggableExpressionInfixOpcode, DebuggableExpressionPrefixOpcode,
+};
+use crate::executor::symbolic_state::{
+    SymbolBindingMap, SymbolicConstraints, SymbolicState, SymbolicTrace,
+};
+use crate::executor::symbolic_value::{
+    OwnerName, QuadraticPoly, SymbolicAccess, SymbolicName, SymbolicValue, SymbolicValueRef,
+};
+
+const MAGIC: &[u8; 4] = b"ZKTC";
+const FORMAT_VERSION: u32 = 2;
+
+/// The inputs that the symbolic execution of a circuit depends on.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct CacheKey {
+    /// The hash of `inputs`, which names the cache entry.
+    pub hash: u64,
+    /// The settings, followed by the length and the digest of every source file, in the
+    /// order of their inclusion, and by the includes that cannot be resolved.
+    pub inputs: Vec<String>,
+}
+
+/// The result of the symbolic execution of the main template.
+pub struct CachedTrace {
+    /// The inputs of the cache key with which the entry was saved.
+    pub key_inputs: Vec<String>,
+    pub name2id: FxHashMap<String, usize>,
+    pub symbol_binding_map: SymbolBindingMap,
+    pub symbolic_trace: SymbolicTrace,
+    pub side_constraints: SymbolicConstraints,
+}
+
+/// Computes the key of the cache entry for the given circuit.
+///
+/// # Parameters
+/// - `input_program`: The path to the circuit with the main component.
+/// - `link_libraries`: The directories searched for included files.
+/// - `settings`: Every other input that affects the symbolic execution, such as the prime and
+///   the flags, in a fixed order.
+///
+/// # Returns
+/// The key, or an error if a source file cannot be read. The key covers the contents of the
+/// circuit and of every file it includes, directly or not.
+pub fn compute_cache_key(
+    input_program: &Path,
+    link_libraries: &[PathBuf],
+    settings: &[String],
+) -> io::Result<CacheKey> {
+    let mut inputs = vec![env!("CARGO_PKG_VERSION").to_string()];
+    inputs.extend(settings.iter().cloned());
+
+    let mut visited: Vec<PathBuf> = Vec::new();
+    let mut stack = vec![input_program.to_path_buf()];
+    while let Some(path) = stack.pop() {
+        let path = fs::canonicalize(&path)?;
+        if visited.contains(&path) {
+            continue;
+        }
+        let source = fs::read_to_string(&path)?;
+        let mut source_hasher = FxHasher::default();
+        source_hasher.write(source.as_bytes());
+        inputs.push(format!("{}:{:016x}", source.len(), source_hasher.finish()));
+
+        let dir = path.parent().map(|p| p.to_path_buf()).unwrap_or_default();
+        for included in find_includes(&source).into_iter().rev() {
+            let resolved = std::iter::once(&dir)
+                .chain(link_libraries.iter())
+                .map(|lib| lib.join(&included))
+                .find(|candidate| candidate.is_file());
+            match resolved {
+                Some(resolved) => stack.push(resolved),
+                // Let the parser report missing includes; they still change the key.
+                None => inputs.push(format!("missing:{}", included)),
+            }
+        }
+        visited.push(path);
+    }
+
+    let mut hasher = FxHasher::default();
+    hasher.write_u32(FORMAT_VERSION);
+    for input in &inputs {
+        hasher.write_usize(input.len());
+        hasher.write(input.as_bytes());
+    }
+    Ok(CacheKey {
+        hash: hasher.finish(),
+        inputs,
+    })
+}
+
+/// Returns the paths of the `include` directives of a Circom source.
+fn find_includes(source: &str) -> Vec<String> {
+    source
+        .lines()
+        .filter_map(|line| {
+            let rest = line.trim_start().strip_prefix("include")?;
+            let start = rest.find('"')? + 1;
+            let end = start + rest[start..].find('"')?;
+            Some(rest[start..end].to_string())
+        })
+        .collect()
+}
+
+/// Returns the path of the cache entry in `cache_dir` for `key`.
+pub fn cache_path(cache_dir: &Path, key: &CacheKey) -> PathBuf {
+    cache_dir.join(format!("{:016x}.zktc", key.hash))
+}
+
+/// Stores the result of the symbolic execution at `path`, i.e., the variable bindings, the
+/// trace, and the side constraints of `state`, along with the inputs of `key`. The entry is
+/// written to a temporary file first, so that a concurrent reader never sees a partial entry.
+pub fn save_cached_trace(
+    path: &Path,
+    key: &CacheKey,
+    name2id: &FxHashMap<String, usize>,
+    state: &SymbolicState,
+) -> io::Result<()> {
+    if let Some(dir) = path.parent() {
+        fs::create_dir_all(dir)?;
+    }
+    let tmp_path = path.with_extension(format!("tmp{}", std::process::id()));
+    let mut encoder = Encoder::new(BufWriter::new(File::create(&tmp_path)?));
+    encoder.out.write_all(MAGIC)?;
+    encoder.write_u32(FORMAT_VERSION)?;
+
+    encoder.write_usize(key.inputs.len())?;
+    for input in &key.inputs {
+        encoder.write_str(input)?;
+    }
+    let mut names: Vec<_> = name2id.iter().collect();
+    names.sort();
+    encoder.write_usize(names.len())?;
+    for (name, id) in names {
+        encoder.write_str(name)?;
+        encoder.write_usize(*id)?;
+    }
+    encoder.write_usize(state.symbol_binding_map.len())?;
+    for (name, value) in state.symbol_binding_map.iter() {
+        encoder.write_name(name)?;
+        encoder.write_ref(value)?;
+    }
+    encoder.write_refs(&state.symbolic_trace)?;
+    encoder.write_refs(&state.side_constraints)?;
+    encoder
+        .out
+        .into_inner()
+        .map_err(|e| e.into_error())?
+        .sync_all()?;
+    fs::rename(tmp_path, path)
+}
+
+/// Loads the result of the symbolic execution stored at `path` by `save_cached_trace`.
+pub fn load_cached_trace(path: &Path) -> io::Result<CachedTrace> {
+    let mut decoder = Decoder::new(BufReader::new(File::open(path)?));
+    let mut magic = [0_u8; 4];
+    decoder.input.read_exact(&mut magic)?;
+    if &magic != MAGIC || decoder.read_u32()? != FORMAT_VERSION {
+        return Err(invalid_data("not a trace cache of this version"));
+    }
+
+    let num_inputs = decoder.read_usize()?;
+    let mut key_inputs = Vec::new();
+    for _ in 0..num_inputs {
+        key_inputs.push(decoder.read_str()?);
+    }
+    let num_names = decoder.read_usize()?;
+    let mut name2id = FxHashMap::default();
+    for _ in 0..num_names {
+        let name = decoder.read_str()?;
+        name2id.insert(name, decoder.read_usize()?);
+    }
+    let num_bindings = decoder.read_usize()?;
+    let mut symbol_binding_map = SymbolBindingMap::default();
+    for _ in 0..num_bindings {
+        let name = decoder.read_name()?;
+        symbol_binding_map.insert(name, decoder.read_ref()?);
+    }
+    let symbolic_trace = decoder.read_refs()?;
+    let side_constraints = decoder.read_refs()?;
+    Ok(CachedTrace {
+        key_inputs,
+        name2id,
+        symbol_binding_map,
+        symbolic_trace,
+        side_constraints,
+    })
+}
+
+pub(crate) fn invalid_data(msg: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, msg.to_string())
+}
+
+pub(crate) const INFIX_OPCODES: [ExpressionInfixOpcode; 20] = [
+    ExpressionInfixOpcode::Mul,
+    ExpressionInfixOpcode::Div,
+    ExpressionInfixOpcode::Add,
+    ExpressionInfixOpcode::Sub,
+    ExpressionInfixOpcode::Pow,
+    ExpressionInfixOpcode::IntDiv,
+    ExpressionInfixOpcode::Mod,
+    ExpressionInfixOpcode::ShiftL,
+    ExpressionInfixOpcode::ShiftR,
+    ExpressionInfixOpcode::LesserEq,
+    ExpressionInfixOpcode::GreaterEq,
+    ExpressionInfixOpcode::Lesser,
+    ExpressionInfixOpcode::Greater,
+    ExpressionInfixOpcode::Eq,
+    ExpressionInfixOpcode::NotEq,
+    ExpressionInfixOpcode::BoolOr,
+    ExpressionInfixOpcode::BoolAnd,
+    ExpressionInfixOpcode::BitOr,
+    ExpressionInfixOpcode::BitAnd,
+    ExpressionInfixOpcode::BitXor,
+];
+
+const PREFIX_OPCODES: [ExpressionPrefixOpcode; 3] = [
+    ExpressionPrefixOpcode::Sub,
+    ExpressionPrefixOpcode::BoolNot,
+    ExpressionPrefixOpcode::Complement,
+];
+
+// Tags of the encoded symbolic values.
+const TAG_NOP: u8 = 0;
+const TAG_CONSTANT_INT: u8 = 1;
+const TAG_CONSTANT_BOOL: u8 = 2;
+const TAG_VARIABLE: u8 = 3;
+const TAG_ASSIGN: u8 = 4;
+const TAG_ASSIGN_EQ: u8 = 5;
+const TAG_ASSIGN_TEMPL_PARAM: u8 = 6;
+const TAG_ASSIGN_CALL: u8 = 7;
+const TAG_BINARY_OP: u8 = 8;
+const TAG_AUX_BINARY_OP: u8 = 9;
+const TAG_CONDITIONAL: u8 = 10;
+const TAG_UNARY_OP: u8 = 11;
+const TAG_ARRAY: u8 = 12;
+const TAG_UNIFORM_ARRAY: u8 = 13;
+const TAG_CALL: u8 = 14;
+
+// Tags of shared values and owners.
+const TAG_NEW: u8 = 0;
+const TAG_SEEN: u8 = 1;
+
+/// Writes values in the binary format of the cache. Symbolic values and owners shared in
+/// memory are written once.
+pub(crate) struct Encoder<W: Write> {
+    pub(crate) out: W,
+    value_ids: FxHashMap<*const SymbolicValue, usize>,
+    owner_ids: FxHashMap<*const Vec<OwnerName>, usize>,
+}
+
+impl<W: Write> Encoder<W> {
+    pub(crate) fn new(out: W) -> Self {
+        Encoder {
+            out,
+            value_ids: FxHashMap::default(),
+            owner_ids: FxHashMap::default(),
+        }
+    }
+
+    pub(crate) fn write_u8(&mut self, v: u8) -> io::Result<()> {
+        self.out.write_all(&[v])
+    }
+
+    pub(crate) fn write_u32(&mut self, v: u32) -> io::Result<()> {
+        self.out.write_all(&v.to_le_bytes())
+    }
+
+    pub(crate) fn write_usize(&mut self, v: usize) -> io::Result<()> {
+        self.write_u64(v as u64)
+    }
+
+    pub(crate) fn write_u64(&mut self, v: u64) -> io::Result<()> {
+        self.out.write_all(&v.to_le_bytes())
+    }
+
+    pub(crate) fn write_str(&mut self, s: &str) -> io::Result<()> {
+        self.write_usize(s.len())?;
+        self.out.write_all(s.as_bytes())
+    }
+
+    pub(crate) fn write_bigint(&mut self, v: &BigInt) -> io::Result<()> {
+        let (sign, bytes) = v.to_bytes_le();
+        self.write_u8(match sign {
+            Sign::Minus => 0,
+            Sign::NoSign => 1,
+            Sign::Plus => 2,
+        })?;
+        self.write_usize(bytes.len())?;
+        self.out.write_all(&bytes)
+    }
+
+    fn write_infix_opcode(&mut self, op: &DebuggableExpressionInfixOpcode) -> io::Result<()> {
+        let index = INFIX_OPCODES.iter().position(|o| *o == op.0).unwrap();
+        self.write_u8(index as u8)
+    }
+
+    fn write_ref(&mut self, value: &SymbolicValueRef) -> io::Result<()> {
+        if let Some(id) = self.value_ids.get(&Arc::as_ptr(value)) {
+            let id = *id;
+            self.write_u8(TAG_SEEN)?;
+            return self.write_usize(id);
+        }
+        self.write_u8(TAG_NEW)?;
+        self.write_value(value)?;
+        // Ids are assigned once the whole value is written, as the decoder does.
+        let id = self.value_ids.len();
+        self.value_ids.insert(Arc::as_ptr(value), id);
+        Ok(())
+    }
+
+    fn write_refs(&mut self, values: &[SymbolicValueRef]) -> io::Result<()> {
+        self.write_usize(values.len())?;
+        for value in values {
+            self.write_ref(value)?;
+        }
+        Ok(())
+    }
+
+    fn write_quadratic_polys(&mut self, polys: &[QuadraticPoly]) -> io::Result<()> {
+        self.write_usize(polys.len())?;
+        for (name, coefficients) in polys {
+            self.write_name(name)?;
+            for coefficient in coefficients {
+                self.write_ref(coefficient)?;
+            }
+        }
+        Ok(())
+    }
+
+    pub(crate) fn write_value(&mut self, value: &SymbolicValue) -> io::Result<()> {
+        match value {
+            SymbolicValue::NOP => self.write_u8(TAG_NOP),
+            SymbolicValue::ConstantInt(v) => {
+                self.write_u8(TAG_CONSTANT_INT)?;
+                self.write_bigint(v)
+            }
+            SymbolicValue::ConstantBool(b) => {
+                self.write_u8(TAG_CONSTANT_BOOL)?;
+                self.write_u8(*b as u8)
+            }
+            SymbolicValue::Variable(name) => {
+                self.write_u8(TAG_VARIABLE)?;
+                self.write_name(name)
+            }
+            SymbolicValue::Assign(lhs, rhs, is_safe, polys) => {
+                self.write_u8(TAG_ASSIGN)?;
+                self.write_ref(lhs)?;
+                self.write_ref(rhs)?;
+                self.write_u8(*is_safe as u8)?;
+                match polys {
+                    Some((numerators, denominators)) => {
+                        self.write_u8(1)?;
+                        self.write_quadratic_polys(numerators)?;
+                        self.write_quadratic_polys(denominators)
+                    }
+                    None => self.write_u8(0),
+                }
+            }
+            SymbolicValue::AssignEq(lhs, rhs) => {
+                self.write_u8(TAG_ASSIGN_EQ)?;
+                self.write_ref(lhs)?;
+                self.write_ref(rhs)
+            }
+            SymbolicValue::AssignTemplParam(lhs, rhs) => {
+                self.write_u8(TAG_ASSIGN_TEMPL_PARAM)?;
+                self.write_ref(lhs)?;
+                self.write_ref(rhs)
+            }
+            SymbolicValue::AssignCall(lhs, rhs, is_mutable) => {
+                self.write_u8(TAG_ASSIGN_CALL)?;
+                self.write_ref(lhs)?;
+                self.write_ref(rhs)?;
+                self.write_u8(*is_mutable as u8)
+            }
+            SymbolicValue::BinaryOp(lhs, op, rhs) | SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+                self.write_u8(if matches!(value, SymbolicValue::BinaryOp(..)) {
+                    TAG_BINARY_OP
+                } else {
+                    TAG_AUX_BINARY_OP
+                })?;
+                self.write_ref(lhs)?;
+                self.write_infix_opcode(op)?;
+                self.write_ref(rhs)
+            }
+            SymbolicValue::Conditional(cond, then_branch, else_branch) => {
+                self.write_u8(TAG_CONDITIONAL)?;
+                self.write_ref(cond)?;
+                self.write_ref(then_branch)?;
+                self.write_ref(else_branch)
+            }
+            SymbolicValue::UnaryOp(op, expr) => {
+                self.write_u8(TAG_UNARY_OP)?;
+                let index = PREFIX_OPCODES.iter().position(|o| *o == op.0).unwrap();
+                self.write_u8(index as u8)?;
+                self.write_ref(expr)
+            }
+            SymbolicValue::Array(elements) => {
+                self.write_u8(TAG_ARRAY)?;
+                self.write_refs(elements)
+            }
+            SymbolicValue::UniformArray(elem, size) => {
+                self.write_u8(TAG_UNIFORM_ARRAY)?;
+                self.write_ref(elem)?;
+                self.write_ref(size)
+            }
+            SymbolicValue::Call(id, args) => {
+                self.write_u8(TAG_CALL)?;
+                self.write_usize(*id)?;
+                self.write_refs(args)
+            }
+        }
+    }
+
+    fn write_accesses(&mut self, accesses: &Option<Vec<SymbolicAccess>>) -> io::Result<()> {
+        match accesses {
+            Some(accesses) => {
+                self.write_u8(1)?;
+                self.write_usize(accesses.len())?;
+                for access in accesses {
+                    match access {
+                        SymbolicAccess::ComponentAccess(id) => {
+                            self.write_u8(0)?;
+                            self.write_usize(*id)?;
+                        }
+                        SymbolicAccess::ArrayAccess(value) => {
+                            self.write_u8(1)?;
+                            self.write_value(value)?;
+                        }
+                    }
+                }
+                Ok(())
+            }
+            None => self.write_u8(0),
+        }
+    }
+
+    pub(crate) fn write_name(&mut self, name: &SymbolicName) -> io::Result<()> {
+        self.write_usize(name.id)?;
+        if let Some(id) = self.owner_ids.get(&Arc::as_ptr(&name.owner)) {
+            let id = *id;
+            self.write_u8(TAG_SEEN)?;
+            self.write_usize(id)?;
+        } else {
+            self.write_u8(TAG_NEW)?;
+            self.write_usize(name.owner.len())?;
+            for owner in name.owner.iter() {
+                self.write_usize(owner.id)?;
+                self.write_accesses(&owner.access)?;
+                self.write_usize(owner.counter)?;
+            }
+            let id = self.owner_ids.len();
+            self.owner_ids.insert(Arc::as_ptr(&name.owner), id);
+        }
+        self.write_accesses(&name.access)
+    }
+}
+
+/// Reads values written by an `Encoder`.
+pub(crate) struct Decoder<R: Read> {
+    pub(crate) input: R,
+    values: Vec<SymbolicValueRef>,
+    owners: Vec<Arc<Vec<OwnerName>>>,
+}
+
+impl<R: Read> Decoder<R> {
+    pub(crate) fn new(input: R) -> Self {
+        Decoder {
+            input,
+            values: Vec::new(),
+            owners: Vec::new(),
+        }
+    }
+
+    pub(crate) fn read_u8(&mut self) -> io::Result<u8> {
+        let mut buf = [0_u8; 1];
+        self.input.read_exact(&mut buf)?;
+        Ok(buf[0])
+    }
+
+    pub(crate) fn read_bool(&mut self) -> io::Result<bool> {
+        match self.read_u8()? {
+            0 => Ok(false),
+            1 => Ok(true),
+            _ => Err(invalid_data("invalid boolean")),
+        }
+    }
+
+    pub(crate) fn read_u32(&mut self) -> io::Result<u32> {
+        let mut buf = [0_u8; 4];
+        self.input.read_exact(&mut buf)?;
+        Ok(u32::from_le_bytes(buf))
+    }
+
+    pub(crate) fn read_usize(&mut self) -> io::Result<usize> {
+        usize::try_from(self.read_u64()?).map_err(|_| invalid_data("invalid length"))
+    }
+
+    pub(crate) fn read_u64(&mut self) -> io::Result<u64> {
+        let mut buf = [0_u8; 8];
+        self.input.read_exact(&mut buf)?;
+        Ok(u64::from_le_bytes(buf))
+    }
+
+    fn read_bytes(&mut self) -> io::Result<Vec<u8>> {
+        let len = self.read_usize()?;
+        let mut bytes = Vec::new();
+        self.input
+            .by_ref()
+            .take(len as u64)
+            .read_to_end(&mut bytes)?;
+        if bytes.len() != len {
+            return Err(io::ErrorKind::UnexpectedEof.into());
+        }
+        Ok(bytes)
+    }
+
+    pub(crate) fn read_str(&mut self) -> io::Result<String> {
+        String::from_utf8(self.read_bytes()?).map_err(|_| invalid_data("invalid string"))
+    }
+
+    pub(crate) fn read_bigint(&mut self) -> io::Result<BigInt> {
+        let sign = match self.read_u8()? {
+            0 => Sign::Minus,
+            1 => Sign::NoSign,
+            2 => Sign::Plus,
+            _ => return Err(invalid_data("invalid sign")),
+        };
+        Ok(BigInt::from_bytes_le(sign, &self.read_bytes()?))
+    }
+
+    fn read_infix_opcode(&mut self) -> io::Result<DebuggableExpressionInfixOpcode> {
+        INFIX_OPCODES
+            .get(self.read_u8()? as usize)
+            .map(|op| DebuggableExpressionInfixOpcode(op.clone()))
+            .ok_or_else(|| invalid_data("invalid infix opcode"))
+    }
+
+    fn read_ref(&mut self) -> io::Result<SymbolicValueRef> {
+        match self.read_u8()? {
+            TAG_SEEN => {
+                let id = self.read_usize()?;
+                self.values
+                    .get(id)
+                    .cloned()
+                    .ok_or_else(|| invalid_data("invalid value reference"))
+            }
+            TAG_NEW => {
+                let value = Arc::new(self.read_value()?);
+                self.values.push(value.clone());
+                Ok(value)
+            }
+            _ => Err(invalid_data("invalid value tag")),
+        }
+    }
+
+    fn read_refs(&mut self) -> io::Result<Vec<SymbolicValueRef>> {
+        let len = self.read_usize()?;
+        (0..len).map(|_| self.read_ref()).collect()
+    }
+
+    fn read_quadratic_polys(&mut self) -> io::Result<Vec<QuadraticPoly>> {
+        let len = self.read_usize()?;
+        (0..len)
+            .map(|_| {
+                let name = self.read_name()?;
+                let coefficients = [self.read_ref()?, self.read_ref()?, self.read_ref()?];
+                Ok((name, coefficients))
+            })
+            .collect()
+    }
+
+    pub(crate) fn read_value(&mut self) -> io::Result<SymbolicValue> {
+        let value = match self.read_u8()? {
+            TAG_NOP => SymbolicValue::NOP,
+            TAG_CONSTANT_INT => SymbolicValue::ConstantInt(self.read_bigint()?),
+            TAG_CONSTANT_BOOL => SymbolicValue::ConstantBool(self.read_bool()?),
+            TAG_VARIABLE => SymbolicValue::Variable(self.read_name()?),
+            TAG_ASSIGN => {
+                let lhs = self.read_ref()?;
+                let rhs = self.read_ref()?;
+                let is_safe = self.read_bool()?;
+                let polys = if self.read_bool()? {
+                    Some((self.read_quadratic_polys()?, self.read_quadratic_polys()?))
+                } else {
+                    None
+                };
+                SymbolicValue::Assign(lhs, rhs, is_safe, polys)
+            }
+            TAG_ASSIGN_EQ => SymbolicValue::AssignEq(self.read_ref()?, self.read_ref()?),
+            TAG_ASSIGN_TEMPL_PARAM => {
+                SymbolicValue::AssignTemplParam(self.read_ref()?, self.read_ref()?)
+            }
+            TAG_ASSIGN_CALL => {
+                SymbolicValue::AssignCall(self.read_ref()?, self.read_ref()?, self.read_bool()?)
+            }
+            TAG_BINARY_OP => SymbolicValue::BinaryOp(
+                self.read_ref()?,
+                self.read_infix_opcode()?,
+                self.read_ref()?,
+            ),
+            TAG_AUX_BINARY_OP => SymbolicValue::AuxBinaryOp(
+                self.read_ref()?,
+                self.read_infix_opcode()?,
+                self.read_ref()?,
+            ),
+            TAG_CONDITIONAL => {
+                SymbolicValue::Conditional(self.read_ref()?, self.read_ref()?, self.read_ref()?)
+            }
+            TAG_UNARY_OP => {
+                let op = PREFIX_OPCODES
+                    .get(self.read_u8()? as usize)
+                    .ok_or_else(|| invalid_data("invalid prefix opcode"))?;
+                SymbolicValue::UnaryOp(
+                    DebuggableExpressionPrefixOpcode(op.clone()),
+                    self.read_ref()?,
+                )
+            }
+            TAG_ARRAY => SymbolicValue::Array(self.read_refs()?),
+            TAG_UNIFORM_ARRAY => SymbolicValue::UniformArray(self.read_ref()?, self.read_ref()?),
+            TAG_CALL => SymbolicValue::Call(self.read_usize()?, self.read_refs()?),
+            _ => return Err(invalid_data("invalid symbolic value")),
+        };
+        Ok(value)
+    }
+
+    fn read_accesses(&mut self) -> io::Result<Option<Vec<SymbolicAccess>>> {
+        if !self.read_bool()? {
+            return Ok(None);
+        }
+        let len = self.read_usize()?;
+        let accesses = (0..len)
+            .map(|_| match self.read_u8()? {
+                0 => Ok(SymbolicAccess::ComponentAccess(self.read_usize()?)),
+                1 => Ok(SymbolicAccess::ArrayAccess(self.read_value()?)),
+                _ => Err(invalid_data("invalid access")),
+            })
+            .collect::<io::Result<_>>()?;
+        Ok(Some(accesses))
+    }
+
+    pub(crate) fn read_name(&mut self) -> io::Result<SymbolicName> {
+        let id = self.read_usize()?;
+        let owner = match self.read_u8()? {
+            TAG_SEEN => {
+                let id = self.read_usize()?;
+                self.owners
+                    .get(id)
+                    .cloned()
+                    .ok_or_else(|| invalid_data("invalid owner reference"))?
+            }
+            TAG_NEW => {
+                let len = self.read_usize()?;
+                let owner = (0..len)
+                    .map(|_| {
+                        Ok(OwnerName {
+                            id: self.read_usize()?,
+                            access: self.read_accesses()?,
+                            counter: self.read_usize()?,
+                        })
+                    })
+                    .collect::<io::Result<Vec<_>>>()?;
+                let owner = Arc::new(owner);
+                self.owners.push(owner.clone());
+                owner
+            }
+            _ => return Err(invalid_data("invalid owner tag")),
+        };
+        Ok(SymbolicName::new(id, owner, self.read_accesses()?))
+    }
+}
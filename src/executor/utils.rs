@@ -1,6 +1,9 @@
 use num_bigint_dig::BigInt;
-use num_traits::{One, Signed, Zero};
+use num_traits::{One, Zero};
 use std::ops::{Div, Rem, Sub};
+use std::slice;
+
+use crate::executor::field::with_field_backend;
 
 pub fn extended_euclidean<F>(a: F, b: F) -> (F, F, F)
 where
@@ -29,52 +32,21 @@ where
     (r0, s0, t0)
 }
 
+/// Computes `base^exp mod modulus` with the field backend of `modulus`.
 pub fn modpow(base: &BigInt, exp: &BigInt, modulus: &BigInt) -> BigInt {
-    let mut result = BigInt::from(1);
-    let mut base = base % modulus; // Reduce base mod modulus initially
-    let mut exp = exp.clone();
-
-    while exp > BigInt::from(0) {
-        // If exp is odd, multiply base with result
-        if &exp % 2 == BigInt::from(1) {
-            result = (result * &base) % modulus;
-        }
-        // Square the base and halve the exponent
-        base = (&base * &base) % modulus;
-        exp /= 2;
-    }
-    result
+    with_field_backend(modulus, |field| field.modpow(base, exp))
 }
 
+/// Computes `lv / rv mod modulus` with the field backend of `modulus`, or zero if either
+/// operand is zero.
 pub fn moddiv(lv: &BigInt, rv: &BigInt, modulus: &BigInt) -> BigInt {
-    if lv.is_zero() || rv.is_zero() {
-        return BigInt::zero();
-    }
-
-    let mut r = modulus.clone();
-    let mut new_r = rv.clone();
-    if r.is_negative() {
-        r += modulus;
-    }
-    if new_r.is_negative() {
-        new_r += modulus;
-    }
-
-    let (_, _, mut rv_inv) = extended_euclidean(r, new_r);
-    rv_inv %= modulus;
-    if rv_inv.is_negative() {
-        rv_inv += modulus;
-    }
-
-    let mut result = (lv * rv_inv) % modulus;
-    if result.is_negative() {
-        result += modulus;
-    }
-    result
+    with_field_backend(modulus, |field| field.moddiv(lv, rv))
 }
 
 /// Returns Some(x) such that x² ≡ n (mod p), or None if no solution exists.
 /// Assumes that `p` is an odd prime.
+///
+/// The constants that only depend on `p` are found once per thread, see `FieldBackend::sqrt`.
 /// # Examples
 /// ```
 /// use num_bigint_dig::BigInt;
@@ -87,93 +59,24 @@ pub fn moddiv(lv: &BigInt, rv: &BigInt, modulus: &BigInt) -> BigInt {
 /// assert_eq!(n_square, answer);
 /// ```
 pub fn tonelli_shanks(n_original: &BigInt, p: &BigInt) -> Option<BigInt> {
-    let one = BigInt::one();
-    let two = BigInt::from(2u32);
-
-    let n = if n_original.is_negative() {
-        n_original + p
-    } else {
-        n_original.clone()
-    };
-
-    // Handle trivial cases.
-    if n.is_zero() {
-        return Some(BigInt::zero());
-    }
-    if p == &two {
-        return Some(n % p);
-    }
-
-    // Check if n is a quadratic residue mod p using Euler's criterion:
-    // n^((p-1)/2) mod p should be 1.
-    let exp = (p - &one) >> 1; // (p - 1) / 2
-    if n.modpow(&exp, p) != one {
-        return None;
-    }
-
-    // Factor p - 1 as q * 2^s with q odd.
-    let mut q = p - &one;
-    let mut s = 0;
-    while (&q & &one) == BigInt::zero() {
-        q >>= 1;
-        s += 1;
-    }
-
-    // Find a quadratic non-residue z modulo p.
-    let mut z = BigInt::from(2u32);
-    while z.modpow(&exp, p) == one {
-        z += &one;
-    }
-
-    let mut m = s;
-    let mut c = z.modpow(&q, p);
-    let mut t = n.modpow(&q, p);
-    let mut r = n.modpow(&((&q + &one) >> 1), p);
-
-    // Main loop: repeat until t ≡ 1 (mod p).
-    while t != one {
-        // Find the smallest i (0 < i < m) such that t^(2^i) ≡ 1 mod p.
-        let mut i = 0;
-        let mut temp = t.clone();
-        while temp != one {
-            temp = temp.modpow(&two, p);
-            i += 1;
-            if i == m {
-                return None; // Should not happen if n is a residue.
-            }
-        }
-
-        // Compute b = c^(2^(m-i-1)) mod p.
-        let exponent = BigInt::from(1u32) << (m - i - 1);
-        let b = c.modpow(&exponent, p);
-
-        m = i;
-        c = b.modpow(&two, p);
-        t = (t * &c) % p;
-        r = (r * b) % p;
-    }
-
-    Some(r)
+    with_field_backend(p, |field| field.sqrt(n_original))
 }
 
+/// Returns a root of `coeffs[0] + coeffs[1] * x + coeffs[2] * x^2` modulo `modulus`, or
+/// `None` if the polynomial is constant or has no root.
 pub fn solve_quadratic_modulus_equation(coeffs: &[BigInt; 3], modulus: &BigInt) -> Option<BigInt> {
-    if coeffs[2].is_zero() && coeffs[1].is_zero() {
-        None
-    } else if coeffs[2].is_zero() {
-        Some(moddiv(&-&coeffs[0], &coeffs[1], modulus))
-    } else {
-        let d = (&coeffs[1] * &coeffs[1] - BigInt::from(4) * &coeffs[2] * &coeffs[0]) % modulus;
-        let root_d = tonelli_shanks(&d, modulus);
-        if let Some(r) = root_d {
-            Some(moddiv(
-                &(-&coeffs[1] + r),
-                &(BigInt::from(2) * &coeffs[2]),
-                modulus,
-            ))
-        } else {
-            None
-        }
-    }
+    solve_quadratic_modulus_equations(slice::from_ref(coeffs), modulus)
+        .pop()
+        .unwrap()
+}
+
+/// Solves each polynomial of `coefficients` like `solve_quadratic_modulus_equation`, sharing a
+/// single modular inversion among all of them.
+pub fn solve_quadratic_modulus_equations(
+    coefficients: &[[BigInt; 3]],
+    modulus: &BigInt,
+) -> Vec<Option<BigInt>> {
+    with_field_backend(modulus, |field| field.solve_quadratics(coefficients))
 }
 
 /// Generates all combinations of indices for a given set of dimensions.
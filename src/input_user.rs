@@ -46,8 +46,15 @@ pub struct Input {
     pub debug_prime: String,
     pub heuristics_range: String,
     pub search_mode: String,
+    pub search_start: String,
+    pub search_end: String,
+    pub num_threads: String,
     pub path_to_mutation_setting: String,
     pub path_to_whitelist: String,
+    pub path_to_cache_dir: String,
+    pub path_to_batch_manifest: String,
+    pub path_to_metrics: String,
+    pub witness_oracle: String,
 }
 
 /*
@@ -133,8 +140,15 @@ impl Input {
             debug_prime: input_processing::get_debug_prime(&matches)?,
             heuristics_range: input_processing::get_heuristics_range(&matches)?,
             search_mode: input_processing::get_search_mode(&matches)?,
+            search_start: input_processing::get_search_start(&matches)?,
+            search_end: input_processing::get_search_end(&matches)?,
+            num_threads: input_processing::get_num_threads(&matches)?,
             path_to_mutation_setting: input_processing::get_path_to_mutation_setting(&matches)?,
             path_to_whitelist: input_processing::get_path_to_whitelist(&matches)?,
+            path_to_cache_dir: input_processing::get_path_to_cache_dir(&matches)?,
+            path_to_batch_manifest: input_processing::get_path_to_batch_manifest(&matches)?,
+            path_to_metrics: input_processing::get_path_to_metrics(&matches)?,
+            witness_oracle: input_processing::get_witness_oracle(&matches)?,
             link_libraries
         })
     }
@@ -262,12 +276,33 @@ impl Input {
     pub fn search_mode(&self) -> String{
         self.search_mode.clone()
     }
+    pub fn search_start(&self) -> String{
+        self.search_start.clone()
+    }
+    pub fn search_end(&self) -> String{
+        self.search_end.clone()
+    }
+    pub fn num_threads(&self) -> String{
+        self.num_threads.clone()
+    }
     pub fn path_to_mutation_setting(&self) -> String{
         self.path_to_mutation_setting.clone()
     }
     pub fn path_to_whitelist(&self) -> String{
         self.path_to_whitelist.clone()
     }
+    pub fn path_to_cache_dir(&self) -> String{
+        self.path_to_cache_dir.clone()
+    }
+    pub fn path_to_batch_manifest(&self) -> String{
+        self.path_to_batch_manifest.clone()
+    }
+    pub fn path_to_metrics(&self) -> String{
+        self.path_to_metrics.clone()
+    }
+    pub fn witness_oracle(&self) -> String{
+        self.witness_oracle.clone()
+    }
 }
 mod input_processing {
     use ansi_term::Colour;
@@ -277,7 +312,8 @@ mod input_processing {
 
     pub fn get_input(matches: &ArgMatches) -> Result<PathBuf, ()> {
         let route = Path::new(matches.value_of("input").unwrap()).to_path_buf();
-        if route.is_file() {
+        // In batch mode, the circuits are listed in the manifest instead.
+        if route.is_file() || matches.value_of("path_to_batch_manifest") != Some("none") {
             Result::Ok(route)
         } else {
             let route = if route.to_str().is_some() { ": ".to_owned() + route.to_str().unwrap()} else { "".to_owned() };
@@ -451,6 +487,27 @@ mod input_processing {
         }
     }
 
+    pub fn get_search_start(matches: &ArgMatches) -> Result<String, ()> {
+        match matches.is_present("search_start") {
+            true => Ok(String::from(matches.value_of("search_start").unwrap())),
+            false => Ok(String::from("0"))
+        }
+    }
+
+    pub fn get_search_end(matches: &ArgMatches) -> Result<String, ()> {
+        match matches.is_present("search_end") {
+            true => Ok(String::from(matches.value_of("search_end").unwrap())),
+            false => Ok(String::from("none"))
+        }
+    }
+
+    pub fn get_num_threads(matches: &ArgMatches) -> Result<String, ()> {
+        match matches.is_present("num_threads") {
+            true => Ok(String::from(matches.value_of("num_threads").unwrap())),
+            false => Ok(String::from("0"))
+        }
+    }
+
     pub fn get_path_to_mutation_setting(matches: &ArgMatches) -> Result<String, ()> {
         match matches.is_present("path_to_mutation_setting") {
             true => Ok(String::from(matches.value_of("path_to_mutation_setting").unwrap())),
@@ -465,6 +522,34 @@ mod input_processing {
         }
     }
 
+    pub fn get_path_to_cache_dir(matches: &ArgMatches) -> Result<String, ()> {
+        match matches.is_present("path_to_cache_dir") {
+            true => Ok(String::from(matches.value_of("path_to_cache_dir").unwrap())),
+            false => Ok(String::from("none"))
+        }
+    }
+
+    pub fn get_path_to_batch_manifest(matches: &ArgMatches) -> Result<String, ()> {
+        match matches.is_present("path_to_batch_manifest") {
+            true => Ok(String::from(matches.value_of("path_to_batch_manifest").unwrap())),
+            false => Ok(String::from("none"))
+        }
+    }
+
+    pub fn get_path_to_metrics(matches: &ArgMatches) -> Result<String, ()> {
+        match matches.is_present("path_to_metrics") {
+            true => Ok(String::from(matches.value_of("path_to_metrics").unwrap())),
+            false => Ok(String::from("none"))
+        }
+    }
+
+    pub fn get_witness_oracle(matches: &ArgMatches) -> Result<String, ()> {
+        match matches.is_present("witness_oracle") {
+            true => Ok(String::from(matches.value_of("witness_oracle").unwrap())),
+            false => Ok(String::from("none"))
+        }
+    }
+
     pub fn view() -> ArgMatches<'static> {
         App::new("ZKP Circuit Fuzzer")
             .version(VERSION)
@@ -625,6 +710,30 @@ mod input_processing {
                     .display_order(330)
                     .help("(zkFuzz) Heuristics range for zkFuzz"),
             )
+            .arg (
+                Arg::with_name("search_start")
+                    .long("search_start")
+                    .takes_value(true)
+                    .default_value("0")
+                    .display_order(331)
+                    .help("(zkFuzz) First index of the assignments enumerated by the quick, full and heuristics search modes"),
+            )
+            .arg (
+                Arg::with_name("search_end")
+                    .long("search_end")
+                    .takes_value(true)
+                    .default_value("none")
+                    .display_order(332)
+                    .help("(zkFuzz) End (exclusive) of the indices of the assignments enumerated by the quick, full and heuristics search modes"),
+            )
+            .arg (
+                Arg::with_name("num_threads")
+                    .long("num_threads")
+                    .takes_value(true)
+                    .default_value("0")
+                    .display_order(333)
+                    .help("(zkFuzz) Number of worker threads for the quick, full and heuristics search modes (0 uses all cores)"),
+            )
             .arg (
                 Arg::with_name("path_to_mutation_setting")
                     .long("path_to_mutation_setting")
@@ -641,6 +750,38 @@ mod input_processing {
                     .display_order(350)
                     .help("(zkFuzz) Path to the white-lists file"),
             )
+            .arg (
+                Arg::with_name("path_to_cache_dir")
+                    .long("path_to_cache_dir")
+                    .takes_value(true)
+                    .default_value("none")
+                    .display_order(351)
+                    .help("(zkFuzz) Directory in which the symbolic trace of the main template is cached across runs"),
+            )
+            .arg (
+                Arg::with_name("path_to_batch_manifest")
+                    .long("path_to_batch_manifest")
+                    .takes_value(true)
+                    .default_value("none")
+                    .display_order(352)
+                    .help("(zkFuzz) Path to a manifest of the circuits to fuzz in batch mode, which replaces <input>"),
+            )
+            .arg (
+                Arg::with_name("path_to_metrics")
+                    .long("path_to_metrics")
+                    .takes_value(true)
+                    .default_value("none")
+                    .display_order(353)
+                    .help("(zkFuzz) Path to which the metrics of the run are exported, as JSON lines or, with the .prom extension, in the Prometheus text format"),
+            )
+            .arg (
+                Arg::with_name("witness_oracle")
+                    .long("witness_oracle")
+                    .takes_value(true)
+                    .default_value("none")
+                    .display_order(354)
+                    .help("(zkFuzz) Command of a witness calculator that runs the original program in the brute-force search modes (quick, full, heuristics; ignored by the genetic search), e.g., node script/witness_oracle.js <wasm> <sym>"),
+            )
             .arg(
                 Arg::with_name("lessthan_dissabled")
                     .long("lessthan_dissabled")
@@ -1,4 +1,5 @@
 pub mod executor;
+pub mod metrics;
 pub mod mutator;
 
 pub mod input_user;
@@ -1,4 +1,6 @@
+mod batch;
 mod executor;
+mod metrics;
 mod mutator;
 mod stats;
 
@@ -26,24 +28,31 @@ use serde_json::json;
 use program_structure::ast::Expression;
 use program_structure::program_archive::ProgramArchive;
 
+use executor::call_graph::collect_reachable_callables;
+use executor::field::with_field_backend;
 use executor::symbolic_execution::SymbolicExecutor;
 use executor::symbolic_setting::{
     get_default_setting_for_concrete_execution, get_default_setting_for_symbolic_execution,
 };
+use executor::symbolic_state::{freeze_symbolic_trace, SymbolicConstraints, SymbolicTrace};
 use executor::symbolic_value::{OwnerName, SymbolicLibrary};
+use executor::trace_cache::{cache_path, compute_cache_key, load_cached_trace, save_cached_trace};
 
-use mutator::mutation_config::load_config_from_json;
+use metrics::{Counter, Phase};
+
+use mutator::mutation_config::{load_config_from_json, MutationConfig};
 use mutator::mutation_test_crossover_fn::random_crossover;
 use mutator::mutation_test_evolution_fn::simple_evolution;
 use mutator::mutation_test_trace_fitness_fn::evaluate_trace_fitness_by_error;
 use mutator::mutation_test_trace_initialization_fn::{
-    initialize_population_with_constant_replacement,
+    initialize_population_with_any_family, initialize_population_with_constant_replacement,
     initialize_population_with_operator_or_const_replacement,
     initialize_population_with_operator_or_const_replacement_or_addition,
     initialize_population_with_operator_or_const_replacement_or_deletion,
 };
 use mutator::mutation_test_trace_mutation_fn::{
-    mutate_trace_with_constant_replacement, mutate_trace_with_operator_or_const_replacement,
+    mutate_trace_with_any_family, mutate_trace_with_constant_replacement,
+    mutate_trace_with_operator_or_const_replacement,
     mutate_trace_with_operator_or_const_replacement_or_addition,
     mutate_trace_with_operator_or_const_replacement_or_deletion,
 };
@@ -53,8 +62,12 @@ use mutator::mutation_test_update_input_fn::{
     update_input_population_with_random_sampling,
 };
 use mutator::{
-    brute_force::brute_force_search, mutation_test::mutation_test_search,
-    unused_outputs::check_unused_outputs, utils::BaseVerificationConfig,
+    brute_force::brute_force_search,
+    mutation_test::mutation_test_search,
+    slicing::{search_slices, slice_by_cone_of_influence},
+    trace_optimizer::{optimize_trace, restore_failure_position},
+    unused_outputs::check_unused_outputs,
+    utils::{BaseVerificationConfig, CounterExample},
 };
 
 use stats::ast_stats::ASTStats;
@@ -110,23 +123,258 @@ fn show_stats(program_archive: &ProgramArchive) {
     }
 }
 
-fn start() -> Result<(), ()> {
-    let start_time = time::Instant::now();
-    //use compilation_user::CompilerConfig;
-
-    let user_input = Input::new()?;
-    let mut program_archive = parser_user::parse_project(&user_input)?;
-    type_analysis_user::analyse_project(&mut program_archive)?;
-
-    if user_input.show_stats_of_ast {
-        show_stats(&program_archive);
-        return Result::Ok(());
+/// Builds the verification settings of the search for a counterexample of the main component,
+/// an instance of the template `target_template_name`.
+fn build_verification_config(
+    user_input: &Input,
+    search_mode: &str,
+    target_template_name: &str,
+    template_param_names: Vec<String>,
+    template_param_values: Vec<Expression>,
+) -> BaseVerificationConfig {
+    BaseVerificationConfig {
+        target_template_name: target_template_name.to_string(),
+        prime: BigInt::from_str(&user_input.debug_prime()).unwrap(),
+        range: BigInt::from_str(&user_input.heuristics_range()).unwrap(),
+        quick_mode: search_mode == "quick",
+        heuristics_mode: search_mode == "heuristics",
+        progress_interval: 10000,
+        num_threads: user_input.num_threads().parse().unwrap(),
+        search_start: BigInt::from_str(&user_input.search_start()).unwrap(),
+        search_end: match &*user_input.search_end() {
+            "none" => None,
+            search_end => Some(BigInt::from_str(search_end).unwrap()),
+        },
+        witness_oracle: match &*user_input.witness_oracle() {
+            "none" => None,
+            command => Some(command.to_string()),
+        },
+        template_param_names: template_param_names,
+        template_param_values: template_param_values,
     }
+}
 
-    env_logger::init();
+/// Searches for a counterexample of the symbolic trace of the main template with `search_mode`.
+///
+/// # Parameters
+/// - `symbolic_library`: The library of the templates and functions of the circuit.
+/// - `symbolic_trace`: The symbolic trace of the main template.
+/// - `side_constraints`: The side constraints of the main template.
+/// - `verification_base_config`: The verification settings, including the template parameters.
+/// - `constraint_assert_dissabled`: Whether asserts are ignored by the concrete execution.
+/// - `search_mode`: One of `quick`, `full`, `heuristics`, and `ga`.
+/// - `load_mutation_config`: Loads the mutation configuration, which is only needed by `ga`.
+///
+/// # Returns
+/// The counterexample, if any, and the auxiliary results of the search saved along with it.
+fn search_counter_example<LoadMutationConfigFn>(
+    symbolic_library: &mut SymbolicLibrary,
+    symbolic_trace: &SymbolicTrace,
+    side_constraints: &SymbolicConstraints,
+    verification_base_config: &BaseVerificationConfig,
+    constraint_assert_dissabled: bool,
+    search_mode: &str,
+    load_mutation_config: LoadMutationConfigFn,
+) -> (Option<CounterExample>, serde_json::Value)
+where
+    LoadMutationConfigFn: FnOnce() -> MutationConfig,
+{
+    let optimized_trace = optimize_trace(
+        &verification_base_config.prime,
+        symbolic_trace,
+        side_constraints,
+        &symbolic_library.template_library
+            [&symbolic_library.name2id[&verification_base_config.target_template_name]]
+            .output_ids,
+    );
+    info!(
+        "🧹 Optimized the trace: {} → {} trace constraints, {} → {} side constraints",
+        symbolic_trace.len(),
+        optimized_trace.symbolic_trace.len(),
+        side_constraints.len(),
+        optimized_trace.side_constraints.len()
+    );
+    let original_trace = symbolic_trace;
+    let symbolic_trace = &optimized_trace.symbolic_trace;
+    let side_constraints = &optimized_trace.side_constraints;
 
+    let subse_base_config = get_default_setting_for_concrete_execution(
+        verification_base_config.prime.clone(),
+        constraint_assert_dissabled,
+    );
+    let mut conc_executor = SymbolicExecutor::new(symbolic_library, &subse_base_config);
+    conc_executor.feed_arguments(
+        &verification_base_config.template_param_names,
+        &verification_base_config.template_param_values,
+    );
+    let mut auxiliary_result = json!({});
+
+    let counter_example = match search_mode {
+        "quick" => brute_force_search(
+            &mut conc_executor,
+            symbolic_trace,
+            side_constraints,
+            verification_base_config,
+        ),
+        "full" => brute_force_search(
+            &mut conc_executor,
+            symbolic_trace,
+            side_constraints,
+            verification_base_config,
+        ),
+        "heuristics" => brute_force_search(
+            &mut conc_executor,
+            symbolic_trace,
+            side_constraints,
+            verification_base_config,
+        ),
+        "ga" => {
+            let mutation_config = load_mutation_config();
+            info!("\n{}", mutation_config);
+
+            let trace_initialization_fn = match mutation_config.trace_mutation_method.as_str() {
+                "naive" => initialize_population_with_constant_replacement,
+                "constant" => initialize_population_with_constant_replacement,
+                "constant_operator" => initialize_population_with_operator_or_const_replacement,
+                "constant_operator_add" => initialize_population_with_operator_or_const_replacement_or_addition,
+                "constant_operator_delete" => initialize_population_with_operator_or_const_replacement_or_deletion,
+                "adaptive" => initialize_population_with_any_family,
+                _ => panic!("`trace_mutation_method` should be one of [`constant`, `constant_operator`, `constant_operator_add`, `constant_operator_delete`, `adaptive`]")
+            };
+
+            let trace_mutation_fn = match mutation_config.trace_mutation_method.as_str() {
+                "naive" => mutate_trace_with_constant_replacement,
+                "constant" => mutate_trace_with_constant_replacement,
+                "constant_operator" => mutate_trace_with_operator_or_const_replacement,
+                "constant_operator_add" => mutate_trace_with_operator_or_const_replacement_or_addition,
+                "constant_operator_delete" => mutate_trace_with_operator_or_const_replacement_or_deletion,
+                "adaptive" => mutate_trace_with_any_family,
+                _ => panic!("`trace_mutation_method` should be one of [`constant`, `constant_operator`, `constant_operator_add`, `constant_operator_delete`, `adaptive`]")
+            };
+
+            let update_input_fn = match mutation_config
+                .input_initialization_method
+                .as_str()
+            {
+                "random" => update_input_population_with_random_sampling,
+                "fitness" => update_input_population_with_fitness_score,
+                "coverage" => update_input_population_with_coverage_maximization,
+                _ => panic!("`input_initialization_method` should be one of [`random`, `fitness`, `coverage`]")
+            };
+
+            let search = |library: &mut SymbolicLibrary,
+                          trace: &SymbolicTrace,
+                          constraints: &SymbolicConstraints,
+                          config: &MutationConfig| {
+                let mut sexe = SymbolicExecutor::new(library, &subse_base_config);
+                sexe.feed_arguments(
+                    &verification_base_config.template_param_names,
+                    &verification_base_config.template_param_values,
+                );
+                mutation_test_search(
+                    &mut sexe,
+                    trace,
+                    constraints,
+                    verification_base_config,
+                    config,
+                    trace_initialization_fn,
+                    update_input_fn,
+                    evaluate_trace_fitness_by_error,
+                    simple_evolution,
+                    trace_mutation_fn,
+                    random_crossover,
+                    roulette_selection,
+                )
+            };
+
+            let slices = if mutation_config.slice_independent_subcircuits {
+                slice_by_cone_of_influence(symbolic_trace, side_constraints)
+            } else {
+                Vec::new()
+            };
+            let (slice_id, mut result) = if slices.len() > 1 {
+                info!(
+                    "✂️ Sliced the trace into {} independent slices",
+                    slices.len()
+                );
+                let results = search_slices(
+                    &*conc_executor.symbolic_library,
+                    &slices,
+                    &mutation_config,
+                    |library, slice, config| {
+                        search(
+                            library,
+                            &slice.symbolic_trace,
+                            &slice.side_constraints,
+                            config,
+                        )
+                    },
+                );
+                auxiliary_result["mutation_test_slices"] = json!(slices
+                    .iter()
+                    .zip(&results)
+                    .map(|(slice, result)| json!({
+                        "num_trace_constraints": slice.symbolic_trace.len(),
+                        "num_side_constraints": slice.side_constraints.len(),
+                        "generation": result.as_ref().map(|result| result.generation),
+                    }))
+                    .collect::<Vec<_>>());
+                // Report the first slice with a counterexample, if any.
+                let (slice_id, result) = results
+                    .into_iter()
+                    .enumerate()
+                    .filter_map(|(slice_id, result)| result.map(|result| (slice_id, result)))
+                    .reduce(|found, searched| {
+                        if found.1.counter_example.is_none() && searched.1.counter_example.is_some()
+                        {
+                            searched
+                        } else {
+                            found
+                        }
+                    })
+                    .unwrap();
+                (Some(slice_id), result)
+            } else {
+                let result = search(
+                    &mut *conc_executor.symbolic_library,
+                    symbolic_trace,
+                    side_constraints,
+                    &mutation_config,
+                );
+                (None, result)
+            };
+
+            // Failure positions point at the original trace in reports.
+            if let Some(counter_example) = &mut result.counter_example {
+                let positions: Vec<usize> = match slice_id {
+                    Some(slice_id) => slices[slice_id]
+                        .positions
+                        .iter()
+                        .map(|pos| optimized_trace.positions[*pos])
+                        .collect(),
+                    None => optimized_trace.positions.clone(),
+                };
+                restore_failure_position(
+                    counter_example,
+                    &positions,
+                    original_trace,
+                    &conc_executor.symbolic_library.id2name,
+                );
+            }
+            auxiliary_result["mutation_test_config"] =
+                serde_json::to_value(result.mutation_config).expect("Failed to serialize to JSON");
+            auxiliary_result["mutation_test_log"] = json!({"random_seed":result.random_seed,"generation":result.generation, "fitness_score_log":result.fitness_score_log, "operator_credits":result.operator_credits});
+            result.counter_example
+        }
+        _ => panic!("search_mode={} is not supported", search_mode),
+    };
+    (counter_example, auxiliary_result)
+}
+
+/// Loads the whitelist of templates given by `--path_to_whitelist`.
+fn load_whitelist(user_input: &Input) -> FxHashSet<String> {
     eprintln!("{}", "🧾 Loading Whitelists...".green());
-    let whitelist = if user_input.path_to_whitelist() == "none" {
+    if user_input.path_to_whitelist() == "none" {
         FxHashSet::from_iter(["IsZero".to_string(), "Num2Bits".to_string()])
     } else {
         FxHashSet::from_iter(
@@ -134,31 +382,42 @@ fn start() -> Result<(), ()> {
                 .unwrap()
                 .into_iter(),
         )
-    };
+    }
+}
 
+/// Registers the templates and the functions of `program_archive` that are reachable from the
+/// templates `root_templates` in a new symbolic library.
+fn build_symbolic_library(
+    program_archive: &ProgramArchive,
+    root_templates: &[String],
+    whitelist: &FxHashSet<String>,
+    user_input: &Input,
+) -> SymbolicLibrary {
+    let _timer = metrics::time(Phase::Registration);
     let mut symbolic_library = SymbolicLibrary {
         template_library: FxHashMap::default(),
         name2id: FxHashMap::default(),
         id2name: FxHashMap::default(),
         function_library: FxHashMap::default(),
         function_counter: FxHashMap::default(),
+        component_summaries: FxHashMap::default(),
+    };
+
+    // The arguments of the main component may call functions too.
+    let root_args = match &program_archive.initial_template_call {
+        Expression::Call { args, .. } => args.clone(),
+        _ => Vec::new(),
     };
+    let reachable = collect_reachable_callables(program_archive, root_templates, &root_args);
 
     eprintln!("{}", "🧩 Parsing Templates...".green());
-    let mut templates_names = program_archive
-        .templates
-        .keys()
-        .cloned()
-        .collect::<Vec<_>>();
-    templates_names.sort();
-    for k in templates_names {
+    for k in reachable.templates {
         let v = program_archive.templates.get(&k).unwrap();
-        let body = v.get_body().clone();
         symbolic_library.register_template(
             k.clone(),
-            &body.clone(),
+            v.get_body(),
             v.get_name_of_params(),
-            &whitelist,
+            whitelist,
             user_input.lessthan_dissabled_flag,
         );
 
@@ -180,16 +439,9 @@ fn start() -> Result<(), ()> {
     }
 
     eprintln!("{}", "⚙️ Parsing Function...".green());
-    let mut function_names = program_archive
-        .functions
-        .keys()
-        .cloned()
-        .collect::<Vec<_>>();
-    function_names.sort();
-    for k in function_names {
+    for k in reachable.functions {
         let v = program_archive.functions.get(&k).unwrap();
-        let body = v.get_body().clone();
-        symbolic_library.register_function(k.clone(), body.clone(), v.get_name_of_params());
+        symbolic_library.register_function(k.clone(), v.get_body().clone(), v.get_name_of_params());
 
         if user_input.flag_printout_ast {
             eprintln!(
@@ -208,6 +460,83 @@ fn start() -> Result<(), ()> {
         }
     }
 
+    symbolic_library
+}
+
+/// Prepares `sym_executor` for the execution of the main component, an instance of the
+/// template `id` with the arguments `args`.
+fn prepare_main_template(
+    sym_executor: &mut SymbolicExecutor,
+    id: &str,
+    param_names: &Vec<String>,
+    args: &Vec<Expression>,
+    symbolic_template_params: bool,
+) {
+    sym_executor.symbolic_library.name2id.insert(
+        "main".to_string(),
+        sym_executor.symbolic_library.name2id.len(),
+    );
+    sym_executor.symbolic_library.id2name.insert(
+        sym_executor.symbolic_library.name2id["main"],
+        "main".to_string(),
+    );
+
+    sym_executor.cur_state.add_owner(&OwnerName {
+        id: sym_executor.symbolic_library.name2id["main"],
+        counter: 0,
+        access: None,
+    });
+    sym_executor
+        .cur_state
+        .set_template_id(sym_executor.symbolic_library.name2id[id]);
+
+    if !symbolic_template_params {
+        sym_executor.feed_arguments(param_names, args);
+    }
+}
+
+fn start() -> Result<(), ()> {
+    let start_time = time::Instant::now();
+    //use compilation_user::CompilerConfig;
+
+    let mut user_input = Input::new()?;
+    if user_input.path_to_metrics() != "none" {
+        if let Err(e) = metrics::enable(&user_input.path_to_metrics()) {
+            eprintln!("{} {}", "Cannot create the metrics file:".red(), e);
+            return Err(());
+        }
+    }
+    if user_input.path_to_batch_manifest() != "none" {
+        env_logger::init();
+        let result = batch::run_batch(&mut user_input);
+        metrics::finish();
+        return result;
+    }
+
+    let mut program_archive = {
+        let _timer = metrics::time(Phase::Parsing);
+        parser_user::parse_project(&user_input)?
+    };
+    {
+        let _timer = metrics::time(Phase::TypeAnalysis);
+        type_analysis_user::analyse_project(&mut program_archive)?;
+    }
+
+    if user_input.show_stats_of_ast {
+        show_stats(&program_archive);
+        return Result::Ok(());
+    }
+
+    env_logger::init();
+
+    let whitelist = load_whitelist(&user_input);
+    let main_template = match &program_archive.initial_template_call {
+        Expression::Call { id, .. } => id.clone(),
+        _ => unimplemented!(),
+    };
+    let mut symbolic_library =
+        build_symbolic_library(&program_archive, &[main_template], &whitelist, &user_input);
+
     let base_config = get_default_setting_for_symbolic_execution(
         BigInt::from_str(&user_input.debug_prime()).unwrap(),
         user_input.constraint_assert_dissabled_flag(),
@@ -220,33 +549,88 @@ fn start() -> Result<(), ()> {
 
             eprintln!("{}", "🛒 Gathering Trace/Side Constraints...".green());
 
-            sym_executor.symbolic_library.name2id.insert(
-                "main".to_string(),
-                sym_executor.symbolic_library.name2id.len(),
-            );
-            sym_executor.symbolic_library.id2name.insert(
-                sym_executor.symbolic_library.name2id["main"],
-                "main".to_string(),
+            prepare_main_template(
+                &mut sym_executor,
+                id,
+                template.get_name_of_params(),
+                args,
+                user_input.flag_symbolic_template_params,
             );
 
-            sym_executor.cur_state.add_owner(&OwnerName {
-                id: sym_executor.symbolic_library.name2id["main"],
-                counter: 0,
-                access: None,
-            });
-            sym_executor
-                .cur_state
-                .set_template_id(sym_executor.symbolic_library.name2id[id]);
-
-            if !user_input.flag_symbolic_template_params {
-                sym_executor.feed_arguments(template.get_name_of_params(), args);
-            }
+            let trace_cache_entry = if user_input.path_to_cache_dir() == "none" {
+                None
+            } else {
+                let mut whitelist_entries = whitelist.iter().cloned().collect::<Vec<_>>();
+                whitelist_entries.sort();
+                let mut settings = vec![
+                    user_input.debug_prime(),
+                    user_input.constraint_assert_dissabled_flag().to_string(),
+                    user_input.lessthan_dissabled_flag.to_string(),
+                    user_input.flag_symbolic_template_params.to_string(),
+                ];
+                settings.append(&mut whitelist_entries);
+                match compute_cache_key(
+                    &user_input.input_program,
+                    user_input.get_link_libraries(),
+                    &settings,
+                ) {
+                    Ok(key) => Some((
+                        cache_path(Path::new(&user_input.path_to_cache_dir()), &key),
+                        key,
+                    )),
+                    Err(e) => {
+                        warn!("Cannot compute the key of the trace cache: {}", e);
+                        None
+                    }
+                }
+            };
+            let cached_trace = trace_cache_entry
+                .as_ref()
+                .filter(|(path, _)| path.exists())
+                .and_then(|(path, key)| match load_cached_trace(path) {
+                    // The hash only names the entry, so the inputs are compared as well, and
+                    // the trace refers to names by id, which must not have changed.
+                    Ok(cached)
+                        if cached.key_inputs == key.inputs
+                            && cached.name2id == sym_executor.symbolic_library.name2id =>
+                    {
+                        Some(cached)
+                    }
+                    Ok(_) => None,
+                    Err(e) => {
+                        warn!("Cannot load the trace cache {:?}: {}", path, e);
+                        None
+                    }
+                });
+
+            if let Some(cached) = cached_trace {
+                eprintln!("{}", "📦 Loaded Trace/Side Constraints from Cache".green());
+                metrics::add(Counter::TraceCacheHits, 1);
+                sym_executor.cur_state.symbol_binding_map = cached.symbol_binding_map;
+                sym_executor.cur_state.symbolic_trace = cached.symbolic_trace;
+                sym_executor.cur_state.side_constraints = cached.side_constraints;
+            } else {
+                let body = sym_executor.symbolic_library.template_library
+                    [&sym_executor.symbolic_library.name2id[id]]
+                    .body
+                    .clone();
+                {
+                    let _timer = metrics::time(Phase::SymbolicExecution);
+                    sym_executor.execute(&body, 0);
+                }
 
-            let body = sym_executor.symbolic_library.template_library
-                [&sym_executor.symbolic_library.name2id[id]]
-                .body
-                .clone();
-            sym_executor.execute(&body, 0);
+                if let Some((path, key)) = &trace_cache_entry {
+                    metrics::add(Counter::TraceCacheMisses, 1);
+                    if let Err(e) = save_cached_trace(
+                        path,
+                        key,
+                        &sym_executor.symbolic_library.name2id,
+                        &sym_executor.cur_state,
+                    ) {
+                        warn!("Cannot save the trace cache {:?}: {}", path, e);
+                    }
+                }
+            }
 
             eprintln!("{}", "══════════════════════════════════".green());
             let mut ts = ConstraintStatistics::new();
@@ -278,118 +662,41 @@ fn start() -> Result<(), ()> {
                         _ => unimplemented!(),
                     };
 
-                let verification_base_config = BaseVerificationConfig {
-                    target_template_name: main_template_name.to_string(),
-                    prime: BigInt::from_str(&user_input.debug_prime()).unwrap(),
-                    range: BigInt::from_str(&user_input.heuristics_range()).unwrap(),
-                    quick_mode: &*user_input.search_mode == "quick",
-                    heuristics_mode: &*user_input.search_mode == "heuristics",
-                    progress_interval: 10000,
-                    template_param_names: template_param_names,
-                    template_param_values: template_param_values,
-                };
+                let verification_base_config = build_verification_config(
+                    &user_input,
+                    &user_input.search_mode(),
+                    main_template_name,
+                    template_param_names,
+                    template_param_values,
+                );
 
                 let mut new_base_config = base_config.clone();
                 new_base_config.off_trace = true;
                 sym_executor.setting = &new_base_config;
 
-                let mut counter_example =
-                    check_unused_outputs(&mut sym_executor, &verification_base_config);
+                let mut counter_example = {
+                    let _timer = metrics::time(Phase::UnusedOutputs);
+                    check_unused_outputs(&mut sym_executor, &verification_base_config)
+                };
                 let mut auxiliary_result = json!({});
                 if let Some(_) = &counter_example {
                     is_safe = false;
                 } else {
-                    let subse_base_config = get_default_setting_for_concrete_execution(
-                        BigInt::from_str(&user_input.debug_prime()).unwrap(),
-                        user_input.constraint_assert_dissabled_flag(),
-                    );
-                    let mut conc_executor = SymbolicExecutor::new(
+                    let symbolic_trace =
+                        freeze_symbolic_trace(sym_executor.cur_state.symbolic_trace.clone());
+                    let side_constraints =
+                        freeze_symbolic_trace(sym_executor.cur_state.side_constraints.clone());
+                    let (search_result, search_auxiliary_result) = search_counter_example(
                         &mut sym_executor.symbolic_library,
-                        &subse_base_config,
-                    );
-                    conc_executor.feed_arguments(
-                        &verification_base_config.template_param_names,
-                        &verification_base_config.template_param_values,
+                        &symbolic_trace,
+                        &side_constraints,
+                        &verification_base_config,
+                        user_input.constraint_assert_dissabled_flag(),
+                        &user_input.search_mode(),
+                        || load_config_from_json(&user_input.path_to_mutation_setting()).unwrap(),
                     );
-
-                    counter_example = match &*user_input.search_mode() {
-                        "quick" => brute_force_search(
-                            &mut conc_executor,
-                            &sym_executor.cur_state.symbolic_trace.clone(),
-                            &sym_executor.cur_state.side_constraints.clone(),
-                            &verification_base_config,
-                        ),
-                        "full" => brute_force_search(
-                            &mut conc_executor,
-                            &sym_executor.cur_state.symbolic_trace.clone(),
-                            &sym_executor.cur_state.side_constraints.clone(),
-                            &verification_base_config,
-                        ),
-                        "heuristics" => brute_force_search(
-                            &mut conc_executor,
-                            &sym_executor.cur_state.symbolic_trace.clone(),
-                            &sym_executor.cur_state.side_constraints.clone(),
-                            &verification_base_config,
-                        ),
-                        "ga" => {
-                            let mutation_config =
-                                load_config_from_json(&&user_input.path_to_mutation_setting())
-                                    .unwrap();
-                            info!("\n{}", mutation_config);
-
-                            let trace_initialization_fn = match mutation_config.trace_mutation_method.as_str() {
-                                "naive" => initialize_population_with_constant_replacement,
-                                "constant" => initialize_population_with_constant_replacement,
-                                "constant_operator" => initialize_population_with_operator_or_const_replacement,
-                                "constant_operator_add" => initialize_population_with_operator_or_const_replacement_or_addition,
-                                "constant_operator_delete" => initialize_population_with_operator_or_const_replacement_or_deletion,
-                                _ => panic!("`trace_mutation_method` should be one of [`constant`, `constant_operator`, `constant_operator_add`, `constant_operator_delete`]")
-                            };
-
-                            let trace_mutation_fn = match mutation_config.trace_mutation_method.as_str() {
-                                "naive" => mutate_trace_with_constant_replacement,
-                                "constant" => mutate_trace_with_constant_replacement,
-                                "constant_operator" => mutate_trace_with_operator_or_const_replacement,
-                                "constant_operator_add" => mutate_trace_with_operator_or_const_replacement_or_addition,
-                                "constant_operator_delete" => mutate_trace_with_operator_or_const_replacement_or_deletion,
-                                _ => panic!("`trace_mutation_method` should be one of [`constant`, `constant_operator`, `constant_operator_add`, `constant_operator_delete`]")
-                            };
-
-                            let update_input_fn = match mutation_config
-                                .input_initialization_method
-                                .as_str()
-                            {
-                                "random" => update_input_population_with_random_sampling,
-                                "fitness" => update_input_population_with_fitness_score,
-                                "coverage" => update_input_population_with_coverage_maximization,
-                                _ => panic!("`input_initialization_method` should be one of [`random`, `fitness`, `coverage`]")
-                            };
-
-                            let result = mutation_test_search(
-                                &mut conc_executor,
-                                &sym_executor.cur_state.symbolic_trace.clone(),
-                                &sym_executor.cur_state.side_constraints.clone(),
-                                &verification_base_config,
-                                &mutation_config,
-                                trace_initialization_fn,
-                                update_input_fn,
-                                evaluate_trace_fitness_by_error,
-                                simple_evolution,
-                                trace_mutation_fn,
-                                random_crossover,
-                                roulette_selection,
-                            );
-                            auxiliary_result["mutation_test_config"] =
-                                serde_json::to_value(result.mutation_config)
-                                    .expect("Failed to serialize to JSON");
-                            auxiliary_result["mutation_test_log"] = json!({"random_seed":result.random_seed,"generation":result.generation, "fitness_score_log":result.fitness_score_log});
-                            result.counter_example
-                        }
-                        _ => panic!(
-                            "search_mode={} is not supported",
-                            user_input.search_mode.to_string()
-                        ),
-                    };
+                    counter_example = search_result;
+                    auxiliary_result = search_auxiliary_result;
                 }
                 if let Some(ce) = &counter_example {
                     is_safe = false;
@@ -451,6 +758,10 @@ fn start() -> Result<(), ()> {
             );
             eprintln!("{}", "📊 Execution Summary:".cyan().bold());
             eprintln!(" ├─ Prime Number      : {}", user_input.debug_prime());
+            eprintln!(
+                " ├─ Field Backend     : {}",
+                with_field_backend(&base_config.prime, |field| field.name())
+            );
             eprintln!(
                 " ├─ Compression Rate  : {:.2}% ({}/{})",
                 (ss.total_constraints as f64 / ts.total_constraints as f64) * 100 as f64,
@@ -534,5 +845,6 @@ fn start() -> Result<(), ()> {
         }
     }
 
+    metrics::finish();
     Result::Ok(())
 }
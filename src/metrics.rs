@@ -0,0 +1,325 @@
+//! Instrumentation of a run: time spent per phase, event counters, and the state of the
+//! search at every generation.
+//!
+//! Metrics are disabled unless `--path_to_metrics` is given, in which case every probe costs
+//! a relaxed atomic load. When enabled, phases are timed with `time`, counters are bumped
+//! with `add`, and the accumulated values are exported at every generation and at the end of
+//! the run, either as JSON lines appended to the metrics file or, if its extension is
+//! `.prom`, as a snapshot in the Prometheus text format that replaces the file, e.g., for the
+//! textfile collector of the node exporter.
+
+use std::fs;
+use std::fs::File;
+use std::io;
+use std::io::{BufWriter, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::Mutex;
+use std::time::Instant;
+
+use log::warn;
+use num_bigint_dig::BigInt;
+use serde_json::{json, Map, Value};
+
+/// A phase of a run, whose wall-clock time is accumulated across its occurrences.
+#[derive(Clone, Copy)]
+pub enum Phase {
+    Parsing,
+    TypeAnalysis,
+    Registration,
+    SymbolicExecution,
+    UnusedOutputs,
+    InputUpdate,
+    Evolution,
+    ZeroDivision,
+    ConstraintSolving,
+    Evaluation,
+}
+
+const PHASES: [Phase; 10] = [
+    Phase::Parsing,
+    Phase::TypeAnalysis,
+    Phase::Registration,
+    Phase::SymbolicExecution,
+    Phase::UnusedOutputs,
+    Phase::InputUpdate,
+    Phase::Evolution,
+    Phase::ZeroDivision,
+    Phase::ConstraintSolving,
+    Phase::Evaluation,
+];
+
+/// The phases that emulate compiled traces, i.e., the coverage of the input update, the
+/// evaluation, and the mutated emulations of the constraint solving on a plateau.
+const EMULATION_PHASES: [Phase; 3] = [
+    Phase::InputUpdate,
+    Phase::Evaluation,
+    Phase::ConstraintSolving,
+];
+
+impl Phase {
+    fn name(self) -> &'static str {
+        match self {
+            Phase::Parsing => "parsing",
+            Phase::TypeAnalysis => "type_analysis",
+            Phase::Registration => "registration",
+            Phase::SymbolicExecution => "symbolic_execution",
+            Phase::UnusedOutputs => "unused_outputs",
+            Phase::InputUpdate => "input_update",
+            Phase::Evolution => "evolution",
+            Phase::ZeroDivision => "zero_division",
+            Phase::ConstraintSolving => "constraint_solving",
+            Phase::Evaluation => "evaluation",
+        }
+    }
+}
+
+/// A count of events of a run.
+#[derive(Clone, Copy)]
+pub enum Counter {
+    /// Emulations of a compiled trace on an input assignment.
+    Emulations,
+    /// Statements run by those emulations.
+    Statements,
+    /// Emulations of the original trace reused across generations, or redone.
+    OriginalEmulationHits,
+    OriginalEmulationMisses,
+    /// Roots of the zero-division pattern found in the cache, or solved.
+    ZeroDivisionCacheHits,
+    ZeroDivisionCacheMisses,
+    /// Symbolic executions of the main template skipped thanks to the trace cache, or run.
+    TraceCacheHits,
+    TraceCacheMisses,
+    /// Runs of the original program answered by the witness oracle, or by the concrete
+    /// executor.
+    OracleRuns,
+    ConcreteRuns,
+    /// Inputs and individuals solved from the most violated side constraint on a plateau.
+    PlateauSolutions,
+    Generations,
+}
+
+const COUNTERS: [Counter; 12] = [
+    Counter::Emulations,
+    Counter::Statements,
+    Counter::OriginalEmulationHits,
+    Counter::OriginalEmulationMisses,
+    Counter::ZeroDivisionCacheHits,
+    Counter::ZeroDivisionCacheMisses,
+    Counter::TraceCacheHits,
+    Counter::TraceCacheMisses,
+    Counter::OracleRuns,
+    Counter::ConcreteRuns,
+    Counter::PlateauSolutions,
+    Counter::Generations,
+];
+
+impl Counter {
+    fn name(self) -> &'static str {
+        match self {
+            Counter::Emulations => "emulations",
+            Counter::Statements => "statements",
+            Counter::OriginalEmulationHits => "original_emulation_hits",
+            Counter::OriginalEmulationMisses => "original_emulation_misses",
+            Counter::ZeroDivisionCacheHits => "zero_division_cache_hits",
+            Counter::ZeroDivisionCacheMisses => "zero_division_cache_misses",
+            Counter::TraceCacheHits => "trace_cache_hits",
+            Counter::TraceCacheMisses => "trace_cache_misses",
+            Counter::OracleRuns => "oracle_runs",
+            Counter::ConcreteRuns => "concrete_runs",
+            Counter::PlateauSolutions => "plateau_solutions",
+            Counter::Generations => "generations",
+        }
+    }
+}
+
+const ZERO: AtomicU64 = AtomicU64::new(0);
+
+static ENABLED: AtomicBool = AtomicBool::new(false);
+static PHASE_NANOS: [AtomicU64; PHASES.len()] = [ZERO; PHASES.len()];
+static COUNTS: [AtomicU64; COUNTERS.len()] = [ZERO; COUNTERS.len()];
+static SINK: Mutex<Option<Sink>> = Mutex::new(None);
+
+/// The destination of the exported metrics.
+struct Sink {
+    path: PathBuf,
+    /// The open metrics file for JSON lines, or `None` for Prometheus snapshots.
+    json_lines: Option<BufWriter<File>>,
+    start_time: Instant,
+}
+
+/// Enables the metrics, which are exported to `path`.
+pub fn enable(path: &str) -> io::Result<()> {
+    let path = PathBuf::from(path);
+    let json_lines = if path.extension().map_or(false, |ext| ext == "prom") {
+        None
+    } else {
+        Some(BufWriter::new(File::create(&path)?))
+    };
+    *SINK.lock().unwrap() = Some(Sink {
+        path,
+        json_lines,
+        start_time: Instant::now(),
+    });
+    ENABLED.store(true, Ordering::Relaxed);
+    Ok(())
+}
+
+/// Returns whether the metrics are enabled.
+#[inline]
+pub fn is_enabled() -> bool {
+    ENABLED.load(Ordering::Relaxed)
+}
+
+/// Adds `n` to `counter`.
+#[inline]
+pub fn add(counter: Counter, n: u64) {
+    if is_enabled() {
+        COUNTS[counter as usize].fetch_add(n, Ordering::Relaxed);
+    }
+}
+
+/// Starts timing an occurrence of `phase`, which lasts until the returned timer is dropped.
+#[inline]
+pub fn time(phase: Phase) -> PhaseTimer {
+    PhaseTimer(if is_enabled() {
+        Some((phase, Instant::now()))
+    } else {
+        None
+    })
+}
+
+/// Accumulates the time elapsed since its creation into its phase when dropped.
+pub struct PhaseTimer(Option<(Phase, Instant)>);
+
+impl Drop for PhaseTimer {
+    fn drop(&mut self) {
+        if let Some((phase, start_time)) = self.0 {
+            PHASE_NANOS[phase as usize]
+                .fetch_add(start_time.elapsed().as_nanos() as u64, Ordering::Relaxed);
+        }
+    }
+}
+
+/// Exports the metrics at the end of a generation of the search of `target`.
+///
+/// # Parameters
+/// - `best_fitness`: The best fitness score of the generation.
+/// - `trace_diversity`: The ratio of distinct individuals in the program population.
+/// - `input_diversity`: The ratio of distinct assignments in the input population.
+pub fn record_generation(
+    target: &str,
+    generation: usize,
+    best_fitness: &BigInt,
+    trace_diversity: f64,
+    input_diversity: f64,
+) {
+    if !is_enabled() {
+        return;
+    }
+    add(Counter::Generations, 1);
+    export(json!({
+        "event": "generation",
+        "target": target,
+        "generation": generation,
+        "best_fitness": best_fitness.to_string(),
+        "trace_diversity": trace_diversity,
+        "input_diversity": input_diversity,
+    }));
+}
+
+/// Exports the metrics at the end of the run.
+pub fn finish() {
+    if !is_enabled() {
+        return;
+    }
+    export(json!({ "event": "summary" }));
+    if let Some(sink) = SINK.lock().unwrap().as_mut() {
+        if let Some(out) = &mut sink.json_lines {
+            if let Err(e) = out.flush() {
+                warn!("Cannot write the metrics to {:?}: {}", sink.path, e);
+            }
+        }
+    }
+}
+
+/// Writes `record`, completed with the accumulated phases and counters, to the sink.
+fn export(mut record: Value) {
+    let mut guard = SINK.lock().unwrap();
+    let sink = match guard.as_mut() {
+        Some(sink) => sink,
+        None => return,
+    };
+    let elapsed_secs = sink.start_time.elapsed().as_secs_f64();
+    let phases: Map<String, Value> = PHASES
+        .iter()
+        .map(|phase| (phase.name().to_string(), json!(phase_secs(*phase))))
+        .collect();
+    let counters: Map<String, Value> = COUNTERS
+        .iter()
+        .map(|counter| (counter.name().to_string(), json!(count(*counter))))
+        .collect();
+    let emulation_secs: f64 = EMULATION_PHASES
+        .iter()
+        .map(|phase| phase_secs(*phase))
+        .sum();
+    record["elapsed_secs"] = json!(elapsed_secs);
+    record["phase_secs"] = Value::Object(phases);
+    record["counters"] = Value::Object(counters);
+    record["emulations_per_sec"] = json!(if emulation_secs > 0.0 {
+        count(Counter::Emulations) as f64 / emulation_secs
+    } else {
+        0.0
+    });
+
+    let result = match &mut sink.json_lines {
+        Some(out) => writeln!(out, "{}", record),
+        None => write_prometheus(&sink.path, &record, elapsed_secs),
+    };
+    if let Err(e) = result {
+        warn!("Cannot write the metrics to {:?}: {}", sink.path, e);
+    }
+}
+
+/// Replaces the metrics file with a snapshot of the metrics in the Prometheus text format.
+fn write_prometheus(path: &Path, record: &Value, elapsed_secs: f64) -> io::Result<()> {
+    let mut text = String::new();
+    text.push_str("# TYPE zkfuzz_elapsed_seconds gauge\n");
+    text.push_str(&format!("zkfuzz_elapsed_seconds {}\n", elapsed_secs));
+    text.push_str("# TYPE zkfuzz_phase_seconds_total counter\n");
+    for phase in PHASES {
+        text.push_str(&format!(
+            "zkfuzz_phase_seconds_total{{phase=\"{}\"}} {}\n",
+            phase.name(),
+            phase_secs(phase)
+        ));
+    }
+    for counter in COUNTERS {
+        text.push_str(&format!(
+            "# TYPE zkfuzz_{0}_total counter\nzkfuzz_{0}_total {1}\n",
+            counter.name(),
+            count(counter)
+        ));
+    }
+    for gauge in ["generation", "trace_diversity", "input_diversity"] {
+        if let Some(value) = record.get(gauge) {
+            text.push_str(&format!(
+                "# TYPE zkfuzz_{0} gauge\nzkfuzz_{0} {1}\n",
+                gauge, value
+            ));
+        }
+    }
+
+    // Write to a temporary file first, so that the collector never reads a partial snapshot.
+    let tmp_path = path.with_extension("prom.tmp");
+    fs::write(&tmp_path, text)?;
+    fs::rename(tmp_path, path)
+}
+
+fn phase_secs(phase: Phase) -> f64 {
+    PHASE_NANOS[phase as usize].load(Ordering::Relaxed) as f64 / 1e9
+}
+
+fn count(counter: Counter) -> u64 {
+    COUNTS[counter as usize].load(Ordering::Relaxed)
+}
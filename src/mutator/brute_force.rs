@@ -1,21 +1,49 @@
-use std::collections::HashSet;
 use std::io;
 use std::io::Write;
 use std::sync::atomic::{AtomicUsize, Ordering};
-use std::sync::Arc;
+use std::thread;
 
+use log::warn;
 use num_bigint_dig::BigInt;
-use num_traits::{One, Zero};
+use num_traits::{One, ToPrimitive, Zero};
 use rustc_hash::FxHashMap;
 
 use crate::executor::symbolic_execution::SymbolicExecutor;
-use crate::executor::symbolic_value::{extract_variables, SymbolicName, SymbolicValueRef};
+use crate::executor::symbolic_value::{
+    extract_variables, SymbolicLibrary, SymbolicName, SymbolicValueRef,
+};
+use crate::metrics;
+use crate::metrics::Counter;
+use crate::mutator::mutation_test::resolve_num_threads;
 use crate::mutator::utils::{
-    is_vulnerable, verify_assignment, BaseVerificationConfig, CounterExample, VerificationResult,
+    evaluate_trace_and_side_constraints, is_vulnerable, oracle_inputs_of_assignment,
+    verify_oracle_outputs, verify_original_run, BaseVerificationConfig, ConstraintScheduler,
+    CounterExample, VerificationResult,
 };
+use crate::mutator::witness_oracle::{OracleOutcome, WitnessOracle};
+
+/// Number of consecutive assignments that a worker claims at once.
+const CHUNK_SIZE: usize = 1024;
 
 /// Performs a brute-force search over variable assignments to evaluate constraints.
 ///
+/// Every variable ranges over the same candidate values (`{0, 1, -1}` in quick mode,
+/// `[-range, range]` and `[p - range, p)` in heuristics mode, and `[0, p)` otherwise), and the
+/// assignments are numbered in mixed radix, with the first variable (in the order of
+/// `SymbolicName`) as the most significant digit. Only the assignments whose index lies in
+/// `[search_start, search_end)` are verified, so that a search can be resumed or sharded across
+/// processes.
+///
+/// The index range is split into chunks claimed by `num_threads` workers, each with its own copy
+/// of the symbolic library. Once a vulnerable assignment is found, chunks after it are no longer
+/// searched, while earlier ones are completed, so the result is the vulnerable assignment with
+/// the smallest index, as in a serial search.
+///
+/// With `base_config.witness_oracle`, each worker starts its own witness oracle, and the
+/// assignments of a chunk that need a run of the original program are sent to it in one
+/// batch. The concrete executor still reports the violated condition of the runs that the
+/// oracle rejects, and takes over if the oracle fails.
+///
 /// # Parameters
 /// - `sexe`: A mutable reference to the symbolic executor.
 /// - `symbolic_trace`: A vector of constraints representing the program trace.
@@ -30,170 +58,302 @@ pub fn brute_force_search(
     side_constraints: &Vec<SymbolicValueRef>,
     base_config: &BaseVerificationConfig,
 ) -> Option<CounterExample> {
-    let mut trace_variables = extract_variables(symbolic_trace);
-    let mut side_variables = extract_variables(side_constraints);
+    let mut variables = extract_variables(symbolic_trace);
+    variables.append(&mut extract_variables(side_constraints));
+    // The index of an assignment must not depend on the run.
+    variables.sort();
+    variables.dedup();
+
+    let total = num_assignments(variables.len(), base_config);
+    let start = base_config.search_start.clone().min(total.clone());
+    let end = base_config
+        .search_end
+        .clone()
+        .unwrap_or_else(|| total.clone())
+        .min(total.clone())
+        .max(start.clone());
+    let num_chunks = ((&end - &start) + BigInt::from(CHUNK_SIZE - 1)) / BigInt::from(CHUNK_SIZE);
+    let num_chunks = num_chunks.to_usize().unwrap_or(usize::MAX);
+
+    let search = ChunkedSearch {
+        symbolic_trace,
+        side_constraints,
+        base_config,
+        variables: &variables,
+        start: &start,
+        end: &end,
+        num_chunks,
+        next_chunk: AtomicUsize::new(0),
+        first_vulnerable_chunk: AtomicUsize::new(usize::MAX),
+        current_iteration: AtomicUsize::new(0),
+    };
+
+    let num_threads = resolve_num_threads(base_config.num_threads).min(num_chunks.max(1));
+    let found = if num_threads > 1 {
+        let setting = sexe.setting;
+        let mut worker_libraries: Vec<SymbolicLibrary> = (0..num_threads)
+            .map(|_| sexe.symbolic_library.clone())
+            .collect();
+        thread::scope(|s| {
+            let handles: Vec<_> = worker_libraries
+                .iter_mut()
+                .map(|library| {
+                    let search = &search;
+                    s.spawn(move || search.run(&mut SymbolicExecutor::new(library, setting)))
+                })
+                .collect();
+            handles
+                .into_iter()
+                .filter_map(|handle| handle.join().unwrap())
+                .min_by_key(|(chunk, _, _)| *chunk)
+        })
+    } else {
+        search.run(sexe)
+    };
+
+    let current_iteration = search.current_iteration.load(Ordering::SeqCst);
+    print!("\rProgress: {} / {}", current_iteration, &end - &start);
+    io::stdout().flush().unwrap();
+
+    let (flag, assignment) = match found {
+        Some((_, flag, assignment)) => (flag, assignment),
+        None => (VerificationResult::WellConstrained, FxHashMap::default()),
+    };
+
+    println!("\n • Search completed");
+    println!("     ├─ Search range: [{}, {}) of {}", start, end, total);
+    println!("     ├─ Total iterations: {}", current_iteration);
+    println!("     └─ Verification result: {}", flag);
+
+    if is_vulnerable(&flag) {
+        Some(CounterExample {
+            flag: flag,
+            target_output: None,
+            assignment: assignment,
+        })
+    } else {
+        None
+    }
+}
+
+/// Returns the number of candidate values of a single variable.
+fn num_candidates(base_config: &BaseVerificationConfig) -> BigInt {
+    if base_config.quick_mode {
+        BigInt::from(3)
+    } else if base_config.heuristics_mode {
+        BigInt::from(3) * &base_config.range + BigInt::one()
+    } else {
+        base_config.prime.clone()
+    }
+}
+
+/// Returns the `digit`-th candidate value of a variable.
+fn candidate(digit: &BigInt, base_config: &BaseVerificationConfig) -> BigInt {
+    if base_config.quick_mode {
+        [BigInt::zero(), BigInt::one(), -BigInt::one()][digit.to_usize().unwrap()].clone()
+    } else if base_config.heuristics_mode {
+        if *digit <= BigInt::from(2) * &base_config.range {
+            digit - &base_config.range
+        } else {
+            &base_config.prime - BigInt::from(3) * &base_config.range - BigInt::one() + digit
+        }
+    } else {
+        digit.clone()
+    }
+}
 
-    let mut variables = Vec::new();
-    variables.append(&mut trace_variables);
-    variables.append(&mut side_variables);
-    let variables_set: HashSet<SymbolicName> = variables.iter().cloned().collect();
-    variables = variables_set.into_iter().collect();
+/// Returns the number of assignments of `num_variables` variables searched by
+/// `brute_force_search`, i.e., the end of its index space.
+pub fn num_assignments(num_variables: usize, base_config: &BaseVerificationConfig) -> BigInt {
+    let radix = num_candidates(base_config);
+    (0..num_variables).fold(BigInt::one(), |acc, _| acc * &radix)
+}
 
-    let mut assignment = FxHashMap::default();
-    let current_iteration = Arc::new(AtomicUsize::new(0));
+/// The state shared by the workers of `brute_force_search`.
+struct ChunkedSearch<'a> {
+    symbolic_trace: &'a [SymbolicValueRef],
+    side_constraints: &'a [SymbolicValueRef],
+    base_config: &'a BaseVerificationConfig,
+    variables: &'a [SymbolicName],
+    start: &'a BigInt,
+    end: &'a BigInt,
+    num_chunks: usize,
+    next_chunk: AtomicUsize,
+    first_vulnerable_chunk: AtomicUsize,
+    current_iteration: AtomicUsize,
+}
 
-    fn search(
+impl<'a> ChunkedSearch<'a> {
+    /// Claims and searches chunks until none is left or a vulnerable assignment is found in an
+    /// earlier chunk. Returns the first vulnerable assignment found by this worker, along with
+    /// its chunk.
+    fn run(
+        &self,
         sexe: &mut SymbolicExecutor,
-        symbolic_trace: &[SymbolicValueRef],
-        side_constraints: &[SymbolicValueRef],
-        base_config: &BaseVerificationConfig,
-        index: usize,
-        variables: &[SymbolicName],
-        assignment: &mut FxHashMap<SymbolicName, BigInt>,
-        current_iteration: &Arc<AtomicUsize>,
-    ) -> VerificationResult {
-        if index == variables.len() {
-            let iter = current_iteration.fetch_add(1, Ordering::SeqCst);
-            if iter % base_config.progress_interval == 0 {
-                print!(
-                    "\rProgress: {} / {}^{}",
-                    iter,
-                    &base_config.prime,
-                    variables.len()
-                );
-                io::stdout().flush().unwrap();
+    ) -> Option<(usize, VerificationResult, FxHashMap<SymbolicName, BigInt>)> {
+        // The order of the constraints is learned across all the chunks of the worker.
+        let mut schedulers = (
+            ConstraintScheduler::for_constraints(self.symbolic_trace),
+            ConstraintScheduler::for_constraints(self.side_constraints),
+        );
+        let mut oracle = self
+            .base_config
+            .witness_oracle
+            .as_ref()
+            .and_then(|command| {
+                WitnessOracle::spawn(command)
+                    .map_err(|e| warn!("Failed to start the witness oracle `{}`: {}", command, e))
+                    .ok()
+            });
+        loop {
+            // Chunks are claimed in increasing order, so every chunk before a vulnerable one
+            // has already been claimed and is completed by its worker.
+            let chunk = self.next_chunk.fetch_add(1, Ordering::Relaxed);
+            if chunk >= self.num_chunks
+                || chunk > self.first_vulnerable_chunk.load(Ordering::Acquire)
+            {
+                return None;
+            }
+            if let Some((flag, assignment)) =
+                self.search_chunk(sexe, chunk, &mut schedulers, &mut oracle)
+            {
+                self.first_vulnerable_chunk
+                    .fetch_min(chunk, Ordering::AcqRel);
+                return Some((chunk, flag, assignment));
             }
+        }
+    }
 
-            return verify_assignment(
-                sexe,
-                symbolic_trace,
-                side_constraints,
-                assignment,
-                base_config,
-            );
+    fn search_chunk(
+        &self,
+        sexe: &mut SymbolicExecutor,
+        chunk: usize,
+        schedulers: &mut (ConstraintScheduler, ConstraintScheduler),
+        oracle: &mut Option<WitnessOracle>,
+    ) -> Option<(VerificationResult, FxHashMap<SymbolicName, BigInt>)> {
+        let chunk_start = self.start + BigInt::from(chunk) * BigInt::from(CHUNK_SIZE);
+        let chunk_end = (&chunk_start + BigInt::from(CHUNK_SIZE)).min(self.end.clone());
+        let chunk_len = (&chunk_end - &chunk_start).to_usize().unwrap();
+
+        // Decode the first index of the chunk, then step through the others like an odometer.
+        let radix = num_candidates(self.base_config);
+        let mut digits = vec![BigInt::zero(); self.variables.len()];
+        let mut rest = chunk_start;
+        for digit in digits.iter_mut().rev() {
+            *digit = &rest % &radix;
+            rest /= &radix;
         }
+        let mut assignment: FxHashMap<SymbolicName, BigInt> = self
+            .variables
+            .iter()
+            .zip(digits.iter())
+            .map(|(var, digit)| (var.clone(), candidate(digit, self.base_config)))
+            .collect();
 
-        let var = &variables[index];
-        if base_config.quick_mode {
-            let candidates = vec![BigInt::zero(), BigInt::one(), -1 * BigInt::one()];
-            for c in candidates.into_iter() {
-                assignment.insert(var.clone(), c.clone());
-                let result = search(
-                    sexe,
-                    symbolic_trace,
-                    side_constraints,
-                    base_config,
-                    index + 1,
-                    variables,
-                    assignment,
-                    current_iteration,
-                );
-                if is_vulnerable(&result) {
-                    return result;
+        // The assignments, in increasing order, left to the witness oracle.
+        let mut pending_runs = Vec::new();
+        let mut over_constrained = None;
+        for offset in 0..chunk_len {
+            if 0 < offset {
+                for (var, digit) in self.variables.iter().zip(digits.iter_mut()).rev() {
+                    *digit += BigInt::one();
+                    let is_carried = *digit == radix;
+                    if is_carried {
+                        digit.set_zero();
+                    }
+                    assignment.insert(var.clone(), candidate(digit, self.base_config));
+                    if !is_carried {
+                        break;
+                    }
                 }
-                assignment.remove(var);
             }
-        } else if base_config.heuristics_mode {
-            let mut value = -&base_config.range;
-            while value <= base_config.range {
-                assignment.insert(var.clone(), value.clone());
-
-                let result = search(
-                    sexe,
-                    symbolic_trace,
-                    side_constraints,
-                    base_config,
-                    index + 1,
-                    variables,
-                    assignment,
-                    current_iteration,
-                );
 
-                if is_vulnerable(&result) {
-                    return result;
-                }
-                assignment.remove(&var);
-                value += BigInt::one();
+            let iter = self.current_iteration.fetch_add(1, Ordering::SeqCst);
+            if iter % self.base_config.progress_interval == 0 {
+                print!("\rProgress: {} / {}", iter, self.end - self.start);
+                io::stdout().flush().unwrap();
             }
-            let mut value = &base_config.prime - &base_config.range;
-
-            while value < base_config.prime {
-                assignment.insert(var.clone(), value.clone());
-
-                let result = search(
-                    sexe,
-                    symbolic_trace,
-                    side_constraints,
-                    base_config,
-                    index + 1,
-                    variables,
-                    assignment,
-                    current_iteration,
-                );
 
-                if is_vulnerable(&result) {
-                    return result;
+            let (is_satisfy_st, is_satisfy_sc) = evaluate_trace_and_side_constraints(
+                sexe,
+                self.symbolic_trace,
+                self.side_constraints,
+                &assignment,
+                self.base_config,
+                &mut schedulers.0,
+                &mut schedulers.1,
+            );
+            if is_satisfy_st && !is_satisfy_sc {
+                // Later assignments of the chunk cannot come first.
+                over_constrained = Some((VerificationResult::OverConstrained, assignment));
+                break;
+            } else if !is_satisfy_st && is_satisfy_sc {
+                if oracle.is_some() {
+                    pending_runs.push(assignment.clone());
+                } else {
+                    let result = verify_original_run(sexe, &assignment, self.base_config);
+                    if is_vulnerable(&result) {
+                        return Some((result, assignment));
+                    }
                 }
-                assignment.remove(&var);
-                value += BigInt::one();
             }
-        } else {
-            let mut value = BigInt::zero();
-            while value < base_config.prime {
-                assignment.insert(var.clone(), value.clone());
-                let result = search(
-                    sexe,
-                    symbolic_trace,
-                    side_constraints,
-                    base_config,
-                    index + 1,
-                    variables,
-                    assignment,
-                    current_iteration,
-                );
-                if is_vulnerable(&result) {
-                    return result;
-                }
-                assignment.remove(var);
-                value += BigInt::one();
+            // An earlier chunk already has a vulnerable assignment.
+            if self.first_vulnerable_chunk.load(Ordering::Relaxed) < chunk {
+                return None;
             }
         }
-        VerificationResult::WellConstrained
-    }
 
-    let flag = search(
-        sexe,
-        &symbolic_trace,
-        &side_constraints,
-        base_config,
-        0,
-        &variables,
-        &mut assignment,
-        &current_iteration,
-    );
-
-    print!(
-        "\rProgress: {} / {}^{}",
-        current_iteration.load(Ordering::SeqCst),
-        base_config.prime,
-        variables.len()
-    );
-    io::stdout().flush().unwrap();
+        self.verify_pending_runs(sexe, pending_runs, oracle)
+            .or(over_constrained)
+    }
 
-    println!("\n • Search completed");
-    println!(
-        "     ├─ Total iterations: {}",
-        current_iteration.load(Ordering::SeqCst)
-    );
-    println!("     └─ Verification result: {}", flag);
+    /// Verifies the assignments that need a run of the original program with the witness
+    /// oracle, and returns the first vulnerable one.
+    fn verify_pending_runs(
+        &self,
+        sexe: &mut SymbolicExecutor,
+        pending_runs: Vec<FxHashMap<SymbolicName, BigInt>>,
+        oracle: &mut Option<WitnessOracle>,
+    ) -> Option<(VerificationResult, FxHashMap<SymbolicName, BigInt>)> {
+        if pending_runs.is_empty() {
+            return None;
+        }
+        let inputs: Vec<_> = pending_runs
+            .iter()
+            .map(|assignment| {
+                oracle_inputs_of_assignment(&sexe.symbolic_library, assignment, self.base_config)
+            })
+            .collect();
+        let outcomes = match oracle.as_mut().unwrap().run_batch(&inputs) {
+            Ok(outcomes) => {
+                metrics::add(Counter::OracleRuns, outcomes.len() as u64);
+                outcomes
+            }
+            Err(e) => {
+                warn!(
+                    "The witness oracle failed, falling back to the concrete executor: {}",
+                    e
+                );
+                *oracle = None;
+                vec![OracleOutcome::Rejected; pending_runs.len()]
+            }
+        };
 
-    if is_vulnerable(&flag) {
-        Some(CounterExample {
-            flag: flag,
-            target_output: None,
-            assignment: assignment,
-        })
-    } else {
+        for (assignment, outcome) in pending_runs.into_iter().zip(outcomes) {
+            let result = match &outcome {
+                OracleOutcome::Accepted(signals) => verify_oracle_outputs(
+                    &sexe.symbolic_library,
+                    &assignment,
+                    self.base_config,
+                    signals,
+                ),
+                OracleOutcome::Rejected => None,
+            }
+            .unwrap_or_else(|| verify_original_run(sexe, &assignment, self.base_config));
+            if is_vulnerable(&result) {
+                return Some((result, assignment));
+            }
+        }
         None
     }
 }
@@ -0,0 +1,295 @@
+//! Checkpoints of a mutation-based search.
+//!
+//! A long search that is preempted (e.g., on a spot instance) would otherwise restart from
+//! scratch. `mutation_test_search` periodically writes the whole state of the genetic
+//! algorithm to a compact binary file with the encoder of the trace cache, and a search
+//! started with the same checkpoint path resumes from the last checkpoint, possibly on
+//! another machine.
+
+use std::fs;
+use std::fs::File;
+use std::io;
+use std::io::{BufReader, BufWriter, Read, Write};
+use std::path::Path;
+
+use log::warn;
+use num_bigint_dig::BigInt;
+use rustc_hash::FxHashMap;
+
+use crate::executor::symbolic_value::SymbolicName;
+use crate::executor::trace_cache::{invalid_data, Decoder, Encoder};
+use crate::mutator::mutation_test::Gene;
+use crate::mutator::mutation_utils::{QuadraticRootCache, QUADRATIC_ROOT_CACHE_CAPACITY};
+
+const MAGIC: &[u8; 4] = b"ZKGA";
+const FORMAT_VERSION: u32 = 4;
+
+/// The state of a search at the start of a generation.
+pub struct SearchCheckpoint {
+    /// Identifies the searched circuit; a checkpoint with another fingerprint is ignored.
+    pub fingerprint: String,
+    /// The population sizes of the configuration that saved the checkpoint; a checkpoint is
+    /// ignored by a search configured with other sizes.
+    pub program_population_size: usize,
+    pub input_population_size: usize,
+    /// The seed reported as the random seed of the search.
+    pub seed: u64,
+    /// The generation from which the search resumes.
+    pub generation: usize,
+    /// Wall-clock time already spent on the search, deducted from the time budget.
+    pub elapsed_secs: u64,
+    /// Seed from which the random number generator is reseeded. `StdRng` does not expose its
+    /// state, so the search reseeds its generator with this value when it saves a checkpoint.
+    pub rng_seed: u64,
+    pub binary_input_mode: bool,
+    pub random_value_ranges: Vec<(BigInt, BigInt)>,
+    pub random_value_probs: Vec<f64>,
+    pub trace_population: Vec<Gene>,
+    pub fitness_scores: Vec<BigInt>,
+    pub input_population: Vec<FxHashMap<SymbolicName, BigInt>>,
+    pub fitness_scores_inputs: Vec<BigInt>,
+    pub fitness_score_log: Vec<BigInt>,
+    pub zero_div_cache: QuadraticRootCache,
+    /// The best fitness score so far, and the number of generations since it last improved.
+    pub best_fitness_score: BigInt,
+    pub num_stagnant_generations: usize,
+    /// Inputs solved on a plateau, which are injected into the input population.
+    pub plateau_inputs: Vec<FxHashMap<SymbolicName, BigInt>>,
+    /// The pulls and improvements of every arm of the operator scheduler, and its best
+    /// fitness score, as returned by `OperatorScheduler::state`. Empty without a scheduler.
+    pub operator_counts: Vec<(usize, usize)>,
+    pub operator_best_score: Option<BigInt>,
+}
+
+/// Writes `checkpoint` to `path`. The checkpoint is written to a temporary file first, so that
+/// a search killed while saving leaves the previous checkpoint intact.
+pub fn save_checkpoint(path: &Path, checkpoint: &SearchCheckpoint) -> io::Result<()> {
+    if let Some(dir) = path.parent() {
+        fs::create_dir_all(dir)?;
+    }
+    let tmp_path = path.with_extension(format!("tmp{}", std::process::id()));
+    let mut encoder = Encoder::new(BufWriter::new(File::create(&tmp_path)?));
+    encoder.out.write_all(MAGIC)?;
+    encoder.write_u32(FORMAT_VERSION)?;
+
+    encoder.write_str(&checkpoint.fingerprint)?;
+    encoder.write_usize(checkpoint.program_population_size)?;
+    encoder.write_usize(checkpoint.input_population_size)?;
+    encoder.write_u64(checkpoint.seed)?;
+    encoder.write_usize(checkpoint.generation)?;
+    encoder.write_u64(checkpoint.elapsed_secs)?;
+    encoder.write_u64(checkpoint.rng_seed)?;
+    encoder.write_u8(checkpoint.binary_input_mode as u8)?;
+    encoder.write_usize(checkpoint.random_value_ranges.len())?;
+    for (lower, upper) in &checkpoint.random_value_ranges {
+        encoder.write_bigint(lower)?;
+        encoder.write_bigint(upper)?;
+    }
+    encoder.write_usize(checkpoint.random_value_probs.len())?;
+    for prob in &checkpoint.random_value_probs {
+        encoder.write_u64(prob.to_bits())?;
+    }
+
+    encoder.write_usize(checkpoint.trace_population.len())?;
+    for gene in &checkpoint.trace_population {
+        let mut mutations: Vec<_> = gene.iter().collect();
+        mutations.sort_by_key(|(pos, _)| **pos);
+        encoder.write_usize(mutations.len())?;
+        for (pos, value) in mutations {
+            encoder.write_usize(*pos)?;
+            encoder.write_value(value)?;
+        }
+    }
+    write_bigints(&mut encoder, &checkpoint.fitness_scores)?;
+
+    write_inputs(&mut encoder, &checkpoint.input_population)?;
+    write_bigints(&mut encoder, &checkpoint.fitness_scores_inputs)?;
+    write_bigints(&mut encoder, &checkpoint.fitness_score_log)?;
+
+    encoder.write_usize(checkpoint.zero_div_cache.len())?;
+    for (coefficients, root) in checkpoint.zero_div_cache.iter() {
+        for coefficient in coefficients {
+            encoder.write_bigint(coefficient)?;
+        }
+        encoder.write_bigint(root)?;
+    }
+
+    encoder.write_bigint(&checkpoint.best_fitness_score)?;
+    encoder.write_usize(checkpoint.num_stagnant_generations)?;
+    write_inputs(&mut encoder, &checkpoint.plateau_inputs)?;
+
+    encoder.write_usize(checkpoint.operator_counts.len())?;
+    for (num_pulls, num_improvements) in &checkpoint.operator_counts {
+        encoder.write_usize(*num_pulls)?;
+        encoder.write_usize(*num_improvements)?;
+    }
+    encoder.write_u8(checkpoint.operator_best_score.is_some() as u8)?;
+    if let Some(score) = &checkpoint.operator_best_score {
+        encoder.write_bigint(score)?;
+    }
+
+    encoder
+        .out
+        .into_inner()
+        .map_err(|e| e.into_error())?
+        .sync_all()?;
+    fs::rename(tmp_path, path)
+}
+
+/// Loads the checkpoint stored at `path` by `save_checkpoint`.
+pub fn load_checkpoint(path: &Path) -> io::Result<SearchCheckpoint> {
+    let mut decoder = Decoder::new(BufReader::new(File::open(path)?));
+    let mut magic = [0_u8; 4];
+    decoder.input.read_exact(&mut magic)?;
+    if &magic != MAGIC || decoder.read_u32()? != FORMAT_VERSION {
+        return Err(invalid_data("not a search checkpoint of this version"));
+    }
+
+    let fingerprint = decoder.read_str()?;
+    let program_population_size = decoder.read_usize()?;
+    let input_population_size = decoder.read_usize()?;
+    let seed = decoder.read_u64()?;
+    let generation = decoder.read_usize()?;
+    let elapsed_secs = decoder.read_u64()?;
+    let rng_seed = decoder.read_u64()?;
+    let binary_input_mode = decoder.read_bool()?;
+    let num_ranges = decoder.read_usize()?;
+    let mut random_value_ranges = Vec::new();
+    for _ in 0..num_ranges {
+        let lower = decoder.read_bigint()?;
+        random_value_ranges.push((lower, decoder.read_bigint()?));
+    }
+    let num_probs = decoder.read_usize()?;
+    let mut random_value_probs = Vec::new();
+    for _ in 0..num_probs {
+        random_value_probs.push(f64::from_bits(decoder.read_u64()?));
+    }
+
+    let num_genes = decoder.read_usize()?;
+    let mut trace_population = Vec::new();
+    for _ in 0..num_genes {
+        let num_mutations = decoder.read_usize()?;
+        let mut gene = Gene::default();
+        for _ in 0..num_mutations {
+            let pos = decoder.read_usize()?;
+            gene.insert(pos, decoder.read_value()?);
+        }
+        trace_population.push(gene);
+    }
+    let fitness_scores = read_bigints(&mut decoder)?;
+
+    let input_population = read_inputs(&mut decoder)?;
+    let fitness_scores_inputs = read_bigints(&mut decoder)?;
+    let fitness_score_log = read_bigints(&mut decoder)?;
+
+    let num_roots = decoder.read_usize()?;
+    let mut zero_div_cache = QuadraticRootCache::new(QUADRATIC_ROOT_CACHE_CAPACITY);
+    for _ in 0..num_roots {
+        let coefficients = [
+            decoder.read_bigint()?,
+            decoder.read_bigint()?,
+            decoder.read_bigint()?,
+        ];
+        zero_div_cache.insert(coefficients, decoder.read_bigint()?);
+    }
+    let best_fitness_score = decoder.read_bigint()?;
+    let num_stagnant_generations = decoder.read_usize()?;
+    let plateau_inputs = read_inputs(&mut decoder)?;
+
+    let num_arms = decoder.read_usize()?;
+    let mut operator_counts = Vec::new();
+    for _ in 0..num_arms {
+        let num_pulls = decoder.read_usize()?;
+        operator_counts.push((num_pulls, decoder.read_usize()?));
+    }
+    let operator_best_score = if decoder.read_bool()? {
+        Some(decoder.read_bigint()?)
+    } else {
+        None
+    };
+
+    Ok(SearchCheckpoint {
+        fingerprint,
+        program_population_size,
+        input_population_size,
+        seed,
+        generation,
+        elapsed_secs,
+        rng_seed,
+        binary_input_mode,
+        random_value_ranges,
+        random_value_probs,
+        trace_population,
+        fitness_scores,
+        input_population,
+        fitness_scores_inputs,
+        fitness_score_log,
+        zero_div_cache,
+        best_fitness_score,
+        num_stagnant_generations,
+        plateau_inputs,
+        operator_counts,
+        operator_best_score,
+    })
+}
+
+/// Removes the checkpoint at `path` once the search it belongs to has completed.
+pub fn remove_checkpoint(path: &Path) {
+    match fs::remove_file(path) {
+        Err(e) if e.kind() != io::ErrorKind::NotFound => {
+            warn!("Cannot remove the checkpoint {:?}: {}", path, e)
+        }
+        _ => {}
+    }
+}
+
+fn write_bigints<W: Write>(encoder: &mut Encoder<W>, values: &[BigInt]) -> io::Result<()> {
+    encoder.write_usize(values.len())?;
+    for value in values {
+        encoder.write_bigint(value)?;
+    }
+    Ok(())
+}
+
+fn write_inputs<W: Write>(
+    encoder: &mut Encoder<W>,
+    inputs: &[FxHashMap<SymbolicName, BigInt>],
+) -> io::Result<()> {
+    encoder.write_usize(inputs.len())?;
+    for input in inputs {
+        let mut assignment: Vec<_> = input.iter().collect();
+        assignment.sort_by(|(l, _), (r, _)| l.cmp(r));
+        encoder.write_usize(assignment.len())?;
+        for (name, value) in assignment {
+            encoder.write_name(name)?;
+            encoder.write_bigint(value)?;
+        }
+    }
+    Ok(())
+}
+
+fn read_inputs<R: Read>(
+    decoder: &mut Decoder<R>,
+) -> io::Result<Vec<FxHashMap<SymbolicName, BigInt>>> {
+    let num_inputs = decoder.read_usize()?;
+    let mut inputs = Vec::new();
+    for _ in 0..num_inputs {
+        let num_variables = decoder.read_usize()?;
+        let mut input = FxHashMap::default();
+        for _ in 0..num_variables {
+            let name = decoder.read_name()?;
+            input.insert(name, decoder.read_bigint()?);
+        }
+        inputs.push(input);
+    }
+    Ok(inputs)
+}
+
+fn read_bigints<R: Read>(decoder: &mut Decoder<R>) -> io::Result<Vec<BigInt>> {
+    let len = decoder.read_usize()?;
+    let mut values = Vec::new();
+    for _ in 0..len {
+        values.push(decoder.read_bigint()?);
+    }
+    Ok(values)
+}
@@ -0,0 +1,1782 @@
+use std::borrow::Cow;
+use std::mem;
+use std::ops::Index;
+use std::slice;
+use std::sync::Arc;
+
+use num_bigint_dig::BigInt;
+use num_traits::{One, Signed, Zero};
+use rustc_hash::FxHashMap;
+
+use program_structure::ast::{ExpressionInfixOpcode, ExpressionPrefixOpcode};
+
+use crate::executor::debug_ast::{
+    DebuggableExpressionInfixOpcode, DebuggableExpressionPrefixOpcode,
+};
+use crate::executor::symbolic_value::{
+    evaluate_binary_op_of_booleans, evaluate_binary_op_of_integers, is_boolean_infix_op,
+    normalize_to_bool, normalize_to_int, SymbolicLibrary, SymbolicName, SymbolicValue,
+    SymbolicValueRef,
+};
+use crate::metrics;
+use crate::metrics::Counter;
+use crate::mutator::coverage_bitmap::{decision_location, EdgeTrace};
+use crate::mutator::utils::{
+    emulate_symbolic_statement, evaluate_constraints, evaluate_error_of_symbolic_value,
+    size_of_symbolic_value, ConstraintScheduler, Direction,
+};
+
+/// A concrete value held by a register or a variable slot during compiled emulation.
+#[derive(Clone, Debug)]
+enum Value {
+    Int(BigInt),
+    Bool(bool),
+}
+
+/// Where an instruction reads one of its inputs from.
+#[derive(Clone, Copy, Debug)]
+enum Operand {
+    Const(usize),
+    Slot(usize),
+    Reg(usize),
+}
+
+/// A single register-machine instruction. Every instruction writes `dst`.
+#[derive(Clone)]
+enum Instruction {
+    Infix {
+        dst: usize,
+        op: DebuggableExpressionInfixOpcode,
+        is_integer_mode: bool,
+        lhs: Operand,
+        rhs: Operand,
+    },
+    Prefix {
+        dst: usize,
+        op: DebuggableExpressionPrefixOpcode,
+        operand: Operand,
+    },
+    Select {
+        dst: usize,
+        cond: Operand,
+        then_branch: Operand,
+        else_branch: Operand,
+    },
+}
+
+/// The compiled form of one statement of the trace.
+#[derive(Clone)]
+enum Statement {
+    Nop,
+    Fail,
+    Assign {
+        code: Vec<Instruction>,
+        value: Operand,
+        target: usize,
+    },
+    Check {
+        code: Vec<Instruction>,
+        lhs: Operand,
+        rhs: Operand,
+        op: DebuggableExpressionInfixOpcode,
+        is_integer_mode: bool,
+        lhs_slot: Option<usize>,
+        rhs_slot: Option<usize>,
+    },
+    Not {
+        code: Vec<Instruction>,
+        value: Operand,
+    },
+    Truthy {
+        code: Vec<Instruction>,
+        value: Operand,
+    },
+    Fallback,
+}
+
+/// Signals that a statement hit a case the compiled code does not handle (e.g. a type mismatch
+/// on which the tree emulator panics) and must be re-run by `emulate_symbolic_statement`.
+struct Deopt;
+
+/// A vector shared by a compiled trace and the mutations compiled from it, in which a mutation
+/// replaces the entries of the positions it recompiles.
+///
+/// A clone only bumps a reference count, so that compiling a mutation allocates for the
+/// statements it recompiles rather than for the whole trace.
+#[derive(Clone)]
+struct Overlay<T> {
+    base: Arc<Vec<T>>,
+    /// The replaced entries, by position. A mutation replaces a handful of statements, so a
+    /// linear scan is cheaper than hashing.
+    replaced: Vec<(usize, T)>,
+}
+
+impl<T: Clone> Overlay<T> {
+    fn new(base: Vec<T>) -> Self {
+        Overlay {
+            base: Arc::new(base),
+            replaced: Vec::new(),
+        }
+    }
+
+    fn len(&self) -> usize {
+        self.base.len()
+    }
+
+    /// Appends an entry while the trace is compiled, i.e., before it is shared.
+    fn push(&mut self, value: T) {
+        debug_assert!(self.replaced.is_empty());
+        Arc::make_mut(&mut self.base).push(value);
+    }
+
+    /// Replaces the entry at `pos`, in place if the base is not shared.
+    fn set(&mut self, pos: usize, value: T) {
+        if let Some((_, replaced)) = self.replaced.iter_mut().find(|(p, _)| *p == pos) {
+            *replaced = value;
+        } else if let Some(base) = Arc::get_mut(&mut self.base) {
+            base[pos] = value;
+        } else {
+            self.replaced.push((pos, value));
+        }
+    }
+}
+
+impl<T> Index<usize> for Overlay<T> {
+    type Output = T;
+
+    #[inline]
+    fn index(&self, pos: usize) -> &T {
+        if !self.replaced.is_empty() {
+            if let Some((_, value)) = self.replaced.iter().find(|(p, _)| *p == pos) {
+                return value;
+            }
+        }
+        &self.base[pos]
+    }
+}
+
+/// A pool shared by a compiled trace and the mutations compiled from it, to which a mutation
+/// appends its own entries, e.g., the constants of its statements.
+#[derive(Clone)]
+struct Pool<T> {
+    base: Arc<Vec<T>>,
+    appended: Vec<T>,
+}
+
+impl<T> Pool<T> {
+    fn new() -> Self {
+        Pool {
+            base: Arc::new(Vec::new()),
+            appended: Vec::new(),
+        }
+    }
+
+    fn len(&self) -> usize {
+        self.base.len() + self.appended.len()
+    }
+
+    fn push(&mut self, value: T) {
+        match Arc::get_mut(&mut self.base) {
+            Some(base) if self.appended.is_empty() => base.push(value),
+            _ => self.appended.push(value),
+        }
+    }
+
+    fn iter(&self) -> impl Iterator<Item = &T> {
+        self.base.iter().chain(self.appended.iter())
+    }
+}
+
+impl<T> Index<usize> for Pool<T> {
+    type Output = T;
+
+    #[inline]
+    fn index(&self, idx: usize) -> &T {
+        match self.base.get(idx) {
+            Some(value) => value,
+            None => &self.appended[idx - self.base.len()],
+        }
+    }
+}
+
+/// A symbolic trace lowered to straight-line register code.
+///
+/// Every variable that the trace mentions is mapped to a dense slot, and every expression is
+/// flattened into instructions over registers, slots and a pool of pre-normalized constants, so
+/// that emulating the trace on many inputs neither walks the expression trees nor hashes
+/// symbolic names. Statements that cannot be lowered (function calls, arrays, ...) are kept as
+/// they are and emulated with `emulate_symbolic_statement` against the assignment map, which is
+/// synchronized with the slots around each of them.
+///
+/// `CompiledTrace::emulate` produces the same result and the same assignment as
+/// `emulate_symbolic_trace` on the trace it was compiled from.
+///
+/// A mutated trace compiled with `compile_mutation` shares the slots of the original one, which
+/// lets `emulate_incremental` start from the final state of an emulation of the original trace
+/// and re-run only the statements that a mutation can affect.
+///
+/// The per-statement data of a mutated trace is overlaid on that of the original trace, see
+/// `Overlay`, and the maps that a mutation seldom changes are copied on write.
+#[derive(Clone)]
+pub struct CompiledTrace {
+    prime: BigInt,
+    trace: Overlay<SymbolicValueRef>,
+    statements: Overlay<Statement>,
+    /// Slots that the tree emulator may write while re-running the statement at each position.
+    writes: Overlay<Vec<usize>>,
+    /// Slots read by the statement at each position.
+    reads: Overlay<Vec<usize>>,
+    /// Slots assigned by the statement at each position, not counting runtime mutations.
+    assigned: Overlay<Vec<usize>>,
+    /// Slots of the variable operands of a comparison, which a runtime mutation may assign.
+    mutable_operands: Overlay<(Option<usize>, Option<usize>)>,
+    constants: Pool<Value>,
+    names: Pool<SymbolicName>,
+    name2slot: Arc<FxHashMap<SymbolicName, usize>>,
+    num_registers: usize,
+    /// Left-hand sides of the fallback assignments, by position.
+    fallback_assignments: Arc<FxHashMap<usize, SymbolicName>>,
+    /// The slots of each variable and owner, ignoring subscripts, as of the last
+    /// `resolve_fallback_writes`.
+    base2slots: Arc<FxHashMap<SymbolicName, Vec<usize>>>,
+}
+
+/// The final state of an emulation of a `CompiledTrace`, kept to resume emulations of its
+/// mutations with `CompiledTrace::emulate_incremental`.
+pub struct EmulationState {
+    slots: Vec<Option<Value>>,
+    failure_positions: Vec<usize>,
+}
+
+/// Which statements of a mutated trace `CompiledTrace::emulate_incremental` has to consider.
+pub struct IncrementalPlan {
+    start: usize,
+    is_mutated: Vec<bool>,
+    /// Slots assigned by each statement, including runtime mutations.
+    defs: Vec<Vec<usize>>,
+}
+
+/// Side constraints lowered over the slots of a `CompiledTrace` by
+/// `CompiledTrace::compile_constraints`, so that they can be checked on the final state of its
+/// emulations without going back to the assignment map.
+#[derive(Clone)]
+pub struct CompiledConstraints {
+    constraints: Vec<SymbolicValueRef>,
+    truths: Vec<ConstraintTruth>,
+    errors: Vec<ConstraintError>,
+    num_registers: usize,
+}
+
+/// The cost of interpreting a node of a constraint without a compiled form, in instructions.
+const INTERPRETED_NODE_COST: usize = 4;
+
+impl CompiledConstraints {
+    /// Returns the cost of checking each constraint, as the number of instructions that it runs,
+    /// for a `ConstraintScheduler` of the constraints.
+    pub fn costs(&self) -> Vec<usize> {
+        self.truths
+            .iter()
+            .zip(self.constraints.iter())
+            .map(|(truth, constraint)| match truth {
+                ConstraintTruth::Always => 0,
+                ConstraintTruth::Equality { code, .. } | ConstraintTruth::Value { code, .. } => {
+                    code.len() + 1
+                }
+                ConstraintTruth::Fallback => {
+                    size_of_symbolic_value(constraint) * INTERPRETED_NODE_COST
+                }
+            })
+            .collect()
+    }
+}
+
+/// The compiled form of the truth value of a side constraint, as computed by
+/// `evaluate_constraints`.
+#[derive(Clone)]
+enum ConstraintTruth {
+    Always,
+    /// An assignment constraint, which holds when both sides agree modulo the prime.
+    Equality {
+        code: Vec<Instruction>,
+        lhs: Operand,
+        rhs: Operand,
+    },
+    Value {
+        code: Vec<Instruction>,
+        value: Operand,
+    },
+    Fallback,
+}
+
+/// The compiled form of the error of a side constraint, as computed by
+/// `evaluate_error_of_symbolic_value`.
+#[derive(Clone)]
+enum ConstraintError {
+    Constant(BigInt),
+    Equality {
+        code: Vec<Instruction>,
+        lhs: Operand,
+        rhs: Operand,
+    },
+    Comparison {
+        code: Vec<Instruction>,
+        lhs: Operand,
+        rhs: Operand,
+        op: ExpressionInfixOpcode,
+    },
+    Not(Box<ConstraintError>),
+    Fallback,
+}
+
+/// One emulation of a batch.
+struct Lane {
+    machine: Machine,
+    failure_positions: Vec<usize>,
+    /// Slots whose value differs from the original emulation, for incremental emulations.
+    is_changed: Vec<bool>,
+    /// Statements re-run by an incremental emulation.
+    is_rerun: Vec<bool>,
+}
+
+/// Mutable state of one compiled emulation.
+struct Machine {
+    slots: Vec<Option<Value>>,
+    registers: Vec<Option<Value>>,
+    is_dirty: Vec<bool>,
+    dirty_slots: Vec<usize>,
+    /// The decisions taken so far, for emulations that collect coverage.
+    edges: Option<EdgeTrace>,
+}
+
+impl Machine {
+    fn set_slot(&mut self, slot: usize, value: Option<Value>) {
+        self.slots[slot] = value;
+        if !self.is_dirty[slot] {
+            self.is_dirty[slot] = true;
+            self.dirty_slots.push(slot);
+        }
+    }
+
+    fn write_slot(&mut self, slot: usize, value: BigInt) {
+        self.set_slot(slot, Some(Value::Int(value)));
+    }
+}
+
+fn allocate_register(next_register: &mut usize) -> usize {
+    *next_register += 1;
+    *next_register - 1
+}
+
+fn operand_slot(operand: &Operand) -> Option<usize> {
+    match operand {
+        Operand::Slot(slot) => Some(*slot),
+        _ => None,
+    }
+}
+
+fn statement_code(statement: &Statement) -> Option<&Vec<Instruction>> {
+    match statement {
+        Statement::Assign { code, .. }
+        | Statement::Check { code, .. }
+        | Statement::Not { code, .. }
+        | Statement::Truthy { code, .. } => Some(code),
+        _ => None,
+    }
+}
+
+fn is_same_value(a: &Option<Value>, b: &Option<Value>) -> bool {
+    match (a, b) {
+        (None, None) => true,
+        (Some(Value::Int(x)), Some(Value::Int(y))) => x == y,
+        (Some(Value::Bool(x)), Some(Value::Bool(y))) => x == y,
+        _ => false,
+    }
+}
+
+/// Returns whether `value` may evaluate to an array.
+fn contains_array(value: &SymbolicValue) -> bool {
+    match value {
+        SymbolicValue::Array(_) | SymbolicValue::UniformArray(..) | SymbolicValue::Call(..) => true,
+        SymbolicValue::BinaryOp(lhs, _, rhs) | SymbolicValue::AuxBinaryOp(lhs, _, rhs) => {
+            contains_array(lhs) || contains_array(rhs)
+        }
+        SymbolicValue::UnaryOp(_, expr) => contains_array(expr),
+        SymbolicValue::Conditional(cond, then_branch, else_branch) => {
+            contains_array(cond) || contains_array(then_branch) || contains_array(else_branch)
+        }
+        _ => false,
+    }
+}
+
+impl CompiledTrace {
+    /// Compiles `trace` for emulation under the prime modulus `prime`.
+    pub fn compile(prime: &BigInt, trace: &[SymbolicValueRef]) -> Self {
+        let mut compiled = CompiledTrace {
+            prime: prime.clone(),
+            trace: Overlay::new(trace.to_vec()),
+            statements: Overlay::new(Vec::with_capacity(trace.len())),
+            writes: Overlay::new(Vec::with_capacity(trace.len())),
+            reads: Overlay::new(Vec::with_capacity(trace.len())),
+            assigned: Overlay::new(Vec::with_capacity(trace.len())),
+            mutable_operands: Overlay::new(Vec::with_capacity(trace.len())),
+            constants: Pool::new(),
+            names: Pool::new(),
+            name2slot: Arc::new(FxHashMap::default()),
+            num_registers: 0,
+            fallback_assignments: Arc::new(FxHashMap::default()),
+            base2slots: Arc::new(FxHashMap::default()),
+        };
+        for (pos, inst) in trace.iter().enumerate() {
+            compiled.compile_statement(pos, inst);
+        }
+        compiled.resolve_fallback_writes();
+        compiled
+    }
+
+    /// Compiles the mutated trace that replaces the statements of this one at the positions of
+    /// `mutated_statements`, given in increasing order, by recompiling those statements on top
+    /// of this one.
+    ///
+    /// The result keeps the slots of this trace, so that it can resume from an
+    /// `EmulationState` of this trace, and shares everything but the recompiled statements
+    /// with it.
+    pub fn compile_mutation(&self, mutated_statements: &[(usize, SymbolicValueRef)]) -> Self {
+        let mut compiled = self.clone();
+        let num_names = compiled.names.len();
+        let mut replaced_assignments = Vec::with_capacity(mutated_statements.len());
+        for (pos, statement) in mutated_statements {
+            if compiled.fallback_assignments.contains_key(pos) {
+                Arc::make_mut(&mut compiled.fallback_assignments).remove(pos);
+            }
+            replaced_assignments.push((*pos, compiled.assigned[*pos].clone()));
+            compiled.trace.set(*pos, statement.clone());
+            compiled.compile_statement(*pos, statement);
+        }
+        if compiled.names.len() == num_names {
+            // The other fallback assignments still write the same slots.
+            let positions: Vec<usize> = mutated_statements.iter().map(|(pos, _)| *pos).collect();
+            compiled.resolve_fallback_writes_at(&positions);
+        } else {
+            compiled.resolve_fallback_writes();
+        }
+        // Variables that only the original statement assigned keep the value they had before
+        // it, so they are still defined by the mutated one as far as `plan_incremental` goes.
+        for (pos, slots) in replaced_assignments {
+            let mut assigned = compiled.assigned[pos].clone();
+            for slot in slots {
+                if !assigned.contains(&slot) {
+                    assigned.push(slot);
+                }
+            }
+            compiled.assigned.set(pos, assigned);
+        }
+        compiled
+    }
+
+    /// Returns the number of statements that are emulated by the tree emulator.
+    pub fn num_fallback_statements(&self) -> usize {
+        (0..self.statements.len())
+            .filter(|pos| matches!(self.statements[*pos], Statement::Fallback))
+            .count()
+    }
+
+    /// Lowers `constraints` over the slots of this trace, adding slots for the variables that
+    /// only they mention. The result can be evaluated with `is_satisfying` and
+    /// `errors_of_constraints` on the final state of any emulation of this trace, or of a
+    /// mutation compiled from it afterwards.
+    pub fn compile_constraints(&mut self, constraints: &[SymbolicValueRef]) -> CompiledConstraints {
+        let mut num_registers = 0;
+        let mut truths = Vec::with_capacity(constraints.len());
+        let mut errors = Vec::with_capacity(constraints.len());
+        for constraint in constraints {
+            let mut next_register = 0;
+            truths.push(self.compile_constraint_truth(constraint, &mut next_register));
+            num_registers = num_registers.max(next_register);
+            let mut next_register = 0;
+            errors.push(self.compile_constraint_error(constraint, &mut next_register));
+            num_registers = num_registers.max(next_register);
+        }
+        // Fallback assignments may also write the elements of an array that only the
+        // constraints mention.
+        self.resolve_fallback_writes();
+        CompiledConstraints {
+            constraints: constraints.to_vec(),
+            truths,
+            errors,
+            num_registers,
+        }
+    }
+
+    fn slot_of(&mut self, name: &SymbolicName) -> usize {
+        if let Some(slot) = self.name2slot.get(name) {
+            return *slot;
+        }
+        // A mutation seldom mentions a variable that the trace does not.
+        let slot = self.names.len();
+        self.names.push(name.clone());
+        Arc::make_mut(&mut self.name2slot).insert(name.clone(), slot);
+        slot
+    }
+
+    fn constant(&mut self, value: Value) -> Operand {
+        self.constants.push(value);
+        Operand::Const(self.constants.len() - 1)
+    }
+
+    /// Lowers `value` into `code`, allocating registers from `next_register`. Returns `None`
+    /// if the expression contains a construct that has no compiled form.
+    fn compile_expression(
+        &mut self,
+        value: &SymbolicValue,
+        code: &mut Vec<Instruction>,
+        next_register: &mut usize,
+    ) -> Option<Operand> {
+        let operand = match value {
+            SymbolicValue::ConstantInt(v) => self.constant(Value::Int(v.clone())),
+            SymbolicValue::ConstantBool(b) => self.constant(Value::Bool(*b)),
+            SymbolicValue::Variable(sym_name) => Operand::Slot(self.slot_of(sym_name)),
+            SymbolicValue::BinaryOp(lhs, op, rhs) | SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+                let lhs = self.compile_infix_operand(lhs, op, code, next_register)?;
+                let rhs = self.compile_infix_operand(rhs, op, code, next_register)?;
+                let dst = allocate_register(next_register);
+                code.push(Instruction::Infix {
+                    dst,
+                    op: op.clone(),
+                    is_integer_mode: matches!(value, SymbolicValue::AuxBinaryOp(..)),
+                    lhs,
+                    rhs,
+                });
+                Operand::Reg(dst)
+            }
+            SymbolicValue::UnaryOp(op, expr) => {
+                let operand = self.compile_expression(expr, code, next_register)?;
+                let dst = allocate_register(next_register);
+                code.push(Instruction::Prefix {
+                    dst,
+                    op: op.clone(),
+                    operand,
+                });
+                Operand::Reg(dst)
+            }
+            SymbolicValue::Conditional(cond, then_branch, else_branch) => {
+                let cond = self.compile_expression(cond, code, next_register)?;
+                let then_branch = self.compile_expression(then_branch, code, next_register)?;
+                let else_branch = self.compile_expression(else_branch, code, next_register)?;
+                let dst = allocate_register(next_register);
+                code.push(Instruction::Select {
+                    dst,
+                    cond,
+                    then_branch,
+                    else_branch,
+                });
+                Operand::Reg(dst)
+            }
+            _ => return None,
+        };
+        Some(operand)
+    }
+
+    /// Constant operands of an operator are stored already normalized (reduced to a boolean for
+    /// logical operators, shifted into the field if negative otherwise), so that the interpreter
+    /// does not redo it on every input.
+    fn compile_infix_operand(
+        &mut self,
+        value: &SymbolicValue,
+        op: &DebuggableExpressionInfixOpcode,
+        code: &mut Vec<Instruction>,
+        next_register: &mut usize,
+    ) -> Option<Operand> {
+        let normalized = match value {
+            SymbolicValue::ConstantInt(_) | SymbolicValue::ConstantBool(_) => {
+                if is_boolean_infix_op(&op.0) {
+                    normalize_to_bool(value, &self.prime)
+                } else {
+                    normalize_to_int(value, &self.prime)
+                }
+            }
+            _ => return self.compile_expression(value, code, next_register),
+        };
+        self.compile_expression(&normalized, code, next_register)
+    }
+
+    /// Collects the slots of all variables in `value`, as read by the tree emulator.
+    fn collect_variable_slots(&mut self, value: &SymbolicValue, slots: &mut Vec<usize>) {
+        match value {
+            SymbolicValue::Variable(sym_name) => slots.push(self.slot_of(sym_name)),
+            SymbolicValue::Assign(lhs, rhs, _, _)
+            | SymbolicValue::AssignEq(lhs, rhs)
+            | SymbolicValue::AssignTemplParam(lhs, rhs)
+            | SymbolicValue::AssignCall(lhs, rhs, _)
+            | SymbolicValue::BinaryOp(lhs, _, rhs)
+            | SymbolicValue::AuxBinaryOp(lhs, _, rhs)
+            | SymbolicValue::UniformArray(lhs, rhs) => {
+                self.collect_variable_slots(lhs, slots);
+                self.collect_variable_slots(rhs, slots);
+            }
+            SymbolicValue::UnaryOp(_, expr) => self.collect_variable_slots(expr, slots),
+            SymbolicValue::Conditional(cond, then_branch, else_branch) => {
+                self.collect_variable_slots(cond, slots);
+                self.collect_variable_slots(then_branch, slots);
+                self.collect_variable_slots(else_branch, slots);
+            }
+            SymbolicValue::Array(elements) | SymbolicValue::Call(_, elements) => {
+                for elem in elements {
+                    self.collect_variable_slots(elem, slots);
+                }
+            }
+            SymbolicValue::NOP | SymbolicValue::ConstantInt(_) | SymbolicValue::ConstantBool(_) => {
+            }
+        }
+    }
+
+    fn compile_constraint_truth(
+        &mut self,
+        constraint: &SymbolicValue,
+        next_register: &mut usize,
+    ) -> ConstraintTruth {
+        let mut code = Vec::new();
+        match constraint {
+            SymbolicValue::AssignTemplParam(..) => ConstraintTruth::Always,
+            SymbolicValue::Assign(lhs, rhs, _, _)
+            | SymbolicValue::AssignEq(lhs, rhs)
+            | SymbolicValue::AssignCall(lhs, rhs, _) => {
+                let lhs = self.compile_expression(lhs, &mut code, next_register);
+                let rhs = self.compile_expression(rhs, &mut code, next_register);
+                match (lhs, rhs) {
+                    (Some(lhs), Some(rhs)) => ConstraintTruth::Equality { code, lhs, rhs },
+                    _ => ConstraintTruth::Fallback,
+                }
+            }
+            _ => match self.compile_expression(constraint, &mut code, next_register) {
+                Some(value) => ConstraintTruth::Value { code, value },
+                None => ConstraintTruth::Fallback,
+            },
+        }
+    }
+
+    fn compile_constraint_error(
+        &mut self,
+        constraint: &SymbolicValue,
+        next_register: &mut usize,
+    ) -> ConstraintError {
+        let mut code = Vec::new();
+        match constraint {
+            SymbolicValue::NOP | SymbolicValue::AssignTemplParam(..) => {
+                ConstraintError::Constant(BigInt::zero())
+            }
+            SymbolicValue::ConstantBool(b) => {
+                ConstraintError::Constant(if *b { BigInt::zero() } else { BigInt::one() })
+            }
+            SymbolicValue::Assign(lhs, rhs, _, _)
+            | SymbolicValue::AssignEq(lhs, rhs)
+            | SymbolicValue::AssignCall(lhs, rhs, _) => {
+                let lhs = self.compile_expression(lhs, &mut code, next_register);
+                let rhs = self.compile_expression(rhs, &mut code, next_register);
+                match (lhs, rhs) {
+                    (Some(lhs), Some(rhs)) => ConstraintError::Equality { code, lhs, rhs },
+                    _ => ConstraintError::Fallback,
+                }
+            }
+            SymbolicValue::BinaryOp(lhs, op, rhs) | SymbolicValue::AuxBinaryOp(lhs, op, rhs)
+                if matches!(
+                    op.0,
+                    ExpressionInfixOpcode::Lesser
+                        | ExpressionInfixOpcode::Greater
+                        | ExpressionInfixOpcode::LesserEq
+                        | ExpressionInfixOpcode::GreaterEq
+                        | ExpressionInfixOpcode::Eq
+                        | ExpressionInfixOpcode::NotEq
+                ) =>
+            {
+                let lhs = self.compile_expression(lhs, &mut code, next_register);
+                let rhs = self.compile_expression(rhs, &mut code, next_register);
+                match (lhs, rhs) {
+                    (Some(lhs), Some(rhs)) => ConstraintError::Comparison {
+                        code,
+                        lhs,
+                        rhs,
+                        op: op.0.clone(),
+                    },
+                    _ => ConstraintError::Fallback,
+                }
+            }
+            SymbolicValue::UnaryOp(op, expr) if matches!(op.0, ExpressionPrefixOpcode::BoolNot) => {
+                ConstraintError::Not(Box::new(self.compile_constraint_error(expr, next_register)))
+            }
+            _ => ConstraintError::Fallback,
+        }
+    }
+
+    fn compile_statement(&mut self, pos: usize, inst: &SymbolicValue) {
+        let mut code = Vec::new();
+        let mut next_register = 0;
+        let mut writes = Vec::new();
+        let mut reads = Vec::new();
+        let mut assigned = Vec::new();
+        let mut mutable_operands = (None, None);
+
+        let statement = match inst {
+            SymbolicValue::NOP | SymbolicValue::ConstantBool(true) => Statement::Nop,
+            SymbolicValue::ConstantBool(false) => Statement::Fail,
+            SymbolicValue::Assign(lhs, rhs, _, _)
+            | SymbolicValue::AssignEq(lhs, rhs)
+            | SymbolicValue::AssignTemplParam(lhs, rhs)
+            | SymbolicValue::AssignCall(lhs, rhs, _) => {
+                if let SymbolicValue::Variable(sym_name) = lhs.as_ref() {
+                    let target = self.slot_of(sym_name);
+                    writes.push(target);
+                    assigned.push(target);
+                    match self.compile_expression(rhs, &mut code, &mut next_register) {
+                        Some(value) => Statement::Assign {
+                            code,
+                            value,
+                            target,
+                        },
+                        None => {
+                            self.collect_variable_slots(rhs, &mut reads);
+                            Arc::make_mut(&mut self.fallback_assignments)
+                                .insert(pos, sym_name.clone());
+                            Statement::Fallback
+                        }
+                    }
+                } else {
+                    self.collect_variable_slots(inst, &mut reads);
+                    Statement::Fallback
+                }
+            }
+            SymbolicValue::BinaryOp(lhs, op, rhs) | SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+                let lhs_slot = match lhs.as_ref() {
+                    SymbolicValue::Variable(sym_name) => Some(self.slot_of(sym_name)),
+                    _ => None,
+                };
+                let rhs_slot = match rhs.as_ref() {
+                    SymbolicValue::Variable(sym_name) => Some(self.slot_of(sym_name)),
+                    _ => None,
+                };
+                writes.extend(lhs_slot.iter().chain(rhs_slot.iter()));
+                mutable_operands = (lhs_slot, rhs_slot);
+
+                let compiled_lhs = self.compile_expression(lhs, &mut code, &mut next_register);
+                let compiled_rhs = self.compile_expression(rhs, &mut code, &mut next_register);
+                match (compiled_lhs, compiled_rhs) {
+                    (Some(lhs), Some(rhs)) => Statement::Check {
+                        code,
+                        lhs,
+                        rhs,
+                        op: op.clone(),
+                        is_integer_mode: matches!(inst, SymbolicValue::AuxBinaryOp(..)),
+                        lhs_slot,
+                        rhs_slot,
+                    },
+                    _ => {
+                        self.collect_variable_slots(inst, &mut reads);
+                        Statement::Fallback
+                    }
+                }
+            }
+            SymbolicValue::UnaryOp(op, expr) if matches!(op.0, ExpressionPrefixOpcode::BoolNot) => {
+                match self.compile_expression(expr, &mut code, &mut next_register) {
+                    Some(value) => Statement::Not { code, value },
+                    None => {
+                        self.collect_variable_slots(inst, &mut reads);
+                        Statement::Fallback
+                    }
+                }
+            }
+            SymbolicValue::UnaryOp(..) => {
+                self.collect_variable_slots(inst, &mut reads);
+                Statement::Fallback
+            }
+            _ => match self.compile_expression(inst, &mut code, &mut next_register) {
+                Some(value) => Statement::Truthy { code, value },
+                None => {
+                    self.collect_variable_slots(inst, &mut reads);
+                    Statement::Fallback
+                }
+            },
+        };
+
+        if let Some(code) = statement_code(&statement) {
+            for instruction in code {
+                match instruction {
+                    Instruction::Infix { lhs, rhs, .. } => {
+                        reads.extend(operand_slot(lhs).iter().chain(operand_slot(rhs).iter()))
+                    }
+                    Instruction::Prefix { operand, .. } => reads.extend(operand_slot(operand)),
+                    Instruction::Select {
+                        cond,
+                        then_branch,
+                        else_branch,
+                        ..
+                    } => reads.extend(
+                        [cond, then_branch, else_branch]
+                            .iter()
+                            .filter_map(|operand| operand_slot(operand)),
+                    ),
+                }
+            }
+        }
+        match &statement {
+            Statement::Assign { value, .. }
+            | Statement::Not { value, .. }
+            | Statement::Truthy { value, .. } => reads.extend(operand_slot(value)),
+            Statement::Check { lhs, rhs, .. } => {
+                reads.extend(operand_slot(lhs).iter().chain(operand_slot(rhs).iter()))
+            }
+            _ => {}
+        }
+        reads.sort_unstable();
+        reads.dedup();
+
+        self.num_registers = self.num_registers.max(next_register);
+        if pos == self.statements.len() {
+            self.statements.push(statement);
+            self.writes.push(writes);
+            self.reads.push(reads);
+            self.assigned.push(assigned);
+            self.mutable_operands.push(mutable_operands);
+        } else {
+            self.statements.set(pos, statement);
+            self.writes.set(pos, writes);
+            self.reads.set(pos, reads);
+            self.assigned.set(pos, assigned);
+            self.mutable_operands.set(pos, mutable_operands);
+        }
+    }
+
+    /// A fallback assignment may store an array into the elements of its left-hand side, so it
+    /// writes every slot that shares the variable and owner of that left-hand side.
+    fn resolve_fallback_writes(&mut self) {
+        let mut base2slots: FxHashMap<SymbolicName, Vec<usize>> = FxHashMap::default();
+        for (slot, name) in self.names.iter().enumerate() {
+            base2slots
+                .entry(SymbolicName::new(name.id, name.owner.clone(), None))
+                .or_default()
+                .push(slot);
+        }
+        self.base2slots = Arc::new(base2slots);
+        let positions: Vec<usize> = self.fallback_assignments.keys().copied().collect();
+        self.resolve_fallback_writes_at(&positions);
+    }
+
+    /// Resolves the writes of the fallback assignments at `positions`, with the slots computed
+    /// by the last `resolve_fallback_writes`.
+    fn resolve_fallback_writes_at(&mut self, positions: &[usize]) {
+        for pos in positions {
+            let sym_name = match self.fallback_assignments.get(pos) {
+                Some(sym_name) => sym_name,
+                None => continue,
+            };
+            let base = SymbolicName::new(sym_name.id, sym_name.owner.clone(), None);
+            if let Some(slots) = self.base2slots.get(&base) {
+                let slots = slots.clone();
+                if let SymbolicValue::Assign(_, rhs, _, _)
+                | SymbolicValue::AssignEq(_, rhs)
+                | SymbolicValue::AssignTemplParam(_, rhs)
+                | SymbolicValue::AssignCall(_, rhs, _) = self.trace[*pos].as_ref()
+                {
+                    if contains_array(rhs) {
+                        self.assigned.set(*pos, slots.clone());
+                    }
+                }
+                self.writes.set(*pos, slots);
+            }
+        }
+    }
+
+    /// Emulates the compiled trace. See `emulate_symbolic_trace` for the meaning of the
+    /// parameters and of the returned value.
+    pub fn emulate(
+        &self,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Option<(bool, usize)> {
+        self.emulate_with_state(runtime_mutable_positions, assignment, symbolic_library)
+            .map(|(success, failure_pos, _)| (success, failure_pos))
+    }
+
+    /// Emulates the compiled trace like `emulate`, and also returns its final state.
+    pub fn emulate_with_state(
+        &self,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Option<(bool, usize, EmulationState)> {
+        self.emulate_batch(
+            runtime_mutable_positions,
+            slice::from_mut(assignment),
+            symbolic_library,
+        )
+        .pop()
+        .unwrap()
+    }
+
+    /// Emulates the compiled trace like `emulate_with_state` on each of `assignments`.
+    ///
+    /// The trace is walked once, and every statement is run on all the lanes, one per
+    /// assignment, before the next one, so that the statements and their code are fetched once
+    /// for the whole batch. A lane whose emulation is aborted (e.g., by an out-of-range
+    /// subscript) is masked off for the remaining statements, and its result is `None`.
+    pub fn emulate_batch(
+        &self,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        assignments: &mut [FxHashMap<SymbolicName, BigInt>],
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Vec<Option<(bool, usize, EmulationState)>> {
+        let mut lanes: Vec<_> = assignments
+            .iter()
+            .map(|assignment| {
+                Some(Lane {
+                    machine: self.start_machine(Vec::new(), assignment),
+                    failure_positions: Vec::new(),
+                    is_changed: Vec::new(),
+                    is_rerun: Vec::new(),
+                })
+            })
+            .collect();
+
+        let mut num_steps = 0;
+        for pos in 0..self.statements.len() {
+            for (lane, assignment) in lanes.iter_mut().zip(assignments.iter_mut()) {
+                if let Some(active) = lane {
+                    num_steps += 1;
+                    if !self.step_lane(
+                        pos,
+                        runtime_mutable_positions,
+                        active,
+                        assignment,
+                        symbolic_library,
+                    ) {
+                        *lane = None;
+                    }
+                }
+            }
+        }
+        metrics::add(Counter::Emulations, lanes.len() as u64);
+        metrics::add(Counter::Statements, num_steps);
+
+        lanes
+            .into_iter()
+            .zip(assignments.iter_mut())
+            .map(|(lane, assignment)| lane.map(|lane| self.finish_lane(lane, None, assignment)))
+            .collect()
+    }
+
+    /// Emulates the compiled trace like `emulate`, and records into `edges`, which is cleared
+    /// first, the branch taken by every conditional expression and the outcome of every
+    /// comparison and constraint, followed by the outcome of the whole emulation.
+    pub fn emulate_with_coverage(
+        &self,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+        edges: &mut EdgeTrace,
+    ) -> Option<(bool, usize)> {
+        let mut lane = Lane {
+            machine: self.start_machine(Vec::new(), assignment),
+            failure_positions: Vec::new(),
+            is_changed: Vec::new(),
+            is_rerun: Vec::new(),
+        };
+        edges.clear();
+        lane.machine.edges = Some(mem::take(edges));
+
+        let mut num_steps = 0;
+        let mut is_aborted = false;
+        for pos in 0..self.statements.len() {
+            num_steps += 1;
+            if !self.step_lane(
+                pos,
+                runtime_mutable_positions,
+                &mut lane,
+                assignment,
+                symbolic_library,
+            ) {
+                is_aborted = true;
+                break;
+            }
+        }
+        metrics::add(Counter::Emulations, 1);
+        metrics::add(Counter::Statements, num_steps);
+
+        *edges = lane.machine.edges.take().unwrap();
+        let result = if is_aborted {
+            None
+        } else {
+            let (is_success, failure_pos, _) = self.finish_lane(lane, None, assignment);
+            Some((is_success, failure_pos))
+        };
+        edges.hit(decision_location(
+            self.statements.len(),
+            0,
+            result.map_or(false, |(is_success, _)| is_success),
+        ));
+        result
+    }
+
+    /// Decides whether the mutated trace, compiled with `compile_mutation`, can be emulated
+    /// incrementally, and returns the plan to do so.
+    ///
+    /// Incremental emulation reads variables from the final state of the original emulation,
+    /// so it requires that the value a statement reads is the final one: every variable that
+    /// is assigned at or after the first mutated position is assigned at most once, and no
+    /// statement reads a variable before all of its assignments. Returns `None` otherwise.
+    pub fn plan_incremental(
+        &self,
+        mutated_positions: &[usize],
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+    ) -> Option<IncrementalPlan> {
+        let start = *mutated_positions.iter().min()?;
+
+        let defs: Vec<Vec<usize>> = (0..self.statements.len())
+            .map(|pos| {
+                let mut defs = self.assigned[pos].clone();
+                match (
+                    runtime_mutable_positions.get(&pos),
+                    self.mutable_operands[pos],
+                ) {
+                    (Some(Direction::Left), (Some(slot), _))
+                    | (Some(Direction::Right), (_, Some(slot))) => defs.push(slot),
+                    _ => {}
+                }
+                defs
+            })
+            .collect();
+
+        let mut num_defs = vec![0_usize; self.names.len()];
+        let mut last_def = vec![0_usize; self.names.len()];
+        for (pos, slots) in defs.iter().enumerate() {
+            for slot in slots {
+                num_defs[*slot] += 1;
+                last_def[*slot] = pos;
+            }
+        }
+        for pos in start..self.statements.len() {
+            if defs[pos].iter().any(|slot| num_defs[*slot] > 1) {
+                return None;
+            }
+            if self.reads[pos]
+                .iter()
+                .any(|slot| num_defs[*slot] > 0 && last_def[*slot] > pos)
+            {
+                return None;
+            }
+        }
+
+        let mut is_mutated = vec![false; self.statements.len()];
+        for pos in mutated_positions {
+            is_mutated[*pos] = true;
+        }
+        Some(IncrementalPlan {
+            start,
+            is_mutated,
+            defs,
+        })
+    }
+
+    /// Emulates the mutated trace, starting from the final state of an emulation of the trace
+    /// it was compiled from with `compile_mutation`.
+    ///
+    /// # Parameters
+    /// - `plan`: The plan returned by `plan_incremental` for the same mutation.
+    /// - `original`: The final state of the emulation of the original trace on `input`.
+    /// - `input`: The input assignment that the original trace was emulated on.
+    /// - `runtime_mutable_positions`: A map of runtime mutable positions.
+    /// - `assignment`: The final assignment of the emulation of the original trace. It is
+    ///   updated into the final assignment of the mutated trace.
+    /// - `symbolic_library`: A mutable reference to the symbolic library.
+    ///
+    /// # Returns
+    /// The same as `emulate` on the mutated trace and `input`. Statements before the first
+    /// mutated position, and later ones whose inputs are unchanged, are not re-run.
+    pub fn emulate_incremental(
+        &self,
+        plan: &IncrementalPlan,
+        original: &EmulationState,
+        input: &FxHashMap<SymbolicName, BigInt>,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Option<(bool, usize)> {
+        self.emulate_incremental_with_state(
+            plan,
+            original,
+            input,
+            runtime_mutable_positions,
+            assignment,
+            symbolic_library,
+        )
+        .map(|(success, failure_pos, _)| (success, failure_pos))
+    }
+
+    /// Emulates the mutated trace like `emulate_incremental`, and also returns its final state.
+    pub fn emulate_incremental_with_state(
+        &self,
+        plan: &IncrementalPlan,
+        original: &EmulationState,
+        input: &FxHashMap<SymbolicName, BigInt>,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Option<(bool, usize, EmulationState)> {
+        self.emulate_incremental_batch(
+            plan,
+            &[original],
+            &[input],
+            runtime_mutable_positions,
+            slice::from_mut(assignment),
+            symbolic_library,
+        )
+        .pop()
+        .unwrap()
+    }
+
+    /// Emulates the mutated trace like `emulate_incremental_with_state` on each lane, given
+    /// by the same index in `originals`, `inputs`, and `assignments`, in lockstep as
+    /// `emulate_batch` does.
+    pub fn emulate_incremental_batch(
+        &self,
+        plan: &IncrementalPlan,
+        originals: &[&EmulationState],
+        inputs: &[&FxHashMap<SymbolicName, BigInt>],
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        assignments: &mut [FxHashMap<SymbolicName, BigInt>],
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Vec<Option<(bool, usize, EmulationState)>> {
+        let mut lanes: Vec<_> = originals
+            .iter()
+            .zip(assignments.iter())
+            .map(|(original, assignment)| {
+                Some(Lane {
+                    machine: self.start_machine(original.slots.clone(), assignment),
+                    failure_positions: Vec::new(),
+                    is_changed: vec![false; self.names.len()],
+                    is_rerun: vec![false; self.statements.len()],
+                })
+            })
+            .collect();
+
+        let mut num_steps = 0;
+        for pos in plan.start..self.statements.len() {
+            for (((lane, original), input), assignment) in lanes
+                .iter_mut()
+                .zip(originals.iter())
+                .zip(inputs.iter())
+                .zip(assignments.iter_mut())
+            {
+                let active = match lane {
+                    Some(active) => active,
+                    None => continue,
+                };
+                if !plan.is_mutated[pos]
+                    && !self.reads[pos].iter().any(|slot| active.is_changed[*slot])
+                {
+                    continue;
+                }
+                active.is_rerun[pos] = true;
+
+                // Put back the values that the assigned variables had before this statement.
+                for slot in &plan.defs[pos] {
+                    let value = input.get(&self.names[*slot]).map(|v| Value::Int(v.clone()));
+                    active.machine.set_slot(*slot, value);
+                }
+                num_steps += 1;
+                if !self.step_lane(
+                    pos,
+                    runtime_mutable_positions,
+                    active,
+                    assignment,
+                    symbolic_library,
+                ) {
+                    *lane = None;
+                    continue;
+                }
+                for slot in &plan.defs[pos] {
+                    if *slot >= original.slots.len()
+                        || !is_same_value(&active.machine.slots[*slot], &original.slots[*slot])
+                    {
+                        active.is_changed[*slot] = true;
+                    }
+                }
+            }
+        }
+        metrics::add(Counter::Emulations, lanes.len() as u64);
+        metrics::add(Counter::Statements, num_steps);
+
+        lanes
+            .into_iter()
+            .zip(originals.iter())
+            .zip(assignments.iter_mut())
+            .map(|((lane, original), assignment)| {
+                lane.map(|lane| self.finish_lane(lane, Some(*original), assignment))
+            })
+            .collect()
+    }
+
+    /// Creates the machine of a lane, whose slots start from `slots` and, past them, from
+    /// `assignment`.
+    fn start_machine(
+        &self,
+        mut slots: Vec<Option<Value>>,
+        assignment: &FxHashMap<SymbolicName, BigInt>,
+    ) -> Machine {
+        slots.extend(
+            self.names
+                .iter()
+                .skip(slots.len())
+                .map(|name| assignment.get(name).map(|v| Value::Int(v.clone()))),
+        );
+        Machine {
+            slots,
+            registers: vec![None; self.num_registers],
+            is_dirty: vec![false; self.names.len()],
+            dirty_slots: Vec::new(),
+            edges: None,
+        }
+    }
+
+    /// Emulates the statement at `pos` on a lane. Returns `false` if the emulation of the lane
+    /// is aborted, in which case its assignment has been synchronized.
+    fn step_lane(
+        &self,
+        pos: usize,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        lane: &mut Lane,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> bool {
+        match self.step(
+            pos,
+            runtime_mutable_positions,
+            &mut lane.machine,
+            assignment,
+            symbolic_library,
+        ) {
+            Some(true) => true,
+            Some(false) => {
+                lane.failure_positions.push(pos);
+                true
+            }
+            None => {
+                self.flush(&mut lane.machine, assignment);
+                false
+            }
+        }
+    }
+
+    /// Synchronizes the assignment of a lane that ran to the end, and returns its result. The
+    /// failures of an incremental emulation include those of the statements of `original` that
+    /// it did not re-run.
+    fn finish_lane(
+        &self,
+        mut lane: Lane,
+        original: Option<&EmulationState>,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+    ) -> (bool, usize, EmulationState) {
+        self.flush(&mut lane.machine, assignment);
+        let mut failure_positions = lane.failure_positions;
+        if let Some(original) = original {
+            failure_positions.extend(
+                original
+                    .failure_positions
+                    .iter()
+                    .filter(|pos| !lane.is_rerun[**pos]),
+            );
+            failure_positions.sort_unstable();
+        }
+        (
+            failure_positions.is_empty(),
+            failure_positions.last().copied().unwrap_or(0),
+            EmulationState {
+                slots: lane.machine.slots,
+                failure_positions,
+            },
+        )
+    }
+
+    /// Returns whether the final state of an emulation satisfies all the constraints, which
+    /// is the same as `evaluate_constraints` on the final assignment of that emulation.
+    ///
+    /// # Parameters
+    /// - `constraints`: Constraints compiled with `compile_constraints` on this trace, or on
+    ///   the trace that this one is a mutation of.
+    /// - `state`: The final state of an emulation of this trace.
+    /// - `assignment`: The final assignment of the same emulation, against which constraints
+    ///   without a compiled form are evaluated.
+    /// - `symbolic_library`: A mutable reference to the symbolic library.
+    /// - `scheduler`: The scheduler of `constraints`, built from `CompiledConstraints::costs`,
+    ///   which decides the order of the checks and stops at the first violated constraint.
+    pub fn is_satisfying(
+        &self,
+        constraints: &CompiledConstraints,
+        state: &EmulationState,
+        assignment: &FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+        scheduler: &mut ConstraintScheduler,
+    ) -> bool {
+        let mut registers = vec![None; constraints.num_registers];
+        scheduler.all(|i| {
+            match self.evaluate_truth(&constraints.truths[i], &state.slots, &mut registers) {
+                Ok(flag) => flag,
+                Err(Deopt) => evaluate_constraints(
+                    &self.prime,
+                    slice::from_ref(&constraints.constraints[i]),
+                    assignment,
+                    symbolic_library,
+                ),
+            }
+        })
+    }
+
+    /// Returns the error of each constraint on the final state of an emulation, which is the
+    /// same as `evaluate_error_of_symbolic_value` on the final assignment of that emulation.
+    /// See `is_satisfying` for the parameters.
+    pub fn errors_of_constraints(
+        &self,
+        constraints: &CompiledConstraints,
+        state: &EmulationState,
+        assignment: &FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Vec<BigInt> {
+        let mut registers = vec![None; constraints.num_registers];
+        constraints
+            .errors
+            .iter()
+            .zip(constraints.constraints.iter())
+            .map(|(error, constraint)| {
+                match self.evaluate_error(error, &state.slots, &mut registers) {
+                    Ok(error) => error,
+                    Err(Deopt) => evaluate_error_of_symbolic_value(
+                        &self.prime,
+                        constraint,
+                        assignment,
+                        symbolic_library,
+                    ),
+                }
+            })
+            .collect()
+    }
+
+    fn evaluate_truth(
+        &self,
+        truth: &ConstraintTruth,
+        slots: &[Option<Value>],
+        registers: &mut [Option<Value>],
+    ) -> Result<bool, Deopt> {
+        match truth {
+            ConstraintTruth::Always => Ok(true),
+            ConstraintTruth::Equality { code, lhs, rhs } => {
+                self.run(code, slots, registers)?;
+                match (
+                    self.read(*lhs, slots, registers),
+                    self.read(*rhs, slots, registers),
+                ) {
+                    (Some(Value::Int(lv)), Some(Value::Int(rv))) => {
+                        Ok(lv % &self.prime == rv % &self.prime)
+                    }
+                    (Some(Value::Int(lv)), Some(Value::Bool(rv))) => {
+                        Ok(lv % &self.prime == bool_to_int(*rv))
+                    }
+                    _ => Err(Deopt),
+                }
+            }
+            ConstraintTruth::Value { code, value } => {
+                self.run(code, slots, registers)?;
+                match self.read(*value, slots, registers) {
+                    Some(Value::Bool(b)) => Ok(*b),
+                    _ => Err(Deopt),
+                }
+            }
+            ConstraintTruth::Fallback => Err(Deopt),
+        }
+    }
+
+    fn evaluate_error(
+        &self,
+        error: &ConstraintError,
+        slots: &[Option<Value>],
+        registers: &mut [Option<Value>],
+    ) -> Result<BigInt, Deopt> {
+        let prime = &self.prime;
+        match error {
+            ConstraintError::Constant(error) => Ok(error.clone()),
+            ConstraintError::Equality { code, lhs, rhs } => {
+                self.run(code, slots, registers)?;
+                match (
+                    self.read(*lhs, slots, registers),
+                    self.read(*rhs, slots, registers),
+                ) {
+                    (Some(Value::Int(lv)), Some(Value::Int(rv))) => {
+                        Ok((lv % prime - rv % prime).abs())
+                    }
+                    (Some(Value::Int(lv)), Some(Value::Bool(flag))) => {
+                        Ok((lv % prime - bool_to_int(*flag)).abs())
+                    }
+                    (Some(Value::Bool(flag)), Some(Value::Int(rv))) => {
+                        Ok((rv % prime - bool_to_int(*flag)).abs())
+                    }
+                    (Some(Value::Bool(lflag)), Some(Value::Bool(rflag))) => {
+                        Ok(bool_to_int(lflag != rflag))
+                    }
+                    _ => Err(Deopt),
+                }
+            }
+            ConstraintError::Comparison { code, lhs, rhs, op } => {
+                self.run(code, slots, registers)?;
+                let (lv, rv) = match (
+                    self.read(*lhs, slots, registers),
+                    self.read(*rhs, slots, registers),
+                ) {
+                    (Some(Value::Int(lv)), Some(Value::Int(rv))) => (lv % prime, rv % prime),
+                    _ => return Err(Deopt),
+                };
+                match op {
+                    ExpressionInfixOpcode::Lesser => Ok(lv + BigInt::one() - rv),
+                    ExpressionInfixOpcode::Greater => Ok(rv + BigInt::one() - lv),
+                    ExpressionInfixOpcode::LesserEq => Ok(lv - rv),
+                    ExpressionInfixOpcode::GreaterEq => Ok(rv - lv),
+                    ExpressionInfixOpcode::Eq => Ok((lv - rv).abs()),
+                    ExpressionInfixOpcode::NotEq => Ok(bool_to_int(lv == rv)),
+                    _ => Err(Deopt),
+                }
+            }
+            ConstraintError::Not(inner) => {
+                let error = self.evaluate_error(inner, slots, registers)?;
+                if error.is_zero() {
+                    Ok(BigInt::one())
+                } else {
+                    Ok(-error)
+                }
+            }
+            ConstraintError::Fallback => Err(Deopt),
+        }
+    }
+
+    /// Emulates the statement at `pos`, with the tree emulator if needed.
+    fn step(
+        &self,
+        pos: usize,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        machine: &mut Machine,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Option<bool> {
+        let flag = match self.execute_statement(pos, runtime_mutable_positions, machine) {
+            Ok(flag) => flag,
+            Err(Deopt) => self.emulate_in_tree(
+                pos,
+                runtime_mutable_positions,
+                machine,
+                assignment,
+                symbolic_library,
+            ),
+        };
+        if let (Some(edges), Some(flag)) = (&mut machine.edges, flag) {
+            if !matches!(
+                self.statements[pos],
+                Statement::Nop | Statement::Assign { .. }
+            ) {
+                edges.hit(decision_location(pos, 0, flag));
+            }
+        }
+        flag
+    }
+
+    /// Writes back the slots updated since the last synchronization.
+    fn flush(&self, machine: &mut Machine, assignment: &mut FxHashMap<SymbolicName, BigInt>) {
+        for slot in machine.dirty_slots.drain(..) {
+            machine.is_dirty[slot] = false;
+            match &machine.slots[slot] {
+                Some(Value::Int(v)) => {
+                    assignment.insert(self.names[slot].clone(), v.clone());
+                }
+                Some(Value::Bool(_)) => {}
+                None => {
+                    assignment.remove(&self.names[slot]);
+                }
+            }
+        }
+    }
+
+    fn emulate_in_tree(
+        &self,
+        pos: usize,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        machine: &mut Machine,
+        assignment: &mut FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Option<bool> {
+        self.flush(machine, assignment);
+        let flag = emulate_symbolic_statement(
+            &self.prime,
+            pos,
+            &self.trace[pos],
+            runtime_mutable_positions,
+            assignment,
+            symbolic_library,
+        );
+        for slot in &self.writes[pos] {
+            machine.slots[*slot] = assignment
+                .get(&self.names[*slot])
+                .map(|v| Value::Int(v.clone()));
+        }
+        flag
+    }
+
+    /// Executes the statement at `pos`. A statement either completes, or bails out with `Deopt`
+    /// before modifying any slot, so that it can be re-run from the same state.
+    fn execute_statement(
+        &self,
+        pos: usize,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        machine: &mut Machine,
+    ) -> Result<Option<bool>, Deopt> {
+        match &self.statements[pos] {
+            Statement::Nop => Ok(Some(true)),
+            Statement::Fail => Ok(Some(false)),
+            Statement::Assign {
+                code,
+                value,
+                target,
+            } => {
+                self.run_statement_code(pos, code, machine)?;
+                let num = match self.read(*value, &machine.slots, &machine.registers) {
+                    Some(Value::Int(v)) => v.clone(),
+                    Some(Value::Bool(b)) => {
+                        if *b {
+                            BigInt::one()
+                        } else {
+                            BigInt::zero()
+                        }
+                    }
+                    None => return Ok(None),
+                };
+                if let (Some(edges), Some(Value::Bool(b))) = (
+                    &mut machine.edges,
+                    self.read(*value, &machine.slots, &machine.registers),
+                ) {
+                    edges.hit(decision_location(pos, 0, *b));
+                }
+                machine.write_slot(*target, num);
+                Ok(Some(true))
+            }
+            Statement::Check {
+                code,
+                lhs,
+                rhs,
+                op,
+                is_integer_mode,
+                lhs_slot,
+                rhs_slot,
+            } => {
+                self.run_statement_code(pos, code, machine)?;
+                let mut lhs_val = self.read(*lhs, &machine.slots, &machine.registers);
+                let mut rhs_val = self.read(*rhs, &machine.slots, &machine.registers);
+
+                let mut mutated = None;
+                match (runtime_mutable_positions.get(&pos), lhs_slot, rhs_slot) {
+                    (Some(Direction::Left), Some(slot), _) => {
+                        if let Some(Value::Int(num)) = rhs_val {
+                            mutated = Some((*slot, num));
+                            lhs_val = rhs_val;
+                        }
+                    }
+                    (Some(Direction::Right), _, Some(slot)) => {
+                        if let Some(Value::Int(num)) = lhs_val {
+                            mutated = Some((*slot, num));
+                            rhs_val = lhs_val;
+                        }
+                    }
+                    _ => {}
+                }
+
+                let flag = match apply_infix(
+                    &self.prime,
+                    op,
+                    *is_integer_mode,
+                    lhs_val.ok_or(Deopt)?,
+                    rhs_val.ok_or(Deopt)?,
+                )? {
+                    Value::Bool(b) => b,
+                    Value::Int(_) => return Err(Deopt),
+                };
+                if let Some((slot, num)) = mutated {
+                    let num = num.clone();
+                    machine.write_slot(slot, num);
+                }
+                Ok(Some(flag))
+            }
+            Statement::Not { code, value } => {
+                self.run_statement_code(pos, code, machine)?;
+                match self.read(*value, &machine.slots, &machine.registers) {
+                    Some(Value::Bool(b)) => Ok(Some(!b)),
+                    _ => Err(Deopt),
+                }
+            }
+            Statement::Truthy { code, value } => {
+                self.run_statement_code(pos, code, machine)?;
+                match self.read(*value, &machine.slots, &machine.registers) {
+                    Some(Value::Bool(b)) => Ok(Some(*b)),
+                    Some(Value::Int(v)) => Ok(Some(!v.is_zero())),
+                    None => Err(Deopt),
+                }
+            }
+            Statement::Fallback => Err(Deopt),
+        }
+    }
+
+    fn read<'a>(
+        &'a self,
+        operand: Operand,
+        slots: &'a [Option<Value>],
+        registers: &'a [Option<Value>],
+    ) -> Option<&'a Value> {
+        match operand {
+            Operand::Const(idx) => Some(&self.constants[idx]),
+            Operand::Slot(slot) => slots[slot].as_ref(),
+            Operand::Reg(reg) => registers[reg].as_ref(),
+        }
+    }
+
+    /// Runs the instructions of the statement at `pos` on a machine, and records the branches
+    /// taken by its conditional expressions if the machine collects coverage.
+    fn run_statement_code(
+        &self,
+        pos: usize,
+        code: &[Instruction],
+        machine: &mut Machine,
+    ) -> Result<(), Deopt> {
+        self.run(code, &machine.slots, &mut machine.registers)?;
+        if let Some(edges) = &mut machine.edges {
+            // Registers are written once per statement, so the conditions are still there.
+            for (site, instruction) in code.iter().enumerate() {
+                if let Instruction::Select { cond, .. } = instruction {
+                    let is_then = match self.read(*cond, &machine.slots, &machine.registers) {
+                        Some(Value::Bool(b)) => *b,
+                        Some(Value::Int(num)) => num.is_positive(),
+                        None => continue,
+                    };
+                    edges.hit(decision_location(pos, site + 1, is_then));
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Runs the instructions of a statement. A missing variable propagates as `None` through
+    /// the registers, like `evaluate_symbolic_value` does.
+    fn run(
+        &self,
+        code: &[Instruction],
+        slots: &[Option<Value>],
+        registers: &mut [Option<Value>],
+    ) -> Result<(), Deopt> {
+        for instruction in code {
+            let (dst, result) = match instruction {
+                Instruction::Infix {
+                    dst,
+                    op,
+                    is_integer_mode,
+                    lhs,
+                    rhs,
+                } => {
+                    let result = match (
+                        self.read(*lhs, slots, registers),
+                        self.read(*rhs, slots, registers),
+                    ) {
+                        (Some(lv), Some(rv)) => {
+                            Some(apply_infix(&self.prime, op, *is_integer_mode, lv, rv)?)
+                        }
+                        _ => None,
+                    };
+                    (*dst, result)
+                }
+                Instruction::Prefix { dst, op, operand } => {
+                    let result = match (&op.0, self.read(*operand, slots, registers)) {
+                        (_, None) => None,
+                        (ExpressionPrefixOpcode::Sub, Some(Value::Int(v))) => {
+                            Some(Value::Int(-1 * v))
+                        }
+                        (ExpressionPrefixOpcode::BoolNot, Some(Value::Bool(b))) => {
+                            Some(Value::Bool(!b))
+                        }
+                        _ => return Err(Deopt),
+                    };
+                    (*dst, result)
+                }
+                Instruction::Select {
+                    dst,
+                    cond,
+                    then_branch,
+                    else_branch,
+                } => {
+                    let is_then = match self.read(*cond, slots, registers) {
+                        Some(Value::Bool(b)) => Some(*b),
+                        Some(Value::Int(num)) => Some(num.is_positive()),
+                        None => None,
+                    };
+                    let result = match is_then {
+                        Some(true) => self.read(*then_branch, slots, registers).cloned(),
+                        Some(false) => self.read(*else_branch, slots, registers).cloned(),
+                        None => None,
+                    };
+                    (*dst, result)
+                }
+            };
+            registers[dst] = result;
+        }
+        Ok(())
+    }
+}
+
+/// Applies a binary operator to two concrete values, normalizing them the same way as
+/// `evaluate_binary_op` does.
+fn apply_infix(
+    prime: &BigInt,
+    op: &DebuggableExpressionInfixOpcode,
+    is_integer_mode: bool,
+    lhs: &Value,
+    rhs: &Value,
+) -> Result<Value, Deopt> {
+    let result = if is_boolean_infix_op(&op.0) {
+        evaluate_binary_op_of_booleans(to_bool(lhs, prime), to_bool(rhs, prime), op)
+    } else {
+        evaluate_binary_op_of_integers(
+            &to_int(lhs, prime),
+            &to_int(rhs, prime),
+            prime,
+            op,
+            is_integer_mode,
+        )
+    };
+    match result {
+        SymbolicValue::ConstantInt(v) => Ok(Value::Int(v)),
+        SymbolicValue::ConstantBool(b) => Ok(Value::Bool(b)),
+        _ => Err(Deopt),
+    }
+}
+
+fn to_int<'a>(value: &'a Value, prime: &BigInt) -> Cow<'a, BigInt> {
+    match value {
+        Value::Int(v) if v.is_negative() => Cow::Owned(v + prime),
+        Value::Int(v) => Cow::Borrowed(v),
+        Value::Bool(true) => Cow::Owned(BigInt::one()),
+        Value::Bool(false) => Cow::Owned(BigInt::zero()),
+    }
+}
+
+fn to_bool(value: &Value, prime: &BigInt) -> bool {
+    match value {
+        Value::Int(v) => !(v % prime).is_zero(),
+        Value::Bool(b) => *b,
+    }
+}
+
+fn bool_to_int(b: bool) -> BigInt {
+    if b {
+        BigInt::one()
+    } else {
+        BigInt::zero()
+    }
+}
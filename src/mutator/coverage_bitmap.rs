@@ -0,0 +1,141 @@
+//! Edge coverage of trace emulations, collected in a fixed-size bitmap in the style of AFL.
+//!
+//! The decisions of an emulation, i.e., the branch taken by each conditional expression and
+//! the outcome of each comparison and constraint, are the locations of its path, and every
+//! pair of consecutive locations is an edge hashed into one of `COVERAGE_MAP_SIZE` cells. An
+//! `EdgeTrace` records the edges of one emulation, and a `CoverageBitmap` keeps, for every
+//! cell, the hit-count classes that no emulation has reached yet, so that telling whether an
+//! emulation found something new costs a few loads per edge.
+
+use std::sync::atomic::{AtomicU8, Ordering};
+
+/// Number of cells of a coverage bitmap.
+pub const COVERAGE_MAP_SIZE: usize = 1 << 16;
+
+/// The edges hit by one emulation.
+#[derive(Clone, Default)]
+pub struct EdgeTrace {
+    previous_location: u32,
+    cells: Vec<u32>,
+}
+
+impl EdgeTrace {
+    /// Creates an empty trace.
+    pub fn new() -> Self {
+        EdgeTrace::default()
+    }
+
+    /// Records that the emulation went through `location`, from the last recorded location.
+    #[inline]
+    pub fn hit(&mut self, location: u32) {
+        self.cells
+            .push((location ^ self.previous_location) % COVERAGE_MAP_SIZE as u32);
+        // Shifted, so that `a -> b` and `b -> a`, as well as `a -> a` and `b -> b`, differ.
+        self.previous_location = location >> 1;
+    }
+
+    /// Empties the trace for the next emulation.
+    pub fn clear(&mut self) {
+        self.previous_location = 0;
+        self.cells.clear();
+    }
+
+    /// Returns the hit cells and the class of their hit counts, as a single bit.
+    fn classified_cells(&self) -> Vec<(usize, u8)> {
+        let mut cells = self.cells.clone();
+        cells.sort_unstable();
+        let mut classified = Vec::new();
+        let mut start = 0;
+        while start < cells.len() {
+            let mut end = start + 1;
+            while end < cells.len() && cells[end] == cells[start] {
+                end += 1;
+            }
+            classified.push((cells[start] as usize, hit_count_class(end - start)));
+            start = end;
+        }
+        classified
+    }
+}
+
+/// Returns the location of a decision at `pos`, where `site` tells the decisions of the same
+/// statement apart.
+#[inline]
+pub fn decision_location(pos: usize, site: usize, outcome: bool) -> u32 {
+    let key = ((pos as u64) << 17) ^ ((site as u64) << 1) ^ outcome as u64;
+    (key.wrapping_mul(0x9E37_79B9_7F4A_7C15) >> 32) as u32
+}
+
+/// Buckets a hit count into one of the classes 1, 2, 3, 4-7, 8-15, 16-31, 32-127, and 128+,
+/// as AFL does, so that a loop running a few more times is not a new behavior.
+fn hit_count_class(count: usize) -> u8 {
+    match count {
+        0 => 0,
+        1 => 1,
+        2 => 1 << 1,
+        3 => 1 << 2,
+        4..=7 => 1 << 3,
+        8..=15 => 1 << 4,
+        16..=31 => 1 << 5,
+        32..=127 => 1 << 6,
+        _ => 1 << 7,
+    }
+}
+
+/// The hit-count classes of every cell that no merged trace has reached yet.
+///
+/// All the operations take `&self` and only use relaxed atomics, so a bitmap can be shared by
+/// worker threads without a lock. Each new class of a cell is claimed by a single `merge`, but
+/// two threads that reach new classes of several cells at the same time may both see their
+/// traces as new, which only keeps one more input.
+pub struct CoverageBitmap {
+    virgin_bits: Vec<AtomicU8>,
+}
+
+impl CoverageBitmap {
+    /// Creates a bitmap on which every edge is new.
+    pub fn new() -> Self {
+        CoverageBitmap {
+            virgin_bits: (0..COVERAGE_MAP_SIZE)
+                .map(|_| AtomicU8::new(u8::MAX))
+                .collect(),
+        }
+    }
+
+    /// Returns whether `trace` reaches a hit-count class of a cell that no merged trace has
+    /// reached, without merging it.
+    pub fn has_new_bits(&self, trace: &EdgeTrace) -> bool {
+        trace
+            .classified_cells()
+            .into_iter()
+            .any(|(cell, class)| self.virgin_bits[cell].load(Ordering::Relaxed) & class != 0)
+    }
+
+    /// Merges `trace` into the bitmap, and returns whether it reached anything new.
+    pub fn merge(&self, trace: &EdgeTrace) -> bool {
+        let mut is_new = false;
+        for (cell, class) in trace.classified_cells() {
+            let virgin_bits = &self.virgin_bits[cell];
+            // Most edges are known, and a load is cheaper than a contended read-modify-write.
+            if virgin_bits.load(Ordering::Relaxed) & class != 0 {
+                is_new |= virgin_bits.fetch_and(!class, Ordering::Relaxed) & class != 0;
+            }
+        }
+        is_new
+    }
+
+    /// Returns the number of cells reached by the merged traces.
+    pub fn count_covered_cells(&self) -> usize {
+        self.virgin_bits
+            .iter()
+            .filter(|virgin_bits| virgin_bits.load(Ordering::Relaxed) != u8::MAX)
+            .count()
+    }
+
+    /// Marks every edge as new again.
+    pub fn clear(&self) {
+        for virgin_bits in &self.virgin_bits {
+            virgin_bits.store(u8::MAX, Ordering::Relaxed);
+        }
+    }
+}
@@ -0,0 +1,310 @@
+use std::fs;
+use std::fs::{File, OpenOptions};
+use std::io;
+use std::io::Write;
+use std::path::PathBuf;
+use std::sync::Arc;
+
+use log::debug;
+use num_bigint_dig::BigInt;
+use program_structure::ast::ExpressionInfixOpcode;
+use rustc_hash::FxHashMap;
+use serde::{Deserialize, Serialize};
+use serde_with::{serde_as, DisplayFromStr};
+
+use crate::executor::debug_ast::DebuggableExpressionInfixOpcode;
+use crate::executor::symbolic_state::SymbolicTrace;
+use crate::executor::symbolic_value::{SymbolicName, SymbolicValue};
+use crate::executor::trace_cache::INFIX_OPCODES;
+use crate::mutator::mutation_config::MutationConfig;
+use crate::mutator::mutation_test::Gene;
+use crate::mutator::utils::CounterExample;
+
+/// Name of the file through which the first island that finds a counterexample stops the others.
+const SOLUTION_FILE_NAME: &str = "solution.json";
+
+/// A mutation of a single trace position, in a form that does not depend on the process.
+///
+/// The mutation operators replace the right-hand side of an assignment with a constant, add a
+/// constant to the original statement, delete it, or replace the operator of a binary
+/// statement, so a gene is described relative to the trace that every island derives from the
+/// same circuit.
+#[serde_as]
+#[derive(Clone, Debug, PartialEq, Serialize, Deserialize)]
+enum MigrantMutation {
+    Constant(#[serde_as(as = "DisplayFromStr")] BigInt),
+    Addition(#[serde_as(as = "DisplayFromStr")] BigInt),
+    Deletion,
+    /// The operands of the original statement combined by the operator of this index in
+    /// `INFIX_OPCODES`.
+    Operator(usize),
+}
+
+/// The individuals that an island publishes for the others.
+#[serde_as]
+#[derive(Serialize, Deserialize)]
+struct Migration {
+    island_id: usize,
+    generation: usize,
+    fingerprint: String,
+    genes: Vec<Vec<(usize, MigrantMutation)>>,
+    /// Input assignments, as the values of the input variables in order.
+    #[serde_as(as = "Vec<Vec<DisplayFromStr>>")]
+    inputs: Vec<Vec<BigInt>>,
+}
+
+/// One population of an island-model search, which runs in its own process, possibly on its
+/// own host.
+///
+/// Islands communicate through files in a shared directory: each one periodically overwrites
+/// `island_<id>.json` with its best genes and input assignments and reads the files of the
+/// others, and the first one to find a counterexample creates `solution.json`, upon which the
+/// others stop.
+pub struct Island {
+    island_id: usize,
+    dir: PathBuf,
+    fingerprint: String,
+    input_variables: Vec<SymbolicName>,
+}
+
+/// Derives the seed of an island from the seed of the search, keeping it for island 0.
+pub fn derive_island_seed(seed: u64, island_id: usize) -> u64 {
+    seed ^ (island_id as u64).wrapping_mul(0x9E37_79B9_7F4A_7C15)
+}
+
+impl Island {
+    /// Joins the island model configured by `mutation_config`, or returns `None` if the search
+    /// consists of a single island.
+    ///
+    /// # Parameters
+    /// - `mutation_config`: The mutation configuration, which sets `island_id`, `num_islands`,
+    ///   and the shared `island_dir`.
+    /// - `fingerprint`: A string that identifies the searched circuit; islands ignore
+    ///   migrations and solutions with a different fingerprint.
+    /// - `input_variables`: The input variables, in the order shared by all islands.
+    pub fn join(
+        mutation_config: &MutationConfig,
+        fingerprint: String,
+        input_variables: &[SymbolicName],
+    ) -> Option<Self> {
+        if mutation_config.num_islands <= 1 || mutation_config.island_dir.is_empty() {
+            return None;
+        }
+        let dir = PathBuf::from(&mutation_config.island_dir);
+        if let Err(e) = fs::create_dir_all(&dir) {
+            panic!("Cannot create the island directory {:?}: {}", dir, e);
+        }
+        Some(Island {
+            island_id: mutation_config.island_id,
+            dir,
+            fingerprint,
+            input_variables: input_variables.to_vec(),
+        })
+    }
+
+    fn migration_path(&self, island_id: usize) -> PathBuf {
+        self.dir.join(format!("island_{}.json", island_id))
+    }
+
+    /// Publishes the given genes and input assignments, replacing the previous migration of this
+    /// island. Empty genes and genes containing mutations that cannot be described relative to
+    /// the trace are left out.
+    pub fn publish(
+        &self,
+        generation: usize,
+        symbolic_trace: &SymbolicTrace,
+        genes: &[&Gene],
+        inputs: &[&FxHashMap<SymbolicName, BigInt>],
+    ) -> io::Result<()> {
+        let migration = Migration {
+            island_id: self.island_id,
+            generation,
+            fingerprint: self.fingerprint.clone(),
+            genes: genes
+                .iter()
+                .filter(|gene| !gene.is_empty())
+                .filter_map(|gene| {
+                    let mutations = encode_gene(gene, symbolic_trace);
+                    if mutations.is_none() {
+                        debug!("Island {} cannot migrate a gene", self.island_id);
+                    }
+                    mutations
+                })
+                .collect(),
+            inputs: inputs
+                .iter()
+                .filter_map(|input| {
+                    self.input_variables
+                        .iter()
+                        .map(|var| input.get(var).cloned())
+                        .collect()
+                })
+                .collect(),
+        };
+
+        // Write to a temporary file first, so that readers never see a partial migration.
+        let path = self.migration_path(self.island_id);
+        let tmp_path = path.with_extension("json.tmp");
+        let mut file = File::create(&tmp_path)?;
+        file.write_all(serde_json::to_string(&migration)?.as_bytes())?;
+        file.sync_all()?;
+        fs::rename(tmp_path, path)
+    }
+
+    /// Collects the genes and input assignments most recently published by the other islands.
+    /// Migrations that are missing, unreadable, or for another circuit are skipped.
+    pub fn collect_migrants(
+        &self,
+        num_islands: usize,
+        symbolic_trace: &SymbolicTrace,
+    ) -> (Vec<Gene>, Vec<FxHashMap<SymbolicName, BigInt>>) {
+        let mut genes = Vec::new();
+        let mut inputs = Vec::new();
+        for island_id in (0..num_islands).filter(|id| *id != self.island_id) {
+            let migration: Migration = match File::open(self.migration_path(island_id))
+                .ok()
+                .and_then(|file| serde_json::from_reader(file).ok())
+            {
+                Some(migration) => migration,
+                None => continue,
+            };
+            if migration.fingerprint != self.fingerprint {
+                continue;
+            }
+            genes.extend(
+                migration
+                    .genes
+                    .iter()
+                    .filter_map(|gene| decode_gene(gene, symbolic_trace)),
+            );
+            inputs.extend(
+                migration
+                    .inputs
+                    .into_iter()
+                    .filter(|values| values.len() == self.input_variables.len())
+                    .map(|values| {
+                        self.input_variables
+                            .iter()
+                            .cloned()
+                            .zip(values.into_iter())
+                            .collect()
+                    }),
+            );
+        }
+        (genes, inputs)
+    }
+
+    /// Reports a counterexample to the other islands. Returns `false` if another island has
+    /// already reported one. A solution left by the search of another circuit is replaced.
+    pub fn report_counter_example(
+        &self,
+        generation: usize,
+        counter_example: &CounterExample,
+        lookup: &FxHashMap<usize, String>,
+    ) -> io::Result<bool> {
+        let path = self.dir.join(SOLUTION_FILE_NAME);
+        let mut file = match OpenOptions::new().write(true).create_new(true).open(&path) {
+            Ok(file) => file,
+            Err(e) if e.kind() == io::ErrorKind::AlreadyExists => {
+                if self.is_solved() {
+                    return Ok(false);
+                }
+                File::create(&path)?
+            }
+            Err(e) => return Err(e),
+        };
+        let meta = FxHashMap::from_iter([
+            ("0_fingerprint".to_string(), self.fingerprint.clone()),
+            ("1_island_id".to_string(), self.island_id.to_string()),
+            ("2_generation".to_string(), generation.to_string()),
+        ]);
+        file.write_all(
+            serde_json::to_string_pretty(&counter_example.to_json_with_meta(lookup, &meta))?
+                .as_bytes(),
+        )?;
+        Ok(true)
+    }
+
+    /// Returns whether some island of this search has reported a counterexample. A solution
+    /// that is still being written, or that has another fingerprint, is not counted.
+    pub fn is_solved(&self) -> bool {
+        fs::read_to_string(self.dir.join(SOLUTION_FILE_NAME))
+            .ok()
+            .and_then(|content| serde_json::from_str::<serde_json::Value>(&content).ok())
+            .map_or(false, |solution| {
+                solution["0_fingerprint"].as_str() == Some(self.fingerprint.as_str())
+            })
+    }
+}
+
+fn encode_gene(
+    gene: &Gene,
+    symbolic_trace: &SymbolicTrace,
+) -> Option<Vec<(usize, MigrantMutation)>> {
+    if gene.is_empty() {
+        return None;
+    }
+    let mut mutations: Vec<_> = gene
+        .iter()
+        .map(|(pos, value)| {
+            let mutation = match value {
+                SymbolicValue::ConstantInt(v) => MigrantMutation::Constant(v.clone()),
+                SymbolicValue::NOP => MigrantMutation::Deletion,
+                SymbolicValue::BinaryOp(lhs, op, rhs)
+                    if matches!(op.0, ExpressionInfixOpcode::Add)
+                        && symbolic_trace.get(*pos) == Some(lhs) =>
+                {
+                    match rhs.as_ref() {
+                        SymbolicValue::ConstantInt(v) => MigrantMutation::Addition(v.clone()),
+                        _ => return None,
+                    }
+                }
+                SymbolicValue::BinaryOp(lhs, op, rhs) => match symbolic_trace.get(*pos)?.as_ref() {
+                    SymbolicValue::BinaryOp(original_lhs, _, original_rhs)
+                        if original_lhs == lhs && original_rhs == rhs =>
+                    {
+                        MigrantMutation::Operator(INFIX_OPCODES.iter().position(|o| *o == op.0)?)
+                    }
+                    _ => return None,
+                },
+                _ => return None,
+            };
+            Some((*pos, mutation))
+        })
+        .collect::<Option<_>>()?;
+    mutations.sort_by_key(|(pos, _)| *pos);
+    Some(mutations)
+}
+
+fn decode_gene(
+    mutations: &[(usize, MigrantMutation)],
+    symbolic_trace: &SymbolicTrace,
+) -> Option<Gene> {
+    mutations
+        .iter()
+        .map(|(pos, mutation)| {
+            let value = match mutation {
+                MigrantMutation::Constant(v) => SymbolicValue::ConstantInt(v.clone()),
+                MigrantMutation::Deletion => SymbolicValue::NOP,
+                MigrantMutation::Addition(v) => SymbolicValue::BinaryOp(
+                    symbolic_trace.get(*pos)?.clone(),
+                    DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
+                    Arc::new(SymbolicValue::ConstantInt(v.clone())),
+                ),
+                MigrantMutation::Operator(index) => match symbolic_trace.get(*pos)?.as_ref() {
+                    SymbolicValue::BinaryOp(lhs, _, rhs) => SymbolicValue::BinaryOp(
+                        lhs.clone(),
+                        DebuggableExpressionInfixOpcode(INFIX_OPCODES.get(*index)?.clone()),
+                        rhs.clone(),
+                    ),
+                    _ => return None,
+                },
+            };
+            if *pos < symbolic_trace.len() {
+                Some((*pos, value))
+            } else {
+                None
+            }
+        })
+        .collect()
+}
@@ -1,4 +1,8 @@
 pub mod brute_force;
+pub mod checkpoint;
+pub mod compiled_trace;
+pub mod coverage_bitmap;
+pub mod island;
 pub mod mutation_config;
 pub mod mutation_test;
 pub mod mutation_test_crossover_fn;
@@ -9,5 +13,9 @@ pub mod mutation_test_trace_mutation_fn;
 pub mod mutation_test_trace_selection_fn;
 pub mod mutation_test_update_input_fn;
 pub mod mutation_utils;
+pub mod operator_scheduler;
+pub mod slicing;
+pub mod trace_optimizer;
 pub mod unused_outputs;
 pub mod utils;
+pub mod witness_oracle;
@@ -37,11 +37,23 @@ pub struct MutationConfig {
     pub binary_mode_search_level: usize,
     pub binary_mode_warmup_round: f64,
     pub zero_div_attempt_prob: f64,
+    pub plateau_generations: usize,
+    pub plateau_num_individuals: usize,
     pub statement_deletion_prob: f64,
     pub add_random_const_prob: f64,
     pub dissable_runtime_mutation_for_hash_check: bool,
     pub dissable_heuristic_for_invalid_array_subscript: bool,
     pub save_fitness_scores: bool,
+    pub num_threads: usize,
+    pub num_islands: usize,
+    pub island_id: usize,
+    pub island_dir: String,
+    pub migration_interval: usize,
+    pub num_migrants: usize,
+    pub time_budget_secs: u64,
+    pub checkpoint_path: String,
+    pub checkpoint_interval: usize,
+    pub slice_independent_subcircuits: bool,
 }
 
 impl Default for MutationConfig {
@@ -78,11 +90,23 @@ impl Default for MutationConfig {
             binary_mode_search_level: 1,
             binary_mode_warmup_round: 0.0,
             zero_div_attempt_prob:0.2,
+            plateau_generations: 20,
+            plateau_num_individuals: 3,
             statement_deletion_prob: 0.2,
             add_random_const_prob: 0.2,
             dissable_runtime_mutation_for_hash_check:false,
             dissable_heuristic_for_invalid_array_subscript:false,
             save_fitness_scores: false,
+            num_threads: 1,
+            num_islands: 1,
+            island_id: 0,
+            island_dir: "".to_string(),
+            migration_interval: 10,
+            num_migrants: 3,
+            time_budget_secs: 0,
+            checkpoint_path: "".to_string(),
+            checkpoint_interval: 10,
+            slice_independent_subcircuits: false,
         }
     }
 }
@@ -106,7 +130,9 @@ impl fmt::Display for MutationConfig {
     ├─ Input Generation Maximum Iteration         : {} 
     ├─ Input Generation Crossover Rate            : {}
     ├─ Input Generation Mutation Rate             : {}
-    └─ Input Generation Singlepoint Mutation Rate : {}",
+    ├─ Input Generation Singlepoint Mutation Rate : {}
+    ├─ Number of Worker Threads                   : {}
+    └─ Island                                     : {} / {}",
             self.program_population_size.to_string().bright_yellow(),
             self.input_population_size.to_string().bright_yellow(),
             self.max_generations.to_string().bright_yellow(),
@@ -129,7 +155,10 @@ impl fmt::Display for MutationConfig {
                 .bright_yellow(),
             self.input_generation_singlepoint_mutation_rate
                 .to_string()
-                .bright_yellow()
+                .bright_yellow(),
+            self.num_threads.to_string().bright_yellow(),
+            self.island_id.to_string().bright_yellow(),
+            self.num_islands.to_string().bright_yellow()
         )
     }
 }
@@ -1,27 +1,46 @@
 use std::collections::HashSet;
+use std::hash::{Hash, Hasher};
 use std::io;
 use std::io::Write;
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
+use std::time::{Duration, Instant};
 
 use colored::Colorize;
-use log::info;
+use log::{info, warn};
 use num_bigint_dig::BigInt;
 use num_traits::Zero;
 use rand::rngs::StdRng;
 use rand::seq::SliceRandom;
 use rand::{Rng, SeedableRng};
-use rustc_hash::{FxHashMap, FxHashSet};
+use rustc_hash::{FxHashMap, FxHashSet, FxHasher};
 
 use crate::executor::symbolic_execution::SymbolicExecutor;
+use crate::executor::symbolic_setting::SymbolicExecutorSetting;
 use crate::executor::symbolic_state::{SymbolicConstraints, SymbolicTrace};
 use crate::executor::symbolic_value::{
-    extract_variables, QuadraticPoly, SymbolicName, SymbolicValue,
+    extract_variables, QuadraticPoly, SymbolicLibrary, SymbolicName, SymbolicValue,
+    SymbolicValueRef,
 };
 
-use crate::executor::utils::solve_quadratic_modulus_equation;
+use crate::executor::utils::solve_quadratic_modulus_equations;
+use crate::metrics;
+use crate::metrics::{Counter, Phase};
+use crate::mutator::checkpoint::{
+    load_checkpoint, remove_checkpoint, save_checkpoint, SearchCheckpoint,
+};
+use crate::mutator::compiled_trace::CompiledTrace;
+use crate::mutator::island::{derive_island_seed, Island};
 use crate::mutator::mutation_config::MutationConfig;
+use crate::mutator::mutation_test_trace_fitness_fn::OriginalTraceCache;
+use crate::mutator::mutation_test_trace_selection_fn::RouletteWheel;
+use crate::mutator::mutation_utils::{QuadraticRootCache, QUADRATIC_ROOT_CACHE_CAPACITY};
+use crate::mutator::operator_scheduler::{ArmCredit, OperatorScheduler};
 use crate::mutator::utils::{
-    evaluate_symbolic_value, gather_potential_zero_division, gather_runtime_mutable_inputs,
-    is_containing_binary_check, BaseVerificationConfig, CounterExample, Direction,
+    evaluate_symbolic_value, gather_constraint_polynomials, gather_potential_zero_division,
+    gather_runtime_mutable_inputs, is_containing_binary_check, BaseVerificationConfig,
+    CounterExample, Direction,
 };
 
 pub struct MutationTestResult {
@@ -30,10 +49,39 @@ pub struct MutationTestResult {
     pub counter_example: Option<CounterExample>,
     pub generation: usize,
     pub fitness_score_log: Vec<BigInt>,
+    pub operator_credits: Vec<ArmCredit>,
 }
 
 pub type Gene = FxHashMap<usize, SymbolicValue>;
 
+/// Identifies the searched circuit by the name of its template and by digests of its optimized
+/// trace and side constraints, so that islands and checkpoints of another circuit, or of
+/// another version of the same one, are told apart from those of this search.
+///
+/// The digests are computed with `FxHasher`, which does not depend on the process, and the
+/// names of the variables hash their ids, which are assigned in the order of the source.
+pub fn search_fingerprint(
+    template_name: &str,
+    symbolic_trace: &SymbolicTrace,
+    side_constraints: &SymbolicConstraints,
+) -> String {
+    let digest = |values: &Vec<SymbolicValueRef>| {
+        let mut hasher = FxHasher::default();
+        values.hash(&mut hasher);
+        hasher.finish()
+    };
+    format!(
+        "{}/{}/{}/{:016x}{:016x}",
+        template_name,
+        symbolic_trace.len(),
+        side_constraints.len(),
+        digest(symbolic_trace),
+        digest(side_constraints)
+    )
+}
+
+type Evaluation = (usize, BigInt, Option<CounterExample>, usize);
+
 /// Conducts a mutation-based search to find counterexamples for symbolic trace verification.
 ///
 /// This function applies a genetic algorithm-like approach to search for counterexamples that
@@ -64,6 +112,8 @@ pub type Gene = FxHashMap<usize, SymbolicValue>;
 /// - `counter_example`: An optional counterexample found during the search.
 /// - `generation`: The generation in which the counterexample was found, or the maximum number of generations if no solution was found.
 /// - `fitness_score_log`: A log of the best fitness scores across generations.
+/// - `operator_credits`: The pulls and improvements of every arm of the operator scheduler,
+///   empty unless `trace_mutation_method` is `adaptive`.
 ///
 /// # Type Parameters
 /// - `TraceInitializationFn`: A closure or function that initializes the population of traces.
@@ -82,10 +132,15 @@ pub type Gene = FxHashMap<usize, SymbolicValue>;
 ///    - Initialize the population of symbolic traces.
 ///
 /// 2. **Iterative Search**:
+///    - With the `adaptive` trace mutation method, let the operator scheduler set the
+///      probabilities of the operator families and of the random values for this generation.
 ///    - Update the input population at regular intervals.
 ///    - Evolve the trace population using mutation, crossover, and selection.
 ///    - Evaluate the fitness of the population.
 ///    - If a counterexample is found, return it immediately.
+///    - When the best fitness score has not improved for `plateau_generations` generations,
+///      solve the most violated side constraint of the best individuals for one of its
+///      variables, and inject the solved inputs and individuals.
 ///
 /// 3. **Termination**:
 ///    - Stop after reaching the maximum number of generations.
@@ -94,6 +149,11 @@ pub type Gene = FxHashMap<usize, SymbolicValue>;
 /// # Notes
 /// - This function assumes that all closures and functions provided as parameters are consistent with the structure of the symbolic execution process.
 /// - The fitness function must be designed such that a fitness score of zero indicates a counterexample.
+/// - When `num_threads` is not 1, the fitness of the population is evaluated by a pool of worker threads.
+///   The outcome for a given seed is independent of the number of workers.
+/// - When `checkpoint_path` is set, the state of the search is saved every `checkpoint_interval`
+///   generations and when the time budget is exhausted, and a search with a checkpoint of the
+///   same circuit resumes from it. The checkpoint is removed once the search completes.
 pub fn mutation_test_search<
     TraceInitializationFn,
     UpdateInputFn,
@@ -127,6 +187,7 @@ where
     ) -> Vec<Gene>,
     UpdateInputFn: Fn(
         &mut SymbolicExecutor,
+        &CompiledTrace,
         &[SymbolicName],
         &mut Vec<FxHashMap<SymbolicName, BigInt>>,
         &Vec<BigInt>,
@@ -135,16 +196,18 @@ where
         &mut StdRng,
     ),
     TraceFitnessFn: Fn(
-        &mut SymbolicExecutor,
-        &BaseVerificationConfig,
-        &MutationConfig,
-        &SymbolicTrace,
-        &SymbolicConstraints,
-        &FxHashMap<usize, Direction>,
-        &Gene,
-        &Vec<FxHashMap<SymbolicName, BigInt>>,
-        &mut Vec<BigInt>,
-    ) -> (usize, BigInt, Option<CounterExample>, usize),
+            &mut SymbolicExecutor,
+            &BaseVerificationConfig,
+            &MutationConfig,
+            &SymbolicTrace,
+            &SymbolicConstraints,
+            &FxHashMap<usize, Direction>,
+            &Gene,
+            &Vec<FxHashMap<SymbolicName, BigInt>>,
+            &OriginalTraceCache,
+            &mut Vec<BigInt>,
+        ) -> (usize, BigInt, Option<CounterExample>, usize)
+        + Sync,
     TraceEvolutionFn: Fn(
         &[usize],
         &SymbolicTrace,
@@ -166,7 +229,7 @@ where
         &mut StdRng,
     ),
     TraceCrossoverFn: Fn(&Gene, &Gene, &mut StdRng) -> Gene,
-    TraceSelectionFn: for<'a> Fn(&'a [Gene], &[BigInt], &mut StdRng) -> &'a Gene,
+    TraceSelectionFn: for<'a> Fn(&'a [Gene], &RouletteWheel, &mut StdRng) -> &'a Gene,
 {
     let mut mutation_config = base_mutation_config.clone();
 
@@ -177,6 +240,8 @@ where
     } else {
         mutation_config.seed
     };
+    // Every island of an island-model search explores from its own seed.
+    let mut seed = derive_island_seed(seed, mutation_config.island_id);
     let mut rng = StdRng::seed_from_u64(seed);
 
     // Gather mutable locations
@@ -213,6 +278,13 @@ where
         }
     }
 
+    let fingerprint = search_fingerprint(
+        &base_config.target_template_name,
+        symbolic_trace,
+        side_constraints,
+    );
+    let island = Island::join(&mutation_config, fingerprint.clone(), &input_variables);
+
     let dummy_runtime_mutable_positions = FxHashMap::default();
     let runtime_mutable_positions = if mutation_config.dissable_runtime_mutation_for_hash_check {
         FxHashMap::default()
@@ -271,10 +343,203 @@ where
         partial_binary_mode = true;
     }
 
+    // The emulations of the original trace only depend on the inputs, so they are shared by
+    // all the individuals and kept until the inputs change.
+    let mut original_trace_cache =
+        OriginalTraceCache::new(&base_config.prime, symbolic_trace, side_constraints);
+
     let potential_zero_div_positions = gather_potential_zero_division(symbolic_trace);
-    let mut zero_div_cache = FxHashMap::default();
+    let mut zero_div_cache = QuadraticRootCache::new(QUADRATIC_ROOT_CACHE_CAPACITY);
+    let input_variable_set: FxHashSet<SymbolicName> = input_variables.iter().cloned().collect();
+
+    // On a plateau of the best fitness score, the most violated side constraint of the best
+    // individuals is solved for an input or for a variable assigned at a mutable position.
+    let mut mutable_assignments: FxHashMap<SymbolicName, usize> = FxHashMap::default();
+    for pos in &assign_pos {
+        if let SymbolicValue::Assign(lhs, _, _, _) | SymbolicValue::AssignCall(lhs, _, _) =
+            symbolic_trace[*pos].as_ref()
+        {
+            if let SymbolicValue::Variable(name) = lhs.as_ref() {
+                mutable_assignments.insert(name.clone(), *pos);
+            }
+        }
+    }
+    let side_constraint_polys = if 0 < mutation_config.plateau_generations {
+        let mut targets = input_variable_set.clone();
+        targets.extend(mutable_assignments.keys().cloned());
+        gather_constraint_polynomials(side_constraints, &targets, &base_config.prime)
+    } else {
+        Vec::new()
+    };
+    let mut best_fitness_score = -base_config.prime.clone();
+    let mut num_stagnant_generations = 0;
+    let mut plateau_inputs: Vec<FxHashMap<SymbolicName, BigInt>> = Vec::new();
+    let mut operator_scheduler = if mutation_config.trace_mutation_method == "adaptive" {
+        Some(OperatorScheduler::new())
+    } else {
+        None
+    };
+
+    // Each worker owns a copy of the library, since the emulation needs mutable access to it.
+    let num_threads = resolve_num_threads(mutation_config.num_threads);
+    let mut worker_libraries: Vec<SymbolicLibrary> = if num_threads > 1 {
+        (0..num_threads)
+            .map(|_| sexe.symbolic_library.clone())
+            .collect()
+    } else {
+        Vec::new()
+    };
+
+    // Resume from the last checkpoint of a preempted search
+    let checkpoint_path = if mutation_config.checkpoint_path.is_empty() {
+        None
+    } else {
+        Some(PathBuf::from(&mutation_config.checkpoint_path))
+    };
+    let mut start_generation = 0;
+    let mut elapsed_before_resume = Duration::ZERO;
+    if let Some(path) = checkpoint_path.as_ref().filter(|path| path.exists()) {
+        match load_checkpoint(path) {
+            Ok(checkpoint) if checkpoint.fingerprint != fingerprint => {
+                warn!("Ignoring the checkpoint {:?} of another circuit", path)
+            }
+            Ok(checkpoint)
+                if checkpoint.program_population_size
+                    != mutation_config.program_population_size
+                    || checkpoint.input_population_size
+                        != mutation_config.input_population_size =>
+            {
+                warn!(
+                    "Ignoring the checkpoint {:?} of a search with other population sizes",
+                    path
+                )
+            }
+            Ok(checkpoint) => {
+                println!(
+                    "{} {} (seed {})",
+                    "♻️ Resuming from generation",
+                    checkpoint.generation.to_string().bold().bright_yellow(),
+                    checkpoint.seed,
+                );
+                seed = checkpoint.seed;
+                rng = StdRng::seed_from_u64(checkpoint.rng_seed);
+                start_generation = checkpoint.generation;
+                elapsed_before_resume = Duration::from_secs(checkpoint.elapsed_secs);
+                binary_input_mode = checkpoint.binary_input_mode;
+                mutation_config.random_value_ranges = checkpoint.random_value_ranges;
+                mutation_config.random_value_probs = checkpoint.random_value_probs;
+                trace_population = checkpoint.trace_population;
+                fitness_scores = checkpoint.fitness_scores;
+                input_population = checkpoint.input_population;
+                fitness_scores_inputs = checkpoint.fitness_scores_inputs;
+                fitness_score_log = checkpoint.fitness_score_log;
+                zero_div_cache = checkpoint.zero_div_cache;
+                best_fitness_score = checkpoint.best_fitness_score;
+                num_stagnant_generations = checkpoint.num_stagnant_generations;
+                plateau_inputs = checkpoint.plateau_inputs;
+                if let Some(operator_scheduler) = &mut operator_scheduler {
+                    operator_scheduler
+                        .restore_state(&checkpoint.operator_counts, checkpoint.operator_best_score);
+                }
+            }
+            Err(e) => warn!("Cannot load the checkpoint {:?}: {}", path, e),
+        }
+    }
+
+    let start_time = Instant::now();
+    let deadline = if mutation_config.time_budget_secs > 0 {
+        Some(
+            start_time
+                + Duration::from_secs(mutation_config.time_budget_secs)
+                    .saturating_sub(elapsed_before_resume),
+        )
+    } else {
+        None
+    };
+
+    for generation in start_generation..mutation_config.max_generations {
+        let is_out_of_time = deadline.map_or(false, |deadline| deadline <= Instant::now());
+
+        // Save the state of the search at the start of this generation
+        if let Some(path) = &checkpoint_path {
+            if is_out_of_time
+                || (start_generation < generation
+                    && 0 < mutation_config.checkpoint_interval
+                    && generation % mutation_config.checkpoint_interval == 0)
+            {
+                // `StdRng` does not expose its state, so the generator is reseeded with a seed
+                // stored in the checkpoint, from which a resumed search continues alike.
+                let rng_seed: u64 = rng.gen();
+                rng = StdRng::seed_from_u64(rng_seed);
+                let (operator_counts, operator_best_score) = operator_scheduler
+                    .as_ref()
+                    .map_or((Vec::new(), None), |scheduler| scheduler.state());
+                let checkpoint = SearchCheckpoint {
+                    fingerprint: fingerprint.clone(),
+                    program_population_size: mutation_config.program_population_size,
+                    input_population_size: mutation_config.input_population_size,
+                    seed,
+                    generation,
+                    elapsed_secs: (elapsed_before_resume + start_time.elapsed()).as_secs(),
+                    rng_seed,
+                    binary_input_mode,
+                    random_value_ranges: mutation_config.random_value_ranges.clone(),
+                    random_value_probs: mutation_config.random_value_probs.clone(),
+                    trace_population: trace_population.clone(),
+                    fitness_scores: fitness_scores.clone(),
+                    input_population: input_population.clone(),
+                    fitness_scores_inputs: fitness_scores_inputs.clone(),
+                    fitness_score_log: fitness_score_log.clone(),
+                    zero_div_cache: zero_div_cache.clone(),
+                    best_fitness_score: best_fitness_score.clone(),
+                    num_stagnant_generations,
+                    plateau_inputs: plateau_inputs.clone(),
+                    operator_counts,
+                    operator_best_score,
+                };
+                if let Err(e) = save_checkpoint(path, &checkpoint) {
+                    warn!("Cannot save the checkpoint {:?}: {}", path, e);
+                }
+            }
+        }
+
+        if is_out_of_time {
+            println!(
+                "\n    └─ Stopped in generation {}: the time budget of {}s is exhausted",
+                generation, mutation_config.time_budget_secs
+            );
+            return MutationTestResult {
+                random_seed: seed,
+                mutation_config: mutation_config.clone(),
+                counter_example: None,
+                generation: generation,
+                fitness_score_log: fitness_score_log,
+                operator_credits: operator_scheduler
+                    .as_ref()
+                    .map_or(Vec::new(), |scheduler| scheduler.credits()),
+            };
+        }
+
+        if island.as_ref().map_or(false, |island| island.is_solved()) {
+            println!(
+                "\n    └─ Stopped in generation {}: another island found a solution",
+                generation
+            );
+            if let Some(path) = &checkpoint_path {
+                remove_checkpoint(path);
+            }
+            return MutationTestResult {
+                random_seed: seed,
+                mutation_config: mutation_config.clone(),
+                counter_example: None,
+                generation: generation,
+                fitness_score_log: fitness_score_log,
+                operator_credits: operator_scheduler
+                    .as_ref()
+                    .map_or(Vec::new(), |scheduler| scheduler.credits()),
+            };
+        }
 
-    for generation in 0..mutation_config.max_generations {
         if partial_binary_mode
             && 1 < generation
             && generation
@@ -286,10 +551,17 @@ where
             mutation_config.binary_mode_prob = original_binary_mode_prob;
         }
 
+        // Set the rates of the operator families scheduled for this generation
+        if let Some(operator_scheduler) = &mut operator_scheduler {
+            operator_scheduler.schedule(&mut mutation_config, binary_input_mode);
+        }
+
         // Generate input population for this generation
         if generation % mutation_config.input_update_interval == 0 {
+            let _timer = metrics::time(Phase::InputUpdate);
             update_input_fn(
                 sexe,
+                original_trace_cache.compiled_trace(),
                 &input_variables,
                 &mut input_population,
                 &fitness_scores_inputs,
@@ -301,6 +573,7 @@ where
 
         // Evolve the trace population
         if !trace_population.is_empty() {
+            let _timer = metrics::time(Phase::Evolution);
             trace_population = trace_evolution_fn(
                 &assign_pos,
                 &symbolic_trace,
@@ -318,48 +591,99 @@ where
 
         // zero-division-pattern
         if !potential_zero_div_positions.is_empty() {
-            for inp in input_population.iter_mut() {
-                if rng.gen::<f64>() < mutation_config.zero_div_attempt_prob {
-                    zero_div_attempt(
-                        inp,
-                        sexe,
-                        &mut zero_div_cache,
-                        base_config,
-                        &potential_zero_div_positions,
-                        &input_variables.iter().cloned().collect(),
-                        &mut rng,
-                    );
-                }
-            }
+            let _timer = metrics::time(Phase::ZeroDivision);
+            zero_div_attempt(
+                &mut input_population,
+                sexe,
+                &mut zero_div_cache,
+                base_config,
+                &mutation_config,
+                &potential_zero_div_positions,
+                &input_variable_set,
+                &mut rng,
+            );
+        }
+
+        // Inputs solved on the last plateau, which the update may have replaced
+        for (inp, plateau_input) in input_population.iter_mut().zip(plateau_inputs.drain(..)) {
+            *inp = plateau_input;
+        }
+        if let Some(operator_scheduler) = &mut operator_scheduler {
+            operator_scheduler.restore(&mut mutation_config);
         }
 
         // Evaluate the trace population
+        let evaluation_timer = metrics::time(Phase::Evaluation);
+        // Draw the runtime-mutation decisions upfront so that they do not depend on the order
+        // in which the workers pick up individuals.
+        let runtime_mutable_positions_of_individuals: Vec<&FxHashMap<usize, Direction>> =
+            trace_population
+                .iter()
+                .map(|_| {
+                    if rng.gen::<f64>() < mutation_config.runtime_mutation_rate {
+                        &dummy_runtime_mutable_positions
+                    } else {
+                        &runtime_mutable_positions
+                    }
+                })
+                .collect();
+        for positions in [&runtime_mutable_positions, &dummy_runtime_mutable_positions] {
+            if runtime_mutable_positions_of_individuals
+                .iter()
+                .any(|p| std::ptr::eq(*p, positions))
+            {
+                original_trace_cache.update(positions, &input_population, sexe.symbolic_library);
+            }
+        }
+
         let mut evaluations = Vec::new();
         let mut is_extincted_due_to_illegal_subscript = true;
-        for individual in &trace_population {
-            let fitness = trace_fitness_fn(
-                sexe,
+        if worker_libraries.is_empty() {
+            for (individual, positions) in trace_population
+                .iter()
+                .zip(runtime_mutable_positions_of_individuals.iter())
+            {
+                let fitness = trace_fitness_fn(
+                    sexe,
+                    &base_config,
+                    &mutation_config,
+                    symbolic_trace,
+                    side_constraints,
+                    *positions,
+                    individual,
+                    &input_population,
+                    &original_trace_cache,
+                    &mut fitness_scores_inputs,
+                );
+                if fitness.1.is_zero() {
+                    evaluations.push(fitness);
+                    break;
+                }
+                is_extincted_due_to_illegal_subscript =
+                    is_extincted_due_to_illegal_subscript && fitness.3 == input_population.len();
+                evaluations.push(fitness);
+            }
+        } else {
+            evaluations = evaluate_trace_population_in_parallel(
+                sexe.setting,
+                &mut worker_libraries,
                 &base_config,
                 &mutation_config,
                 symbolic_trace,
                 side_constraints,
-                if rng.gen::<f64>() < mutation_config.runtime_mutation_rate {
-                    &dummy_runtime_mutable_positions
-                } else {
-                    &runtime_mutable_positions
-                },
-                individual,
+                &runtime_mutable_positions_of_individuals,
+                &trace_population,
                 &input_population,
+                &original_trace_cache,
                 &mut fitness_scores_inputs,
+                &trace_fitness_fn,
             );
-            if fitness.1.is_zero() {
-                evaluations.push(fitness);
-                break;
+            for fitness in evaluations.iter().filter(|fitness| !fitness.1.is_zero()) {
+                is_extincted_due_to_illegal_subscript =
+                    is_extincted_due_to_illegal_subscript && fitness.3 == input_population.len();
             }
-            is_extincted_due_to_illegal_subscript =
-                is_extincted_due_to_illegal_subscript && fitness.3 == input_population.len();
-            evaluations.push(fitness);
         }
+        drop(evaluation_timer);
 
         if !binary_input_mode
             && is_extincted_due_to_illegal_subscript
@@ -380,6 +704,9 @@ where
 
         // Pick the best one
         let best_idx = evaluation_indices.last().unwrap();
+        if let Some(operator_scheduler) = &mut operator_scheduler {
+            operator_scheduler.reward(&evaluations[*best_idx].1);
+        }
 
         if evaluations[*best_idx].1.is_zero() {
             print!(
@@ -388,12 +715,28 @@ where
             );
             println!("\n    └─ Solution found in generation {}", generation);
 
+            if let (Some(island), Some(counter_example)) = (&island, &evaluations[*best_idx].2) {
+                if let Err(e) = island.report_counter_example(
+                    generation,
+                    counter_example,
+                    &sexe.symbolic_library.id2name,
+                ) {
+                    warn!("Cannot report the solution to the other islands: {}", e);
+                }
+            }
+            if let Some(path) = &checkpoint_path {
+                remove_checkpoint(path);
+            }
+
             return MutationTestResult {
                 random_seed: seed,
                 mutation_config: mutation_config.clone(),
                 counter_example: evaluations[*best_idx].2.clone(),
                 generation: generation,
                 fitness_score_log: fitness_score_log,
+                operator_credits: operator_scheduler
+                    .as_ref()
+                    .map_or(Vec::new(), |scheduler| scheduler.credits()),
             };
         }
 
@@ -411,9 +754,106 @@ where
         if mutation_config.save_fitness_scores {
             fitness_score_log.push(fitness_scores[*best_idx].clone());
         }
+        if metrics::is_enabled() {
+            metrics::record_generation(
+                &base_config.target_template_name,
+                generation,
+                &fitness_scores[*best_idx],
+                diversity(&trace_population),
+                diversity(&input_population),
+            );
+        }
+
+        // Exchange the best individuals and inputs with the other islands
+        let mut migrant_genes = Vec::new();
+        if let Some(island) = &island {
+            if 0 < generation
+                && 0 < mutation_config.migration_interval
+                && generation % mutation_config.migration_interval == 0
+            {
+                let mut input_indices: Vec<usize> =
+                    (0..input_population.len().min(fitness_scores_inputs.len())).collect();
+                input_indices
+                    .sort_by(|&i, &j| fitness_scores_inputs[i].cmp(&fitness_scores_inputs[j]));
+                let best_genes: Vec<&Gene> = evaluation_indices
+                    .iter()
+                    .rev()
+                    .take(mutation_config.num_migrants)
+                    .map(|i| &trace_population[*i])
+                    .collect();
+                let best_inputs: Vec<&FxHashMap<SymbolicName, BigInt>> = input_indices
+                    .iter()
+                    .rev()
+                    .take(mutation_config.num_migrants)
+                    .map(|i| &input_population[*i])
+                    .collect();
+                if let Err(e) =
+                    island.publish(generation, symbolic_trace, &best_genes, &best_inputs)
+                {
+                    warn!("Cannot publish the migrants of this island: {}", e);
+                }
+
+                let (genes, inputs) =
+                    island.collect_migrants(mutation_config.num_islands, symbolic_trace);
+                migrant_genes = genes;
+                // Migrant inputs replace the worst inputs, up to half of the population.
+                let num_replaced_inputs = input_indices.len() / 2;
+                for (i, inp) in input_indices
+                    .into_iter()
+                    .take(num_replaced_inputs)
+                    .zip(inputs.into_iter())
+                {
+                    input_population[i] = inp;
+                }
+            }
+        }
+
+        // Solve the most violated side constraint of the best individuals on a plateau
+        if 0 < mutation_config.plateau_generations {
+            if fitness_scores[*best_idx] > best_fitness_score {
+                best_fitness_score = fitness_scores[*best_idx].clone();
+                num_stagnant_generations = 0;
+            } else {
+                num_stagnant_generations += 1;
+            }
+        }
+        if 0 < mutation_config.plateau_generations
+            && mutation_config.plateau_generations <= num_stagnant_generations
+        {
+            let _timer = metrics::time(Phase::ConstraintSolving);
+            num_stagnant_generations = 0;
+            let targets: Vec<_> = evaluation_indices
+                .iter()
+                .rev()
+                .take(mutation_config.plateau_num_individuals)
+                .filter_map(|i| {
+                    input_population.get(evaluations[*i].0).map(|inp| {
+                        (
+                            &trace_population[*i],
+                            runtime_mutable_positions_of_individuals[*i],
+                            inp,
+                        )
+                    })
+                })
+                .collect();
+            let (solved_inputs, solved_genes) = plateau_solving_attempt(
+                sexe,
+                &original_trace_cache,
+                &mut zero_div_cache,
+                base_config,
+                symbolic_trace,
+                &side_constraint_polys,
+                &mutable_assignments,
+                &targets,
+                &mut rng,
+            );
+            plateau_inputs = solved_inputs;
+            migrant_genes.extend(solved_genes);
+        }
 
-        // Reset individuals with poor fitness score
-        let new_trace_population = trace_initialization_fn(
+        // Reset individuals with poor fitness score, starting with the migrants and the
+        // individuals solved on a plateau
+        let mut new_trace_population = trace_initialization_fn(
             &assign_pos,
             mutation_config.num_eliminated_individuals,
             &symbolic_trace,
@@ -421,6 +861,9 @@ where
             &mutation_config,
             &mut rng,
         );
+        for (individual, migrant) in new_trace_population.iter_mut().zip(migrant_genes) {
+            *individual = migrant;
+        }
         for (i, j) in evaluation_indices
             .into_iter()
             .take(mutation_config.num_eliminated_individuals)
@@ -434,6 +877,9 @@ where
         "\n └─ No solution found after {} generations",
         mutation_config.max_generations
     );
+    if let Some(path) = &checkpoint_path {
+        remove_checkpoint(path);
+    }
 
     MutationTestResult {
         random_seed: seed,
@@ -441,92 +887,357 @@ where
         counter_example: None,
         generation: mutation_config.max_generations,
         fitness_score_log: fitness_score_log,
+        operator_credits: operator_scheduler
+            .as_ref()
+            .map_or(Vec::new(), |scheduler| scheduler.credits()),
+    }
+}
+
+/// Returns the ratio of distinct individuals in `population`.
+fn diversity<K: Ord + Hash, V: Eq + Hash>(population: &[FxHashMap<K, V>]) -> f64 {
+    if population.is_empty() {
+        return 0.0;
+    }
+    let distinct: FxHashSet<Vec<(&K, &V)>> = population
+        .iter()
+        .map(|individual| {
+            let mut entries: Vec<_> = individual.iter().collect();
+            entries.sort_by(|(l, _), (r, _)| l.cmp(r));
+            entries
+        })
+        .collect();
+    distinct.len() as f64 / population.len() as f64
+}
+
+/// Returns the number of worker threads to use, where `0` stands for all available cores.
+pub(crate) fn resolve_num_threads(num_threads: usize) -> usize {
+    if num_threads == 0 {
+        thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1)
+    } else {
+        num_threads
+    }
+}
+
+/// Evaluates the fitness of the trace population with a pool of worker threads.
+///
+/// Each worker repeatedly claims the next unevaluated individual and runs `trace_fitness_fn`
+/// against its own copy of the symbolic library. Once an individual reaches a zero fitness
+/// score, no worker claims an individual with a larger index, while those with smaller
+/// indices are still evaluated. The returned evaluations and the updated
+/// `fitness_scores_inputs` are therefore identical to those of the serial loop, which stops
+/// at the first individual with a zero fitness score.
+///
+/// # Parameters
+/// - `setting`: The setting of the executor used for the evaluation.
+/// - `worker_libraries`: One symbolic library per worker thread.
+/// - `runtime_mutable_positions_of_individuals`: The runtime mutable positions used for each individual.
+/// - `trace_population`: The individuals to be evaluated.
+/// - `original_trace_cache`: The emulations of the original trace on `input_population`.
+/// - `fitness_scores_inputs`: The fitness scores of inputs, updated with the minimum score over the individuals.
+///
+/// # Returns
+/// The evaluations of the individuals up to and including the first one with a zero fitness score.
+fn evaluate_trace_population_in_parallel<TraceFitnessFn>(
+    setting: &SymbolicExecutorSetting,
+    worker_libraries: &mut [SymbolicLibrary],
+    base_config: &BaseVerificationConfig,
+    mutation_config: &MutationConfig,
+    symbolic_trace: &SymbolicTrace,
+    side_constraints: &SymbolicConstraints,
+    runtime_mutable_positions_of_individuals: &[&FxHashMap<usize, Direction>],
+    trace_population: &[Gene],
+    input_population: &Vec<FxHashMap<SymbolicName, BigInt>>,
+    original_trace_cache: &OriginalTraceCache,
+    fitness_scores_inputs: &mut Vec<BigInt>,
+    trace_fitness_fn: &TraceFitnessFn,
+) -> Vec<Evaluation>
+where
+    TraceFitnessFn: Fn(
+            &mut SymbolicExecutor,
+            &BaseVerificationConfig,
+            &MutationConfig,
+            &SymbolicTrace,
+            &SymbolicConstraints,
+            &FxHashMap<usize, Direction>,
+            &Gene,
+            &Vec<FxHashMap<SymbolicName, BigInt>>,
+            &OriginalTraceCache,
+            &mut Vec<BigInt>,
+        ) -> Evaluation
+        + Sync,
+{
+    let next_index = AtomicUsize::new(0);
+    let first_solution_index = AtomicUsize::new(usize::MAX);
+    let initial_fitness_scores_inputs: &Vec<BigInt> = fitness_scores_inputs;
+
+    let worker_results: Vec<Vec<(usize, Evaluation, Vec<BigInt>)>> = thread::scope(|s| {
+        let handles: Vec<_> = worker_libraries
+            .iter_mut()
+            .map(|library| {
+                let next_index = &next_index;
+                let first_solution_index = &first_solution_index;
+                s.spawn(move || {
+                    let mut worker_sexe = SymbolicExecutor::new(library, setting);
+                    let mut results = Vec::new();
+                    loop {
+                        // Indices are claimed in increasing order, so no later claim can
+                        // precede a solution found so far.
+                        let idx = next_index.fetch_add(1, Ordering::Relaxed);
+                        if idx >= trace_population.len()
+                            || idx > first_solution_index.load(Ordering::Acquire)
+                        {
+                            break;
+                        }
+                        let mut local_fitness_scores_inputs = initial_fitness_scores_inputs.clone();
+                        let fitness = trace_fitness_fn(
+                            &mut worker_sexe,
+                            base_config,
+                            mutation_config,
+                            symbolic_trace,
+                            side_constraints,
+                            runtime_mutable_positions_of_individuals[idx],
+                            &trace_population[idx],
+                            input_population,
+                            original_trace_cache,
+                            &mut local_fitness_scores_inputs,
+                        );
+                        if fitness.1.is_zero() {
+                            first_solution_index.fetch_min(idx, Ordering::AcqRel);
+                        }
+                        results.push((idx, fitness, local_fitness_scores_inputs));
+                    }
+                    results
+                })
+            })
+            .collect();
+        handles
+            .into_iter()
+            .map(|handle| handle.join().unwrap())
+            .collect()
+    });
+
+    let first_solution_index = first_solution_index.into_inner();
+    let mut slots: Vec<Option<(Evaluation, Vec<BigInt>)>> =
+        (0..trace_population.len()).map(|_| None).collect();
+    for (idx, fitness, local_fitness_scores_inputs) in worker_results.into_iter().flatten() {
+        if idx <= first_solution_index {
+            slots[idx] = Some((fitness, local_fitness_scores_inputs));
+        }
+    }
+
+    let mut evaluations = Vec::new();
+    for (fitness, local_fitness_scores_inputs) in slots.into_iter().map_while(|slot| slot) {
+        for (score, local_score) in fitness_scores_inputs
+            .iter_mut()
+            .zip(local_fitness_scores_inputs.into_iter())
+        {
+            if *score > local_score {
+                *score = local_score;
+            }
+        }
+        evaluations.push(fitness);
     }
+    evaluations
 }
 
+/// Sets input variables of some inputs to roots of the numerator or the denominator of a
+/// potential division by zero.
+///
+/// Each input is picked with probability `zero_div_attempt_prob`, and the roots of all the
+/// picked inputs are solved together, after which they are written to the inputs.
 fn zero_div_attempt(
-    inp: &mut FxHashMap<SymbolicName, BigInt>,
+    input_population: &mut [FxHashMap<SymbolicName, BigInt>],
     sexe: &mut SymbolicExecutor,
-    cache: &mut FxHashMap<[BigInt; 3], BigInt>,
+    cache: &mut QuadraticRootCache,
     base_config: &BaseVerificationConfig,
+    mutation_config: &MutationConfig,
     potential_zero_div_positions: &Vec<(usize, (Vec<QuadraticPoly>, Vec<QuadraticPoly>))>,
     input_variables: &FxHashSet<SymbolicName>,
     rng: &mut StdRng,
 ) {
-    let zero_div_info = potential_zero_div_positions.choose(rng);
-    let mut dummy_inp = inp.clone();
-
-    if let Some((_, (numerator_polys, denominator_polys))) = zero_div_info {
-        if !numerator_polys.is_empty() {
-            let numerator = numerator_polys.choose(rng);
-            if let Some((numerator_var_name, numerator_coefs)) = numerator {
-                if input_variables.contains(numerator_var_name) {
-                    let tmp_val = dummy_inp.remove(numerator_var_name);
-                    let numerator_coefficients: Option<Vec<_>> = numerator_coefs
-                        .iter()
-                        .map(|expr| {
-                            evaluate_symbolic_value(
-                                &base_config.prime,
-                                expr,
-                                &dummy_inp,
-                                sexe.symbolic_library,
-                            )
-                            .and_then(|val| match val {
-                                SymbolicValue::ConstantInt(c) => Some(c),
-                                _ => None,
-                            })
-                        })
-                        .collect();
-                    if let Some(coefs) = numerator_coefficients {
-                        let coefs_slice = [coefs[0].clone(), coefs[1].clone(), coefs[2].clone()];
-                        if let Some(ans_val) = cache.get(&coefs_slice) {
-                            inp.insert(numerator_var_name.clone(), ans_val.clone());
-                        } else if let Some(ans_val) =
-                            solve_quadratic_modulus_equation(&coefs_slice, &base_config.prime)
-                        {
-                            inp.insert(numerator_var_name.clone(), ans_val.clone());
-                            cache.insert(coefs_slice, ans_val);
-                        }
-                    }
-                    if let Some(tv) = tmp_val {
-                        dummy_inp.insert(numerator_var_name.clone(), tv);
+    // The index of the input, the variable to solve for, and the coefficients over it.
+    let mut requests: Vec<(usize, SymbolicName, [BigInt; 3])> = Vec::new();
+    for (i, inp) in input_population.iter_mut().enumerate() {
+        if rng.gen::<f64>() >= mutation_config.zero_div_attempt_prob {
+            continue;
+        }
+        if let Some((_, (numerator_polys, denominator_polys))) =
+            potential_zero_div_positions.choose(rng)
+        {
+            // Both roots are solved for on the current input, and only then written to it.
+            for polys in [numerator_polys, denominator_polys] {
+                if let Some((var_name, coefs)) = polys
+                    .choose(rng)
+                    .filter(|(var_name, _)| input_variables.contains(var_name))
+                {
+                    if let Some(coefficients) =
+                        coefficients_over_input(inp, var_name, coefs, sexe, base_config)
+                    {
+                        requests.push((i, var_name.clone(), coefficients));
                     }
                 }
             }
         }
-        if !denominator_polys.is_empty() {
-            let denominator = denominator_polys.choose(rng);
-            if let Some((denominator_var_name, denominator_coefs)) = denominator {
-                if input_variables.contains(denominator_var_name) {
-                    dummy_inp.remove(denominator_var_name);
-                    let denominator_coefficients: Option<Vec<_>> = denominator_coefs
-                        .iter()
-                        .map(|expr| {
-                            evaluate_symbolic_value(
-                                &base_config.prime,
-                                expr,
-                                &dummy_inp,
-                                sexe.symbolic_library,
-                            )
-                            .and_then(|val| match val {
-                                SymbolicValue::ConstantInt(c) => Some(c),
-                                _ => None,
-                            })
-                        })
-                        .collect();
-                    if let Some(coefs) = denominator_coefficients {
-                        let coefs_slice = [coefs[0].clone(), coefs[1].clone(), coefs[2].clone()];
-                        if let Some(ans_val) = cache.get(&coefs_slice) {
-                            inp.insert(denominator_var_name.clone(), ans_val.clone());
-                        } else if let Some(ans_val) =
-                            solve_quadratic_modulus_equation(&coefs_slice, &base_config.prime)
-                        {
-                            inp.insert(denominator_var_name.clone(), ans_val.clone());
-                            cache.insert(coefs_slice, ans_val);
-                        }
-                    }
-                }
+    }
+
+    let (roots, num_hits) = solve_quadratics_with_cache(
+        cache,
+        requests.iter().map(|(_, _, coefficients)| coefficients),
+        &base_config.prime,
+    );
+    metrics::add(Counter::ZeroDivisionCacheHits, num_hits as u64);
+    metrics::add(
+        Counter::ZeroDivisionCacheMisses,
+        (roots.len() - num_hits) as u64,
+    );
+
+    for ((i, var_name, _), root) in requests.into_iter().zip(roots.into_iter()) {
+        if let Some(root) = root {
+            input_population[i].insert(var_name, root);
+        }
+    }
+}
+
+/// Solves the most violated side constraint of each individual of `targets`, given with its
+/// runtime mutable positions, on its best input.
+///
+/// The individual is emulated on the input, and the violated side constraints are tried from
+/// the most violated one, until the coefficients of a polynomial of `side_constraint_polys`,
+/// picked at random, evaluate to constants on the final assignment without its variable. All
+/// the polynomials are then solved together.
+///
+/// # Returns
+/// The inputs of `targets` whose input variable is set to a root, and the individuals of
+/// `targets` that assign a root as a constant at the position of its variable in
+/// `mutable_assignments`. The input of such an individual is also returned, since the root
+/// only zeroes the constraint on that input.
+fn plateau_solving_attempt(
+    sexe: &mut SymbolicExecutor,
+    original_trace_cache: &OriginalTraceCache,
+    cache: &mut QuadraticRootCache,
+    base_config: &BaseVerificationConfig,
+    symbolic_trace: &SymbolicTrace,
+    side_constraint_polys: &[Vec<QuadraticPoly>],
+    mutable_assignments: &FxHashMap<SymbolicName, usize>,
+    targets: &[(
+        &Gene,
+        &FxHashMap<usize, Direction>,
+        &FxHashMap<SymbolicName, BigInt>,
+    )],
+    rng: &mut StdRng,
+) -> (Vec<FxHashMap<SymbolicName, BigInt>>, Vec<Gene>) {
+    // The index of the target, the variable to solve for, and the coefficients over it.
+    let mut requests: Vec<(usize, SymbolicName, [BigInt; 3])> = Vec::new();
+    for (t, (gene, runtime_mutable_positions, inp)) in targets.iter().enumerate() {
+        let (mut assignment, errors) = match original_trace_cache.errors_of_mutation(
+            symbolic_trace,
+            runtime_mutable_positions,
+            gene,
+            inp,
+            sexe.symbolic_library,
+        ) {
+            Some(result) => result,
+            None => continue,
+        };
+        let mut violated: Vec<usize> = (0..errors.len().min(side_constraint_polys.len()))
+            .filter(|k| errors[*k] > BigInt::zero() && !side_constraint_polys[*k].is_empty())
+            .collect();
+        violated.sort_by(|&k, &l| errors[l].cmp(&errors[k]));
+        for k in violated {
+            let (var_name, coefs) = side_constraint_polys[k].choose(rng).unwrap();
+            if let Some(coefficients) =
+                coefficients_over_input(&mut assignment, var_name, coefs, sexe, base_config)
+            {
+                requests.push((t, var_name.clone(), coefficients));
+                break;
+            }
+        }
+    }
+
+    let (roots, _) = solve_quadratics_with_cache(
+        cache,
+        requests.iter().map(|(_, _, coefficients)| coefficients),
+        &base_config.prime,
+    );
+    let mut solved_inputs = Vec::new();
+    let mut solved_genes = Vec::new();
+    for ((t, var_name, _), root) in requests.into_iter().zip(roots.into_iter()) {
+        let (gene, _, inp) = targets[t];
+        if let Some(root) = root {
+            if let Some(pos) = mutable_assignments.get(&var_name) {
+                let mut solved_gene = gene.clone();
+                solved_gene.insert(*pos, SymbolicValue::ConstantInt(root));
+                solved_genes.push(solved_gene);
+                solved_inputs.push(inp.clone());
+            } else {
+                let mut solved_input = inp.clone();
+                solved_input.insert(var_name, root);
+                solved_inputs.push(solved_input);
             }
         }
     }
+    metrics::add(
+        Counter::PlateauSolutions,
+        (solved_inputs.len() + solved_genes.len()) as u64,
+    );
+    (solved_inputs, solved_genes)
+}
+
+/// Returns a root of each quadratic polynomial of `coefficients`, looking it up in `cache`
+/// first and solving the others in one batch, together with the number of cache hits.
+fn solve_quadratics_with_cache<'a>(
+    cache: &mut QuadraticRootCache,
+    coefficients: impl Iterator<Item = &'a [BigInt; 3]>,
+    prime: &BigInt,
+) -> (Vec<Option<BigInt>>, usize) {
+    let coefficients: Vec<&[BigInt; 3]> = coefficients.collect();
+    let mut roots: Vec<Option<BigInt>> = coefficients
+        .iter()
+        .map(|coefficients| cache.get(coefficients))
+        .collect();
+    let num_hits = roots.iter().filter(|root| root.is_some()).count();
+    let missing: Vec<usize> = (0..roots.len()).filter(|j| roots[*j].is_none()).collect();
+    let missing_coefficients: Vec<[BigInt; 3]> =
+        missing.iter().map(|j| coefficients[*j].clone()).collect();
+    let solved = solve_quadratic_modulus_equations(&missing_coefficients, prime);
+    for ((j, coefficients), root) in missing
+        .into_iter()
+        .zip(missing_coefficients.into_iter())
+        .zip(solved.into_iter())
+    {
+        if let Some(root) = root {
+            cache.insert(coefficients, root.clone());
+            roots[j] = Some(root);
+        }
+    }
+    (roots, num_hits)
+}
+
+/// Evaluates the coefficients `coefs` of a quadratic polynomial over the input variable
+/// `var_name` on `inp` without it. `inp` is left unchanged.
+fn coefficients_over_input(
+    inp: &mut FxHashMap<SymbolicName, BigInt>,
+    var_name: &SymbolicName,
+    coefs: &[SymbolicValueRef; 3],
+    sexe: &mut SymbolicExecutor,
+    base_config: &BaseVerificationConfig,
+) -> Option<[BigInt; 3]> {
+    let tmp_val = inp.remove(var_name);
+    let coefficients: Option<Vec<_>> = coefs
+        .iter()
+        .map(|expr| {
+            evaluate_symbolic_value(&base_config.prime, expr, inp, sexe.symbolic_library).and_then(
+                |val| match val {
+                    SymbolicValue::ConstantInt(c) => Some(c),
+                    _ => None,
+                },
+            )
+        })
+        .collect();
+    if let Some(tv) = tmp_val {
+        inp.insert(var_name.clone(), tv);
+    }
+    coefficients?.try_into().ok()
 }
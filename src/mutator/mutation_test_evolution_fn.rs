@@ -4,6 +4,7 @@ use rand::Rng;
 
 use crate::executor::symbolic_state::SymbolicTrace;
 use crate::mutator::mutation_config::MutationConfig;
+use crate::mutator::mutation_test_trace_selection_fn::RouletteWheel;
 use crate::mutator::utils::BaseVerificationConfig;
 
 /// Performs a basic evolutionary step to generate the next population of individuals.
@@ -29,8 +30,8 @@ use crate::mutator::utils::BaseVerificationConfig;
 /// - `trace_crossover_fn`: A function that performs crossover between two parent individuals
 ///   to produce a child individual. It takes two parent references and a random number generator.
 /// - `trace_selection_fn`: A function that selects a parent individual from the population based
-///   on their evaluation scores. It takes a slice of individuals, their evaluations, and a random
-///   number generator.
+///   on their evaluation scores. It takes a slice of individuals, the `RouletteWheel` of their
+///   evaluations, and a random number generator.
 ///
 /// # Returns
 /// A `Vec<T>` representing the next generation of individuals after applying selection, crossover,
@@ -43,13 +44,14 @@ use crate::mutator::utils::BaseVerificationConfig;
 /// - `SelectionFn`: A callable function type for selecting individuals based on fitness.
 ///
 /// # Algorithm
-/// 1. For each new individual in the population:
+/// 1. Build the `RouletteWheel` of `prev_evaluations` once for the whole generation.
+/// 2. For each new individual in the population:
 ///     - Select two parent individuals using `trace_selection_fn`.
 ///     - With a probability defined in `mutation_config.crossover_rate`, create a child
 ///       by applying `trace_crossover_fn` to the parents. Otherwise, clone one parent.
 ///     - With a probability defined in `mutation_config.mutation_rate`, apply `trace_mutation_fn`
 ///       to the child.
-/// 2. Collect all generated individuals into a new population.
+/// 3. Collect all generated individuals into a new population.
 pub fn simple_evolution<T: Clone, MutationFn, CrossoverFn, SelectionFn>(
     assign_pos: &[usize],
     symbolic_trace: &SymbolicTrace,
@@ -66,12 +68,13 @@ where
     MutationFn:
         Fn(&[usize], &SymbolicTrace, &mut T, &BaseVerificationConfig, &MutationConfig, &mut StdRng),
     CrossoverFn: Fn(&T, &T, &mut StdRng) -> T,
-    SelectionFn: for<'a> Fn(&'a [T], &[BigInt], &mut StdRng) -> &'a T,
+    SelectionFn: for<'a> Fn(&'a [T], &RouletteWheel, &mut StdRng) -> &'a T,
 {
+    let wheel = RouletteWheel::new(prev_evaluations);
     (0..mutation_config.program_population_size)
         .map(|_| {
-            let parent1 = selection_fn(prev_population, prev_evaluations, rng);
-            let parent2 = selection_fn(prev_population, prev_evaluations, rng);
+            let parent1 = selection_fn(prev_population, &wheel, rng);
+            let parent2 = selection_fn(prev_population, &wheel, rng);
             let mut child = if rng.gen::<f64>() < mutation_config.crossover_rate {
                 crossover_fn(&parent1, &parent2, rng)
             } else {
@@ -3,15 +3,206 @@ use num_traits::Zero;
 use rustc_hash::FxHashMap;
 
 use crate::executor::symbolic_execution::SymbolicExecutor;
-use crate::executor::symbolic_value::{SymbolicName, SymbolicValue, SymbolicValueRef};
+use crate::executor::symbolic_value::{
+    SymbolicLibrary, SymbolicName, SymbolicValue, SymbolicValueRef,
+};
+use crate::metrics;
+use crate::metrics::Counter;
+use crate::mutator::compiled_trace::{CompiledConstraints, CompiledTrace, EmulationState};
 use crate::mutator::mutation_config::MutationConfig;
-use crate::mutator::mutation_utils::apply_trace_mutation;
+use crate::mutator::mutation_utils::mutated_statements;
 use crate::mutator::utils::{
-    accumulate_error_of_constraints, count_error_constraints, emulate_symbolic_trace,
-    evaluate_constraints, is_equal_mod, max_error_of_constraints, BaseVerificationConfig,
-    CounterExample, Direction, UnderConstrainedType, VerificationResult,
+    is_equal_mod, BaseVerificationConfig, ConstraintScheduler, CounterExample, Direction,
+    UnderConstrainedType, VerificationResult,
 };
 
+/// The emulation of the original trace on one input assignment.
+pub struct OriginalEmulation {
+    input: FxHashMap<SymbolicName, BigInt>,
+    /// `None` if the emulation was aborted, e.g., by an out-of-range subscript.
+    result: Option<OriginalRun>,
+}
+
+/// The outcome of an emulation of the original trace that ran to the end.
+struct OriginalRun {
+    assignment: FxHashMap<SymbolicName, BigInt>,
+    is_success: bool,
+    failure_pos: usize,
+    /// Whether the final assignment satisfies the side constraints.
+    is_satisfying: bool,
+    state: EmulationState,
+}
+
+/// The emulations of the original trace on the input population, shared by all the
+/// individuals that `evaluate_trace_fitness_by_error` evaluates.
+///
+/// They depend only on the inputs and on the runtime mutable positions, so they are kept
+/// across individuals and generations, and an input is re-emulated only once it has changed.
+pub struct OriginalTraceCache {
+    compiled_trace: CompiledTrace,
+    compiled_side_constraints: CompiledConstraints,
+    /// Learns which side constraints the original emulations violate most often, so that
+    /// checking them stops early.
+    side_constraint_scheduler: ConstraintScheduler,
+    /// The emulations of each input, for each set of runtime mutable positions.
+    emulations: Vec<(FxHashMap<usize, Direction>, Vec<OriginalEmulation>)>,
+}
+
+impl OriginalTraceCache {
+    /// Compiles `symbolic_trace` and `side_constraints` for emulation under `prime`.
+    pub fn new(
+        prime: &BigInt,
+        symbolic_trace: &[SymbolicValueRef],
+        side_constraints: &[SymbolicValueRef],
+    ) -> Self {
+        let mut compiled_trace = CompiledTrace::compile(prime, symbolic_trace);
+        let compiled_side_constraints = compiled_trace.compile_constraints(side_constraints);
+        let side_constraint_scheduler = ConstraintScheduler::new(compiled_side_constraints.costs());
+        OriginalTraceCache {
+            compiled_trace,
+            compiled_side_constraints,
+            side_constraint_scheduler,
+            emulations: Vec::new(),
+        }
+    }
+
+    /// Returns the compiled original trace.
+    pub fn compiled_trace(&self) -> &CompiledTrace {
+        &self.compiled_trace
+    }
+
+    /// Brings the emulations under `runtime_mutable_positions` up to date with
+    /// `input_population`, emulating the inputs that changed since the last update in one
+    /// lockstep batch.
+    pub fn update(
+        &mut self,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        input_population: &[FxHashMap<SymbolicName, BigInt>],
+        symbolic_library: &mut SymbolicLibrary,
+    ) {
+        let idx = match self
+            .emulations
+            .iter()
+            .position(|(positions, _)| positions == runtime_mutable_positions)
+        {
+            Some(idx) => idx,
+            None => {
+                self.emulations
+                    .push((runtime_mutable_positions.clone(), Vec::new()));
+                self.emulations.len() - 1
+            }
+        };
+        let emulations = &mut self.emulations[idx].1;
+        emulations.truncate(input_population.len());
+
+        let stale_indices: Vec<usize> = (0..input_population.len())
+            .filter(|i| {
+                emulations
+                    .get(*i)
+                    .map_or(true, |emulation| emulation.input != input_population[*i])
+            })
+            .collect();
+        metrics::add(
+            Counter::OriginalEmulationHits,
+            (input_population.len() - stale_indices.len()) as u64,
+        );
+        metrics::add(Counter::OriginalEmulationMisses, stale_indices.len() as u64);
+        let mut assignments: Vec<_> = stale_indices
+            .iter()
+            .map(|i| input_population[*i].clone())
+            .collect();
+        let results = self.compiled_trace.emulate_batch(
+            runtime_mutable_positions,
+            &mut assignments,
+            symbolic_library,
+        );
+
+        for ((i, assignment), result) in stale_indices
+            .into_iter()
+            .zip(assignments.into_iter())
+            .zip(results.into_iter())
+        {
+            let result = result.map(|(is_success, failure_pos, state)| OriginalRun {
+                is_satisfying: self.compiled_trace.is_satisfying(
+                    &self.compiled_side_constraints,
+                    &state,
+                    &assignment,
+                    symbolic_library,
+                    &mut self.side_constraint_scheduler,
+                ),
+                assignment,
+                is_success,
+                failure_pos,
+                state,
+            });
+            let emulation = OriginalEmulation {
+                input: input_population[i].clone(),
+                result,
+            };
+            // Stale inputs are in increasing order, so missing ones are appended in place.
+            if i < emulations.len() {
+                emulations[i] = emulation;
+            } else {
+                emulations.push(emulation);
+            }
+        }
+    }
+
+    /// Returns the emulations of `input_population` under `runtime_mutable_positions`.
+    ///
+    /// # Panics
+    /// If they have not been brought up to date with `update`.
+    fn emulations(
+        &self,
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        input_population: &[FxHashMap<SymbolicName, BigInt>],
+    ) -> &[OriginalEmulation] {
+        let emulations = self
+            .emulations
+            .iter()
+            .find(|(positions, _)| positions == runtime_mutable_positions)
+            .map(|(_, emulations)| emulations)
+            .expect("The original trace has not been emulated on the inputs");
+        assert_eq!(
+            emulations.len(),
+            input_population.len(),
+            "The input population changed since the original trace was emulated"
+        );
+        emulations
+    }
+
+    /// Emulates the trace mutated by `trace_mutation` on `input`, and returns its final
+    /// assignment with the error of each side constraint on it, or `None` if the emulation was
+    /// aborted. Function counters are left as they were, as in `evaluate_trace_fitness_by_error`.
+    pub fn errors_of_mutation(
+        &self,
+        symbolic_trace: &[SymbolicValueRef],
+        runtime_mutable_positions: &FxHashMap<usize, Direction>,
+        trace_mutation: &FxHashMap<usize, SymbolicValue>,
+        input: &FxHashMap<SymbolicName, BigInt>,
+        symbolic_library: &mut SymbolicLibrary,
+    ) -> Option<(FxHashMap<SymbolicName, BigInt>, Vec<BigInt>)> {
+        let compiled_mutated_trace = self
+            .compiled_trace
+            .compile_mutation(&mutated_statements(symbolic_trace, trace_mutation));
+        let mut assignment = input.clone();
+        symbolic_library.with_scoped_function_counter(|symbolic_library| {
+            let (_, _, state) = compiled_mutated_trace.emulate_with_state(
+                runtime_mutable_positions,
+                &mut assignment,
+                symbolic_library,
+            )?;
+            let errors = compiled_mutated_trace.errors_of_constraints(
+                &self.compiled_side_constraints,
+                &state,
+                &assignment,
+                symbolic_library,
+            );
+            Some((assignment, errors))
+        })
+    }
+}
+
 /// Evaluates the fitness of a mutated symbolic execution trace by calculating the error score.
 ///
 /// This function applies a mutation to a symbolic trace and evaluates the fitness of the trace
@@ -29,6 +220,8 @@ use crate::mutator::utils::{
 /// - `runtime_mutable_positions`: A map of runtime mutable positions.
 /// - `trace_mutation`: A mapping of indices to mutated symbolic values applied to the trace.
 /// - `inputs_assignment`: A vector of potential input assignments, where each assignment is a mapping of symbolic names to `BigInt` values.
+/// - `original_trace_cache`: The emulations of the original trace on `inputs_assignment`, brought up to date
+///   with `OriginalTraceCache::update` for `runtime_mutable_positions`.
 /// - `fitness_scores_inputs`: A vector to store the fitness scores of inputs.
 ///
 /// # Returns
@@ -40,11 +233,13 @@ use crate::mutator::utils::{
 ///
 /// # Behavior
 /// 1. Applies the provided mutation to the symbolic trace.
-/// 2. For each input assignment:
-///    - Simulates the trace using the assignment and evaluates errors in the side constraints.
+/// 2. Emulates the mutated trace on the input assignments in a single lockstep batch (see
+///    `CompiledTrace::emulate_batch`), next to their cached emulations of the original trace.
+/// 3. For each input assignment, in order:
+///    - Evaluates the errors in the side constraints of the mutated emulation.
 ///    - Checks if the trace successfully satisfies the constraints and whether it results in a counterexample.
-/// 3. Tracks the highest fitness score and the associated input assignment.
-/// 4. If a counterexample is found, the evaluation halts early and returns the result.
+/// 4. Tracks the highest fitness score and the associated input assignment.
+/// 5. If a counterexample is found, the evaluation halts early and returns the result.
 ///
 /// # Fitness Scoring
 /// - Fitness scores are calculated based on the negated error of the side constraints.
@@ -61,41 +256,107 @@ pub fn evaluate_trace_fitness_by_error(
     runtime_mutable_positions: &FxHashMap<usize, Direction>,
     trace_mutation: &FxHashMap<usize, SymbolicValue>,
     inputs_assignment: &Vec<FxHashMap<SymbolicName, BigInt>>,
+    original_trace_cache: &OriginalTraceCache,
     fitness_scores_inputs: &mut Vec<BigInt>,
 ) -> (usize, BigInt, Option<CounterExample>, usize) {
-    // Apply the given mutations to the symbolic trace.
-    let mutated_symbolic_trace = apply_trace_mutation(symbolic_trace, trace_mutation);
+    // Only the mutated statements are built, and the rest is shared with the original trace.
+    let mutated_statements = mutated_statements(symbolic_trace, trace_mutation);
+
+    // The original trace is emulated once per input for all the individuals, see
+    // `OriginalTraceCache`. The mutated trace is compiled on top of it, so that it shares the
+    // slots of the compiled side constraints.
+    let compiled_symbolic_trace = &original_trace_cache.compiled_trace;
+    let compiled_side_constraints = &original_trace_cache.compiled_side_constraints;
+    let original_emulations =
+        original_trace_cache.emulations(runtime_mutable_positions, inputs_assignment);
+    let mutated_positions: Vec<usize> = mutated_statements.iter().map(|(pos, _)| *pos).collect();
+    let compiled_mutated_symbolic_trace =
+        compiled_symbolic_trace.compile_mutation(&mutated_statements);
+
+    // The mutated trace agrees with the original one up to the first mutated position, so it
+    // is resumed from the state of the original emulation whenever that is sound.
+    let incremental_plan = compiled_mutated_symbolic_trace
+        .plan_incremental(&mutated_positions, runtime_mutable_positions);
 
     let mut max_idx = 0_usize;
     let mut max_score = -base_config.prime.clone();
     let mut counter_example = None;
     let mut num_invalida_assignments = 0; // invalid assignments causing out-of-range subscript
 
-    for (i, inp) in inputs_assignment.iter().enumerate() {
-        // Clone the input assignment for evaluation with the original program.
-        let mut assignment_for_original = inp.clone();
+    // The search stops at the first input on which the original trace alone gives a
+    // counterexample, i.e., it succeeds but violates the side constraints, or the other way
+    // around.
+    let num_considered_inputs = original_emulations
+        .iter()
+        .position(|emulation| {
+            emulation
+                .result
+                .as_ref()
+                .map_or(false, |run| run.is_success != run.is_satisfying)
+        })
+        .map_or(original_emulations.len(), |i| i + 1);
 
-        // Emulate the original trace to evaluate its behavior on the given input.
-        // Even if an assertion fails, the function proceeds, treating it as a modified trace with no assertions.
-        let emulation_result = emulate_symbolic_trace(
-            &base_config.prime,
-            &symbolic_trace,
-            runtime_mutable_positions,
-            &mut assignment_for_original,
-            &mut sexe.symbolic_library,
-        );
-        if emulation_result.is_none() {
-            num_invalida_assignments += 1;
-            continue;
-        }
-        let (is_original_program_success, original_program_failure_pos) = emulation_result.unwrap();
-        // Check if the original trace satisfies the side constraints.
-        let is_original_satisfy_sc = evaluate_constraints(
-            &base_config.prime,
-            side_constraints,
-            &assignment_for_original,
-            &mut sexe.symbolic_library,
-        );
+    // The other inputs are emulated on the mutated trace in one lockstep batch.
+    // Function counters advanced by the mutated runs are rolled back, as if they had been
+    // emulated on a copy of the library.
+    let mutated_lanes: Vec<_> = original_emulations[..num_considered_inputs]
+        .iter()
+        .filter_map(|emulation| emulation.result.as_ref().map(|run| (&emulation.input, run)))
+        .filter(|(_, run)| run.is_success == run.is_satisfying)
+        .collect();
+    let mut assignments_for_mutation: Vec<_> = mutated_lanes
+        .iter()
+        .map(|(input, run)| {
+            if incremental_plan.is_some() {
+                // Resume from the final assignment of the original trace.
+                run.assignment.clone()
+            } else {
+                (*input).clone()
+            }
+        })
+        .collect();
+    let mutated_results = sexe
+        .symbolic_library
+        .with_scoped_function_counter(|symbolic_library| {
+            if let Some(plan) = &incremental_plan {
+                let original_states: Vec<_> =
+                    mutated_lanes.iter().map(|(_, run)| &run.state).collect();
+                let inputs: Vec<_> = mutated_lanes.iter().map(|(input, _)| *input).collect();
+                compiled_mutated_symbolic_trace.emulate_incremental_batch(
+                    plan,
+                    &original_states,
+                    &inputs,
+                    runtime_mutable_positions,
+                    &mut assignments_for_mutation,
+                    symbolic_library,
+                )
+            } else {
+                compiled_mutated_symbolic_trace.emulate_batch(
+                    runtime_mutable_positions,
+                    &mut assignments_for_mutation,
+                    symbolic_library,
+                )
+            }
+        });
+    let mut mutated_emulations = mutated_results
+        .into_iter()
+        .zip(assignments_for_mutation.into_iter());
+
+    for (i, emulation) in original_emulations[..num_considered_inputs]
+        .iter()
+        .enumerate()
+    {
+        let run = match &emulation.result {
+            Some(run) => run,
+            None => {
+                num_invalida_assignments += 1;
+                continue;
+            }
+        };
+        let is_original_program_success = run.is_success;
+        let original_program_failure_pos = run.failure_pos;
+        let is_original_satisfy_sc = run.is_satisfying;
+        let assignment_for_original = &run.assignment;
         // The original program succeeds, but the side constraints fail.
         if is_original_program_success && !is_original_satisfy_sc {
             counter_example = Some(CounterExample {
@@ -125,47 +386,27 @@ pub fn evaluate_trace_fitness_by_error(
             break;
         }
 
-        // Clone the input assignment for evaluating the mutated trace.
-        let mut assignment_for_mutation = inp.clone();
-
-        // Emulate the mutated trace and evaluate the error in side constraints.
-        let mutated_emulation_result = emulate_symbolic_trace(
-            &base_config.prime,
-            &mutated_symbolic_trace,
-            runtime_mutable_positions,
-            &mut assignment_for_mutation,
-            &mut sexe.symbolic_library.clone(),
-        );
+        // Evaluate the error in side constraints of the mutated trace.
+        let (mutated_emulation_result, assignment_for_mutation) =
+            mutated_emulations.next().unwrap();
         if mutated_emulation_result.is_none() {
             break;
         }
-        let (_is_mutated_program_success, _mutated_program_failure_pos) =
+        let (_is_mutated_program_success, _mutated_program_failure_pos, mutated_state) =
             mutated_emulation_result.unwrap();
         // Calculate the error in side constraints for the mutated trace.
 
-        let error_of_side_constraints_for_mutated_assignment =
-            if mutation_config.fitness_function == "count-error" {
-                count_error_constraints(
-                    &base_config.prime,
-                    side_constraints,
-                    &assignment_for_mutation,
-                    &mut sexe.symbolic_library,
-                )
-            } else if mutation_config.fitness_function == "max-error" {
-                max_error_of_constraints(
-                    &base_config.prime,
-                    side_constraints,
-                    &assignment_for_mutation,
-                    &mut sexe.symbolic_library,
-                )
-            } else {
-                accumulate_error_of_constraints(
-                    &base_config.prime,
-                    side_constraints,
-                    &assignment_for_mutation,
-                    &mut sexe.symbolic_library,
-                )
-            };
+        let errors_of_side_constraints = compiled_mutated_symbolic_trace.errors_of_constraints(
+            &compiled_side_constraints,
+            &mutated_state,
+            &assignment_for_mutation,
+            &mut sexe.symbolic_library,
+        );
+        let error_of_side_constraints_for_mutated_assignment = aggregate_errors_of_constraints(
+            &mutation_config.fitness_function,
+            &base_config.prime,
+            errors_of_side_constraints,
+        );
         let mut score = -error_of_side_constraints_for_mutated_assignment.clone();
 
         // Check for valid solutions that satisfy all side constraints.
@@ -242,3 +483,24 @@ pub fn evaluate_trace_fitness_by_error(
         num_invalida_assignments,
     )
 }
+
+/// Combines the errors of the side constraints into the error minimized by the fitness
+/// function, in the same way as `count_error_constraints`, `max_error_of_constraints`, and
+/// `accumulate_error_of_constraints`, respectively.
+fn aggregate_errors_of_constraints(
+    fitness_function: &str,
+    prime: &BigInt,
+    errors: Vec<BigInt>,
+) -> BigInt {
+    if fitness_function == "count-error" {
+        BigInt::from(errors.iter().filter(|e| !e.is_zero()).count())
+    } else if fitness_function == "max-error" {
+        errors
+            .into_iter()
+            .map(|e| e.max(BigInt::zero()))
+            .max()
+            .unwrap_or(prime.clone())
+    } else {
+        errors.into_iter().map(|e| e.max(BigInt::zero())).sum()
+    }
+}
@@ -1,5 +1,5 @@
 use std::cmp::min;
-use std::rc::Rc;
+use std::sync::Arc;
 
 use rand::rngs::StdRng;
 use rand::seq::SliceRandom;
@@ -14,7 +14,8 @@ use crate::executor::symbolic_value::SymbolicValue;
 use crate::mutator::mutation_config::MutationConfig;
 use crate::mutator::mutation_test::Gene;
 use crate::mutator::mutation_utils::{
-    draw_bigint_with_probabilities, draw_operator_mutation_or_random_constant,
+    draw_bigint_with_probabilities, draw_mutation_of_any_family,
+    draw_operator_mutation_or_random_constant,
 };
 use crate::mutator::utils::BaseVerificationConfig;
 
@@ -130,7 +131,7 @@ pub fn initialize_population_with_operator_or_const_replacement_or_addition(
                             SymbolicValue::BinaryOp(
                                 symbolic_trace[*p].clone(),
                                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                                Rc::new(SymbolicValue::ConstantInt(
+                                Arc::new(SymbolicValue::ConstantInt(
                                     draw_bigint_with_probabilities(&mutation_config, rng).unwrap(),
                                 )),
                             ),
@@ -187,3 +188,34 @@ pub fn initialize_population_with_operator_or_const_replacement_or_deletion(
         })
         .collect()
 }
+
+/// Initializes a population with mutations of every operator family, drawn by
+/// `draw_mutation_of_any_family`, for the `adaptive` trace mutation method.
+pub fn initialize_population_with_any_family(
+    pos: &[usize],
+    program_population_size: usize,
+    symbolic_trace: &SymbolicTrace,
+    _base_config: &BaseVerificationConfig,
+    mutation_config: &MutationConfig,
+    rng: &mut StdRng,
+) -> Vec<Gene> {
+    (0..program_population_size)
+        .map(|_| {
+            let num_mutations = if pos.len() > 1 {
+                rng.gen_range(1, min(pos.len(), mutation_config.max_num_mutation_points))
+            } else {
+                1
+            };
+            let selected_pos: Vec<_> = pos.choose_multiple(rng, num_mutations).cloned().collect();
+            selected_pos
+                .iter()
+                .map(|p| {
+                    (
+                        p.clone(),
+                        draw_mutation_of_any_family(&symbolic_trace[*p], mutation_config, rng),
+                    )
+                })
+                .collect()
+        })
+        .collect()
+}
@@ -1,4 +1,4 @@
-use std::rc::Rc;
+use std::sync::Arc;
 
 use program_structure::ast::ExpressionInfixOpcode;
 use rand::rngs::StdRng;
@@ -11,7 +11,8 @@ use crate::executor::symbolic_value::SymbolicValue;
 use crate::mutator::mutation_config::MutationConfig;
 use crate::mutator::mutation_test::Gene;
 use crate::mutator::mutation_utils::{
-    draw_bigint_with_probabilities, draw_operator_mutation_or_random_constant,
+    draw_bigint_with_probabilities, draw_mutation_of_any_family,
+    draw_operator_mutation_or_random_constant,
 };
 use crate::mutator::utils::BaseVerificationConfig;
 
@@ -134,7 +135,7 @@ pub fn mutate_trace_with_operator_or_const_replacement_or_addition(
                 SymbolicValue::BinaryOp(
                     symbolic_trace[*var].clone(),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                    Rc::new(SymbolicValue::ConstantInt(
+                    Arc::new(SymbolicValue::ConstantInt(
                         draw_bigint_with_probabilities(&mutation_config, rng).unwrap(),
                     )),
                 )
@@ -154,7 +155,7 @@ pub fn mutate_trace_with_operator_or_const_replacement_or_addition(
                     SymbolicValue::BinaryOp(
                         symbolic_trace[*var].clone(),
                         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                        Rc::new(SymbolicValue::ConstantInt(
+                        Arc::new(SymbolicValue::ConstantInt(
                             draw_bigint_with_probabilities(&mutation_config, rng).unwrap(),
                         )),
                     )
@@ -221,3 +222,37 @@ pub fn mutate_trace_with_operator_or_const_replacement_or_deletion(
         }
     }
 }
+
+/// Mutates a trace with mutations of every operator family, drawn by
+/// `draw_mutation_of_any_family`, for the `adaptive` trace mutation method, whose scheduler
+/// tunes the probabilities of the families for each generation.
+pub fn mutate_trace_with_any_family(
+    pos: &[usize],
+    symbolic_trace: &SymbolicTrace,
+    individual: &mut Gene,
+    _base_config: &BaseVerificationConfig,
+    mutation_config: &MutationConfig,
+    rng: &mut StdRng,
+) {
+    if !individual.is_empty() {
+        let mut keys: Vec<usize> = individual.keys().copied().collect();
+        keys.sort();
+        let var = keys.iter().choose(rng).unwrap();
+        individual.insert(
+            var.clone(),
+            draw_mutation_of_any_family(&symbolic_trace[*var], mutation_config, rng),
+        );
+        if individual.len() < mutation_config.max_num_mutation_points && rng.gen::<bool>() {
+            let var = pos.into_iter().choose(rng).unwrap();
+            individual.insert(
+                var.clone(),
+                draw_mutation_of_any_family(&symbolic_trace[*var], mutation_config, rng),
+            );
+        } else if individual.len() > 1 && rng.gen::<bool>() {
+            let mut keys: Vec<usize> = individual.keys().copied().collect();
+            keys.sort();
+            let var = keys.iter().choose(rng).unwrap();
+            individual.remove(&var);
+        }
+    }
+}
@@ -1,7 +1,83 @@
 use num_bigint_dig::BigInt;
-use num_bigint_dig::RandBigInt;
-use num_traits::{One, Signed, Zero};
+use num_traits::ToPrimitive;
 use rand::rngs::StdRng;
+use rand::Rng;
+
+/// The selection probabilities of a population, derived once from its fitness scores so that
+/// every draw takes constant time.
+///
+/// The weight of an individual is its fitness score minus the minimum score, as a `f64`, and
+/// individuals are drawn in proportion to their weights with Vose's alias method: a draw
+/// picks a column uniformly and then either the individual of the column or its alias.
+///
+/// # Edge Cases
+/// - If all fitness scores are equal, the first individual is always drawn.
+///
+/// # Complexity
+/// - Construction: O(n), where `n` is the size of the population.
+/// - Draw: O(1).
+pub struct RouletteWheel {
+    probabilities: Vec<f64>,
+    aliases: Vec<usize>,
+}
+
+impl RouletteWheel {
+    /// Builds the wheel of a population with the given fitness scores.
+    ///
+    /// # Panics
+    /// - Panics if `fitness_scores` is empty.
+    pub fn new(fitness_scores: &[BigInt]) -> Self {
+        let min_score = fitness_scores.iter().min().unwrap();
+        let weights: Vec<f64> = fitness_scores
+            .iter()
+            .map(|score| (score - min_score).to_f64().unwrap_or(f64::MAX))
+            .collect();
+        let total_weight: f64 = weights.iter().sum();
+        let n = weights.len();
+        if !(total_weight > 0.0 && total_weight.is_finite()) {
+            return RouletteWheel {
+                probabilities: vec![0.0; n],
+                aliases: vec![0; n],
+            };
+        }
+
+        let mut probabilities: Vec<f64> = weights
+            .iter()
+            .map(|weight| weight * n as f64 / total_weight)
+            .collect();
+        let mut aliases: Vec<usize> = (0..n).collect();
+        let (mut small, mut large): (Vec<usize>, Vec<usize>) =
+            (0..n).partition(|i| probabilities[*i] < 1.0);
+        while !small.is_empty() && !large.is_empty() {
+            let s = small.pop().unwrap();
+            let l = *large.last().unwrap();
+            aliases[s] = l;
+            probabilities[l] -= 1.0 - probabilities[s];
+            if probabilities[l] < 1.0 {
+                large.pop();
+                small.push(l);
+            }
+        }
+        // The columns left over are full up to rounding errors.
+        for i in small.into_iter().chain(large) {
+            probabilities[i] = 1.0;
+        }
+        RouletteWheel {
+            probabilities,
+            aliases,
+        }
+    }
+
+    /// Draws the index of an individual.
+    pub fn spin(&self, rng: &mut StdRng) -> usize {
+        let column = rng.gen_range(0, self.probabilities.len());
+        if rng.gen::<f64>() < self.probabilities[column] {
+            column
+        } else {
+            self.aliases[column]
+        }
+    }
+}
 
 /// Selects an individual from the population using roulette-wheel selection.
 ///
@@ -11,8 +87,8 @@ use rand::rngs::StdRng;
 ///
 /// # Parameters
 /// - `population`: A slice of individuals in the population.
-/// - `fitness_scores`: A slice of fitness scores corresponding to the individuals in the population.
-///   Each fitness score represents the relative "quality" or fitness of an individual.
+/// - `wheel`: The `RouletteWheel` built from the fitness scores of the individuals in the
+///   population, once for all the selections of a generation.
 /// - `rng`: A mutable reference to a random number generator used to perform the selection.
 ///
 /// # Returns
@@ -21,64 +97,32 @@ use rand::rngs::StdRng;
 /// # Type Parameters
 /// - `T`: The type of individuals in the population, which must implement `Clone`.
 ///
-/// # Algorithm
-/// 1. Calculate the weight for each individual by subtracting the minimum fitness score from
-///    each individual's fitness score. This ensures non-negative weights.
-/// 2. Compute the total weight as the sum of all individual weights.
-/// 3. Generate a random target weight in the range `[0, total_weight)`.
-/// 4. Iterate through the population and subtract each individual's weight from the target.
-///    When the target becomes less than the current individual's weight, that individual is selected.
-/// 5. If no individual is selected due to edge cases (e.g., all weights are zero), the first
-///    individual in the population is returned as a fallback.
-///
 /// # Edge Cases
-/// - If all fitness scores are equal, the selection is effectively random.
-/// - If the population is empty, this function will panic when attempting to compute the minimum score.
-/// - If all fitness scores are zero, the first individual in the population will always be selected.
+/// - If all fitness scores are equal, the first individual in the population is always selected.
+/// - If the wheel draws an index past the end of the population, the first individual is selected.
 ///
 /// # Example
 /// ```rust
 /// use rand::{SeedableRng, rngs::StdRng};
 /// use num_bigint_dig::BigInt;
 ///
-/// use zkfuzz::mutator::mutation_test_trace_selection_fn::roulette_selection;
+/// use zkfuzz::mutator::mutation_test_trace_selection_fn::{roulette_selection, RouletteWheel};
 ///
 /// let population = vec!["A", "B", "C"];
 /// let fitness_scores = vec![BigInt::from(10), BigInt::from(20), BigInt::from(30)];
+/// let wheel = RouletteWheel::new(&fitness_scores);
 /// let mut rng = StdRng::seed_from_u64(42);
 ///
-/// let selected = roulette_selection(&population, &fitness_scores, &mut rng);
+/// let selected = roulette_selection(&population, &wheel, &mut rng);
 /// println!("Selected individual: {}", selected);
 /// ```
 ///
-/// # Panics
-/// - Panics if `fitness_scores` is empty or if its length does not match the length of `population`.
-///
 /// # Complexity
-/// - Time complexity: O(n), where `n` is the size of the population.
-/// - Space complexity: O(n), due to the allocation of the weights vector.
+/// - Time complexity: O(1).
 pub fn roulette_selection<'a, T: Clone>(
     population: &'a [T],
-    fitness_scores: &[BigInt],
+    wheel: &RouletteWheel,
     rng: &mut StdRng,
 ) -> &'a T {
-    let min_score = fitness_scores.iter().min().unwrap();
-    let weights: Vec<_> = fitness_scores
-        .iter()
-        .map(|score| score - min_score)
-        .collect();
-    let mut total_weight: BigInt = weights.iter().sum();
-    total_weight = if total_weight.is_positive() {
-        total_weight
-    } else {
-        BigInt::one()
-    };
-    let mut target = rng.gen_bigint_range(&BigInt::zero(), &total_weight);
-    for (individual, weight) in population.iter().zip(weights.iter()) {
-        if &target < weight {
-            return individual;
-        }
-        target -= weight;
-    }
-    &population[0]
+    population.get(wheel.spin(rng)).unwrap_or(&population[0])
 }
@@ -4,11 +4,13 @@ use rand::Rng;
 use rustc_hash::FxHashMap;
 
 use crate::executor::symbolic_execution::SymbolicExecutor;
-use crate::executor::symbolic_value::{OwnerName, SymbolicName};
+use crate::executor::symbolic_value::SymbolicName;
 
+use crate::mutator::compiled_trace::CompiledTrace;
+use crate::mutator::coverage_bitmap::{CoverageBitmap, EdgeTrace};
 use crate::mutator::mutation_config::MutationConfig;
 use crate::mutator::mutation_test_crossover_fn::random_crossover;
-use crate::mutator::mutation_test_trace_selection_fn::roulette_selection;
+use crate::mutator::mutation_test_trace_selection_fn::{roulette_selection, RouletteWheel};
 use crate::mutator::mutation_utils::draw_bigint_with_probabilities;
 use crate::mutator::utils::BaseVerificationConfig;
 
@@ -20,6 +22,7 @@ use crate::mutator::utils::BaseVerificationConfig;
 ///
 /// # Parameters
 /// - `_sexe`: A mutable reference to the symbolic executor. Not used in this implementation.
+/// - `_compiled_trace`: The compiled symbolic trace under test. Not used in this implementation.
 /// - `input_variables`: A slice of symbolic names representing the input variables.
 /// - `inputs_population`: A mutable vector of hash maps representing the current input population.
 ///   This will be cleared and replaced with the new randomly generated population.
@@ -34,6 +37,7 @@ use crate::mutator::utils::BaseVerificationConfig;
 /// with the new one.
 pub fn update_input_population_with_random_sampling(
     _sexe: &mut SymbolicExecutor,
+    _compiled_trace: &CompiledTrace,
     input_variables: &[SymbolicName],
     inputs_population: &mut Vec<FxHashMap<SymbolicName, BigInt>>,
     _inputs_population_score: &Vec<BigInt>,
@@ -60,6 +64,7 @@ pub fn update_input_population_with_random_sampling(
 
 pub fn update_input_population_with_fitness_score(
     sexe: &mut SymbolicExecutor,
+    compiled_trace: &CompiledTrace,
     input_variables: &[SymbolicName],
     inputs_population: &mut Vec<FxHashMap<SymbolicName, BigInt>>,
     inputs_population_score: &Vec<BigInt>,
@@ -70,6 +75,7 @@ pub fn update_input_population_with_fitness_score(
     if inputs_population.is_empty() {
         update_input_population_with_random_sampling(
             sexe,
+            compiled_trace,
             input_variables,
             inputs_population,
             inputs_population_score,
@@ -78,10 +84,11 @@ pub fn update_input_population_with_fitness_score(
             rng,
         );
     }
+    let wheel = RouletteWheel::new(inputs_population_score);
     let mut updated_inputs_population = (0..mutation_config.input_population_size)
         .map(|_| {
-            let parent1 = roulette_selection(inputs_population, inputs_population_score, rng);
-            let parent2 = roulette_selection(inputs_population, inputs_population_score, rng);
+            let parent1 = roulette_selection(inputs_population, &wheel, rng);
+            let parent2 = roulette_selection(inputs_population, &wheel, rng);
             let mut child = if rng.gen::<f64>() < mutation_config.crossover_rate {
                 random_crossover(&parent1, &parent2, rng)
             } else {
@@ -106,42 +113,36 @@ pub fn update_input_population_with_fitness_score(
     inputs_population.append(&mut updated_inputs_population);
 }
 
-/// Evaluates the coverage achieved by a given set of inputs.
+/// Evaluates whether a given set of inputs takes a path that no previous input has taken.
 ///
-/// This function runs the symbolic executor with the provided inputs and measures
-/// the coverage based on the paths explored during execution.
+/// The compiled trace is emulated, and its edges are collected into a bitmap shared by all the
+/// evaluated inputs.
 ///
 /// # Parameters
-/// - `sexe`: A mutable reference to the symbolic executor used for evaluation.
+/// - `sexe`: A mutable reference to the symbolic executor whose library the trace refers to.
+/// - `compiled_trace`: The compiled symbolic trace under test.
 /// - `inputs`: A reference to a hash map representing the input values to evaluate.
-/// - `base_config`: A reference to the base verification configuration containing execution parameters.
+/// - `coverage`: The edges covered by the previously evaluated inputs, updated with the new ones.
+/// - `edges`: A buffer for the edges of the emulation, reused across evaluations.
 ///
 /// # Returns
-/// The number of coverage points (e.g., branches or paths) achieved by the inputs.
-///
-/// # Behavior
-/// The symbolic executor is cleared and set up for coverage tracking. The inputs are fed into the executor,
-/// and the coverage is recorded. The coverage tracking is then disabled, and the coverage count is returned.
-pub fn evaluate_coverage(
+/// `true` if the emulation reached an edge, or a number of hits of an edge, that is new to
+/// `coverage`.
+pub fn evaluate_edge_coverage(
     sexe: &mut SymbolicExecutor,
+    compiled_trace: &CompiledTrace,
     inputs: &FxHashMap<SymbolicName, BigInt>,
-    base_config: &BaseVerificationConfig,
-) -> usize {
-    sexe.clear();
-    sexe.turn_on_coverage_tracking();
-    sexe.cur_state.add_owner(&OwnerName {
-        id: sexe.symbolic_library.name2id["main"],
-        counter: 0,
-        access: None,
-    });
-    sexe.feed_arguments(
-        &base_config.template_param_names,
-        &base_config.template_param_values,
+    coverage: &CoverageBitmap,
+    edges: &mut EdgeTrace,
+) -> bool {
+    let mut assignment = inputs.clone();
+    compiled_trace.emulate_with_coverage(
+        &FxHashMap::default(),
+        &mut assignment,
+        sexe.symbolic_library,
+        edges,
     );
-    sexe.concrete_execute(&base_config.target_template_name, inputs);
-    sexe.record_path();
-    sexe.turn_off_coverage_tracking();
-    sexe.coverage_count()
+    coverage.merge(edges)
 }
 
 /// Updates the input population to maximize coverage.
@@ -152,6 +153,9 @@ pub fn evaluate_coverage(
 ///
 /// # Parameters
 /// - `sexe`: A mutable reference to the symbolic executor used for coverage evaluation.
+/// - `compiled_trace`: The compiled symbolic trace under test, whose emulations measure the
+///   coverage. The search passes the one of its `OriginalTraceCache`, so that the trace is not
+///   compiled again on every update.
 /// - `input_variables`: A slice of symbolic names representing the input variables.
 /// - `inputs_population`: A mutable vector of hash maps representing the current input population.
 ///   This will be updated to contain inputs that maximize coverage.
@@ -162,13 +166,15 @@ pub fn evaluate_coverage(
 ///
 /// # Behavior
 /// 1. Initializes the population with random inputs.
-/// 2. Evaluates each input for coverage and retains those that increase coverage.
+/// 2. Evaluates each input for coverage with `evaluate_edge_coverage` and retains those that
+///    increase coverage.
 /// 3. Iteratively performs mutations and crossovers on the population to explore new inputs,
 ///    retaining inputs that further increase coverage.
 /// 4. The process stops when the population reaches the maximum size or the specified number
 ///    of iterations is completed.
 pub fn update_input_population_with_coverage_maximization(
     sexe: &mut SymbolicExecutor,
+    compiled_trace: &CompiledTrace,
     input_variables: &[SymbolicName],
     inputs_population: &mut Vec<FxHashMap<SymbolicName, BigInt>>,
     inputs_population_score: &Vec<BigInt>,
@@ -176,13 +182,14 @@ pub fn update_input_population_with_coverage_maximization(
     mutation_config: &MutationConfig,
     rng: &mut StdRng,
 ) {
-    sexe.clear_coverage_tracker();
-    let mut total_coverage = 0_usize;
+    let coverage = CoverageBitmap::new();
+    let mut edges = EdgeTrace::new();
     inputs_population.clear();
 
     let mut initial_input_population = Vec::new();
     update_input_population_with_random_sampling(
         sexe,
+        compiled_trace,
         input_variables,
         &mut initial_input_population,
         inputs_population_score,
@@ -192,10 +199,8 @@ pub fn update_input_population_with_coverage_maximization(
     );
 
     for input in &initial_input_population {
-        let new_coverage = evaluate_coverage(sexe, &input, base_config);
-        if new_coverage > total_coverage {
+        if evaluate_edge_coverage(sexe, compiled_trace, input, &coverage, &mut edges) {
             inputs_population.push(input.clone());
-            total_coverage = new_coverage;
         }
     }
 
@@ -230,10 +235,8 @@ pub fn update_input_population_with_coverage_maximization(
             }
 
             // Evaluate the new input
-            let new_coverage = evaluate_coverage(sexe, &new_input, base_config);
-            if new_coverage > total_coverage {
+            if evaluate_edge_coverage(sexe, compiled_trace, &new_input, &coverage, &mut edges) {
                 new_inputs_population.push(new_input);
-                total_coverage = new_coverage;
             }
         }
         inputs_population.append(&mut new_inputs_population);
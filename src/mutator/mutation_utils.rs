@@ -1,4 +1,5 @@
-use std::rc::Rc;
+use std::collections::BTreeMap;
+use std::sync::Arc;
 
 use num_bigint_dig::BigInt;
 use num_bigint_dig::RandBigInt;
@@ -11,7 +12,7 @@ use rustc_hash::FxHashMap;
 
 use crate::executor::debug_ast::DebuggableExpressionInfixOpcode;
 use crate::executor::symbolic_state::SymbolicTrace;
-use crate::executor::symbolic_value::SymbolicValue;
+use crate::executor::symbolic_value::{SymbolicValue, SymbolicValueRef};
 use crate::mutator::mutation_config::MutationConfig;
 
 /// Draws a random BigInt from specified ranges based on given probabilities.
@@ -89,36 +90,39 @@ pub fn apply_trace_mutation(
     trace_mutation: &FxHashMap<usize, SymbolicValue>,
 ) -> SymbolicTrace {
     let mut mutated_constraints = symbolic_trace.clone();
-    let mut keys: Vec<_> = trace_mutation.keys().collect();
-    keys.sort();
-
-    for index in keys {
-        let value = trace_mutation.get(index).unwrap();
-        if let SymbolicValue::Assign(lv, _, is_safe, _) =
-            mutated_constraints[*index].as_ref().clone()
-        {
-            mutated_constraints[*index] = Rc::new(SymbolicValue::Assign(
-                lv.clone(),
-                Rc::new(value.clone()),
-                is_safe,
-                None,
-            ));
-        } else if let SymbolicValue::AssignCall(lv, _, is_mutable) =
-            mutated_constraints[*index].as_ref().clone()
-        {
-            mutated_constraints[*index] = Rc::new(SymbolicValue::Assign(
-                lv.clone(),
-                Rc::new(value.clone()),
-                !is_mutable,
-                None,
-            ));
-        } else {
-            panic!("We can only mutate SymbolicValue::Assign");
-        }
+    for (index, value) in mutated_statements(symbolic_trace, trace_mutation) {
+        mutated_constraints[index] = value;
     }
     mutated_constraints
 }
 
+/// Returns the statements that `trace_mutation` puts in place of those of `symbolic_trace`,
+/// by increasing position, without copying the rest of the trace.
+///
+/// See `apply_trace_mutation` for how each statement is mutated.
+pub fn mutated_statements(
+    symbolic_trace: &[SymbolicValueRef],
+    trace_mutation: &FxHashMap<usize, SymbolicValue>,
+) -> Vec<(usize, SymbolicValueRef)> {
+    let mut statements: Vec<(usize, SymbolicValueRef)> = trace_mutation
+        .iter()
+        .map(|(index, value)| {
+            let statement = match symbolic_trace[*index].as_ref() {
+                SymbolicValue::Assign(lv, _, is_safe, _) => {
+                    SymbolicValue::Assign(lv.clone(), Arc::new(value.clone()), *is_safe, None)
+                }
+                SymbolicValue::AssignCall(lv, _, is_mutable) => {
+                    SymbolicValue::Assign(lv.clone(), Arc::new(value.clone()), !is_mutable, None)
+                }
+                _ => panic!("We can only mutate SymbolicValue::Assign"),
+            };
+            (*index, Arc::new(statement))
+        })
+        .collect();
+    statements.sort_unstable_by_key(|(index, _)| *index);
+    statements
+}
+
 lazy_static::lazy_static! {
     static ref OPERATOR_MUTATION_CANDIDATES_STRICT: Vec<(ExpressionInfixOpcode,Vec<ExpressionInfixOpcode>)> = {
         vec![
@@ -181,3 +185,95 @@ pub fn draw_operator_mutation_or_random_constant(
         ),
     }
 }
+
+/// Draws a mutation of `target` from every operator family: a deletion with probability
+/// `statement_deletion_prob`, otherwise the addition of a random constant with probability
+/// `add_random_const_prob`, and otherwise an operator or constant replacement.
+pub fn draw_mutation_of_any_family(
+    target: &SymbolicValueRef,
+    mutation_config: &MutationConfig,
+    rng: &mut StdRng,
+) -> SymbolicValue {
+    if rng.gen::<f64>() < mutation_config.statement_deletion_prob {
+        SymbolicValue::NOP
+    } else if rng.gen::<f64>() < mutation_config.add_random_const_prob {
+        SymbolicValue::BinaryOp(
+            target.clone(),
+            DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
+            Arc::new(SymbolicValue::ConstantInt(
+                draw_bigint_with_probabilities(&mutation_config, rng).unwrap(),
+            )),
+        )
+    } else {
+        draw_operator_mutation_or_random_constant(&*target, mutation_config, rng)
+    }
+}
+
+/// Number of roots kept by the `QuadraticRootCache` of a search.
+pub const QUADRATIC_ROOT_CACHE_CAPACITY: usize = 4096;
+
+/// A bounded cache of the roots of quadratic polynomials over the field, keyed by their
+/// coefficients, which evicts the least recently used root once full.
+#[derive(Clone)]
+pub struct QuadraticRootCache {
+    capacity: usize,
+    roots: FxHashMap<[BigInt; 3], (BigInt, u64)>,
+    /// The coefficients of the cached roots, by the time of their last use.
+    recency: BTreeMap<u64, [BigInt; 3]>,
+    clock: u64,
+}
+
+impl QuadraticRootCache {
+    pub fn new(capacity: usize) -> Self {
+        QuadraticRootCache {
+            capacity,
+            roots: FxHashMap::default(),
+            recency: BTreeMap::new(),
+            clock: 0,
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.roots.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.roots.is_empty()
+    }
+
+    /// Returns the root of the polynomial with `coefficients`, and marks it as recently used.
+    pub fn get(&mut self, coefficients: &[BigInt; 3]) -> Option<BigInt> {
+        let (root, last_use) = self.roots.get_mut(coefficients)?;
+        let coefficients = self.recency.remove(last_use).unwrap();
+        self.clock += 1;
+        *last_use = self.clock;
+        self.recency.insert(self.clock, coefficients);
+        Some(root.clone())
+    }
+
+    /// Caches the root of the polynomial with `coefficients`, evicting the least recently used
+    /// root if the cache is full.
+    pub fn insert(&mut self, coefficients: [BigInt; 3], root: BigInt) {
+        self.clock += 1;
+        if let Some((_, last_use)) = self.roots.get(&coefficients) {
+            self.recency.remove(last_use);
+        }
+        self.recency.insert(self.clock, coefficients.clone());
+        self.roots.insert(coefficients, (root, self.clock));
+        while self.roots.len() > self.capacity {
+            if let Some((_, oldest)) = self.recency.pop_first() {
+                self.roots.remove(&oldest);
+            } else {
+                break;
+            }
+        }
+    }
+
+    /// Returns the cached roots, from the least to the most recently used, so that inserting
+    /// them in this order into an empty cache restores it.
+    pub fn iter(&self) -> impl Iterator<Item = (&[BigInt; 3], &BigInt)> {
+        self.recency
+            .values()
+            .map(|coefficients| (coefficients, &self.roots[coefficients].0))
+    }
+}
@@ -0,0 +1,257 @@
+//! Adaptive scheduling of the mutation operators and of the distributions of random values.
+//!
+//! With `trace_mutation_method = "adaptive"`, every operator family stays available, and the
+//! probabilities that pick among them are tuned for each generation by a multi-armed bandit
+//! instead of being fixed by the mutation configuration. An `OperatorScheduler` pulls one
+//! operator family and one distribution of random values at the start of a generation,
+//! restores the configured probabilities once the generation has been mutated, and credits
+//! both arms when it has been evaluated: 1 if it improved the best fitness score of the
+//! search, and 0 otherwise. The arms are picked by UCB1, so that the families that lower the
+//! error fastest on the circuit are pulled more often.
+
+use num_bigint_dig::BigInt;
+use serde::Serialize;
+
+use crate::mutator::mutation_config::MutationConfig;
+
+/// Exploration constant of UCB1.
+const EXPLORATION: f64 = std::f64::consts::SQRT_2;
+
+/// The operator families, each of which makes one kind of mutation certain for a generation.
+const OPERATOR_ARMS: [&str; 6] = [
+    "constant", "operator", "add", "delete", "zero_div", "binary",
+];
+
+/// Reweightings of the configured `random_value_ranges`, which are listed from the smallest
+/// values to the largest ones.
+const VALUE_ARMS: [&str; 4] = ["preset", "uniform", "small", "large"];
+
+/// The credit of one arm, as exported in the result.
+#[derive(Clone, Debug, Serialize)]
+pub struct ArmCredit {
+    /// Either "operator" or "value".
+    pub kind: String,
+    pub arm: String,
+    pub num_pulls: usize,
+    /// Pulls after which the best fitness score of the search improved.
+    pub num_improvements: usize,
+}
+
+/// A bandit over a fixed set of arms with Bernoulli rewards, played by UCB1.
+#[derive(Clone)]
+pub struct Bandit {
+    num_pulls: Vec<usize>,
+    num_improvements: Vec<usize>,
+}
+
+impl Bandit {
+    pub fn new(num_arms: usize) -> Self {
+        Bandit {
+            num_pulls: vec![0; num_arms],
+            num_improvements: vec![0; num_arms],
+        }
+    }
+
+    /// Returns the arm to pull next: the first arm never pulled, or otherwise the arm with the
+    /// highest upper confidence bound, the first one on ties.
+    pub fn select(&self) -> usize {
+        if let Some(arm) = self.num_pulls.iter().position(|n| *n == 0) {
+            return arm;
+        }
+        let total = self.num_pulls.iter().sum::<usize>() as f64;
+        let bound = |arm: usize| {
+            let n = self.num_pulls[arm] as f64;
+            self.num_improvements[arm] as f64 / n + EXPLORATION * (total.ln() / n).sqrt()
+        };
+        (0..self.num_pulls.len()).fold(
+            0,
+            |best, arm| if bound(arm) > bound(best) { arm } else { best },
+        )
+    }
+
+    /// Records a pull of `arm`, which improved the search or not.
+    pub fn reward(&mut self, arm: usize, is_improved: bool) {
+        self.num_pulls[arm] += 1;
+        self.num_improvements[arm] += is_improved as usize;
+    }
+}
+
+/// The probabilities of the mutation configuration that the arms set.
+#[derive(Clone)]
+struct Rates {
+    operator_mutation_rate: f64,
+    add_random_const_prob: f64,
+    statement_deletion_prob: f64,
+    zero_div_attempt_prob: f64,
+    binary_mode_prob: f64,
+    random_value_probs: Vec<f64>,
+}
+
+impl Rates {
+    fn of(mutation_config: &MutationConfig) -> Self {
+        Rates {
+            operator_mutation_rate: mutation_config.operator_mutation_rate,
+            add_random_const_prob: mutation_config.add_random_const_prob,
+            statement_deletion_prob: mutation_config.statement_deletion_prob,
+            zero_div_attempt_prob: mutation_config.zero_div_attempt_prob,
+            binary_mode_prob: mutation_config.binary_mode_prob,
+            random_value_probs: mutation_config.random_value_probs.clone(),
+        }
+    }
+
+    fn apply_to(&self, mutation_config: &mut MutationConfig) {
+        mutation_config.operator_mutation_rate = self.operator_mutation_rate;
+        mutation_config.add_random_const_prob = self.add_random_const_prob;
+        mutation_config.statement_deletion_prob = self.statement_deletion_prob;
+        mutation_config.zero_div_attempt_prob = self.zero_div_attempt_prob;
+        mutation_config.binary_mode_prob = self.binary_mode_prob;
+        mutation_config.random_value_probs = self.random_value_probs.clone();
+    }
+}
+
+/// Schedules an operator family and a distribution of random values for each generation.
+#[derive(Clone)]
+pub struct OperatorScheduler {
+    operators: Bandit,
+    values: Bandit,
+    /// The best fitness score of the search so far.
+    best_score: Option<BigInt>,
+    /// The arms of the current generation. No value arm is pulled in binary input mode.
+    pulled: Option<(usize, Option<usize>)>,
+    /// The rates that the arms of the current generation replaced.
+    replaced_rates: Option<Rates>,
+}
+
+impl OperatorScheduler {
+    pub fn new() -> Self {
+        OperatorScheduler {
+            operators: Bandit::new(OPERATOR_ARMS.len()),
+            values: Bandit::new(VALUE_ARMS.len()),
+            best_score: None,
+            pulled: None,
+            replaced_rates: None,
+        }
+    }
+
+    /// Pulls the arms of the next generation, and sets their rates in `mutation_config` until
+    /// `restore` puts back the previous ones. In binary input mode, the random values are
+    /// already restricted to valid subscripts and are left as they are.
+    pub fn schedule(&mut self, mutation_config: &mut MutationConfig, binary_input_mode: bool) {
+        let operator_arm = self.operators.select();
+        self.replaced_rates = Some(Rates::of(mutation_config));
+        match OPERATOR_ARMS[operator_arm] {
+            "constant" => {
+                mutation_config.operator_mutation_rate = 0.0;
+                mutation_config.add_random_const_prob = 0.0;
+                mutation_config.statement_deletion_prob = 0.0;
+            }
+            "operator" => {
+                mutation_config.operator_mutation_rate = 1.0;
+                mutation_config.add_random_const_prob = 0.0;
+                mutation_config.statement_deletion_prob = 0.0;
+            }
+            "add" => {
+                mutation_config.add_random_const_prob = 1.0;
+                mutation_config.statement_deletion_prob = 0.0;
+            }
+            "delete" => mutation_config.statement_deletion_prob = 1.0,
+            "zero_div" => mutation_config.zero_div_attempt_prob = 1.0,
+            "binary" => mutation_config.binary_mode_prob = 1.0,
+            _ => unreachable!(),
+        }
+        if binary_input_mode {
+            self.pulled = Some((operator_arm, None));
+            return;
+        }
+
+        let value_arm = self.values.select();
+        let num_ranges = mutation_config.random_value_probs.len();
+        let weights: Vec<f64> = match VALUE_ARMS[value_arm] {
+            "preset" => mutation_config.random_value_probs.clone(),
+            "uniform" => vec![1.0; num_ranges],
+            "small" => (0..num_ranges).map(|i| 0.5_f64.powi(i as i32)).collect(),
+            "large" => (0..num_ranges)
+                .rev()
+                .map(|i| 0.5_f64.powi(i as i32))
+                .collect(),
+            _ => unreachable!(),
+        };
+        let total: f64 = weights.iter().sum();
+        if 0.0 < total {
+            mutation_config.random_value_probs = weights.iter().map(|w| w / total).collect();
+        }
+        self.pulled = Some((operator_arm, Some(value_arm)));
+    }
+
+    /// Puts back the rates that the arms of the current generation replaced.
+    pub fn restore(&mut self, mutation_config: &mut MutationConfig) {
+        if let Some(rates) = self.replaced_rates.take() {
+            rates.apply_to(mutation_config);
+        }
+    }
+
+    /// Credits the arms of the current generation, whose best fitness score is `score`.
+    ///
+    /// The pull of the first generation is never credited, since it only sets the score to
+    /// improve on.
+    pub fn reward(&mut self, score: &BigInt) {
+        let is_improved = self.best_score.as_ref().map_or(false, |best| score > best);
+        if self.best_score.as_ref().map_or(true, |best| score > best) {
+            self.best_score = Some(score.clone());
+        }
+        if let Some((operator_arm, value_arm)) = self.pulled.take() {
+            self.operators.reward(operator_arm, is_improved);
+            if let Some(value_arm) = value_arm {
+                self.values.reward(value_arm, is_improved);
+            }
+        }
+    }
+
+    /// Returns the credit of every arm.
+    pub fn credits(&self) -> Vec<ArmCredit> {
+        let credits_of = |kind: &str, names: &[&str], bandit: &Bandit| -> Vec<ArmCredit> {
+            names
+                .iter()
+                .enumerate()
+                .map(|(arm, name)| ArmCredit {
+                    kind: kind.to_string(),
+                    arm: name.to_string(),
+                    num_pulls: bandit.num_pulls[arm],
+                    num_improvements: bandit.num_improvements[arm],
+                })
+                .collect()
+        };
+        let mut credits = credits_of("operator", &OPERATOR_ARMS, &self.operators);
+        credits.append(&mut credits_of("value", &VALUE_ARMS, &self.values));
+        credits
+    }
+
+    /// Returns the number of pulls and of improvements of every arm, in the order of
+    /// `credits`, and the best fitness score so far, to be saved in a checkpoint.
+    pub fn state(&self) -> (Vec<(usize, usize)>, Option<BigInt>) {
+        let counts = self
+            .credits()
+            .into_iter()
+            .map(|credit| (credit.num_pulls, credit.num_improvements))
+            .collect();
+        (counts, self.best_score.clone())
+    }
+
+    /// Restores a state returned by `state`. A state of another shape is ignored.
+    pub fn restore_state(&mut self, counts: &[(usize, usize)], best_score: Option<BigInt>) {
+        if counts.len() != OPERATOR_ARMS.len() + VALUE_ARMS.len() {
+            return;
+        }
+        let (operator_counts, value_counts) = counts.split_at(OPERATOR_ARMS.len());
+        for (bandit, counts) in [
+            (&mut self.operators, operator_counts),
+            (&mut self.values, value_counts),
+        ] {
+            for (arm, (num_pulls, num_improvements)) in counts.iter().enumerate() {
+                bandit.num_pulls[arm] = *num_pulls;
+                bandit.num_improvements[arm] = *num_improvements;
+            }
+        }
+        self.best_score = best_score;
+    }
+}
@@ -0,0 +1,318 @@
+//! Cone-of-influence slicing of a symbolic trace.
+//!
+//! Circuits that compute several outputs from disjoint inputs, e.g., a vector of range checks,
+//! yield traces made of independent sub-circuits. Since a statement or a constraint only reads
+//! and writes the variables it mentions, a counterexample of such a circuit is a counterexample
+//! of one of its sub-circuits, whatever the values of the other ones. Each sub-circuit is
+//! therefore searched on its own, and every emulation covers the statements of its slice only.
+
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::thread;
+
+use rustc_hash::{FxHashMap, FxHashSet};
+
+use crate::executor::symbolic_state::{SymbolicConstraints, SymbolicTrace};
+use crate::executor::symbolic_value::{
+    extract_variables_from_symbolic_value, OwnerName, SymbolicAccess, SymbolicLibrary,
+    SymbolicName, SymbolicValue, SymbolicValueRef,
+};
+use crate::mutator::mutation_config::MutationConfig;
+use crate::mutator::mutation_test::{resolve_num_threads, MutationTestResult};
+
+/// An independent sub-circuit of a trace.
+pub struct TraceSlice {
+    /// Positions of the statements of the slice in the full trace, in increasing order.
+    pub positions: Vec<usize>,
+    pub symbolic_trace: SymbolicTrace,
+    pub side_constraints: SymbolicConstraints,
+}
+
+/// Partitions a trace and its side constraints into independent slices.
+///
+/// Two statements or constraints belong to the same slice if they are connected by a chain of
+/// shared variables. An element of an array accessed with a non-constant subscript may alias
+/// any element of the array, so all the elements of such an array share a slice. A variable
+/// also shares a slice with its access prefixes that are mentioned, e.g., `a[0]` with `a`,
+/// since an assignment of an array to `a` defines all the elements `a[i]`. Statements and
+/// constraints without variables are attached to the first slice.
+///
+/// # Parameters
+/// - `symbolic_trace`: The symbolic trace to partition.
+/// - `side_constraints`: The side constraints of the trace.
+///
+/// # Returns
+/// The slices, ordered by their first statement, which keep the relative order of their
+/// statements and constraints. A connected trace yields a single slice.
+pub fn slice_by_cone_of_influence(
+    symbolic_trace: &[SymbolicValueRef],
+    side_constraints: &[SymbolicValueRef],
+) -> Vec<TraceSlice> {
+    let values: Vec<&SymbolicValueRef> = symbolic_trace.iter().chain(side_constraints).collect();
+
+    let mut nodes: FxHashMap<SymbolicName, usize> = FxHashMap::default();
+    let mut parents: Vec<usize> = Vec::new();
+    let mut node_of = |name: SymbolicName, parents: &mut Vec<usize>| {
+        *nodes.entry(name).or_insert_with(|| {
+            parents.push(parents.len());
+            parents.len() - 1
+        })
+    };
+
+    let mut aliased_arrays = FxHashSet::default();
+    let mut names = Vec::new();
+    let mut representatives = Vec::with_capacity(values.len());
+    for value in &values {
+        let variables = collect_variables(value);
+        let mut representative = None;
+        for name in variables {
+            if !is_concrete_name(&name) {
+                aliased_arrays.insert(strip_access(&name));
+            }
+            let node = node_of(name.clone(), &mut parents);
+            match representative {
+                Some(root) => union(&mut parents, root, node),
+                None => representative = Some(node),
+            }
+            names.push((name, node));
+        }
+        representatives.push(representative);
+    }
+    for (name, node) in &names {
+        let array = strip_access(name);
+        if aliased_arrays.contains(&array) {
+            let array_node = node_of(array, &mut parents);
+            union(&mut parents, array_node, *node);
+        }
+    }
+    for (name, node) in &names {
+        for prefix in access_prefixes(name) {
+            if let Some(prefix_node) = nodes.get(&prefix) {
+                union(&mut parents, *prefix_node, *node);
+            }
+        }
+    }
+
+    let mut slice_ids: FxHashMap<usize, usize> = FxHashMap::default();
+    let assigned_slices: Vec<Option<usize>> = representatives
+        .into_iter()
+        .map(|representative| {
+            representative.map(|node| {
+                let root = find(&mut parents, node);
+                let next_id = slice_ids.len();
+                *slice_ids.entry(root).or_insert(next_id)
+            })
+        })
+        .collect();
+    let mut slices: Vec<TraceSlice> = (0..slice_ids.len().max(1))
+        .map(|_| TraceSlice {
+            positions: Vec::new(),
+            symbolic_trace: Vec::new(),
+            side_constraints: Vec::new(),
+        })
+        .collect();
+    for (i, slice_id) in assigned_slices.into_iter().enumerate() {
+        let slice = &mut slices[slice_id.unwrap_or(0)];
+        if i < symbolic_trace.len() {
+            slice.positions.push(i);
+            slice.symbolic_trace.push(values[i].clone());
+        } else {
+            slice.side_constraints.push(values[i].clone());
+        }
+    }
+    slices
+}
+
+/// Searches the slices of a trace with a pool of worker threads.
+///
+/// Each worker owns a copy of the library, and repeatedly claims the next unsearched slice
+/// until a counterexample is found, after which the remaining slices are skipped. The slices
+/// share the threads of `mutation_config.num_threads`, and each one gets an even share of its
+/// time budget.
+///
+/// # Parameters
+/// - `symbolic_library`: The library of the templates and functions of the circuit.
+/// - `slices`: The slices returned by `slice_by_cone_of_influence`.
+/// - `mutation_config`: The mutation configuration of the whole search.
+/// - `search_fn`: Searches a slice with the given library and mutation configuration.
+///
+/// # Returns
+/// The result of the search of each slice, or `None` for the skipped slices.
+pub fn search_slices<SearchFn>(
+    symbolic_library: &SymbolicLibrary,
+    slices: &[TraceSlice],
+    mutation_config: &MutationConfig,
+    search_fn: SearchFn,
+) -> Vec<Option<MutationTestResult>>
+where
+    SearchFn: Fn(&mut SymbolicLibrary, &TraceSlice, &MutationConfig) -> MutationTestResult + Sync,
+{
+    let num_threads = resolve_num_threads(mutation_config.num_threads);
+    let num_workers = num_threads.min(slices.len()).max(1);
+    let slice_configs: Vec<MutationConfig> = (0..slices.len())
+        .map(|slice_id| {
+            config_for_slice(
+                mutation_config,
+                slice_id,
+                slices.len(),
+                num_workers,
+                (num_threads / num_workers).max(1),
+            )
+        })
+        .collect();
+
+    let next_slice = AtomicUsize::new(0);
+    let is_solved = AtomicBool::new(false);
+    let search_fn = &search_fn;
+    let mut results: Vec<Option<MutationTestResult>> = (0..slices.len()).map(|_| None).collect();
+    thread::scope(|s| {
+        let workers: Vec<_> = (0..num_workers)
+            .map(|_| {
+                s.spawn(|| {
+                    let mut library = symbolic_library.clone();
+                    let mut worker_results = Vec::new();
+                    while !is_solved.load(Ordering::Relaxed) {
+                        let slice_id = next_slice.fetch_add(1, Ordering::Relaxed);
+                        if slice_id >= slices.len() {
+                            break;
+                        }
+                        let result =
+                            search_fn(&mut library, &slices[slice_id], &slice_configs[slice_id]);
+                        if result.counter_example.is_some() {
+                            is_solved.store(true, Ordering::Relaxed);
+                        }
+                        worker_results.push((slice_id, result));
+                    }
+                    worker_results
+                })
+            })
+            .collect();
+        for worker in workers {
+            for (slice_id, result) in worker.join().unwrap() {
+                results[slice_id] = Some(result);
+            }
+        }
+    });
+    results
+}
+
+/// Derives the mutation configuration of the search of a slice.
+///
+/// The checkpoints and the island directory of the slices are kept apart, since their states
+/// are unrelated.
+fn config_for_slice(
+    mutation_config: &MutationConfig,
+    slice_id: usize,
+    num_slices: usize,
+    num_workers: usize,
+    num_threads: usize,
+) -> MutationConfig {
+    let mut config = mutation_config.clone();
+    config.num_threads = num_threads;
+    if config.time_budget_secs > 0 {
+        let num_rounds = ((num_slices + num_workers - 1) / num_workers) as u64;
+        config.time_budget_secs = (config.time_budget_secs / num_rounds).max(1);
+    }
+    if !config.checkpoint_path.is_empty() {
+        config.checkpoint_path = format!("{}.slice{}", config.checkpoint_path, slice_id);
+    }
+    if !config.island_dir.is_empty() {
+        config.island_dir = format!("{}/slice{}", config.island_dir, slice_id);
+    }
+    config
+}
+
+/// Collects the variables of `value`, including those of non-constant subscripts.
+pub(crate) fn collect_variables(value: &SymbolicValue) -> Vec<SymbolicName> {
+    let mut variables = FxHashSet::default();
+    extract_variables_from_symbolic_value(value, &mut variables);
+    let mut pending: Vec<SymbolicName> = variables.iter().cloned().collect();
+    while let Some(name) = pending.pop() {
+        let accesses = name
+            .owner
+            .iter()
+            .filter_map(|owner| owner.access.as_ref())
+            .chain(name.access.as_ref());
+        for access in accesses.flatten() {
+            if let SymbolicAccess::ArrayAccess(subscript) = access {
+                let mut subscript_variables = FxHashSet::default();
+                extract_variables_from_symbolic_value(subscript, &mut subscript_variables);
+                for variable in subscript_variables {
+                    if variables.insert(variable.clone()) {
+                        pending.push(variable);
+                    }
+                }
+            }
+        }
+    }
+    let mut variables: Vec<SymbolicName> = variables.into_iter().collect();
+    variables.sort();
+    variables
+}
+
+/// Returns whether all the subscripts of `name` and of its owners are constants.
+pub(crate) fn is_concrete_name(name: &SymbolicName) -> bool {
+    let is_concrete_access = |access: &Option<Vec<SymbolicAccess>>| {
+        access.iter().flatten().all(|access| match access {
+            SymbolicAccess::ComponentAccess(_) => true,
+            SymbolicAccess::ArrayAccess(subscript) => {
+                matches!(subscript, SymbolicValue::ConstantInt(_))
+            }
+        })
+    };
+    is_concrete_access(&name.access)
+        && name
+            .owner
+            .iter()
+            .all(|owner| is_concrete_access(&owner.access))
+}
+
+/// Returns the name of the array that contains `name`, ignoring all subscripts.
+pub(crate) fn strip_access(name: &SymbolicName) -> SymbolicName {
+    let owner: Vec<OwnerName> = name
+        .owner
+        .iter()
+        .map(|owner| OwnerName {
+            id: owner.id,
+            access: None,
+            counter: owner.counter,
+        })
+        .collect();
+    SymbolicName::new(name.id, Arc::new(owner), None)
+}
+
+/// Returns the names of the arrays and sub-arrays that contain `name`, obtained by dropping
+/// trailing subscripts, from the whole array to the closest one.
+fn access_prefixes(name: &SymbolicName) -> Vec<SymbolicName> {
+    let access = match &name.access {
+        Some(access) if !access.is_empty() => access,
+        _ => return Vec::new(),
+    };
+    let mut prefixes = vec![
+        SymbolicName::new(name.id, name.owner.clone(), None),
+        SymbolicName::new(name.id, name.owner.clone(), Some(Vec::new())),
+    ];
+    for len in 1..access.len() {
+        prefixes.push(SymbolicName::new(
+            name.id,
+            name.owner.clone(),
+            Some(access[..len].to_vec()),
+        ));
+    }
+    prefixes
+}
+
+fn find(parents: &mut [usize], mut node: usize) -> usize {
+    while parents[node] != node {
+        parents[node] = parents[parents[node]];
+        node = parents[node];
+    }
+    node
+}
+
+fn union(parents: &mut [usize], lhs: usize, rhs: usize) {
+    let (lhs, rhs) = (find(parents, lhs), find(parents, rhs));
+    if lhs != rhs {
+        parents[rhs.max(lhs)] = lhs.min(rhs);
+    }
+}
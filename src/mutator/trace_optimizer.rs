@@ -0,0 +1,316 @@
+//! Optimization of a symbolic trace before the search.
+//!
+//! Every candidate input of the search emulates the whole trace and evaluates all the side
+//! constraints, so work removed from them once is saved on every emulation. The optimizer
+//! folds constant sub-expressions, drops `NOP`s, trivially true and duplicated constraints, and
+//! assignments that neither a constraint nor an output of the main template depends on. It
+//! keeps the position in the original trace of every remaining statement, so that the failure
+//! positions reported by the search can be mapped back.
+
+use std::sync::Arc;
+
+use num_bigint_dig::BigInt;
+use num_traits::Signed;
+use rustc_hash::{FxHashMap, FxHashSet};
+
+use program_structure::ast::ExpressionPrefixOpcode;
+
+use crate::executor::symbolic_state::{SymbolicConstraints, SymbolicTrace};
+use crate::executor::symbolic_value::{
+    evaluate_binary_op, evaluate_binary_op_integer_mode, precompute_hashes_of_symbolic_value,
+    SymbolicAccess, SymbolicName, SymbolicValue, SymbolicValueRef,
+};
+use crate::mutator::slicing::{collect_variables, is_concrete_name, strip_access};
+use crate::mutator::utils::{CounterExample, UnderConstrainedType, VerificationResult};
+
+/// A trace and its side constraints after `optimize_trace`.
+pub struct OptimizedTrace {
+    pub symbolic_trace: SymbolicTrace,
+    pub side_constraints: SymbolicConstraints,
+    /// Position in the original trace of every statement of the optimized trace.
+    pub positions: Vec<usize>,
+}
+
+/// Optimizes a trace and its side constraints without changing the outcome of their emulation
+/// on the outputs of the main template.
+///
+/// # Parameters
+/// - `prime`: The prime modulus of the field.
+/// - `symbolic_trace`: The symbolic trace of the main template.
+/// - `side_constraints`: The side constraints of the main template.
+/// - `output_ids`: The ids of the output signals of the main template.
+///
+/// # Returns
+/// The optimized trace, whose statements keep their relative order.
+///
+/// # Notes
+/// - Constraints of the trace are always kept, even if no output depends on them, since they
+///   decide whether the program fails, and hash checks may assign their variables at runtime.
+/// - An assignment whose target is accessed with a non-constant subscript is always kept, and
+///   so is any assignment to an array that is read with one.
+pub fn optimize_trace(
+    prime: &BigInt,
+    symbolic_trace: &[SymbolicValueRef],
+    side_constraints: &[SymbolicValueRef],
+    output_ids: &FxHashSet<usize>,
+) -> OptimizedTrace {
+    let mut seen_constraints = FxHashSet::default();
+    let mut optimized_side_constraints = Vec::new();
+    for constraint in side_constraints {
+        // The assignments of template parameters always hold.
+        if let SymbolicValue::AssignTemplParam(..) = constraint.as_ref() {
+            continue;
+        }
+        if let Some(folded) = fold_statement(prime, constraint) {
+            if seen_constraints.insert(folded.clone()) {
+                optimized_side_constraints.push(folded);
+            }
+        }
+    }
+
+    let mut liveness = Liveness::default();
+    for constraint in &optimized_side_constraints {
+        liveness.insert_all(collect_variables(constraint));
+    }
+    let mut statements = Vec::new();
+    for (pos, statement) in symbolic_trace.iter().enumerate().rev() {
+        let folded = match fold_statement(prime, statement) {
+            Some(folded) => folded,
+            None => continue,
+        };
+        let is_live = match assigned_name(&folded) {
+            Some(name) => {
+                (name.owner.len() == 1 && output_ids.contains(&name.id))
+                    || !is_concrete_name(name)
+                    || liveness.contains(name)
+            }
+            None => true,
+        };
+        if is_live {
+            liveness.insert_all(collect_variables(&folded));
+            statements.push((pos, folded));
+        }
+    }
+    statements.reverse();
+
+    for value in statements
+        .iter()
+        .map(|(_, statement)| statement)
+        .chain(&optimized_side_constraints)
+    {
+        precompute_hashes_of_symbolic_value(value);
+    }
+    let (positions, optimized_trace) = statements.into_iter().unzip();
+    OptimizedTrace {
+        symbolic_trace: optimized_trace,
+        side_constraints: optimized_side_constraints,
+        positions,
+    }
+}
+
+/// Maps the failure position of a counterexample found on an optimized trace back to the
+/// original trace.
+///
+/// # Parameters
+/// - `counter_example`: The counterexample reported by the search of the optimized trace.
+/// - `positions`: The position in `original_trace` of every statement of the optimized trace.
+/// - `original_trace`: The trace before the optimization.
+/// - `id2name`: The names of the ids of the library, used to print the violated condition.
+pub fn restore_failure_position(
+    counter_example: &mut CounterExample,
+    positions: &[usize],
+    original_trace: &[SymbolicValueRef],
+    id2name: &FxHashMap<usize, String>,
+) {
+    if let VerificationResult::UnderConstrained(UnderConstrainedType::UnexpectedInput(
+        pos,
+        violated_condition,
+    )) = &mut counter_example.flag
+    {
+        if let Some(original_pos) = positions.get(*pos) {
+            *pos = *original_pos;
+            *violated_condition = original_trace[*original_pos].lookup_fmt(id2name);
+        }
+    }
+}
+
+/// The variables read by the statements kept so far, compared by their access paths, since an
+/// assignment of an array to `a` defines all the elements `a[i]`.
+#[derive(Default)]
+struct Liveness {
+    accesses: FxHashMap<SymbolicName, FxHashSet<Vec<SymbolicAccess>>>,
+    aliased_arrays: FxHashSet<SymbolicName>,
+}
+
+impl Liveness {
+    fn insert_all(&mut self, names: Vec<SymbolicName>) {
+        for name in names {
+            if !is_concrete_name(&name) {
+                self.aliased_arrays.insert(strip_access(&name));
+            }
+            let access = name.access.clone().unwrap_or_default();
+            self.accesses
+                .entry(SymbolicName::new(name.id, name.owner.clone(), None))
+                .or_default()
+                .insert(access);
+        }
+    }
+
+    /// Returns whether an assignment to `name` may define a variable read later.
+    fn contains(&self, name: &SymbolicName) -> bool {
+        if self.aliased_arrays.contains(&strip_access(name)) {
+            return true;
+        }
+        let access = name.access.clone().unwrap_or_default();
+        match self
+            .accesses
+            .get(&SymbolicName::new(name.id, name.owner.clone(), None))
+        {
+            Some(live_accesses) => {
+                live_accesses.contains(&access)
+                    || live_accesses.iter().any(|live_access| {
+                        live_access.starts_with(&access) || access.starts_with(live_access)
+                    })
+            }
+            None => false,
+        }
+    }
+}
+
+/// Returns the target of an assignment.
+fn assigned_name(statement: &SymbolicValue) -> Option<&SymbolicName> {
+    match statement {
+        SymbolicValue::Assign(lhs, _, _, _)
+        | SymbolicValue::AssignEq(lhs, _)
+        | SymbolicValue::AssignTemplParam(lhs, _)
+        | SymbolicValue::AssignCall(lhs, _, _) => match lhs.as_ref() {
+            SymbolicValue::Variable(name) => Some(name),
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
+/// Folds the constants of a statement, or returns `None` if the statement has no effect.
+///
+/// The right-hand sides of assignments are folded. A constraint that folds to `true` is
+/// dropped, and one that folds to another constant is kept as it is, so that its error is
+/// still measured on its operands.
+fn fold_statement(prime: &BigInt, statement: &SymbolicValueRef) -> Option<SymbolicValueRef> {
+    match statement.as_ref() {
+        SymbolicValue::NOP => None,
+        SymbolicValue::Assign(lhs, rhs, is_safe, meta) => {
+            let folded_rhs = fold_constants(prime, rhs);
+            Some(if Arc::ptr_eq(&folded_rhs, rhs) {
+                statement.clone()
+            } else {
+                Arc::new(SymbolicValue::Assign(
+                    lhs.clone(),
+                    folded_rhs,
+                    *is_safe,
+                    meta.clone(),
+                ))
+            })
+        }
+        SymbolicValue::AssignEq(lhs, rhs) => {
+            let folded_rhs = fold_constants(prime, rhs);
+            Some(if Arc::ptr_eq(&folded_rhs, rhs) {
+                statement.clone()
+            } else {
+                Arc::new(SymbolicValue::AssignEq(lhs.clone(), folded_rhs))
+            })
+        }
+        SymbolicValue::AssignTemplParam(..) | SymbolicValue::AssignCall(..) => {
+            Some(statement.clone())
+        }
+        _ => {
+            let folded = fold_constants(prime, statement);
+            match folded.as_ref() {
+                SymbolicValue::ConstantBool(true) => None,
+                SymbolicValue::ConstantBool(_) | SymbolicValue::ConstantInt(_) => {
+                    Some(statement.clone())
+                }
+                _ => Some(folded),
+            }
+        }
+    }
+}
+
+/// Folds the constant sub-expressions of `value` the way `evaluate_symbolic_value` evaluates
+/// them on every input.
+fn fold_constants(prime: &BigInt, value: &SymbolicValueRef) -> SymbolicValueRef {
+    match value.as_ref() {
+        SymbolicValue::BinaryOp(lhs, op, rhs) | SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+            let folded_lhs = fold_constants(prime, lhs);
+            let folded_rhs = fold_constants(prime, rhs);
+            if is_constant(&folded_lhs) && is_constant(&folded_rhs) {
+                Arc::new(if let SymbolicValue::BinaryOp(..) = value.as_ref() {
+                    evaluate_binary_op(&folded_lhs, &folded_rhs, prime, op)
+                } else {
+                    evaluate_binary_op_integer_mode(&folded_lhs, &folded_rhs, prime, op)
+                })
+            } else if Arc::ptr_eq(&folded_lhs, lhs) && Arc::ptr_eq(&folded_rhs, rhs) {
+                value.clone()
+            } else if let SymbolicValue::BinaryOp(..) = value.as_ref() {
+                Arc::new(SymbolicValue::BinaryOp(folded_lhs, op.clone(), folded_rhs))
+            } else {
+                Arc::new(SymbolicValue::AuxBinaryOp(
+                    folded_lhs,
+                    op.clone(),
+                    folded_rhs,
+                ))
+            }
+        }
+        SymbolicValue::UnaryOp(op, expr) => {
+            let folded_expr = fold_constants(prime, expr);
+            match (&op.0, folded_expr.as_ref()) {
+                (ExpressionPrefixOpcode::Sub, SymbolicValue::ConstantInt(rv)) => {
+                    Arc::new(SymbolicValue::ConstantInt(-1 * rv))
+                }
+                (ExpressionPrefixOpcode::BoolNot, SymbolicValue::ConstantBool(rv)) => {
+                    Arc::new(SymbolicValue::ConstantBool(!rv))
+                }
+                _ if Arc::ptr_eq(&folded_expr, expr) => value.clone(),
+                _ => Arc::new(SymbolicValue::UnaryOp(op.clone(), folded_expr)),
+            }
+        }
+        SymbolicValue::Conditional(cond, then_branch, else_branch) => {
+            let folded_cond = fold_constants(prime, cond);
+            match folded_cond.as_ref() {
+                SymbolicValue::ConstantBool(true) => fold_constants(prime, then_branch),
+                SymbolicValue::ConstantBool(false) => fold_constants(prime, else_branch),
+                SymbolicValue::ConstantInt(num) => {
+                    if num.is_positive() {
+                        fold_constants(prime, then_branch)
+                    } else {
+                        fold_constants(prime, else_branch)
+                    }
+                }
+                _ => {
+                    let folded_then = fold_constants(prime, then_branch);
+                    let folded_else = fold_constants(prime, else_branch);
+                    if Arc::ptr_eq(&folded_cond, cond)
+                        && Arc::ptr_eq(&folded_then, then_branch)
+                        && Arc::ptr_eq(&folded_else, else_branch)
+                    {
+                        value.clone()
+                    } else {
+                        Arc::new(SymbolicValue::Conditional(
+                            folded_cond,
+                            folded_then,
+                            folded_else,
+                        ))
+                    }
+                }
+            }
+        }
+        _ => value.clone(),
+    }
+}
+
+fn is_constant(value: &SymbolicValue) -> bool {
+    matches!(
+        value,
+        SymbolicValue::ConstantInt(_) | SymbolicValue::ConstantBool(_)
+    )
+}
@@ -1,6 +1,6 @@
 use core::panic;
 use std::fmt;
-use std::rc::Rc;
+use std::sync::Arc;
 
 use colored::Colorize;
 use num_bigint_dig::BigInt;
@@ -18,9 +18,12 @@ use crate::executor::symbolic_execution::SymbolicExecutor;
 use crate::executor::symbolic_setting::SymbolicExecutorSetting;
 use crate::executor::symbolic_value::{
     evaluate_binary_op, evaluate_binary_op_integer_mode, extract_variables_from_symbolic_value,
-    normalize_to_bool, normalize_to_int, val_for_relational_operators, OwnerName, QuadraticPoly,
-    SymbolicAccess, SymbolicLibrary, SymbolicName, SymbolicValue, SymbolicValueRef,
+    get_coefficient_of_polynomials, get_degree_polynomial, normalize_to_bool, normalize_to_int,
+    val_for_relational_operators, OwnerName, QuadraticPoly, SymbolicAccess, SymbolicLibrary,
+    SymbolicName, SymbolicValue, SymbolicValueRef,
 };
+use crate::metrics;
+use crate::metrics::Counter;
 
 #[derive(Clone)]
 pub enum UnderConstrainedType {
@@ -215,6 +218,15 @@ pub struct BaseVerificationConfig {
     pub quick_mode: bool,
     pub heuristics_mode: bool,
     pub progress_interval: usize,
+    /// Number of worker threads of the brute-force search, where `0` stands for all cores.
+    pub num_threads: usize,
+    /// First index of the assignments verified by the brute-force search.
+    pub search_start: BigInt,
+    /// End (exclusive) of the indices of the assignments verified by the brute-force search.
+    pub search_end: Option<BigInt>,
+    /// Command of the witness oracle that runs the original program in the brute-force
+    /// search instead of the concrete executor, see `witness_oracle`.
+    pub witness_oracle: Option<String>,
     pub template_param_names: Vec<String>,
     pub template_param_values: Vec<Expression>,
 }
@@ -316,24 +328,159 @@ pub fn evaluate_constraints(
     assignment: &FxHashMap<SymbolicName, BigInt>,
     symbolic_library: &mut SymbolicLibrary,
 ) -> bool {
-    if constraints.is_empty() {
-        true
-    } else {
-        constraints.iter().all(|constraint| {
-            let sv = evaluate_symbolic_value(prime, constraint, assignment, symbolic_library);
-            match sv {
-                Some(SymbolicValue::ConstantBool(b)) => b,
-                Some(v) => {
-                    panic!(
-                        "Non-bool output value is detected when evaluating a constraint: {}",
-                        v.lookup_fmt(&symbolic_library.id2name)
-                    )
-                }
-                _ => {
-                    panic!("Non-bool output value is detected when evaluating a constraint: None",)
-                }
+    constraints
+        .iter()
+        .all(|constraint| evaluate_constraint(prime, constraint, assignment, symbolic_library))
+}
+
+/// Evaluates a set of constraints like `evaluate_constraints`, in the order learned by
+/// `scheduler`, and stops at the first violated constraint.
+///
+/// # Parameters
+/// - `scheduler`: A scheduler created for `constraints`, which is updated with the outcome.
+///
+/// See `evaluate_constraints` for the other parameters and the result.
+pub fn evaluate_constraints_in_order(
+    prime: &BigInt,
+    constraints: &[SymbolicValueRef],
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    symbolic_library: &mut SymbolicLibrary,
+    scheduler: &mut ConstraintScheduler,
+) -> bool {
+    scheduler.all(|i| evaluate_constraint(prime, &constraints[i], assignment, symbolic_library))
+}
+
+fn evaluate_constraint(
+    prime: &BigInt,
+    constraint: &SymbolicValue,
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    symbolic_library: &mut SymbolicLibrary,
+) -> bool {
+    let sv = evaluate_symbolic_value(prime, constraint, assignment, symbolic_library);
+    match sv {
+        Some(SymbolicValue::ConstantBool(b)) => b,
+        Some(v) => {
+            panic!(
+                "Non-bool output value is detected when evaluating a constraint: {}",
+                v.lookup_fmt(&symbolic_library.id2name)
+            )
+        }
+        _ => {
+            panic!("Non-bool output value is detected when evaluating a constraint: None",)
+        }
+    }
+}
+
+/// Number of checks between two updates of the order of a `ConstraintScheduler`.
+const REORDER_INTERVAL: usize = 64;
+
+/// Learns an order of a set of constraints in which a violated constraint, if any, is found
+/// early, for the checks that only need to know whether all the constraints hold.
+///
+/// Each constraint has a fixed cost, and an estimated probability of being violated, which is
+/// its share of violations among its evaluations so far (with a prior of one violation in two
+/// evaluations). Constraints are checked in decreasing order of probability per unit of cost,
+/// which minimizes the expected cost of a check when violations are independent, so that the
+/// cheapest constraints come first until violations have been observed.
+///
+/// The result of a check does not depend on the order, so a search using a scheduler gives the
+/// same results as one evaluating the constraints in their declaration order. Checks that need
+/// the error of every constraint, as the error-based fitness scores do, must not use it.
+#[derive(Clone)]
+pub struct ConstraintScheduler {
+    costs: Vec<usize>,
+    num_evaluations: Vec<u64>,
+    num_violations: Vec<u64>,
+    order: Vec<usize>,
+    num_checks: usize,
+}
+
+impl ConstraintScheduler {
+    /// Creates a scheduler for constraints with the given costs, in declaration order.
+    pub fn new(costs: Vec<usize>) -> Self {
+        let n = costs.len();
+        let mut scheduler = ConstraintScheduler {
+            costs,
+            num_evaluations: vec![0; n],
+            num_violations: vec![0; n],
+            order: (0..n).collect(),
+            num_checks: 0,
+        };
+        scheduler.reorder();
+        scheduler
+    }
+
+    /// Creates a scheduler for `constraints`, whose costs are the sizes of the constraints.
+    pub fn for_constraints(constraints: &[SymbolicValueRef]) -> Self {
+        ConstraintScheduler::new(
+            constraints
+                .iter()
+                .map(|c| size_of_symbolic_value(c))
+                .collect(),
+        )
+    }
+
+    /// Returns the current order of the constraints.
+    pub fn order(&self) -> &[usize] {
+        &self.order
+    }
+
+    /// Returns whether `is_satisfied` holds for all the constraints, calling it on their
+    /// indices in the learned order until the first violated one.
+    pub fn all<F: FnMut(usize) -> bool>(&mut self, mut is_satisfied: F) -> bool {
+        let mut result = true;
+        for &i in &self.order {
+            self.num_evaluations[i] += 1;
+            if !is_satisfied(i) {
+                self.num_violations[i] += 1;
+                result = false;
+                break;
             }
-        })
+        }
+        self.num_checks += 1;
+        if self.num_checks % REORDER_INTERVAL == 0 {
+            self.reorder();
+        }
+        result
+    }
+
+    fn reorder(&mut self) {
+        let priorities: Vec<f64> = (0..self.costs.len())
+            .map(|i| {
+                let violation_rate =
+                    (self.num_violations[i] + 1) as f64 / (self.num_evaluations[i] + 2) as f64;
+                violation_rate / (self.costs[i] + 1) as f64
+            })
+            .collect();
+        // The sort is stable, so that ties keep the declaration order.
+        self.order
+            .sort_by(|l, r| priorities[*r].partial_cmp(&priorities[*l]).unwrap());
+    }
+}
+
+/// Returns the number of nodes of `value`, as an estimate of the cost of its evaluation.
+pub fn size_of_symbolic_value(value: &SymbolicValue) -> usize {
+    1 + match value {
+        SymbolicValue::Assign(lhs, rhs, _, _)
+        | SymbolicValue::AssignEq(lhs, rhs)
+        | SymbolicValue::AssignTemplParam(lhs, rhs)
+        | SymbolicValue::AssignCall(lhs, rhs, _)
+        | SymbolicValue::BinaryOp(lhs, _, rhs)
+        | SymbolicValue::AuxBinaryOp(lhs, _, rhs)
+        | SymbolicValue::UniformArray(lhs, rhs) => {
+            size_of_symbolic_value(lhs) + size_of_symbolic_value(rhs)
+        }
+        SymbolicValue::UnaryOp(_, expr) => size_of_symbolic_value(expr),
+        SymbolicValue::Conditional(cond, then_val, else_val) => {
+            size_of_symbolic_value(cond)
+                + size_of_symbolic_value(then_val)
+                + size_of_symbolic_value(else_val)
+        }
+        SymbolicValue::Array(elements) | SymbolicValue::Call(_, elements) => elements
+            .iter()
+            .map(|elem| size_of_symbolic_value(elem))
+            .sum(),
+        _ => 0,
     }
 }
 
@@ -358,6 +505,51 @@ pub fn gather_potential_zero_division(
     result
 }
 
+/// Gathers, for each constraint, the quadratic polynomials of the difference of its two sides
+/// over each variable of `targets` that it mentions, see `get_coefficient_of_polynomials`.
+///
+/// Only equalities are gathered, and a variable whose degree exceeds 2 is left out, so the
+/// polynomials of the other constraints are empty.
+pub fn gather_constraint_polynomials(
+    constraints: &[SymbolicValueRef],
+    targets: &FxHashSet<SymbolicName>,
+    prime: &BigInt,
+) -> Vec<Vec<QuadraticPoly>> {
+    constraints
+        .iter()
+        .map(|constraint| {
+            let (lhs, rhs) = match constraint.as_ref() {
+                SymbolicValue::AssignEq(lhs, rhs) => (lhs, rhs),
+                SymbolicValue::BinaryOp(lhs, op, rhs)
+                    if matches!(op.0, ExpressionInfixOpcode::Eq) =>
+                {
+                    (lhs, rhs)
+                }
+                _ => return Vec::new(),
+            };
+            let difference = SymbolicValue::BinaryOp(
+                lhs.clone(),
+                DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Sub),
+                rhs.clone(),
+            );
+            let mut variables = FxHashSet::default();
+            extract_variables_from_symbolic_value(&difference, &mut variables);
+            let mut variables: Vec<SymbolicName> = variables
+                .into_iter()
+                .filter(|v| targets.contains(v) && get_degree_polynomial(&difference, v) <= 2)
+                .collect();
+            variables.sort();
+            variables
+                .into_iter()
+                .map(|v| {
+                    let coefs = get_coefficient_of_polynomials(&difference, &v, prime);
+                    (v, coefs)
+                })
+                .collect()
+        })
+        .collect()
+}
+
 /// Gathers runtime mutable inputs from a symbolic execution trace.
 ///
 /// This function analyzes a symbolic execution trace to identify inputs that are mutable during runtime.
@@ -471,304 +663,323 @@ pub fn emulate_symbolic_trace(
 ) -> Option<(bool, usize)> {
     let mut success = true;
     let mut failure_pos = 0;
-    // let input_variables: FxHashSet<SymbolicName> = assignment.keys().cloned().collect();
     for (i, inst) in trace.iter().enumerate() {
-        // println!("{}", inst.lookup_fmt(&symbolic_library.id2name));
-        match inst.as_ref() {
-            SymbolicValue::NOP => {}
-            SymbolicValue::ConstantBool(b) => {
-                if !b {
-                    success = false;
-                    failure_pos = i;
-                }
+        if !emulate_symbolic_statement(
+            prime,
+            i,
+            inst,
+            runtime_mutable_positions,
+            assignment,
+            symbolic_library,
+        )? {
+            success = false;
+            failure_pos = i;
+        }
+    }
+
+    Some((success, failure_pos))
+}
+
+/// Emulates a single statement of a symbolic trace.
+///
+/// # Parameters
+/// - `prime`: A reference to the prime modulus used for modular arithmetic.
+/// - `pos`: The position of `inst` within its trace, used to look up `runtime_mutable_positions`.
+/// - `inst`: The statement to emulate.
+/// - `runtime_mutable_positions`: A map of runtime mutable positions.
+/// - `assignment`: A mutable hash map of symbolic variable names to their corresponding `BigInt` values.
+/// - `symbolic_library`: A mutable reference to a symbolic library containing the definitions of symbolic values.
+///
+/// # Returns
+/// `Some(true)` if the statement holds, `Some(false)` if it fails, and `None` if the right-hand
+/// side of an assignment cannot be evaluated under `assignment`.
+pub fn emulate_symbolic_statement(
+    prime: &BigInt,
+    pos: usize,
+    inst: &SymbolicValueRef,
+    runtime_mutable_positions: &FxHashMap<usize, Direction>,
+    assignment: &mut FxHashMap<SymbolicName, BigInt>,
+    symbolic_library: &mut SymbolicLibrary,
+) -> Option<bool> {
+    match inst.as_ref() {
+        SymbolicValue::NOP => {}
+        SymbolicValue::ConstantBool(b) => {
+            if !b {
+                return Some(false);
             }
-            SymbolicValue::Assign(lhs, rhs, _, _)
-            | SymbolicValue::AssignEq(lhs, rhs)
-            | SymbolicValue::AssignTemplParam(lhs, rhs)
-            | SymbolicValue::AssignCall(lhs, rhs, _) => {
-                if let SymbolicValue::Variable(sym_name) = lhs.as_ref() {
-                    let rhs_val = evaluate_symbolic_value(prime, rhs, assignment, symbolic_library);
-                    match &rhs_val {
-                        Some(SymbolicValue::NOP) => {
-                            if !assignment.contains_key(sym_name) {
-                                assignment.insert(sym_name.clone(), BigInt::zero());
-                            }
-                        }
-                        Some(SymbolicValue::ConstantInt(num)) => {
-                            assignment.insert(sym_name.clone(), num.clone());
-                        }
-                        Some(SymbolicValue::ConstantBool(b)) => {
-                            assignment.insert(
-                                sym_name.clone(),
-                                if *b { BigInt::one() } else { BigInt::zero() },
-                            );
+        }
+        SymbolicValue::Assign(lhs, rhs, _, _)
+        | SymbolicValue::AssignEq(lhs, rhs)
+        | SymbolicValue::AssignTemplParam(lhs, rhs)
+        | SymbolicValue::AssignCall(lhs, rhs, _) => {
+            if let SymbolicValue::Variable(sym_name) = lhs.as_ref() {
+                let rhs_val = evaluate_symbolic_value(prime, rhs, assignment, symbolic_library);
+                match &rhs_val {
+                    Some(SymbolicValue::NOP) => {
+                        if !assignment.contains_key(sym_name) {
+                            assignment.insert(sym_name.clone(), BigInt::zero());
                         }
-                        Some(SymbolicValue::Array(arr)) => {
-                            for (i, a) in arr.iter().enumerate() {
-                                if let SymbolicValue::ConstantInt(v) = a.as_ref() {
-                                    let mut name = sym_name.clone();
-                                    let mut accsess = if name.access.is_some() {
-                                        name.access.unwrap().clone()
-                                    } else {
-                                        Vec::new()
-                                    };
-                                    accsess.push(SymbolicAccess::ArrayAccess(
-                                        SymbolicValue::ConstantInt(BigInt::from(i)),
-                                    ));
-                                    name.access = Some(accsess);
-                                    name.update_hash();
-                                    assignment.insert(name, v.clone());
+                    }
+                    Some(SymbolicValue::ConstantInt(num)) => {
+                        assignment.insert(sym_name.clone(), num.clone());
+                    }
+                    Some(SymbolicValue::ConstantBool(b)) => {
+                        assignment.insert(
+                            sym_name.clone(),
+                            if *b { BigInt::one() } else { BigInt::zero() },
+                        );
+                    }
+                    Some(SymbolicValue::Array(arr)) => {
+                        for (i, a) in arr.iter().enumerate() {
+                            if let SymbolicValue::ConstantInt(v) = a.as_ref() {
+                                let mut name = sym_name.clone();
+                                let mut accsess = if name.access.is_some() {
+                                    name.access.unwrap().clone()
                                 } else {
-                                    todo!("Support nested-arrays for template parameters");
-                                }
+                                    Vec::new()
+                                };
+                                accsess.push(SymbolicAccess::ArrayAccess(
+                                    SymbolicValue::ConstantInt(BigInt::from(i)),
+                                ));
+                                name.access = Some(accsess);
+                                name.update_hash();
+                                assignment.insert(name, v.clone());
+                            } else {
+                                todo!("Support nested-arrays for template parameters");
                             }
                         }
-                        None => {
-                            return None;
-                        }
-                        _ => {
-                            success = false;
-                            failure_pos = i;
-                        }
                     }
-                } else {
-                    panic!(
-                        "Left hand of the assignment is not a variable: {}",
-                        inst.lookup_fmt(&symbolic_library.id2name)
-                    );
+                    None => {
+                        return None;
+                    }
+                    _ => {
+                        return Some(false);
+                    }
                 }
+            } else {
+                panic!(
+                    "Left hand of the assignment is not a variable: {}",
+                    inst.lookup_fmt(&symbolic_library.id2name)
+                );
             }
-            SymbolicValue::BinaryOp(lhs, op, rhs) => {
-                let mut lhs_val = evaluate_symbolic_value(prime, lhs, assignment, symbolic_library);
-                let mut rhs_val = evaluate_symbolic_value(prime, rhs, assignment, symbolic_library);
-
-                if let Some(dir) = runtime_mutable_positions.get(&i) {
-                    match dir {
-                        Direction::Left => {
-                            if let SymbolicValue::Variable(var_name) = &**lhs {
-                                if let Some(SymbolicValue::ConstantInt(ref num)) = rhs_val {
-                                    assignment.insert(var_name.clone(), num.clone());
-                                    lhs_val = rhs_val.clone();
-                                }
+        }
+        SymbolicValue::BinaryOp(lhs, op, rhs) => {
+            let mut lhs_val = evaluate_symbolic_value(prime, lhs, assignment, symbolic_library);
+            let mut rhs_val = evaluate_symbolic_value(prime, rhs, assignment, symbolic_library);
+
+            if let Some(dir) = runtime_mutable_positions.get(&pos) {
+                match dir {
+                    Direction::Left => {
+                        if let SymbolicValue::Variable(var_name) = &**lhs {
+                            if let Some(SymbolicValue::ConstantInt(ref num)) = rhs_val {
+                                assignment.insert(var_name.clone(), num.clone());
+                                lhs_val = rhs_val.clone();
                             }
                         }
-                        Direction::Right => {
-                            if let SymbolicValue::Variable(var_name) = &**rhs {
-                                if let Some(SymbolicValue::ConstantInt(ref num)) = lhs_val {
-                                    assignment.insert(var_name.clone(), num.clone());
-                                    rhs_val = lhs_val.clone();
-                                }
+                    }
+                    Direction::Right => {
+                        if let SymbolicValue::Variable(var_name) = &**rhs {
+                            if let Some(SymbolicValue::ConstantInt(ref num)) = lhs_val {
+                                assignment.insert(var_name.clone(), num.clone());
+                                rhs_val = lhs_val.clone();
                             }
                         }
                     }
                 }
+            }
 
-                let (normalized_lhs, normalized_rhs) = match &op.0 {
-                    // Convert booleans to integers for arithmetic or bitwise operators
-                    ExpressionInfixOpcode::Add
-                    | ExpressionInfixOpcode::Sub
-                    | ExpressionInfixOpcode::Mul
-                    | ExpressionInfixOpcode::Pow
-                    | ExpressionInfixOpcode::Div
-                    | ExpressionInfixOpcode::IntDiv
-                    | ExpressionInfixOpcode::Mod
-                    | ExpressionInfixOpcode::BitOr
-                    | ExpressionInfixOpcode::BitAnd
-                    | ExpressionInfixOpcode::BitXor
-                    | ExpressionInfixOpcode::ShiftL
-                    | ExpressionInfixOpcode::ShiftR
-                    | ExpressionInfixOpcode::Lesser
-                    | ExpressionInfixOpcode::Greater
-                    | ExpressionInfixOpcode::LesserEq
-                    | ExpressionInfixOpcode::GreaterEq
-                    | ExpressionInfixOpcode::Eq
-                    | ExpressionInfixOpcode::NotEq => (
-                        normalize_to_int(&lhs_val.unwrap(), prime),
-                        normalize_to_int(&rhs_val.unwrap(), prime),
-                    ),
-                    // Keep booleans as they are for logical operators
-                    ExpressionInfixOpcode::BoolAnd | ExpressionInfixOpcode::BoolOr => (
-                        normalize_to_bool(&lhs_val.unwrap(), prime),
-                        normalize_to_bool(&rhs_val.unwrap(), prime),
-                    ), //_ => (lhs.clone(), rhs.clone()), // Default case
-                };
-
-                let flag = match (&normalized_lhs, &normalized_rhs) {
-                    (SymbolicValue::ConstantInt(lv), SymbolicValue::ConstantInt(rv)) => {
-                        match op.0 {
-                            ExpressionInfixOpcode::Lesser => {
-                                val_for_relational_operators(&(lv % prime), prime)
-                                    < val_for_relational_operators(&(rv % prime), prime)
-                            }
-                            ExpressionInfixOpcode::Greater => {
-                                val_for_relational_operators(&(lv % prime), prime)
-                                    > val_for_relational_operators(&(rv % prime), prime)
-                            }
-                            ExpressionInfixOpcode::LesserEq => {
-                                val_for_relational_operators(&(lv % prime), prime)
-                                    <= val_for_relational_operators(&(rv % prime), prime)
-                            }
-                            ExpressionInfixOpcode::GreaterEq => {
-                                val_for_relational_operators(&(lv % prime), prime)
-                                    >= val_for_relational_operators(&(rv % prime), prime)
-                            }
-                            ExpressionInfixOpcode::Eq => lv % prime == rv % prime,
-                            ExpressionInfixOpcode::NotEq => lv % prime != rv % prime,
-                            _ => panic!(
-                                "Non-Boolean Operation: {}",
-                                inst.lookup_fmt(&symbolic_library.id2name)
-                            ),
-                        }
+            let (normalized_lhs, normalized_rhs) = match &op.0 {
+                // Convert booleans to integers for arithmetic or bitwise operators
+                ExpressionInfixOpcode::Add
+                | ExpressionInfixOpcode::Sub
+                | ExpressionInfixOpcode::Mul
+                | ExpressionInfixOpcode::Pow
+                | ExpressionInfixOpcode::Div
+                | ExpressionInfixOpcode::IntDiv
+                | ExpressionInfixOpcode::Mod
+                | ExpressionInfixOpcode::BitOr
+                | ExpressionInfixOpcode::BitAnd
+                | ExpressionInfixOpcode::BitXor
+                | ExpressionInfixOpcode::ShiftL
+                | ExpressionInfixOpcode::ShiftR
+                | ExpressionInfixOpcode::Lesser
+                | ExpressionInfixOpcode::Greater
+                | ExpressionInfixOpcode::LesserEq
+                | ExpressionInfixOpcode::GreaterEq
+                | ExpressionInfixOpcode::Eq
+                | ExpressionInfixOpcode::NotEq => (
+                    normalize_to_int(&lhs_val.unwrap(), prime),
+                    normalize_to_int(&rhs_val.unwrap(), prime),
+                ),
+                // Keep booleans as they are for logical operators
+                ExpressionInfixOpcode::BoolAnd | ExpressionInfixOpcode::BoolOr => (
+                    normalize_to_bool(&lhs_val.unwrap(), prime),
+                    normalize_to_bool(&rhs_val.unwrap(), prime),
+                ), //_ => (lhs.clone(), rhs.clone()), // Default case
+            };
+
+            let flag = match (&normalized_lhs, &normalized_rhs) {
+                (SymbolicValue::ConstantInt(lv), SymbolicValue::ConstantInt(rv)) => match op.0 {
+                    ExpressionInfixOpcode::Lesser => {
+                        val_for_relational_operators(&(lv % prime), prime)
+                            < val_for_relational_operators(&(rv % prime), prime)
                     }
-                    (SymbolicValue::ConstantBool(lv), SymbolicValue::ConstantBool(rv)) => {
-                        match &op.0 {
-                            ExpressionInfixOpcode::BoolAnd => *lv && *rv,
-                            ExpressionInfixOpcode::BoolOr => *lv || *rv,
-                            _ => todo!(),
-                        }
+                    ExpressionInfixOpcode::Greater => {
+                        val_for_relational_operators(&(lv % prime), prime)
+                            > val_for_relational_operators(&(rv % prime), prime)
+                    }
+                    ExpressionInfixOpcode::LesserEq => {
+                        val_for_relational_operators(&(lv % prime), prime)
+                            <= val_for_relational_operators(&(rv % prime), prime)
                     }
+                    ExpressionInfixOpcode::GreaterEq => {
+                        val_for_relational_operators(&(lv % prime), prime)
+                            >= val_for_relational_operators(&(rv % prime), prime)
+                    }
+                    ExpressionInfixOpcode::Eq => lv % prime == rv % prime,
+                    ExpressionInfixOpcode::NotEq => lv % prime != rv % prime,
                     _ => panic!(
-                        "Unassigned variables exist: {}",
+                        "Non-Boolean Operation: {}",
                         inst.lookup_fmt(&symbolic_library.id2name)
                     ),
-                };
-                if !flag {
-                    success = false;
-                    failure_pos = i;
-                }
+                },
+                (SymbolicValue::ConstantBool(lv), SymbolicValue::ConstantBool(rv)) => match &op.0 {
+                    ExpressionInfixOpcode::BoolAnd => *lv && *rv,
+                    ExpressionInfixOpcode::BoolOr => *lv || *rv,
+                    _ => todo!(),
+                },
+                _ => panic!(
+                    "Unassigned variables exist: {}",
+                    inst.lookup_fmt(&symbolic_library.id2name)
+                ),
+            };
+            if !flag {
+                return Some(false);
             }
-            SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
-                let mut lhs_val = evaluate_symbolic_value(prime, lhs, assignment, symbolic_library);
-                let mut rhs_val = evaluate_symbolic_value(prime, rhs, assignment, symbolic_library);
-
-                if let Some(dir) = runtime_mutable_positions.get(&i) {
-                    match dir {
-                        Direction::Left => {
-                            if let SymbolicValue::Variable(var_name) = &**lhs {
-                                if let Some(SymbolicValue::ConstantInt(ref num)) = rhs_val {
-                                    assignment.insert(var_name.clone(), num.clone());
-                                    lhs_val = rhs_val.clone();
-                                }
+        }
+        SymbolicValue::AuxBinaryOp(lhs, op, rhs) => {
+            let mut lhs_val = evaluate_symbolic_value(prime, lhs, assignment, symbolic_library);
+            let mut rhs_val = evaluate_symbolic_value(prime, rhs, assignment, symbolic_library);
+
+            if let Some(dir) = runtime_mutable_positions.get(&pos) {
+                match dir {
+                    Direction::Left => {
+                        if let SymbolicValue::Variable(var_name) = &**lhs {
+                            if let Some(SymbolicValue::ConstantInt(ref num)) = rhs_val {
+                                assignment.insert(var_name.clone(), num.clone());
+                                lhs_val = rhs_val.clone();
                             }
                         }
-                        Direction::Right => {
-                            if let SymbolicValue::Variable(var_name) = &**rhs {
-                                if let Some(SymbolicValue::ConstantInt(ref num)) = lhs_val {
-                                    assignment.insert(var_name.clone(), num.clone());
-                                    rhs_val = lhs_val.clone();
-                                }
+                    }
+                    Direction::Right => {
+                        if let SymbolicValue::Variable(var_name) = &**rhs {
+                            if let Some(SymbolicValue::ConstantInt(ref num)) = lhs_val {
+                                assignment.insert(var_name.clone(), num.clone());
+                                rhs_val = lhs_val.clone();
                             }
                         }
                     }
                 }
+            }
 
-                let (normalized_lhs, normalized_rhs) = match &op.0 {
-                    // Convert booleans to integers for arithmetic or bitwise operators
-                    ExpressionInfixOpcode::Add
-                    | ExpressionInfixOpcode::Sub
-                    | ExpressionInfixOpcode::Mul
-                    | ExpressionInfixOpcode::Pow
-                    | ExpressionInfixOpcode::Div
-                    | ExpressionInfixOpcode::IntDiv
-                    | ExpressionInfixOpcode::Mod
-                    | ExpressionInfixOpcode::BitOr
-                    | ExpressionInfixOpcode::BitAnd
-                    | ExpressionInfixOpcode::BitXor
-                    | ExpressionInfixOpcode::ShiftL
-                    | ExpressionInfixOpcode::ShiftR
-                    | ExpressionInfixOpcode::Lesser
-                    | ExpressionInfixOpcode::Greater
-                    | ExpressionInfixOpcode::LesserEq
-                    | ExpressionInfixOpcode::GreaterEq
-                    | ExpressionInfixOpcode::Eq
-                    | ExpressionInfixOpcode::NotEq => (
-                        normalize_to_int(&lhs_val.unwrap(), prime),
-                        normalize_to_int(&rhs_val.unwrap(), prime),
-                    ),
-                    // Keep booleans as they are for logical operators
-                    ExpressionInfixOpcode::BoolAnd | ExpressionInfixOpcode::BoolOr => (
-                        normalize_to_bool(&lhs_val.unwrap(), prime),
-                        normalize_to_bool(&rhs_val.unwrap(), prime),
-                    ), //_ => (lhs.clone(), rhs.clone()), // Default case
-                };
-
-                let flag = match (&normalized_lhs, &normalized_rhs) {
-                    (SymbolicValue::ConstantInt(lv), SymbolicValue::ConstantInt(rv)) => {
-                        match op.0 {
-                            ExpressionInfixOpcode::Lesser => lv % prime < rv % prime,
-                            ExpressionInfixOpcode::Greater => lv % prime > rv % prime,
-                            ExpressionInfixOpcode::LesserEq => lv % prime <= rv % prime,
-                            ExpressionInfixOpcode::GreaterEq => lv % prime >= rv % prime,
-                            ExpressionInfixOpcode::Eq => lv % prime == rv % prime,
-                            ExpressionInfixOpcode::NotEq => lv % prime != rv % prime,
-                            _ => panic!(
-                                "Non-Boolean Operation: {}",
-                                inst.lookup_fmt(&symbolic_library.id2name)
-                            ),
-                        }
-                    }
-                    (SymbolicValue::ConstantBool(lv), SymbolicValue::ConstantBool(rv)) => {
-                        match &op.0 {
-                            ExpressionInfixOpcode::BoolAnd => *lv && *rv,
-                            ExpressionInfixOpcode::BoolOr => *lv || *rv,
-                            _ => todo!(),
-                        }
-                    }
+            let (normalized_lhs, normalized_rhs) = match &op.0 {
+                // Convert booleans to integers for arithmetic or bitwise operators
+                ExpressionInfixOpcode::Add
+                | ExpressionInfixOpcode::Sub
+                | ExpressionInfixOpcode::Mul
+                | ExpressionInfixOpcode::Pow
+                | ExpressionInfixOpcode::Div
+                | ExpressionInfixOpcode::IntDiv
+                | ExpressionInfixOpcode::Mod
+                | ExpressionInfixOpcode::BitOr
+                | ExpressionInfixOpcode::BitAnd
+                | ExpressionInfixOpcode::BitXor
+                | ExpressionInfixOpcode::ShiftL
+                | ExpressionInfixOpcode::ShiftR
+                | ExpressionInfixOpcode::Lesser
+                | ExpressionInfixOpcode::Greater
+                | ExpressionInfixOpcode::LesserEq
+                | ExpressionInfixOpcode::GreaterEq
+                | ExpressionInfixOpcode::Eq
+                | ExpressionInfixOpcode::NotEq => (
+                    normalize_to_int(&lhs_val.unwrap(), prime),
+                    normalize_to_int(&rhs_val.unwrap(), prime),
+                ),
+                // Keep booleans as they are for logical operators
+                ExpressionInfixOpcode::BoolAnd | ExpressionInfixOpcode::BoolOr => (
+                    normalize_to_bool(&lhs_val.unwrap(), prime),
+                    normalize_to_bool(&rhs_val.unwrap(), prime),
+                ), //_ => (lhs.clone(), rhs.clone()), // Default case
+            };
+
+            let flag = match (&normalized_lhs, &normalized_rhs) {
+                (SymbolicValue::ConstantInt(lv), SymbolicValue::ConstantInt(rv)) => match op.0 {
+                    ExpressionInfixOpcode::Lesser => lv % prime < rv % prime,
+                    ExpressionInfixOpcode::Greater => lv % prime > rv % prime,
+                    ExpressionInfixOpcode::LesserEq => lv % prime <= rv % prime,
+                    ExpressionInfixOpcode::GreaterEq => lv % prime >= rv % prime,
+                    ExpressionInfixOpcode::Eq => lv % prime == rv % prime,
+                    ExpressionInfixOpcode::NotEq => lv % prime != rv % prime,
                     _ => panic!(
-                        "Unassigned variables exist: {}",
+                        "Non-Boolean Operation: {}",
                         inst.lookup_fmt(&symbolic_library.id2name)
                     ),
-                };
-                if !flag {
-                    success = false;
-                    failure_pos = i;
-                }
+                },
+                (SymbolicValue::ConstantBool(lv), SymbolicValue::ConstantBool(rv)) => match &op.0 {
+                    ExpressionInfixOpcode::BoolAnd => *lv && *rv,
+                    ExpressionInfixOpcode::BoolOr => *lv || *rv,
+                    _ => todo!(),
+                },
+                _ => panic!(
+                    "Unassigned variables exist: {}",
+                    inst.lookup_fmt(&symbolic_library.id2name)
+                ),
+            };
+            if !flag {
+                return Some(false);
             }
-            SymbolicValue::UnaryOp(op, expr) => {
-                let expr_val = evaluate_symbolic_value(prime, expr, assignment, symbolic_library);
-                let flag = match &expr_val {
-                    Some(SymbolicValue::ConstantBool(rv)) => match op.0 {
-                        ExpressionPrefixOpcode::BoolNot => !rv,
-                        _ => panic!(
-                            "Unassigned variables exist: {}",
-                            inst.lookup_fmt(&symbolic_library.id2name)
-                        ),
-                    },
+        }
+        SymbolicValue::UnaryOp(op, expr) => {
+            let expr_val = evaluate_symbolic_value(prime, expr, assignment, symbolic_library);
+            let flag = match &expr_val {
+                Some(SymbolicValue::ConstantBool(rv)) => match op.0 {
+                    ExpressionPrefixOpcode::BoolNot => !rv,
                     _ => panic!(
-                        "Non-Boolean Operation: {}",
+                        "Unassigned variables exist: {}",
                         inst.lookup_fmt(&symbolic_library.id2name)
                     ),
-                };
-                if !flag {
-                    success = false;
-                    failure_pos = i;
-                }
+                },
+                _ => panic!(
+                    "Non-Boolean Operation: {}",
+                    inst.lookup_fmt(&symbolic_library.id2name)
+                ),
+            };
+            if !flag {
+                return Some(false);
             }
-            _ => {
-                let val = evaluate_symbolic_value(prime, inst, assignment, symbolic_library);
-                match &val.unwrap() {
-                    SymbolicValue::ConstantBool(b) => {
-                        if !b {
-                            success = false;
-                            failure_pos = i;
-                        }
+        }
+        _ => {
+            let val = evaluate_symbolic_value(prime, inst, assignment, symbolic_library);
+            match &val.unwrap() {
+                SymbolicValue::ConstantBool(b) => {
+                    if !b {
+                        return Some(false);
                     }
-                    SymbolicValue::ConstantInt(v) => {
-                        if v.is_zero() {
-                            success = false;
-                            failure_pos = i;
-                        }
+                }
+                SymbolicValue::ConstantInt(v) => {
+                    if v.is_zero() {
+                        return Some(false);
                     }
-                    _ => panic!(
-                        "Unassigned variables exist: {}",
-                        inst.lookup_fmt(&symbolic_library.id2name)
-                    ),
                 }
+                _ => panic!(
+                    "Unassigned variables exist: {}",
+                    inst.lookup_fmt(&symbolic_library.id2name)
+                ),
             }
         }
     }
 
-    Some((success, failure_pos))
+    Some(true)
 }
 
 /// Evaluates a symbolic value within the given context of a symbolic library and variable assignments.
@@ -833,7 +1044,7 @@ pub fn evaluate_symbolic_value(
             elements
                 .iter()
                 .map(|e| {
-                    Rc::new(
+                    Arc::new(
                         evaluate_symbolic_value(prime, e, assignment, symbolic_library).unwrap(),
                     )
                 })
@@ -849,13 +1060,13 @@ pub fn evaluate_symbolic_value(
 
             if let Some(SymbolicValue::ConstantInt(c)) = evaled_counts {
                 Some(SymbolicValue::Array(vec![
-                    Rc::new(evaled_elem.unwrap());
+                    Arc::new(evaled_elem.unwrap());
                     c.to_usize().unwrap()
                 ]))
             } else {
                 Some(SymbolicValue::UniformArray(
-                    Rc::new(evaled_elem.unwrap()),
-                    Rc::new(evaled_counts.unwrap()),
+                    Arc::new(evaled_elem.unwrap()),
+                    Arc::new(evaled_counts.unwrap()),
                 ))
             }
         }
@@ -988,7 +1199,7 @@ pub fn evaluate_symbolic_value(
                 }
                 subse
                     .cur_state
-                    .set_rc_sym_val(sym_name, Rc::new(evaled_arg.unwrap()));
+                    .set_rc_sym_val(sym_name, Arc::new(evaled_arg.unwrap()));
             }
             subse.execute(&func.body.clone(), 0);
             if subse.execution_failed {
@@ -1227,6 +1438,8 @@ pub fn is_equal_mod(a: &BigInt, b: &BigInt, p: &BigInt) -> bool {
 /// - `side_constraints`: A reference to a slice of symbolic values representing the side constraints.
 /// - `assignment`: A mapping from symbolic names to concrete integer values representing the assignment to be verified.
 /// - `setting`: Configuration settings (`BaseVerificationConfig`) including modular arithmetic parameters and template configurations.
+/// - `trace_scheduler`, `side_constraint_scheduler`: The schedulers of `symbolic_trace` and
+///   `side_constraints`, shared by the assignments verified by a worker.
 ///
 /// # Returns
 /// A `VerificationResult` that represents one of the following:
@@ -1258,92 +1471,192 @@ pub fn verify_assignment(
     side_constraints: &[SymbolicValueRef],
     assignment: &FxHashMap<SymbolicName, BigInt>,
     setting: &BaseVerificationConfig,
+    trace_scheduler: &mut ConstraintScheduler,
+    side_constraint_scheduler: &mut ConstraintScheduler,
 ) -> VerificationResult {
-    let is_satisfy_st = evaluate_constraints(
+    let (is_satisfy_st, is_satisfy_sc) = evaluate_trace_and_side_constraints(
+        sexe,
+        symbolic_trace,
+        side_constraints,
+        assignment,
+        setting,
+        trace_scheduler,
+        side_constraint_scheduler,
+    );
+
+    if is_satisfy_st && !is_satisfy_sc {
+        VerificationResult::OverConstrained
+    } else if !is_satisfy_st && is_satisfy_sc {
+        verify_original_run(sexe, assignment, setting)
+    } else {
+        VerificationResult::WellConstrained
+    }
+}
+
+/// Returns whether `assignment` satisfies the symbolic trace and the side constraints, which
+/// are the first step of `verify_assignment`.
+pub fn evaluate_trace_and_side_constraints(
+    sexe: &mut SymbolicExecutor,
+    symbolic_trace: &[SymbolicValueRef],
+    side_constraints: &[SymbolicValueRef],
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    setting: &BaseVerificationConfig,
+    trace_scheduler: &mut ConstraintScheduler,
+    side_constraint_scheduler: &mut ConstraintScheduler,
+) -> (bool, bool) {
+    let is_satisfy_st = evaluate_constraints_in_order(
         &setting.prime,
         symbolic_trace,
         assignment,
         &mut sexe.symbolic_library,
+        trace_scheduler,
     );
-    let is_satisfy_sc = evaluate_constraints(
+    let is_satisfy_sc = evaluate_constraints_in_order(
         &setting.prime,
         side_constraints,
         assignment,
         &mut sexe.symbolic_library,
+        side_constraint_scheduler,
     );
+    (is_satisfy_st, is_satisfy_sc)
+}
 
-    if is_satisfy_st && !is_satisfy_sc {
-        VerificationResult::OverConstrained
-    } else if !is_satisfy_st && is_satisfy_sc {
-        sexe.clear();
-        sexe.cur_state.add_owner(&OwnerName {
-            id: sexe.symbolic_library.name2id["main"],
-            counter: 0,
-            access: None,
-        });
-        sexe.feed_arguments(
-            &setting.template_param_names,
-            &setting.template_param_values,
-        );
-        sexe.concrete_execute(&setting.target_template_name, assignment);
-
-        if sexe.cur_state.is_failed {
-            let vc = sexe.violated_condition.clone().unwrap();
-            return VerificationResult::UnderConstrained(UnderConstrainedType::UnexpectedInput(
-                vc.0,
-                vc.1.lookup_fmt(&sexe.symbolic_library.id2name),
-            ));
-        }
+/// Runs the original program on the inputs of `assignment` with the concrete executor, and
+/// checks that it succeeds with the outputs of `assignment`.
+///
+/// This is the second step of `verify_assignment`, for an assignment that satisfies the side
+/// constraints but not the symbolic trace.
+pub fn verify_original_run(
+    sexe: &mut SymbolicExecutor,
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    setting: &BaseVerificationConfig,
+) -> VerificationResult {
+    metrics::add(Counter::ConcreteRuns, 1);
+    sexe.clear();
+    sexe.cur_state.add_owner(&OwnerName {
+        id: sexe.symbolic_library.name2id["main"],
+        counter: 0,
+        access: None,
+    });
+    sexe.feed_arguments(
+        &setting.template_param_names,
+        &setting.template_param_values,
+    );
+    sexe.concrete_execute(&setting.target_template_name, assignment);
 
-        let mut result = VerificationResult::WellConstrained;
-        for (k, v) in assignment {
-            if sexe.symbolic_library.template_library
-                [&sexe.symbolic_library.name2id[&setting.target_template_name]]
-                .output_ids
-                .contains(&k.id)
-            {
-                let original_sym_value = sexe.cur_state.symbol_binding_map[&k].clone();
-                let mut memo = FxHashSet::default();
-                let simplified_sym_value = sexe.simplify_variables(
-                    &original_sym_value,
-                    std::usize::MAX,
-                    false,
-                    false,
-                    &mut memo,
-                );
-                let original_int_value = match simplified_sym_value {
-                    SymbolicValue::ConstantInt(num) => num.clone(),
-                    SymbolicValue::ConstantBool(b) => {
-                        if b {
-                            BigInt::one()
-                        } else {
-                            BigInt::zero()
-                        }
-                    }
-                    _ => {
-                        panic!(
-                            "Undetermined Output: {}",
-                            original_sym_value
-                                .clone()
-                                .lookup_fmt(&sexe.symbolic_library.id2name)
-                        );
+    if sexe.cur_state.is_failed {
+        let vc = sexe.violated_condition.clone().unwrap();
+        return VerificationResult::UnderConstrained(UnderConstrainedType::UnexpectedInput(
+            vc.0,
+            vc.1.lookup_fmt(&sexe.symbolic_library.id2name),
+        ));
+    }
+
+    let mut result = VerificationResult::WellConstrained;
+    for (k, v) in assignment {
+        if sexe.symbolic_library.template_library
+            [&sexe.symbolic_library.name2id[&setting.target_template_name]]
+            .output_ids
+            .contains(&k.id)
+        {
+            let original_sym_value = sexe.cur_state.symbol_binding_map[&k].clone();
+            let mut memo = FxHashSet::default();
+            let simplified_sym_value = sexe.simplify_variables(
+                &original_sym_value,
+                std::usize::MAX,
+                false,
+                false,
+                &mut memo,
+            );
+            let original_int_value = match simplified_sym_value {
+                SymbolicValue::ConstantInt(num) => num.clone(),
+                SymbolicValue::ConstantBool(b) => {
+                    if b {
+                        BigInt::one()
+                    } else {
+                        BigInt::zero()
                     }
-                };
-                if !is_equal_mod(&original_int_value, v, &setting.prime) {
-                    result = VerificationResult::UnderConstrained(
-                        UnderConstrainedType::NonDeterministic(
-                            k.clone(),
-                            k.lookup_fmt(&sexe.symbolic_library.id2name),
-                            original_int_value.clone(),
-                        ),
+                }
+                _ => {
+                    panic!(
+                        "Undetermined Output: {}",
+                        original_sym_value
+                            .clone()
+                            .lookup_fmt(&sexe.symbolic_library.id2name)
                     );
-                    break;
                 }
+            };
+            if !is_equal_mod(&original_int_value, v, &setting.prime) {
+                result =
+                    VerificationResult::UnderConstrained(UnderConstrainedType::NonDeterministic(
+                        k.clone(),
+                        k.lookup_fmt(&sexe.symbolic_library.id2name),
+                        original_int_value.clone(),
+                    ));
+                break;
             }
         }
+    }
 
-        result
-    } else {
-        VerificationResult::WellConstrained
+    result
+}
+
+/// Returns the names of the input signals of the main template in `assignment`, as the
+/// witness oracle expects them, along with their values in `[0, p)`.
+pub fn oracle_inputs_of_assignment(
+    symbolic_library: &SymbolicLibrary,
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    setting: &BaseVerificationConfig,
+) -> FxHashMap<String, BigInt> {
+    let input_ids = &symbolic_library.template_library
+        [&symbolic_library.name2id[&setting.target_template_name]]
+        .input_ids;
+    assignment
+        .iter()
+        .filter(|(k, _)| k.owner.len() == 1 && input_ids.contains(&k.id))
+        .map(|(k, v)| {
+            (
+                k.lookup_fmt(&symbolic_library.id2name),
+                ((v % &setting.prime) + &setting.prime) % &setting.prime,
+            )
+        })
+        .collect()
+}
+
+/// Checks the outputs of `assignment` against those computed by the witness oracle for a
+/// run of the original program that succeeded, like `verify_original_run` does with the
+/// concrete executor.
+///
+/// The same signals as in `verify_original_run` are checked, including those of the
+/// sub-components that share their ids with the outputs of the main component, each looked up
+/// by its full dotted name, as written in the `.sym` file of the circuit.
+///
+/// # Returns
+/// `None` if the oracle did not return the value of one of these signals, e.g., one removed by
+/// the simplification of circom, in which case the run is left to `verify_original_run`.
+pub fn verify_oracle_outputs(
+    symbolic_library: &SymbolicLibrary,
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    setting: &BaseVerificationConfig,
+    signals: &FxHashMap<String, BigInt>,
+) -> Option<VerificationResult> {
+    let output_ids = &symbolic_library.template_library
+        [&symbolic_library.name2id[&setting.target_template_name]]
+        .output_ids;
+    for (k, v) in assignment {
+        if output_ids.contains(&k.id) {
+            let name = k.lookup_fmt(&symbolic_library.id2name);
+            let original_int_value = signals.get(&name)?;
+            if !is_equal_mod(original_int_value, v, &setting.prime) {
+                return Some(VerificationResult::UnderConstrained(
+                    UnderConstrainedType::NonDeterministic(
+                        k.clone(),
+                        name,
+                        original_int_value.clone(),
+                    ),
+                ));
+            }
+        }
     }
+    Some(VerificationResult::WellConstrained)
 }
@@ -0,0 +1,141 @@
+//! A native witness calculator as the oracle of the runs of the original program.
+//!
+//! The brute-force search re-runs the original program with the concrete executor on every
+//! assignment that satisfies the side constraints but not the trace, which interprets the AST
+//! of the whole circuit. A `WitnessOracle` instead asks the witness calculator that circom
+//! generates for the circuit (`--wasm` or `--c`), kept loaded by a wrapper in a child process
+//! that answers one request per line on its standard streams:
+//! - A request is a JSON object that maps the input signals of the main component, e.g.,
+//!   `main.in[0]`, to decimal strings.
+//! - A response is a JSON object that maps the signals of the main component to decimal
+//!   strings, or `{"error": <message>}` if the witness calculator rejects the inputs.
+//!
+//! `script/witness_oracle.js` is such a wrapper for the WASM witness calculator.
+
+use std::io::{self, BufRead, BufReader, Write};
+use std::process::{Child, ChildStdin, ChildStdout, Command, Stdio};
+use std::str::FromStr;
+use std::thread;
+
+use num_bigint_dig::BigInt;
+use rustc_hash::FxHashMap;
+use serde_json::Value;
+
+/// The answer of the witness calculator to one request.
+#[derive(Clone, Debug, PartialEq)]
+pub enum OracleOutcome {
+    /// The witness calculator failed on the inputs, e.g., on an assertion.
+    Rejected,
+    /// The values of the signals of the main component, by name.
+    Accepted(FxHashMap<String, BigInt>),
+}
+
+/// A witness calculator running in a child process.
+pub struct WitnessOracle {
+    child: Child,
+    stdin: ChildStdin,
+    stdout: BufReader<ChildStdout>,
+}
+
+impl WitnessOracle {
+    /// Starts the wrapper `command`, given as a program followed by its arguments, separated by
+    /// whitespace.
+    pub fn spawn(command: &str) -> io::Result<Self> {
+        let mut words = command.split_whitespace();
+        let program = words.next().ok_or_else(|| {
+            io::Error::new(io::ErrorKind::InvalidInput, "empty witness oracle command")
+        })?;
+        let mut child = Command::new(program)
+            .args(words)
+            .stdin(Stdio::piped())
+            .stdout(Stdio::piped())
+            .spawn()?;
+        let stdin = child.stdin.take().unwrap();
+        let stdout = BufReader::new(child.stdout.take().unwrap());
+        Ok(WitnessOracle {
+            child,
+            stdin,
+            stdout,
+        })
+    }
+
+    /// Runs the witness calculator on a batch of inputs, given by the names of the input
+    /// signals, and returns its answers in the same order.
+    ///
+    /// The requests are written from another thread while the responses are read, so that
+    /// neither process blocks on a full pipe however large the batch is. After an error, the
+    /// child process is killed and the oracle should be dropped.
+    pub fn run_batch(
+        &mut self,
+        inputs: &[FxHashMap<String, BigInt>],
+    ) -> io::Result<Vec<OracleOutcome>> {
+        let requests: String = inputs
+            .iter()
+            .map(|input| {
+                let request: serde_json::Map<String, Value> = input
+                    .iter()
+                    .map(|(name, value)| (name.clone(), Value::String(value.to_string())))
+                    .collect();
+                Value::Object(request).to_string() + "\n"
+            })
+            .collect();
+
+        let (child, stdin, stdout) = (&mut self.child, &mut self.stdin, &mut self.stdout);
+        thread::scope(|s| {
+            let writer = s.spawn(move || {
+                stdin.write_all(requests.as_bytes())?;
+                stdin.flush()
+            });
+            let responses: io::Result<Vec<OracleOutcome>> =
+                (0..inputs.len()).map(|_| read_response(stdout)).collect();
+            if responses.is_err() {
+                // Unblocks the writer if the child stopped reading.
+                let _ = child.kill();
+            }
+            writer.join().unwrap()?;
+            responses
+        })
+    }
+}
+
+impl Drop for WitnessOracle {
+    fn drop(&mut self) {
+        let _ = self.child.kill();
+        let _ = self.child.wait();
+    }
+}
+
+fn read_response(stdout: &mut BufReader<ChildStdout>) -> io::Result<OracleOutcome> {
+    let invalid_response = |message: String| io::Error::new(io::ErrorKind::InvalidData, message);
+
+    let mut line = String::new();
+    if stdout.read_line(&mut line)? == 0 {
+        return Err(io::Error::new(
+            io::ErrorKind::UnexpectedEof,
+            "the witness oracle exited",
+        ));
+    }
+    let response = match serde_json::from_str(&line) {
+        Ok(Value::Object(response)) => response,
+        _ => {
+            return Err(invalid_response(format!(
+                "invalid response: {}",
+                line.trim()
+            )))
+        }
+    };
+    if response.contains_key("error") {
+        return Ok(OracleOutcome::Rejected);
+    }
+    let mut signals = FxHashMap::default();
+    for (name, value) in response {
+        let value = match &value {
+            Value::String(value) => BigInt::from_str(value).ok(),
+            Value::Number(value) => BigInt::from_str(&value.to_string()).ok(),
+            _ => None,
+        }
+        .ok_or_else(|| invalid_response(format!("invalid value of {}: {}", name, value)))?;
+        signals.insert(name, value);
+    }
+    Ok(OracleOutcome::Accepted(signals))
+}
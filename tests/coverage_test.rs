@@ -1,7 +1,7 @@
 mod utils;
 
-use std::rc::Rc;
 use std::str::FromStr;
+use std::sync::Arc;
 
 use num_bigint_dig::BigInt;
 use num_traits::identities::Zero;
@@ -12,17 +12,21 @@ use program_structure::ast::Expression;
 use program_structure::program_archive::ProgramArchive;
 
 use zkfuzz::executor::symbolic_execution::SymbolicExecutor;
-use zkfuzz::executor::symbolic_setting::get_default_setting_for_concrete_execution;
+use zkfuzz::executor::symbolic_setting::{
+    get_default_setting_for_concrete_execution, get_default_setting_for_symbolic_execution,
+};
 use zkfuzz::executor::symbolic_value::{OwnerName, SymbolicAccess, SymbolicName, SymbolicValue};
+use zkfuzz::mutator::compiled_trace::CompiledTrace;
+use zkfuzz::mutator::coverage_bitmap::{CoverageBitmap, EdgeTrace};
 
-use crate::utils::prepare_symbolic_library;
+use crate::utils::{execute, prepare_symbolic_library};
 
 fn get_inputs(cexe: &SymbolicExecutor, inputs: &[BigInt]) -> FxHashMap<SymbolicName, BigInt> {
     let mut map = FxHashMap::default();
     map.insert(
         SymbolicName::new(
             cexe.symbolic_library.name2id["in"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: cexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
@@ -36,7 +40,7 @@ fn get_inputs(cexe: &SymbolicExecutor, inputs: &[BigInt]) -> FxHashMap<SymbolicN
     map.insert(
         SymbolicName::new(
             cexe.symbolic_library.name2id["in"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: cexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
@@ -158,3 +162,76 @@ fn test_coverage_test() {
     cexe.record_path();
     assert_eq!(4, cexe.coverage_count());
 }
+
+#[test]
+fn test_edge_coverage_of_emulation() {
+    let path = "./tests/sample/test_if_else.circom".to_string();
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (mut symbolic_library, program_archive) = prepare_symbolic_library(path, prime.clone());
+    let setting = get_default_setting_for_symbolic_execution(prime.clone(), false);
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+
+    let main_in = SymbolicName::new(
+        sexe.symbolic_library.name2id["in"],
+        Arc::new(vec![OwnerName {
+            id: sexe.symbolic_library.name2id["main"],
+            access: None,
+            counter: 0,
+        }]),
+        None,
+    );
+    let compiled_trace = CompiledTrace::compile(&prime, &sexe.cur_state.symbolic_trace);
+    let coverage = CoverageBitmap::new();
+    let mut edges = EdgeTrace::new();
+    let mut is_new = |value: BigInt| {
+        let mut assignment = FxHashMap::from_iter([(main_in.clone(), value)]);
+        compiled_trace.emulate_with_coverage(
+            &FxHashMap::default(),
+            &mut assignment,
+            &mut sexe.symbolic_library,
+            &mut edges,
+        );
+        let has_new_bits = coverage.has_new_bits(&edges);
+        assert_eq!(has_new_bits, coverage.merge(&edges));
+        has_new_bits
+    };
+
+    // `inv <-- in != 0 ? 1 / in : 0` takes the else branch on zero and the then branch otherwise.
+    assert!(is_new(BigInt::zero()));
+    assert!(!is_new(BigInt::zero()));
+    assert!(is_new(BigInt::one()));
+    assert!(!is_new(BigInt::from(7)));
+    assert!(coverage.count_covered_cells() > 0);
+
+    coverage.clear();
+    assert_eq!(coverage.count_covered_cells(), 0);
+}
+
+#[test]
+fn test_coverage_bitmap_shared_across_threads() {
+    let num_threads = 4;
+    let traces: Vec<EdgeTrace> = (0..1000_u32)
+        .map(|location| {
+            let mut trace = EdgeTrace::new();
+            trace.hit(location);
+            trace
+        })
+        .collect();
+
+    // Every thread merges every single-edge trace, and exactly one of them claims each edge.
+    let coverage = CoverageBitmap::new();
+    let num_new: usize = std::thread::scope(|s| {
+        let handles: Vec<_> = (0..num_threads)
+            .map(|_| s.spawn(|| traces.iter().filter(|trace| coverage.merge(trace)).count()))
+            .collect();
+        handles.into_iter().map(|h| h.join().unwrap()).sum()
+    });
+    assert_eq!(num_new, traces.len());
+    assert_eq!(coverage.count_covered_cells(), traces.len());
+    assert!(traces.iter().all(|trace| !coverage.has_new_bits(trace)));
+}
@@ -0,0 +1,161 @@
+use std::str::FromStr;
+
+use num_bigint_dig::{BigInt, RandBigInt};
+use num_traits::{One, Signed, Zero};
+use rand::rngs::StdRng;
+use rand::SeedableRng;
+
+use zkfuzz::executor::field::{FieldBackend, MontgomeryField};
+
+fn primes() -> Vec<BigInt> {
+    vec![
+        // BN254
+        BigInt::from_str(
+            "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+        )
+        .unwrap(),
+        // BLS12-381
+        BigInt::from_str(
+            "52435875175126190479447740508185965837690552500527637822603658699938581184513",
+        )
+        .unwrap(),
+        // Goldilocks
+        BigInt::from_str("18446744069414584321").unwrap(),
+        BigInt::from(41),
+    ]
+}
+
+#[test]
+fn test_montgomery_backend_matches_bigint() {
+    let mut rng = StdRng::seed_from_u64(42);
+    for prime in primes() {
+        let montgomery = FieldBackend::new(&prime);
+        let bigint = FieldBackend::new_bigint(&prime);
+        assert_eq!(montgomery.name(), "Montgomery (4x64)");
+        assert_eq!(bigint.name(), "BigInt");
+
+        let mut values = vec![BigInt::zero(), BigInt::one(), &prime - BigInt::one()];
+        for _ in 0..32 {
+            values.push(rng.gen_bigint_range(&BigInt::zero(), &prime));
+        }
+        for _ in 0..8 {
+            values.push(rng.gen_bigint_range(&-&prime, &BigInt::zero()));
+        }
+
+        for lv in &values {
+            for rv in &values {
+                assert_eq!(montgomery.moddiv(lv, rv), bigint.moddiv(lv, rv));
+                if !lv.is_negative() && !rv.is_negative() {
+                    assert_eq!(montgomery.modpow(lv, rv), bigint.modpow(lv, rv));
+                }
+            }
+        }
+        assert_eq!(
+            montgomery.batch_inverse(&values),
+            bigint.batch_inverse(&values)
+        );
+    }
+}
+
+#[test]
+fn test_montgomery_field_arithmetic() {
+    let prime = primes()[0].clone();
+    let field = MontgomeryField::new(&prime).unwrap();
+
+    let a = BigInt::from(7);
+    let b = &prime - BigInt::from(3);
+    let fa = field.from_bigint(&a, &prime);
+    let fb = field.from_bigint(&b, &prime);
+
+    assert_eq!(field.to_bigint(&field.add(&fa, &fb)), BigInt::from(4));
+    assert_eq!(
+        field.to_bigint(&field.sub(&fb, &fa)),
+        &prime - BigInt::from(10)
+    );
+    assert_eq!(
+        field.to_bigint(&field.mul(&fa, &fb)),
+        &prime - BigInt::from(21)
+    );
+    assert_eq!(
+        field.to_bigint(&field.mul(&fa, &field.inverse(&fa))),
+        BigInt::one()
+    );
+    assert_eq!(
+        field.from_bigint(&-&a, &prime),
+        field.sub(&field.zero(), &fa)
+    );
+
+    assert!(MontgomeryField::new(&BigInt::from(2)).is_none());
+    assert!(MontgomeryField::new(&(BigInt::one() << 256)).is_none());
+}
+
+#[test]
+fn test_composite_modulus_falls_back_to_bigint() {
+    let bn254 = &primes()[0];
+    for modulus in [
+        BigInt::from(15),
+        BigInt::from(41 * 43),
+        // A strong pseudoprime to base 2.
+        BigInt::from(3215031751_u64),
+        bn254 * BigInt::from(3),
+    ] {
+        assert!(MontgomeryField::new(&modulus).is_none());
+        let backend = FieldBackend::new(&modulus);
+        assert_eq!(backend.name(), "BigInt");
+        let a = BigInt::from(7);
+        let b = BigInt::from(2);
+        assert_eq!(
+            backend.moddiv(&a, &b),
+            FieldBackend::new_bigint(&modulus).moddiv(&a, &b)
+        );
+    }
+    for prime in primes() {
+        assert!(MontgomeryField::new(&prime).is_some());
+    }
+}
+
+#[test]
+fn test_sqrt_and_batched_quadratics() {
+    let mut rng = StdRng::seed_from_u64(42);
+    for prime in primes() {
+        let montgomery = FieldBackend::new(&prime);
+        let bigint = FieldBackend::new_bigint(&prime);
+
+        for _ in 0..16 {
+            let x = rng.gen_bigint_range(&BigInt::zero(), &prime);
+            let square = (&x * &x) % &prime;
+            let root = montgomery.sqrt(&square).unwrap();
+            assert_eq!((&root * &root) % &prime, square);
+            assert_eq!(bigint.sqrt(&square), Some(root));
+
+            let n = rng.gen_bigint_range(&-&prime, &prime);
+            assert_eq!(montgomery.sqrt(&n), bigint.sqrt(&n));
+        }
+
+        let mut coefficients = vec![
+            [BigInt::from(5), BigInt::zero(), BigInt::zero()],
+            [BigInt::from(3), BigInt::from(2), BigInt::zero()],
+            [BigInt::from(-1), BigInt::zero(), BigInt::one()],
+        ];
+        for _ in 0..16 {
+            coefficients.push([
+                rng.gen_bigint_range(&BigInt::zero(), &prime),
+                rng.gen_bigint_range(&BigInt::zero(), &prime),
+                rng.gen_bigint_range(&BigInt::zero(), &prime),
+            ]);
+        }
+        let roots = montgomery.solve_quadratics(&coefficients);
+        assert_eq!(roots, bigint.solve_quadratics(&coefficients));
+        assert_eq!(roots[0], None);
+        for (coeffs, root) in coefficients.iter().zip(roots.iter()) {
+            assert_eq!(
+                montgomery.solve_quadratics(std::slice::from_ref(coeffs)),
+                vec![root.clone()]
+            );
+            if let Some(x) = root {
+                let value = (&coeffs[0] + &coeffs[1] * x + &coeffs[2] * x * x) % &prime;
+                assert!(value.is_zero());
+            }
+        }
+    }
+}
@@ -1,11 +1,17 @@
 mod utils;
 
 use std::str::FromStr;
+use std::sync::Arc;
 
 use num_bigint_dig::BigInt;
+use num_traits::Zero;
+use rand::rngs::StdRng;
+use rand::SeedableRng;
+use rustc_hash::FxHashMap;
 
-use program_structure::ast::Expression;
+use program_structure::ast::{Expression, ExpressionInfixOpcode};
 
+use zkfuzz::executor::debug_ast::DebuggableExpressionInfixOpcode;
 use zkfuzz::executor::symbolic_execution::SymbolicExecutor;
 use zkfuzz::executor::symbolic_setting::{
     get_default_setting_for_concrete_execution, get_default_setting_for_symbolic_execution,
@@ -14,21 +20,37 @@ use zkfuzz::mutator::utils::{
     BaseVerificationConfig, CounterExample, UnderConstrainedType, VerificationResult,
 };
 
-use zkfuzz::mutator::mutation_config::load_config_from_json;
+use zkfuzz::executor::symbolic_value::SymbolicValue;
+use zkfuzz::mutator::brute_force::brute_force_search;
+use zkfuzz::mutator::island::Island;
+use zkfuzz::mutator::mutation_config::{load_config_from_json, MutationConfig};
+use zkfuzz::mutator::mutation_test::Gene;
 use zkfuzz::mutator::mutation_test::{mutation_test_search, MutationTestResult};
 use zkfuzz::mutator::mutation_test_crossover_fn::random_crossover;
 use zkfuzz::mutator::mutation_test_evolution_fn::simple_evolution;
 use zkfuzz::mutator::mutation_test_trace_fitness_fn::evaluate_trace_fitness_by_error;
 use zkfuzz::mutator::mutation_test_trace_initialization_fn::initialize_population_with_operator_or_const_replacement;
 use zkfuzz::mutator::mutation_test_trace_mutation_fn::mutate_trace_with_operator_or_const_replacement;
-use zkfuzz::mutator::mutation_test_trace_selection_fn::roulette_selection;
+use zkfuzz::mutator::mutation_test_trace_selection_fn::{roulette_selection, RouletteWheel};
 use zkfuzz::mutator::mutation_test_update_input_fn::{
     update_input_population_with_fitness_score, update_input_population_with_random_sampling,
 };
+use zkfuzz::mutator::operator_scheduler::OperatorScheduler;
+use zkfuzz::mutator::slicing::{search_slices, slice_by_cone_of_influence};
+use zkfuzz::mutator::witness_oracle::{OracleOutcome, WitnessOracle};
 
 use crate::utils::{execute, prepare_symbolic_library};
 
 fn conduct_mutation_testing(path: String, update_input_method: String) -> MutationTestResult {
+    let mutation_config = load_config_from_json("./tests/parameters/test.json").unwrap();
+    conduct_mutation_testing_with_config(path, update_input_method, &mutation_config)
+}
+
+fn conduct_mutation_testing_with_config(
+    path: String,
+    update_input_method: String,
+    mutation_config: &MutationConfig,
+) -> MutationTestResult {
     let prime = BigInt::from_str(
         "21888242871839275222246405745257275088548364400416034343698204186575808495617",
     )
@@ -56,6 +78,10 @@ fn conduct_mutation_testing(path: String, update_input_method: String) -> Mutati
         quick_mode: false,
         heuristics_mode: false,
         progress_interval: 10000,
+        num_threads: 1,
+        search_start: BigInt::zero(),
+        search_end: None,
+        witness_oracle: None,
         template_param_names: template_param_names,
         template_param_values: template_param_values,
     };
@@ -67,8 +93,6 @@ fn conduct_mutation_testing(path: String, update_input_method: String) -> Mutati
         &verification_base_config.template_param_values,
     );
 
-    let mutation_config = load_config_from_json("./tests/parameters/test.json").unwrap();
-
     let update_func = if update_input_method == "fitness" {
         update_input_population_with_fitness_score
     } else {
@@ -80,7 +104,7 @@ fn conduct_mutation_testing(path: String, update_input_method: String) -> Mutati
         &sexe.cur_state.symbolic_trace.clone(),
         &sexe.cur_state.side_constraints.clone(),
         &verification_base_config,
-        &mutation_config,
+        mutation_config,
         initialize_population_with_operator_or_const_replacement,
         update_func,
         evaluate_trace_fitness_by_error,
@@ -266,3 +290,462 @@ fn test_array_template_parameter() {
         })
     ));
 }
+
+#[test]
+fn test_vuln_iszero_parallel() {
+    let mut mutation_config = load_config_from_json("./tests/parameters/test.json").unwrap();
+
+    // The serial evaluation is the reference that every number of workers must reproduce.
+    let results: Vec<_> = [1, 2, 4]
+        .into_iter()
+        .map(|num_threads| {
+            mutation_config.num_threads = num_threads;
+            conduct_mutation_testing_with_config(
+                "./tests/sample/test_vuln_iszero.circom".to_string(),
+                "random".to_string(),
+                &mutation_config,
+            )
+        })
+        .collect();
+
+    assert!(matches!(
+        results[0].counter_example,
+        Some(CounterExample {
+            flag: VerificationResult::UnderConstrained(UnderConstrainedType::NonDeterministic(..)),
+            ..
+        })
+    ));
+    for result in &results[1..] {
+        assert_eq!(results[0].generation, result.generation);
+        assert_eq!(
+            results[0].counter_example.as_ref().unwrap().assignment,
+            result.counter_example.as_ref().unwrap().assignment
+        );
+    }
+}
+
+fn conduct_brute_force_search(
+    path: String,
+    num_threads: usize,
+    search_start: BigInt,
+    search_end: Option<BigInt>,
+    witness_oracle: Option<String>,
+) -> Option<CounterExample> {
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (mut symbolic_library, program_archive) = prepare_symbolic_library(path, prime.clone());
+    let setting = get_default_setting_for_symbolic_execution(prime.clone(), false);
+
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+
+    let (main_template_name, template_param_names, template_param_values) =
+        match &program_archive.initial_template_call {
+            Expression::Call { id, args, .. } => {
+                let template = &program_archive.templates[id];
+                (id, template.get_name_of_params().clone(), args.clone())
+            }
+            _ => unimplemented!(),
+        };
+
+    let verification_base_config = BaseVerificationConfig {
+        target_template_name: main_template_name.to_string(),
+        prime: prime.clone(),
+        range: BigInt::from(5),
+        quick_mode: false,
+        heuristics_mode: true,
+        progress_interval: 10000,
+        num_threads: num_threads,
+        search_start: search_start,
+        search_end: search_end,
+        witness_oracle: witness_oracle,
+        template_param_names: template_param_names,
+        template_param_values: template_param_values,
+    };
+
+    let subse_base_config = get_default_setting_for_concrete_execution(prime, false);
+    let mut conc_executor = SymbolicExecutor::new(&mut sexe.symbolic_library, &subse_base_config);
+    conc_executor.feed_arguments(
+        &verification_base_config.template_param_names,
+        &verification_base_config.template_param_values,
+    );
+
+    brute_force_search(
+        &mut conc_executor,
+        &sexe.cur_state.symbolic_trace.clone(),
+        &sexe.cur_state.side_constraints.clone(),
+        &verification_base_config,
+    )
+}
+
+#[test]
+fn test_parallel_and_sharded_brute_force() {
+    let path = "./tests/sample/test_vuln_iszero.circom".to_string();
+    // Three variables with 16 candidates each span 4 chunks of assignments.
+    let serial = conduct_brute_force_search(path.clone(), 1, BigInt::zero(), None, None);
+    let parallel = conduct_brute_force_search(path.clone(), 4, BigInt::zero(), None, None);
+    let first_shard = conduct_brute_force_search(
+        path.clone(),
+        4,
+        BigInt::zero(),
+        Some(BigInt::from(2048)),
+        None,
+    );
+    let second_shard = conduct_brute_force_search(path, 4, BigInt::from(2048), None, None);
+
+    let serial = serial.unwrap();
+    assert!(matches!(
+        serial.flag,
+        VerificationResult::UnderConstrained(..)
+    ));
+    assert_eq!(serial.assignment, parallel.unwrap().assignment);
+    assert_eq!(
+        serial.assignment,
+        first_shard.or(second_shard).unwrap().assignment
+    );
+}
+
+#[test]
+fn test_brute_force_with_witness_oracle() {
+    // `cat` answers every request with its inputs, so that the outputs are always checked
+    // by the concrete executor.
+    let mut oracle = WitnessOracle::spawn("cat").unwrap();
+    let inputs: Vec<FxHashMap<String, BigInt>> = (0..3)
+        .map(|i| FxHashMap::from_iter([("main.in".to_string(), BigInt::from(i))]))
+        .collect();
+    let outcomes = oracle.run_batch(&inputs).unwrap();
+    assert_eq!(
+        outcomes,
+        inputs
+            .into_iter()
+            .map(OracleOutcome::Accepted)
+            .collect::<Vec<_>>()
+    );
+
+    let path = "./tests/sample/test_vuln_iszero.circom".to_string();
+    let interpreted = conduct_brute_force_search(path.clone(), 1, BigInt::zero(), None, None);
+    let with_oracle =
+        conduct_brute_force_search(path, 2, BigInt::zero(), None, Some("cat".to_string()));
+    assert_eq!(
+        interpreted.as_ref().unwrap().assignment,
+        with_oracle.unwrap().assignment
+    );
+
+    // The outputs returned by a stub oracle of the circuit are compared with those of the
+    // trace instead.
+    let with_stub_oracle = conduct_brute_force_search(
+        path.clone(),
+        2,
+        BigInt::zero(),
+        None,
+        Some("sh ./tests/sample/stub_iszero_oracle.sh".to_string()),
+    )
+    .unwrap();
+    assert_eq!(
+        interpreted.as_ref().unwrap().assignment,
+        with_stub_oracle.assignment
+    );
+    assert!(matches!(
+        &with_stub_oracle.flag,
+        VerificationResult::UnderConstrained(UnderConstrainedType::NonDeterministic(_, name, value))
+            if name == "main.out" && value.is_zero()
+    ));
+
+    // A wrong output of the oracle is reported as the expected one.
+    let with_wrong_oracle = conduct_brute_force_search(
+        path,
+        2,
+        BigInt::zero(),
+        None,
+        Some("sh ./tests/sample/stub_iszero_oracle.sh wrong".to_string()),
+    )
+    .unwrap();
+    assert!(matches!(
+        &with_wrong_oracle.flag,
+        VerificationResult::UnderConstrained(UnderConstrainedType::NonDeterministic(_, name, value))
+            if name == "main.out" && *value == BigInt::from(2)
+    ));
+}
+
+#[test]
+fn test_island_model_stops_other_islands() {
+    let island_dir = std::env::temp_dir().join(format!("zkfuzz_islands_{}", std::process::id()));
+    let _ = std::fs::remove_dir_all(&island_dir);
+
+    let mut mutation_config = load_config_from_json("./tests/parameters/test.json").unwrap();
+    mutation_config.num_islands = 2;
+    mutation_config.island_dir = island_dir.to_str().unwrap().to_string();
+
+    // A solution left by the search of another circuit does not stop the islands.
+    std::fs::create_dir_all(&island_dir).unwrap();
+    std::fs::write(
+        island_dir.join("solution.json"),
+        r#"{"0_fingerprint": "OtherTemplate/0/0/0"}"#,
+    )
+    .unwrap();
+
+    let first_island = conduct_mutation_testing_with_config(
+        "./tests/sample/test_vuln_iszero.circom".to_string(),
+        "random".to_string(),
+        &mutation_config,
+    );
+    assert!(first_island.counter_example.is_some());
+    let solution = std::fs::read_to_string(island_dir.join("solution.json")).unwrap();
+    assert!(!solution.contains("OtherTemplate"));
+
+    mutation_config.island_id = 1;
+    let second_island = conduct_mutation_testing_with_config(
+        "./tests/sample/test_vuln_iszero.circom".to_string(),
+        "random".to_string(),
+        &mutation_config,
+    );
+    assert!(second_island.counter_example.is_none());
+    assert_eq!(second_island.generation, 0);
+
+    std::fs::remove_dir_all(&island_dir).unwrap();
+}
+
+#[test]
+fn test_island_migrates_operator_replacements() {
+    let island_dir = std::env::temp_dir().join(format!("zkfuzz_migrants_{}", std::process::id()));
+    let _ = std::fs::remove_dir_all(&island_dir);
+
+    let mut mutation_config = MutationConfig::default();
+    mutation_config.num_islands = 2;
+    mutation_config.island_dir = island_dir.to_str().unwrap().to_string();
+    let first_island = Island::join(&mutation_config, "circuit".to_string(), &[]).unwrap();
+    mutation_config.island_id = 1;
+    let second_island = Island::join(&mutation_config, "circuit".to_string(), &[]).unwrap();
+
+    let lhs = Arc::new(SymbolicValue::ConstantInt(BigInt::from(3)));
+    let rhs = Arc::new(SymbolicValue::ConstantInt(BigInt::from(4)));
+    let symbolic_trace = vec![
+        Arc::new(SymbolicValue::BinaryOp(
+            lhs.clone(),
+            DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
+            rhs.clone(),
+        )),
+        Arc::new(SymbolicValue::ConstantInt(BigInt::from(5))),
+    ];
+    let gene: Gene = FxHashMap::from_iter([
+        (
+            0,
+            SymbolicValue::BinaryOp(
+                lhs,
+                DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
+                rhs,
+            ),
+        ),
+        (1, SymbolicValue::NOP),
+    ]);
+    first_island
+        .publish(1, &symbolic_trace, &[&gene], &[])
+        .unwrap();
+
+    let (genes, _) = second_island.collect_migrants(2, &symbolic_trace);
+    assert_eq!(genes, vec![gene]);
+
+    std::fs::remove_dir_all(&island_dir).unwrap();
+}
+
+#[test]
+fn test_roulette_wheel_is_fitness_proportionate() {
+    let population: Vec<usize> = (0..4).collect();
+    let fitness_scores = vec![
+        BigInt::from(-10),
+        BigInt::from(-9),
+        BigInt::from(-7),
+        BigInt::from(-6),
+    ];
+    let wheel = RouletteWheel::new(&fitness_scores);
+    let mut rng = StdRng::seed_from_u64(42);
+
+    let num_draws = 100000;
+    let mut counts = vec![0_usize; population.len()];
+    for _ in 0..num_draws {
+        counts[*roulette_selection(&population, &wheel, &mut rng)] += 1;
+    }
+    // The weights are 0, 1, 3 and 4.
+    assert_eq!(counts[0], 0);
+    for (count, weight) in counts.iter().zip([0.0, 1.0, 3.0, 4.0]) {
+        let expected = num_draws as f64 * weight / 8.0;
+        assert!((*count as f64 - expected).abs() < 0.02 * num_draws as f64);
+    }
+
+    let wheel = RouletteWheel::new(&vec![BigInt::from(5); 4]);
+    assert!((0..100).all(|_| *roulette_selection(&population, &wheel, &mut rng) == 0));
+}
+
+#[test]
+fn test_operator_scheduler_favors_improving_arms() {
+    let mut mutation_config = MutationConfig::default();
+    let original_config = mutation_config.clone();
+    let mut scheduler = OperatorScheduler::new();
+
+    // Only operator replacements lower the error.
+    let mut score = BigInt::from(-1000);
+    let num_generations = 200;
+    for _ in 0..num_generations {
+        scheduler.schedule(&mut mutation_config, false);
+        if mutation_config.operator_mutation_rate == 1.0 {
+            score += 1;
+        }
+        let total: f64 = mutation_config.random_value_probs.iter().sum();
+        assert!((total - 1.0).abs() < 1e-9);
+        scheduler.restore(&mut mutation_config);
+        assert_eq!(
+            mutation_config.operator_mutation_rate,
+            original_config.operator_mutation_rate
+        );
+        assert_eq!(
+            mutation_config.random_value_probs,
+            original_config.random_value_probs
+        );
+        scheduler.reward(&score);
+    }
+
+    let credits = scheduler.credits();
+    let operator = credits
+        .iter()
+        .find(|credit| credit.kind == "operator" && credit.arm == "operator")
+        .unwrap();
+    assert!(num_generations / 2 < operator.num_pulls);
+    assert_eq!(operator.num_improvements, operator.num_pulls);
+    assert!(credits
+        .iter()
+        .filter(|credit| credit.kind == "operator" && credit.arm != "operator")
+        .all(|credit| 0 < credit.num_pulls && credit.num_improvements == 0));
+
+    // A restored scheduler continues alike.
+    let (counts, best_score) = scheduler.state();
+    let mut restored = OperatorScheduler::new();
+    restored.restore_state(&counts, best_score);
+    let mut restored_config = mutation_config.clone();
+    scheduler.schedule(&mut mutation_config, false);
+    restored.schedule(&mut restored_config, false);
+    assert_eq!(
+        mutation_config.operator_mutation_rate,
+        restored_config.operator_mutation_rate
+    );
+    assert_eq!(
+        mutation_config.random_value_probs,
+        restored_config.random_value_probs
+    );
+}
+
+#[test]
+fn test_slicing_keeps_whole_array_assignments_with_their_elements() {
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (mut symbolic_library, program_archive) = prepare_symbolic_library(
+        "./tests/sample/test_array_from_function.circom".to_string(),
+        prime.clone(),
+    );
+    let setting = get_default_setting_for_symbolic_execution(prime, false);
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+    let symbolic_trace = sexe.cur_state.symbolic_trace.clone();
+    let side_constraints = sexe.cur_state.side_constraints.clone();
+
+    // `arr` is defined by a single assignment of the returned array, and both of its elements
+    // are read afterwards.
+    let slices = slice_by_cone_of_influence(&symbolic_trace, &side_constraints);
+    assert_eq!(slices.len(), 1);
+    assert_eq!(
+        slices[0].positions,
+        (0..symbolic_trace.len()).collect::<Vec<_>>()
+    );
+}
+
+#[test]
+fn test_slicing_of_independent_subcircuits() {
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (mut symbolic_library, program_archive) = prepare_symbolic_library(
+        "./tests/sample/test_vuln_independent_iszero.circom".to_string(),
+        prime.clone(),
+    );
+    let setting = get_default_setting_for_symbolic_execution(prime.clone(), false);
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+    let symbolic_trace = sexe.cur_state.symbolic_trace.clone();
+    let side_constraints = sexe.cur_state.side_constraints.clone();
+
+    let slices = slice_by_cone_of_influence(&symbolic_trace, &side_constraints);
+    assert_eq!(slices.len(), 3);
+    let mut positions: Vec<usize> = slices
+        .iter()
+        .flat_map(|slice| slice.positions.clone())
+        .collect();
+    positions.sort();
+    assert_eq!(positions, (0..symbolic_trace.len()).collect::<Vec<_>>());
+    assert_eq!(
+        slices
+            .iter()
+            .map(|slice| slice.side_constraints.len())
+            .sum::<usize>(),
+        side_constraints.len()
+    );
+
+    let verification_base_config = BaseVerificationConfig {
+        target_template_name: "IndependentIsZeros".to_string(),
+        prime: prime.clone(),
+        range: prime.clone(),
+        quick_mode: false,
+        heuristics_mode: false,
+        progress_interval: 10000,
+        num_threads: 1,
+        search_start: BigInt::zero(),
+        search_end: None,
+        witness_oracle: None,
+        template_param_names: Vec::new(),
+        template_param_values: Vec::new(),
+    };
+    let subse_base_config = get_default_setting_for_concrete_execution(prime, false);
+    let mutation_config = load_config_from_json("./tests/parameters/test.json").unwrap();
+
+    let results = search_slices(
+        &*sexe.symbolic_library,
+        &slices,
+        &mutation_config,
+        |library, slice, config| {
+            let mut conc_executor = SymbolicExecutor::new(library, &subse_base_config);
+            mutation_test_search(
+                &mut conc_executor,
+                &slice.symbolic_trace,
+                &slice.side_constraints,
+                &verification_base_config,
+                config,
+                initialize_population_with_operator_or_const_replacement,
+                update_input_population_with_random_sampling,
+                evaluate_trace_fitness_by_error,
+                simple_evolution,
+                mutate_trace_with_operator_or_const_replacement,
+                random_crossover,
+                roulette_selection,
+            )
+        },
+    );
+
+    // Only the slice of `VulnerableIsZero`, which comes last, has a counterexample.
+    assert!(results.iter().all(|result| result.is_some()));
+    let counter_examples: Vec<CounterExample> = results
+        .into_iter()
+        .flatten()
+        .filter_map(|result| result.counter_example)
+        .collect();
+    assert_eq!(counter_examples.len(), 1);
+    assert!(matches!(
+        counter_examples[0].flag,
+        VerificationResult::UnderConstrained(UnderConstrainedType::NonDeterministic(..))
+    ));
+}
@@ -0,0 +1,16 @@
+#!/bin/sh
+# A witness oracle of `test_vuln_iszero.circom` that answers `{"main.out": ...}` to each request
+# `{"main.in": ...}`, as `script/witness_oracle.js` would. With `wrong`, every output is `2`,
+# which no run of the circuit produces.
+
+while IFS= read -r line; do
+  in=$(printf '%s' "$line" | sed 's/.*"main\.in":"\([0-9]*\)".*/\1/')
+  if [ "$1" = "wrong" ]; then
+    out=2
+  elif [ "$in" = "0" ]; then
+    out=1
+  else
+    out=0
+  fi
+  printf '{"main.out":"%s"}\n' "$out"
+done
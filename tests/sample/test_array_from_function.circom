@@ -0,0 +1,25 @@
+pragma circom 2.0.0;
+
+/**
+ * @template ArrayFromFunction
+ * @description Assigns the array returned by a function to a variable, whose elements are then
+ *              read by separate constraints, so that the whole-array assignment and the reads
+ *              of its elements must share a slice.
+ */
+function split(x) {
+    var r[2];
+    r[0] = x;
+    r[1] = x + 1;
+    return r;
+}
+
+template ArrayFromFunction() {
+    signal input in;
+    signal output out[2];
+
+    var arr[2] = split(in);
+    out[0] <== arr[0];
+    out[1] <== arr[1] * 2;
+}
+
+component main = ArrayFromFunction();
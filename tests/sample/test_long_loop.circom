@@ -0,0 +1,14 @@
+pragma circom 2.0.0;
+
+template Main(n) {
+    signal input x;
+    signal output y;
+
+    var acc = 0;
+    for (var i = 0; i < n; i++) {
+        acc += 1;
+    }
+    y <== x + acc;
+}
+
+component main = Main(100000);
@@ -0,0 +1,47 @@
+pragma circom 2.0.0;
+
+/**
+ * @template IndependentIsZeros
+ * @description Checks whether each of three inputs is zero with independent sub-circuits. The
+ *              first two checks are sound, while the third one uses `VulnerableIsZero`, whose
+ *              output can be forced to `1` for a non-zero input.
+ */
+template IsZero() {
+    signal input in;
+    signal output out;
+    signal inv;
+
+    inv <-- in!=0 ? 1/in : 0;
+
+    out <== -in*inv +1;
+    in*out === 0;
+}
+
+template VulnerableIsZero() {
+    signal input in;
+    signal output out;
+    signal inv;
+
+    inv <-- in!=0 ? 1/in : 0;
+
+    out <== -in*inv +1;
+    out*(out-1) === 0;
+}
+
+template IndependentIsZeros() {
+    signal input in[3];
+    signal output out[3];
+
+    component checks[2];
+    for (var i = 0; i < 2; i++) {
+        checks[i] = IsZero();
+        checks[i].in <== in[i];
+        out[i] <== checks[i].out;
+    }
+
+    component vuln = VulnerableIsZero();
+    vuln.in <== in[2];
+    out[2] <== vuln.out;
+}
+
+component main = IndependentIsZeros();
@@ -1,7 +1,8 @@
 mod utils;
 
-use std::rc::Rc;
+use std::path::Path;
 use std::str::FromStr;
+use std::sync::Arc;
 
 use num_bigint_dig::BigInt;
 use num_traits::identities::Zero;
@@ -9,12 +10,17 @@ use num_traits::One;
 
 use program_structure::ast::{Expression, ExpressionInfixOpcode, ExpressionPrefixOpcode};
 
+use zkfuzz::executor::call_graph::collect_reachable_callables;
 use zkfuzz::executor::debug_ast::{
     DebuggableExpressionInfixOpcode, DebuggableExpressionPrefixOpcode,
 };
+use zkfuzz::executor::hash_cons::SymbolicValueInterner;
 use zkfuzz::executor::symbolic_execution::SymbolicExecutor;
 use zkfuzz::executor::symbolic_setting::get_default_setting_for_symbolic_execution;
 use zkfuzz::executor::symbolic_value::{OwnerName, SymbolicAccess, SymbolicName, SymbolicValue};
+use zkfuzz::executor::trace_cache::{
+    cache_path, compute_cache_key, load_cached_trace, save_cached_trace,
+};
 use zkfuzz::mutator::unused_outputs::check_unused_outputs;
 use zkfuzz::mutator::utils::BaseVerificationConfig;
 
@@ -43,20 +49,20 @@ fn test_if_else() {
 
     let ground_truth_symbolic_trace_if_branch = vec![
         SymbolicValue::Assign(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["inv"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
                 }]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Conditional(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Conditional(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["in"],
-                        Rc::new(vec![OwnerName {
+                        Arc::new(vec![OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
                             counter: 0,
@@ -64,14 +70,14 @@ fn test_if_else() {
                         None,
                     ))),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::NotEq),
-                    Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+                    Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
                 )),
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::ConstantInt(BigInt::one())),
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::ConstantInt(BigInt::one())),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Div),
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["in"],
-                        Rc::new(vec![OwnerName {
+                        Arc::new(vec![OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
                             counter: 0,
@@ -79,28 +85,28 @@ fn test_if_else() {
                         None,
                     ))),
                 )),
-                Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
             )),
             false,
             None,
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["out"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
                 }]),
                 None,
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::UnaryOp(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::UnaryOp(
                         DebuggableExpressionPrefixOpcode(ExpressionPrefixOpcode::Sub),
-                        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                        Arc::new(SymbolicValue::Variable(SymbolicName::new(
                             sexe.symbolic_library.name2id["in"],
-                            Rc::new(vec![OwnerName {
+                            Arc::new(vec![OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
                                 counter: 0,
@@ -109,9 +115,9 @@ fn test_if_else() {
                         ))),
                     )),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["inv"],
-                        Rc::new(vec![OwnerName {
+                        Arc::new(vec![OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
                             counter: 0,
@@ -120,14 +126,14 @@ fn test_if_else() {
                     ))),
                 )),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                Rc::new(SymbolicValue::ConstantInt(BigInt::one())),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::one())),
             )),
         ),
         SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["in"],
-                    Rc::new(vec![OwnerName {
+                    Arc::new(vec![OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
                         counter: 0,
@@ -135,9 +141,9 @@ fn test_if_else() {
                     None,
                 ))),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["out"],
-                    Rc::new(vec![OwnerName {
+                    Arc::new(vec![OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
                         counter: 0,
@@ -146,7 +152,7 @@ fn test_if_else() {
                 ))),
             )),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Eq),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
         ),
     ];
 
@@ -175,9 +181,9 @@ fn test_lessthan() {
 
     let ground_truth_symbolic_trace = vec![
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -193,9 +199,9 @@ fn test_lessthan() {
                     SymbolicValue::ConstantInt(BigInt::zero()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["a"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -204,9 +210,9 @@ fn test_lessthan() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -222,9 +228,9 @@ fn test_lessthan() {
                     SymbolicValue::ConstantInt(BigInt::one()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["b"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -234,7 +240,7 @@ fn test_lessthan() {
         ),
     ];
 
-    let owner_name = Rc::new(vec![
+    let owner_name = Arc::new(vec![
         OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
@@ -246,55 +252,55 @@ fn test_lessthan() {
             counter: 0,
         },
     ]);
-    let in_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let in_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["in"],
         owner_name.clone(),
         Some(vec![SymbolicAccess::ArrayAccess(
             SymbolicValue::ConstantInt(BigInt::zero()),
         )]),
     )));
-    let in_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let in_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["in"],
         owner_name.clone(),
         Some(vec![SymbolicAccess::ArrayAccess(
             SymbolicValue::ConstantInt(BigInt::one()),
         )]),
     )));
-    let lessthan_out = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let lessthan_out = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["out"],
         owner_name.clone(),
         None,
     )));
     let cond_1 = SymbolicValue::BinaryOp(
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::ConstantInt(BigInt::one())),
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::ConstantInt(BigInt::one())),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Eq),
             lessthan_out.clone(),
         )),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::BoolAnd),
-        Rc::new(SymbolicValue::AuxBinaryOp(
+        Arc::new(SymbolicValue::AuxBinaryOp(
             in_0.clone(),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Lesser),
             in_1.clone(),
         )),
     );
     let cond_0 = SymbolicValue::BinaryOp(
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Eq),
             lessthan_out.clone(),
         )),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::BoolAnd),
-        Rc::new(SymbolicValue::AuxBinaryOp(
+        Arc::new(SymbolicValue::AuxBinaryOp(
             in_0,
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::GreaterEq),
             in_1,
         )),
     );
     let cond = SymbolicValue::BinaryOp(
-        Rc::new(cond_1),
+        Arc::new(cond_1),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::BoolOr),
-        Rc::new(cond_0),
+        Arc::new(cond_0),
     );
 
     // (BoolOr (BoolAnd (Eq 1 main.lt.out) (Lt main.lt.in[0] main.lt.in[1])) (BoolAnd (Eq 0 main.lt.out) (GEq main.lt.in[0] main.lt.in[1]))),
@@ -326,9 +332,9 @@ fn test_1d_array_component() {
 
     let ground_truth_symbolic_trace = vec![
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["x"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -346,9 +352,9 @@ fn test_1d_array_component() {
                     SymbolicValue::ConstantInt(BigInt::zero()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["a"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -357,9 +363,9 @@ fn test_1d_array_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["x"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -377,9 +383,9 @@ fn test_1d_array_component() {
                     SymbolicValue::ConstantInt(BigInt::one()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["b"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -388,9 +394,9 @@ fn test_1d_array_component() {
             ))),
         ),
         SymbolicValue::Assign(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["y"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -408,10 +414,10 @@ fn test_1d_array_component() {
                     SymbolicValue::ConstantInt(BigInt::zero()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["x"],
-                    Rc::new(vec![
+                    Arc::new(vec![
                         OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
@@ -430,9 +436,9 @@ fn test_1d_array_component() {
                     )]),
                 ))),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Div),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["x"],
-                    Rc::new(vec![
+                    Arc::new(vec![
                         OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
@@ -459,7 +465,7 @@ fn test_1d_array_component() {
     let mut results = Vec::new();
     for s in sexe.cur_state.symbolic_trace {
         if let SymbolicValue::Assign(a, b, c, Some(_)) = s.as_ref() {
-            results.push(Rc::new(SymbolicValue::Assign(
+            results.push(Arc::new(SymbolicValue::Assign(
                 a.clone(),
                 b.clone(),
                 c.clone(),
@@ -478,7 +484,7 @@ fn test_1d_array_component() {
     assert_eq!(
         *sexe.cur_state.symbol_binding_map[&SymbolicName::new(
             sexe.symbolic_library.name2id["x"],
-            Rc::new(vec![
+            Arc::new(vec![
                 OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
@@ -499,7 +505,7 @@ fn test_1d_array_component() {
             .clone(),
         SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["a"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
@@ -525,9 +531,9 @@ fn test_array_signal_initialization() {
 
     let ground_truth_symbolic_trace = vec![
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -543,10 +549,10 @@ fn test_array_signal_initialization() {
                     SymbolicValue::ConstantInt(BigInt::zero()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["in"],
-                    Rc::new(vec![OwnerName {
+                    Arc::new(vec![OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
                         counter: 0,
@@ -554,13 +560,13 @@ fn test_array_signal_initialization() {
                     None,
                 ))),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                Rc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
             )),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -576,10 +582,10 @@ fn test_array_signal_initialization() {
                     SymbolicValue::ConstantInt(BigInt::one()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["in"],
-                    Rc::new(vec![OwnerName {
+                    Arc::new(vec![OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
                         counter: 0,
@@ -587,13 +593,13 @@ fn test_array_signal_initialization() {
                     None,
                 ))),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                Rc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
             )),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["out"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -607,13 +613,13 @@ fn test_array_signal_initialization() {
                 ]),
                 None,
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["in"],
-                        Rc::new(vec![
+                        Arc::new(vec![
                             OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
@@ -631,9 +637,9 @@ fn test_array_signal_initialization() {
                     ))),
                 )),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["in"],
-                    Rc::new(vec![
+                    Arc::new(vec![
                         OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
@@ -652,18 +658,18 @@ fn test_array_signal_initialization() {
             )),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["out"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
                 }]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["out"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -703,22 +709,22 @@ fn test_2d_array_var() {
     execute(&mut sexe, &program_archive);
 
     let ground_truth_symbolic_trace = vec![SymbolicValue::Assign(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["out"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
             }]),
             None,
         ))),
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::BinaryOp(
-                        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::BinaryOp(
+                        Arc::new(SymbolicValue::Variable(SymbolicName::new(
                             sexe.symbolic_library.name2id["in"],
-                            Rc::new(vec![OwnerName {
+                            Arc::new(vec![OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
                                 counter: 0,
@@ -726,16 +732,16 @@ fn test_2d_array_var() {
                             None,
                         ))),
                         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                        Rc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
+                        Arc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
                     )),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                    Rc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
+                    Arc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
                 )),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Div),
-                Rc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
             )),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from(4))),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(4))),
         )),
         false,
         None,
@@ -764,19 +770,19 @@ fn test_multidimensional_array_function() {
     execute(&mut sexe, &program_archive);
 
     let ground_truth_symbolic_trace = vec![SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["out"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
             }]),
             None,
         ))),
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -784,7 +790,7 @@ fn test_multidimensional_array_function() {
                 None,
             ))),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from(8))),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(8))),
         )),
     )];
 
@@ -812,9 +818,9 @@ fn test_2d_array_component() {
 
     let ground_truth_symbolic_trace = vec![
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["x"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -831,9 +837,9 @@ fn test_2d_array_component() {
                     SymbolicAccess::ArrayAccess(SymbolicValue::ConstantInt(BigInt::zero())),
                 ]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -844,9 +850,9 @@ fn test_2d_array_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["x"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -863,9 +869,9 @@ fn test_2d_array_component() {
                     SymbolicAccess::ArrayAccess(SymbolicValue::ConstantInt(BigInt::one())),
                 ]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -876,9 +882,9 @@ fn test_2d_array_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["x"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -895,9 +901,9 @@ fn test_2d_array_component() {
                     SymbolicAccess::ArrayAccess(SymbolicValue::ConstantInt(BigInt::zero())),
                 ]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -908,9 +914,9 @@ fn test_2d_array_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["x"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -927,9 +933,9 @@ fn test_2d_array_component() {
                     SymbolicAccess::ArrayAccess(SymbolicValue::ConstantInt(BigInt::one())),
                 ]),
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -940,9 +946,9 @@ fn test_2d_array_component() {
             ))),
         ),
         SymbolicValue::Assign(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["y"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -958,11 +964,11 @@ fn test_2d_array_component() {
                     SymbolicValue::ConstantInt(BigInt::zero()),
                 )]),
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["x"],
-                        Rc::new(vec![
+                        Arc::new(vec![
                             OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
@@ -980,9 +986,9 @@ fn test_2d_array_component() {
                         ]),
                     ))),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["x"],
-                        Rc::new(vec![
+                        Arc::new(vec![
                             OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
@@ -1001,9 +1007,9 @@ fn test_2d_array_component() {
                     ))),
                 )),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Div),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["x"],
-                    Rc::new(vec![
+                    Arc::new(vec![
                         OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
@@ -1029,7 +1035,7 @@ fn test_2d_array_component() {
     let mut results = Vec::new();
     for s in sexe.cur_state.symbolic_trace {
         if let SymbolicValue::Assign(a, b, c, Some(_)) = s.as_ref() {
-            results.push(Rc::new(SymbolicValue::Assign(
+            results.push(Arc::new(SymbolicValue::Assign(
                 a.clone(),
                 b.clone(),
                 c.clone(),
@@ -1060,19 +1066,19 @@ fn test_recursive_function() {
     execute(&mut sexe, &program_archive);
 
     let ground_truth_symbolic_trace = vec![SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["out"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
             }]),
             None,
         ))),
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -1080,7 +1086,7 @@ fn test_recursive_function() {
                 None,
             ))),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from(15))),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(15))),
         )),
     )];
 
@@ -1107,9 +1113,9 @@ fn test_bulk_assignment() {
     execute(&mut sexe, &program_archive);
 
     let ground_truth_trace_constraint_1 = SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["in"],
-            Rc::new(vec![
+            Arc::new(vec![
                 OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
@@ -1126,9 +1132,9 @@ fn test_bulk_assignment() {
                 SymbolicAccess::ArrayAccess(SymbolicValue::ConstantInt(BigInt::zero())),
             ]),
         ))),
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["in"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
@@ -1142,9 +1148,9 @@ fn test_bulk_assignment() {
     );
 
     let ground_truth_trace_constraint_2 = SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["out"],
-            Rc::new(vec![
+            Arc::new(vec![
                 OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
@@ -1158,14 +1164,14 @@ fn test_bulk_assignment() {
             ]),
             None,
         ))),
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["in"],
-                        Rc::new(vec![
+                        Arc::new(vec![
                             OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
@@ -1184,9 +1190,9 @@ fn test_bulk_assignment() {
                     ))),
                 )),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["in"],
-                    Rc::new(vec![
+                    Arc::new(vec![
                         OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
@@ -1205,9 +1211,9 @@ fn test_bulk_assignment() {
                 ))),
             )),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1252,9 +1258,9 @@ fn test_array_template_argument() {
     execute(&mut sexe, &program_archive);
 
     let thrid_cond = SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["out"],
-            Rc::new(vec![
+            Arc::new(vec![
                 OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
@@ -1270,10 +1276,10 @@ fn test_array_template_argument() {
                 SymbolicValue::ConstantInt(BigInt::zero()),
             )]),
         ))),
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1290,7 +1296,7 @@ fn test_array_template_argument() {
                 )]),
             ))),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::one())),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::one())),
         )),
     );
 
@@ -1313,9 +1319,9 @@ fn test_anonymous_component() {
 
     let ground_truth_symbolic_trace = vec![
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["a"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1329,9 +1335,9 @@ fn test_anonymous_component() {
                 ]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -1342,9 +1348,9 @@ fn test_anonymous_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["b"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1358,9 +1364,9 @@ fn test_anonymous_component() {
                 ]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -1371,9 +1377,9 @@ fn test_anonymous_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["c"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1387,13 +1393,13 @@ fn test_anonymous_component() {
                 ]),
                 None,
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["a"],
-                        Rc::new(vec![
+                        Arc::new(vec![
                             OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
@@ -1409,9 +1415,9 @@ fn test_anonymous_component() {
                     ))),
                 )),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["b"],
-                    Rc::new(vec![
+                    Arc::new(vec![
                         OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
@@ -1428,18 +1434,18 @@ fn test_anonymous_component() {
             )),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["out_1"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
                 }]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["c"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1455,9 +1461,9 @@ fn test_anonymous_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["a"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1471,9 +1477,9 @@ fn test_anonymous_component() {
                 ]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -1484,9 +1490,9 @@ fn test_anonymous_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["b"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1500,9 +1506,9 @@ fn test_anonymous_component() {
                 ]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -1513,9 +1519,9 @@ fn test_anonymous_component() {
             ))),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["c"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1529,13 +1535,13 @@ fn test_anonymous_component() {
                 ]),
                 None,
             ))),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::BinaryOp(
-                    Rc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
+                    Arc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                    Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                    Arc::new(SymbolicValue::Variable(SymbolicName::new(
                         sexe.symbolic_library.name2id["a"],
-                        Rc::new(vec![
+                        Arc::new(vec![
                             OwnerName {
                                 id: sexe.symbolic_library.name2id["main"],
                                 access: None,
@@ -1551,9 +1557,9 @@ fn test_anonymous_component() {
                     ))),
                 )),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["b"],
-                    Rc::new(vec![
+                    Arc::new(vec![
                         OwnerName {
                             id: sexe.symbolic_library.name2id["main"],
                             access: None,
@@ -1570,18 +1576,18 @@ fn test_anonymous_component() {
             )),
         ),
         SymbolicValue::AssignEq(
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["out_2"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
                 }]),
                 None,
             ))),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["c"],
-                Rc::new(vec![
+                Arc::new(vec![
                     OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
@@ -1673,10 +1679,10 @@ fn test_array_processing_and_nested_output() {
     let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
     execute(&mut sexe, &program_archive);
 
-    let first_cond = Rc::new(SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let first_cond = Arc::new(SymbolicValue::AssignEq(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["a"],
-            Rc::new(vec![
+            Arc::new(vec![
                 OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
@@ -1692,9 +1698,9 @@ fn test_array_processing_and_nested_output() {
                 SymbolicValue::ConstantInt(BigInt::zero()),
             )]),
         ))),
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["x"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
@@ -1744,9 +1750,9 @@ fn test_inline_call_bulk_return_assignment() {
     let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
     execute(&mut sexe, &program_archive);
 
-    let x_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let x_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["x"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -1756,9 +1762,9 @@ fn test_inline_call_bulk_return_assignment() {
         )]),
     )));
 
-    let x_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let x_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["x"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -1768,9 +1774,9 @@ fn test_inline_call_bulk_return_assignment() {
         )]),
     )));
 
-    let x0_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let x0_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["x0"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -1787,9 +1793,9 @@ fn test_inline_call_bulk_return_assignment() {
         )]),
     )));
 
-    let x0_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let x0_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["x0"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -1806,9 +1812,9 @@ fn test_inline_call_bulk_return_assignment() {
         )]),
     )));
 
-    let out0_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let out0_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["out0"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -1825,9 +1831,9 @@ fn test_inline_call_bulk_return_assignment() {
         )]),
     )));
 
-    let out0_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let out0_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["out0"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -1844,9 +1850,9 @@ fn test_inline_call_bulk_return_assignment() {
         )]),
     )));
 
-    let out_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let out_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["out"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -1856,9 +1862,9 @@ fn test_inline_call_bulk_return_assignment() {
         )]),
     )));
 
-    let out_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let out_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["out"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -1873,7 +1879,7 @@ fn test_inline_call_bulk_return_assignment() {
         SymbolicValue::AssignEq(x0_1.clone(), x_1.clone()),
         SymbolicValue::AssignEq(
             out0_0.clone(),
-            Rc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::BinaryOp(
                 x0_0.clone(),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
                 x0_1.clone(),
@@ -1881,7 +1887,7 @@ fn test_inline_call_bulk_return_assignment() {
         ),
         SymbolicValue::AssignEq(
             out0_1.clone(),
-            Rc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::BinaryOp(
                 x0_0.clone(),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Sub),
                 x0_1.clone(),
@@ -1920,9 +1926,9 @@ fn test_one_line_call() {
     let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
     execute(&mut sexe, &program_archive);
 
-    let main_a_11_152_a = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_a_11_152_a = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["a"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -1937,9 +1943,9 @@ fn test_one_line_call() {
         None,
     )));
 
-    let main_a_11_152_b = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_a_11_152_b = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["b"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -1954,9 +1960,9 @@ fn test_one_line_call() {
         None,
     )));
 
-    let main_a_11_152_c = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_a_11_152_c = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["c"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -1971,9 +1977,9 @@ fn test_one_line_call() {
         None,
     )));
 
-    let main_n = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_n = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["n"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -1981,9 +1987,9 @@ fn test_one_line_call() {
         None,
     )));
 
-    let main_in_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_in_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["in"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -1993,9 +1999,9 @@ fn test_one_line_call() {
         )]),
     )));
 
-    let main_in_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_in_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["in"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -2005,9 +2011,9 @@ fn test_one_line_call() {
         )]),
     )));
 
-    let main_out = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_out = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["out"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -2018,13 +2024,13 @@ fn test_one_line_call() {
     let ground_truth_constraints = vec![
         SymbolicValue::AssignTemplParam(
             main_n.clone(),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from_str("2").unwrap())),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from_str("2").unwrap())),
         ),
         SymbolicValue::AssignEq(main_a_11_152_a.clone(), main_in_0.clone()),
         SymbolicValue::AssignEq(main_a_11_152_b.clone(), main_in_1.clone()),
         SymbolicValue::AssignEq(
             main_a_11_152_c.clone(),
-            Rc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::BinaryOp(
                 main_a_11_152_a,
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
                 main_a_11_152_b,
@@ -2059,9 +2065,9 @@ fn test_one_line_call_array() {
     let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
     execute(&mut sexe, &program_archive);
 
-    let main_callee_13_217_in_0 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_callee_13_217_in_0 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["in"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -2078,9 +2084,9 @@ fn test_one_line_call_array() {
         )]),
     )));
 
-    let main_callee_13_217_in_1 = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_callee_13_217_in_1 = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["in"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -2097,9 +2103,9 @@ fn test_one_line_call_array() {
         )]),
     )));
 
-    let main_callee_13_217_out = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_callee_13_217_out = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["out"],
-        Rc::new(vec![
+        Arc::new(vec![
             OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
@@ -2114,9 +2120,9 @@ fn test_one_line_call_array() {
         None,
     )));
 
-    let main_a = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_a = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["a"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -2124,9 +2130,9 @@ fn test_one_line_call_array() {
         None,
     )));
 
-    let main_b = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_b = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["b"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -2134,9 +2140,9 @@ fn test_one_line_call_array() {
         None,
     )));
 
-    let main_c = Rc::new(SymbolicValue::Variable(SymbolicName::new(
+    let main_c = Arc::new(SymbolicValue::Variable(SymbolicName::new(
         sexe.symbolic_library.name2id["c"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -2149,10 +2155,10 @@ fn test_one_line_call_array() {
         SymbolicValue::AssignEq(main_callee_13_217_in_1.clone(), main_b),
         SymbolicValue::AssignEq(
             main_callee_13_217_out.clone(),
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::ConstantInt(BigInt::from_str("3").unwrap())),
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::ConstantInt(BigInt::from_str("3").unwrap())),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-                Rc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::BinaryOp(
                     main_callee_13_217_in_0,
                     DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
                     main_callee_13_217_in_1,
@@ -2205,6 +2211,10 @@ fn test_unused_outputs() {
         quick_mode: false,
         heuristics_mode: false,
         progress_interval: 10000,
+        num_threads: 1,
+        search_start: BigInt::zero(),
+        search_end: None,
+        witness_oracle: None,
         template_param_names: template_param_names,
         template_param_values: template_param_values,
     };
@@ -2227,9 +2237,9 @@ fn test_assign_nested_array() {
     execute(&mut sexe, &program_archive);
 
     let last_cond = SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["out"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
@@ -2240,9 +2250,9 @@ fn test_assign_nested_array() {
                 SymbolicAccess::ArrayAccess(SymbolicValue::ConstantInt(BigInt::from(2))),
             ]),
         ))),
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["y"],
-            Rc::new(vec![
+            Arc::new(vec![
                 OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
@@ -2279,22 +2289,22 @@ fn test_var_bulk_assignment() {
     execute(&mut sexe, &program_archive);
 
     let first_cond = SymbolicValue::AssignEq(
-        Rc::new(SymbolicValue::Variable(SymbolicName::new(
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
             sexe.symbolic_library.name2id["out"],
-            Rc::new(vec![OwnerName {
+            Arc::new(vec![OwnerName {
                 id: sexe.symbolic_library.name2id["main"],
                 access: None,
                 counter: 0,
             }]),
             None,
         ))),
-        Rc::new(SymbolicValue::BinaryOp(
-            Rc::new(SymbolicValue::BinaryOp(
-                Rc::new(SymbolicValue::ConstantInt(BigInt::zero())),
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::ConstantInt(BigInt::zero())),
                 DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-                Rc::new(SymbolicValue::Variable(SymbolicName::new(
+                Arc::new(SymbolicValue::Variable(SymbolicName::new(
                     sexe.symbolic_library.name2id["in"],
-                    Rc::new(vec![OwnerName {
+                    Arc::new(vec![OwnerName {
                         id: sexe.symbolic_library.name2id["main"],
                         access: None,
                         counter: 0,
@@ -2306,9 +2316,9 @@ fn test_var_bulk_assignment() {
                 ))),
             )),
             DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-            Rc::new(SymbolicValue::Variable(SymbolicName::new(
+            Arc::new(SymbolicValue::Variable(SymbolicName::new(
                 sexe.symbolic_library.name2id["in"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -2324,3 +2334,168 @@ fn test_var_bulk_assignment() {
     assert_eq!(*sexe.cur_state.symbolic_trace[0], first_cond);
     assert_eq!(*sexe.cur_state.side_constraints[0], first_cond);
 }
+
+#[test]
+fn test_trace_cache_round_trip() {
+    let path =
+        "./tests/sample/test_multiplexer_with_decoder_and_escalar_product.circom".to_string();
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (mut symbolic_library, program_archive) =
+        prepare_symbolic_library(path.clone(), prime.clone());
+    let setting = get_default_setting_for_symbolic_execution(prime, false);
+
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+
+    let cache_dir = std::env::temp_dir().join(format!("zkfuzz_trace_cache_{}", std::process::id()));
+    let settings = vec!["254".to_string()];
+    let key = compute_cache_key(Path::new(&path), &[], &settings).unwrap();
+    assert_eq!(
+        key,
+        compute_cache_key(Path::new(&path), &[], &settings).unwrap()
+    );
+    assert_ne!(
+        key,
+        compute_cache_key(Path::new(&path), &[], &["255".to_string()]).unwrap()
+    );
+
+    let cache_file = cache_path(&cache_dir, &key);
+    save_cached_trace(
+        &cache_file,
+        &key,
+        &sexe.symbolic_library.name2id,
+        &sexe.cur_state,
+    )
+    .unwrap();
+    let cached = load_cached_trace(&cache_file).unwrap();
+    std::fs::remove_dir_all(&cache_dir).unwrap();
+
+    assert_eq!(cached.key_inputs, key.inputs);
+    assert_eq!(cached.name2id, sexe.symbolic_library.name2id);
+    assert_eq!(cached.symbol_binding_map, sexe.cur_state.symbol_binding_map);
+    assert_eq!(cached.symbolic_trace, sexe.cur_state.symbolic_trace);
+    assert_eq!(cached.side_constraints, sexe.cur_state.side_constraints);
+}
+
+#[test]
+fn test_component_summary() {
+    let path = "./tests/sample/test_1d_array_component.circom".to_string();
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (mut symbolic_library, program_archive) = prepare_symbolic_library(path, prime.clone());
+    let setting = get_default_setting_for_symbolic_execution(prime, false);
+
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+
+    // Both instances of `Callee` share a summary, from which `c[1]` is instantiated, and the
+    // trace checked by `test_1d_array_component` is unchanged.
+    assert_eq!(sexe.symbolic_library.component_summaries.len(), 1);
+}
+
+#[test]
+fn test_long_loop() {
+    let path = "./tests/sample/test_long_loop.circom".to_string();
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (mut symbolic_library, program_archive) = prepare_symbolic_library(path, prime.clone());
+    let setting = get_default_setting_for_symbolic_execution(prime, false);
+
+    // The loop runs on the default stack of the test thread.
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+
+    assert!(!sexe.execution_failed);
+    assert!(sexe
+        .cur_state
+        .symbolic_trace
+        .last()
+        .unwrap()
+        .lookup_fmt(&sexe.symbolic_library.id2name)
+        .contains("100000"));
+}
+
+#[test]
+fn test_hash_cons() {
+    let x = SymbolicName::new(0, Arc::new(Vec::new()), None);
+    let build = || {
+        SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::Variable(x.clone())),
+            DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
+            Arc::new(SymbolicValue::BinaryOp(
+                Arc::new(SymbolicValue::Variable(x.clone())),
+                DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::one())),
+            )),
+        )
+    };
+
+    let mut interner = SymbolicValueInterner::default();
+    let first = interner.intern(&build());
+    let second = interner.intern(&build());
+    assert!(Arc::ptr_eq(&first, &second));
+    assert_eq!(*first, build());
+    // `x`, `1`, `x + 1`, and `x * (x + 1)`.
+    assert_eq!(interner.len(), 4);
+    assert!(Arc::ptr_eq(&interner.intern_ref(&first), &first));
+
+    let path = "./tests/sample/test_1d_array_component.circom".to_string();
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+    let (mut symbolic_library, program_archive) = prepare_symbolic_library(path, prime.clone());
+    let setting = get_default_setting_for_symbolic_execution(prime, false);
+    let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+    execute(&mut sexe, &program_archive);
+
+    // Constraints are shared by the trace and the side constraints.
+    for constraint in &sexe.cur_state.side_constraints {
+        assert!(sexe
+            .cur_state
+            .symbolic_trace
+            .iter()
+            .any(|value| Arc::ptr_eq(value, constraint)));
+    }
+}
+
+#[test]
+fn test_reachable_callables() {
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+
+    let (_, program_archive) = prepare_symbolic_library(
+        "./tests/sample/test_lessthan.circom".to_string(),
+        prime.clone(),
+    );
+    let reachable = collect_reachable_callables(&program_archive, &["LessThan".to_string()], &[]);
+    assert_eq!(reachable.templates, vec!["LessThan", "Num2Bits"]);
+    assert!(reachable.functions.is_empty());
+    let reachable =
+        collect_reachable_callables(&program_archive, &["VulnerableLessThan".to_string()], &[]);
+    assert_eq!(
+        reachable.templates,
+        vec!["LessThan", "Num2Bits", "VulnerableLessThan"]
+    );
+
+    // Recursive functions are visited once.
+    let (_, program_archive) = prepare_symbolic_library(
+        "./tests/sample/test_recursive_function.circom".to_string(),
+        prime,
+    );
+    let reachable = collect_reachable_callables(&program_archive, &["Main".to_string()], &[]);
+    assert_eq!(reachable.templates, vec!["Main"]);
+    assert_eq!(reachable.functions, vec!["f"]);
+}
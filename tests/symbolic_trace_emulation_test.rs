@@ -1,17 +1,28 @@
 mod utils;
 
-use std::rc::Rc;
 use std::str::FromStr;
+use std::sync::Arc;
 
 use num_bigint_dig::BigInt;
 use num_traits::identities::Zero;
 use num_traits::One;
 
+use program_structure::ast::ExpressionInfixOpcode;
 use rustc_hash::{FxHashMap, FxHashSet};
+use zkfuzz::executor::debug_ast::DebuggableExpressionInfixOpcode;
 use zkfuzz::executor::symbolic_execution::SymbolicExecutor;
 use zkfuzz::executor::symbolic_setting::get_default_setting_for_symbolic_execution;
-use zkfuzz::executor::symbolic_value::{OwnerName, SymbolicAccess, SymbolicName, SymbolicValue};
-use zkfuzz::mutator::utils::{emulate_symbolic_trace, gather_runtime_mutable_inputs, Direction};
+use zkfuzz::executor::symbolic_value::{
+    OwnerName, SymbolicAccess, SymbolicLibrary, SymbolicName, SymbolicValue, SymbolicValueRef,
+};
+use zkfuzz::mutator::compiled_trace::CompiledTrace;
+use zkfuzz::mutator::mutation_utils::{apply_trace_mutation, mutated_statements};
+use zkfuzz::mutator::trace_optimizer::optimize_trace;
+use zkfuzz::mutator::utils::{
+    emulate_symbolic_trace, evaluate_constraints, evaluate_constraints_in_order,
+    evaluate_error_of_symbolic_value, gather_runtime_mutable_inputs, ConstraintScheduler,
+    Direction,
+};
 
 use crate::utils::{execute, prepare_symbolic_library};
 
@@ -31,7 +42,7 @@ fn test_emulate_if_else() {
 
     let main_in = SymbolicName::new(
         sexe.symbolic_library.name2id["in"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -40,7 +51,7 @@ fn test_emulate_if_else() {
     );
     let main_out = SymbolicName::new(
         sexe.symbolic_library.name2id["out"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -89,7 +100,7 @@ fn test_recursive_call() {
         (
             SymbolicName::new(
                 sexe.symbolic_library.name2id["inputs"],
-                Rc::new(vec![OwnerName {
+                Arc::new(vec![OwnerName {
                     id: sexe.symbolic_library.name2id["main"],
                     access: None,
                     counter: 0,
@@ -112,7 +123,7 @@ fn test_recursive_call() {
 
     let main_out = SymbolicName::new(
         sexe.symbolic_library.name2id["out"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -139,7 +150,7 @@ fn test_call_const_template() {
 
     let main_a = SymbolicName::new(
         sexe.symbolic_library.name2id["a"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -148,7 +159,7 @@ fn test_call_const_template() {
     );
     let main_b = SymbolicName::new(
         sexe.symbolic_library.name2id["b"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -157,7 +168,7 @@ fn test_call_const_template() {
     );
     let main_c = SymbolicName::new(
         sexe.symbolic_library.name2id["c"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -196,7 +207,7 @@ fn test_hash_break() {
 
     let main_x = SymbolicName::new(
         sexe.symbolic_library.name2id["x"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -205,7 +216,7 @@ fn test_hash_break() {
     );
     let main_y = SymbolicName::new(
         sexe.symbolic_library.name2id["y"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -214,7 +225,7 @@ fn test_hash_break() {
     );
     let main_z = SymbolicName::new(
         sexe.symbolic_library.name2id["z"],
-        Rc::new(vec![OwnerName {
+        Arc::new(vec![OwnerName {
             id: sexe.symbolic_library.name2id["main"],
             access: None,
             counter: 0,
@@ -232,3 +243,425 @@ fn test_hash_break() {
     assert_eq!(runtime_mutable_positions.len(), 1);
     assert_eq!(*runtime_mutable_positions.get(&2).unwrap(), Direction::Left);
 }
+
+fn assert_same_emulation(
+    prime: &BigInt,
+    trace: &[SymbolicValueRef],
+    runtime_mutable_positions: &FxHashMap<usize, Direction>,
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    symbolic_library: &mut SymbolicLibrary,
+) {
+    let mut tree_assignment = assignment.clone();
+    let tree_result = emulate_symbolic_trace(
+        prime,
+        trace,
+        runtime_mutable_positions,
+        &mut tree_assignment,
+        symbolic_library,
+    );
+
+    let compiled_trace = CompiledTrace::compile(prime, trace);
+    let mut compiled_assignment = assignment.clone();
+    let compiled_result = compiled_trace.emulate(
+        runtime_mutable_positions,
+        &mut compiled_assignment,
+        symbolic_library,
+    );
+
+    assert_eq!(tree_result, compiled_result);
+    assert_eq!(tree_assignment, compiled_assignment);
+}
+
+fn assert_same_incremental_emulation(
+    prime: &BigInt,
+    trace: &Vec<SymbolicValueRef>,
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    symbolic_library: &mut SymbolicLibrary,
+) {
+    let runtime_mutable_positions = FxHashMap::default();
+    let compiled_trace = CompiledTrace::compile(prime, trace);
+    let mut original_assignment = assignment.clone();
+    let original_result = compiled_trace.emulate_with_state(
+        &runtime_mutable_positions,
+        &mut original_assignment,
+        symbolic_library,
+    );
+    let original_state = match original_result {
+        Some((_, _, original_state)) => original_state,
+        None => return,
+    };
+
+    for (pos, inst) in trace.iter().enumerate() {
+        if !matches!(
+            inst.as_ref(),
+            SymbolicValue::Assign(..) | SymbolicValue::AssignCall(..)
+        ) {
+            continue;
+        }
+        let trace_mutation =
+            FxHashMap::from_iter([(pos, SymbolicValue::ConstantInt(BigInt::from(pos)))]);
+        let mutated_trace = apply_trace_mutation(trace, &trace_mutation);
+
+        let mut tree_assignment = assignment.clone();
+        let tree_result = emulate_symbolic_trace(
+            prime,
+            &mutated_trace,
+            &runtime_mutable_positions,
+            &mut tree_assignment,
+            symbolic_library,
+        );
+
+        let compiled_mutated_trace =
+            compiled_trace.compile_mutation(&mutated_statements(trace, &trace_mutation));
+        // Traces that reassign a variable after the mutation are emulated in full instead.
+        let plan = match compiled_mutated_trace.plan_incremental(&[pos], &runtime_mutable_positions)
+        {
+            Some(plan) => plan,
+            None => continue,
+        };
+        let mut incremental_assignment = original_assignment.clone();
+        let incremental_result = compiled_mutated_trace.emulate_incremental(
+            &plan,
+            &original_state,
+            assignment,
+            &runtime_mutable_positions,
+            &mut incremental_assignment,
+            symbolic_library,
+        );
+
+        assert_eq!(tree_result, incremental_result);
+        assert_eq!(tree_assignment, incremental_assignment);
+    }
+}
+
+fn assert_same_constraint_evaluation(
+    prime: &BigInt,
+    trace: &Vec<SymbolicValueRef>,
+    side_constraints: &Vec<SymbolicValueRef>,
+    assignment: &FxHashMap<SymbolicName, BigInt>,
+    symbolic_library: &mut SymbolicLibrary,
+) {
+    let mut compiled_trace = CompiledTrace::compile(prime, trace);
+    let compiled_constraints = compiled_trace.compile_constraints(side_constraints);
+    let mut final_assignment = assignment.clone();
+    let state = match compiled_trace.emulate_with_state(
+        &FxHashMap::default(),
+        &mut final_assignment,
+        symbolic_library,
+    ) {
+        Some((_, _, state)) => state,
+        None => return,
+    };
+
+    assert_eq!(
+        evaluate_constraints(prime, side_constraints, &final_assignment, symbolic_library),
+        compiled_trace.is_satisfying(
+            &compiled_constraints,
+            &state,
+            &final_assignment,
+            symbolic_library,
+            &mut ConstraintScheduler::new(compiled_constraints.costs())
+        )
+    );
+    let tree_errors: Vec<_> = side_constraints
+        .iter()
+        .map(|constraint| {
+            evaluate_error_of_symbolic_value(prime, constraint, &final_assignment, symbolic_library)
+        })
+        .collect();
+    assert_eq!(
+        tree_errors,
+        compiled_trace.errors_of_constraints(
+            &compiled_constraints,
+            &state,
+            &final_assignment,
+            symbolic_library
+        )
+    );
+}
+
+fn assert_same_batch_emulation(
+    prime: &BigInt,
+    trace: &Vec<SymbolicValueRef>,
+    assignments: &[FxHashMap<SymbolicName, BigInt>],
+    symbolic_library: &mut SymbolicLibrary,
+) {
+    let runtime_mutable_positions = FxHashMap::default();
+    let compiled_trace = CompiledTrace::compile(prime, trace);
+    let mut batch_assignments = assignments.to_vec();
+    let batch_results = compiled_trace.emulate_batch(
+        &runtime_mutable_positions,
+        &mut batch_assignments,
+        symbolic_library,
+    );
+
+    for ((assignment, batch_assignment), batch_result) in assignments
+        .iter()
+        .zip(batch_assignments.iter())
+        .zip(batch_results.into_iter())
+    {
+        let mut tree_assignment = assignment.clone();
+        let tree_result = emulate_symbolic_trace(
+            prime,
+            trace,
+            &runtime_mutable_positions,
+            &mut tree_assignment,
+            symbolic_library,
+        );
+        assert_eq!(
+            tree_result,
+            batch_result.map(|(success, failure_pos, _)| (success, failure_pos))
+        );
+        assert_eq!(&tree_assignment, batch_assignment);
+    }
+}
+
+#[test]
+fn test_compiled_trace_emulation() {
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+    let setting = get_default_setting_for_symbolic_execution(prime.clone(), false);
+
+    for (path, input_name, inputs) in [
+        ("./tests/sample/test_if_else.circom", "in", vec![None]),
+        (
+            "./tests/sample/test_recursive_call.circom",
+            "inputs",
+            (0..8).map(Some).collect(),
+        ),
+    ] {
+        let (mut symbolic_library, program_archive) =
+            prepare_symbolic_library(path.to_string(), prime.clone());
+        let mut sexe = SymbolicExecutor::new(&mut symbolic_library, &setting);
+        execute(&mut sexe, &program_archive);
+
+        let owner = Arc::new(vec![OwnerName {
+            id: sexe.symbolic_library.name2id["main"],
+            access: None,
+            counter: 0,
+        }]);
+        let names: Vec<_> = inputs
+            .iter()
+            .map(|i: &Option<usize>| {
+                SymbolicName::new(
+                    sexe.symbolic_library.name2id[input_name],
+                    owner.clone(),
+                    i.map(|i| {
+                        vec![SymbolicAccess::ArrayAccess(SymbolicValue::ConstantInt(
+                            BigInt::from(i),
+                        ))]
+                    }),
+                )
+            })
+            .collect();
+
+        let trace = sexe.cur_state.symbolic_trace.clone();
+        let side_constraints = sexe.cur_state.side_constraints.clone();
+        let assignments: Vec<FxHashMap<_, _>> = (0..4)
+            .map(|seed| {
+                FxHashMap::from_iter(
+                    names
+                        .iter()
+                        .enumerate()
+                        .map(|(i, name)| (name.clone(), BigInt::from((seed + i) % 3))),
+                )
+            })
+            .collect();
+        assert_same_batch_emulation(&prime, &trace, &assignments, &mut sexe.symbolic_library);
+        for assignment in assignments {
+            assert_same_emulation(
+                &prime,
+                &trace,
+                &FxHashMap::default(),
+                &assignment,
+                &mut sexe.symbolic_library,
+            );
+            assert_same_incremental_emulation(
+                &prime,
+                &trace,
+                &assignment,
+                &mut sexe.symbolic_library,
+            );
+            assert_same_constraint_evaluation(
+                &prime,
+                &trace,
+                &side_constraints,
+                &assignment,
+                &mut sexe.symbolic_library,
+            );
+        }
+    }
+}
+
+#[test]
+fn test_optimize_trace() {
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+    let owner = Arc::new(vec![OwnerName {
+        id: 0,
+        access: None,
+        counter: 0,
+    }]);
+    let variable = |id: usize| {
+        Arc::new(SymbolicValue::Variable(SymbolicName::new(
+            id,
+            owner.clone(),
+            None,
+        )))
+    };
+    let constant = |n: i32| Arc::new(SymbolicValue::ConstantInt(BigInt::from(n)));
+    let binary_op = |lhs: SymbolicValueRef, op: ExpressionInfixOpcode, rhs: SymbolicValueRef| {
+        Arc::new(SymbolicValue::BinaryOp(
+            lhs,
+            DebuggableExpressionInfixOpcode(op),
+            rhs,
+        ))
+    };
+    let (main_in, main_out, main_dead) = (variable(1), variable(2), variable(3));
+
+    let constraint = binary_op(
+        main_out.clone(),
+        ExpressionInfixOpcode::Eq,
+        binary_op(main_in.clone(), ExpressionInfixOpcode::Add, constant(6)),
+    );
+    let symbolic_trace: Vec<SymbolicValueRef> = vec![
+        Arc::new(SymbolicValue::NOP),
+        Arc::new(SymbolicValue::Assign(
+            main_dead.clone(),
+            binary_op(main_in.clone(), ExpressionInfixOpcode::Mul, constant(2)),
+            false,
+            None,
+        )),
+        Arc::new(SymbolicValue::Assign(
+            main_out.clone(),
+            binary_op(
+                main_in.clone(),
+                ExpressionInfixOpcode::Add,
+                binary_op(constant(2), ExpressionInfixOpcode::Mul, constant(3)),
+            ),
+            false,
+            None,
+        )),
+        constraint.clone(),
+        binary_op(constant(1), ExpressionInfixOpcode::Eq, constant(1)),
+    ];
+    let side_constraints: Vec<SymbolicValueRef> = vec![
+        constraint.clone(),
+        constraint.clone(),
+        binary_op(constant(1), ExpressionInfixOpcode::Eq, constant(1)),
+    ];
+
+    let optimized = optimize_trace(
+        &prime,
+        &symbolic_trace,
+        &side_constraints,
+        &FxHashSet::from_iter([2]),
+    );
+    // The `NOP`, the dead assignment, and the trivially true constraint are dropped.
+    assert_eq!(optimized.positions, vec![2, 3]);
+    assert_eq!(
+        *optimized.symbolic_trace[0],
+        SymbolicValue::Assign(main_out.clone(), constraint_rhs(&constraint), false, None)
+    );
+    assert_eq!(optimized.side_constraints, vec![constraint]);
+
+    let mut symbolic_library = SymbolicLibrary::default();
+    let runtime_mutable_positions = FxHashMap::default();
+    let main_in_name = match main_in.as_ref() {
+        SymbolicValue::Variable(name) => name.clone(),
+        _ => unreachable!(),
+    };
+    let main_out_name = match main_out.as_ref() {
+        SymbolicValue::Variable(name) => name.clone(),
+        _ => unreachable!(),
+    };
+    let mut original_assignment = FxHashMap::from_iter([(main_in_name.clone(), BigInt::from(5))]);
+    let mut optimized_assignment = original_assignment.clone();
+    assert_eq!(
+        emulate_symbolic_trace(
+            &prime,
+            &symbolic_trace,
+            &runtime_mutable_positions,
+            &mut original_assignment,
+            &mut symbolic_library,
+        ),
+        Some((true, 0))
+    );
+    assert_eq!(
+        emulate_symbolic_trace(
+            &prime,
+            &optimized.symbolic_trace,
+            &runtime_mutable_positions,
+            &mut optimized_assignment,
+            &mut symbolic_library,
+        ),
+        Some((true, 0))
+    );
+    assert_eq!(
+        original_assignment[&main_out_name],
+        optimized_assignment[&main_out_name]
+    );
+}
+
+fn constraint_rhs(constraint: &SymbolicValueRef) -> SymbolicValueRef {
+    match constraint.as_ref() {
+        SymbolicValue::BinaryOp(_, _, rhs) => rhs.clone(),
+        _ => unreachable!(),
+    }
+}
+
+#[test]
+fn test_constraint_scheduler() {
+    let prime = BigInt::from_str(
+        "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    )
+    .unwrap();
+    let mut symbolic_library = SymbolicLibrary::default();
+    let satisfied = Arc::new(SymbolicValue::ConstantBool(true));
+    let violated = Arc::new(SymbolicValue::ConstantBool(false));
+    let constraints = vec![satisfied.clone(), violated.clone()];
+
+    // Without any observation, the cheapest constraint comes first.
+    let mut scheduler = ConstraintScheduler::new(vec![1, 10]);
+    assert_eq!(scheduler.order(), &[0, 1]);
+
+    // Once the expensive constraint is known to fail, it is checked first.
+    for _ in 0..64 {
+        assert!(!evaluate_constraints_in_order(
+            &prime,
+            &constraints,
+            &FxHashMap::default(),
+            &mut symbolic_library,
+            &mut scheduler,
+        ));
+    }
+    assert_eq!(scheduler.order(), &[1, 0]);
+
+    // The order does not change the outcome of a check.
+    for constraints in [
+        vec![satisfied.clone()],
+        vec![satisfied.clone(), satisfied.clone()],
+        vec![satisfied.clone(), violated.clone()],
+    ] {
+        let mut scheduler = ConstraintScheduler::for_constraints(&constraints);
+        assert_eq!(
+            evaluate_constraints(
+                &prime,
+                &constraints,
+                &FxHashMap::default(),
+                &mut symbolic_library
+            ),
+            evaluate_constraints_in_order(
+                &prime,
+                &constraints,
+                &FxHashMap::default(),
+                &mut symbolic_library,
+                &mut scheduler,
+            )
+        );
+    }
+}
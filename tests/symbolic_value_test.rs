@@ -1,12 +1,19 @@
-use std::rc::Rc;
+use std::collections::hash_map::DefaultHasher;
+use std::hash::{Hash, Hasher};
 use std::str::FromStr;
+use std::sync::Arc;
+use std::thread;
 
 use num_bigint_dig::BigInt;
 
 use program_structure::ast::ExpressionInfixOpcode;
 
 use zkfuzz::executor::debug_ast::DebuggableExpressionInfixOpcode;
-use zkfuzz::executor::symbolic_value::{enumerate_array, evaluate_binary_op, SymbolicValue};
+use zkfuzz::executor::symbolic_state::{freeze_symbolic_trace, SymbolicTrace};
+use zkfuzz::executor::symbolic_value::{
+    enumerate_array, evaluate_binary_op, SymbolicAccess, SymbolicLibrary, SymbolicName,
+    SymbolicValue,
+};
 
 #[test]
 fn test_arithmetic_operations() {
@@ -191,9 +198,9 @@ fn test_edge_cases() {
 #[test]
 fn test_enumerate_flat_array() {
     let array = SymbolicValue::Array(vec![
-        Rc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
-        Rc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
-        Rc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
+        Arc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
+        Arc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
+        Arc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
     ]);
 
     let result = enumerate_array(&array);
@@ -216,13 +223,13 @@ fn test_enumerate_flat_array() {
 #[test]
 fn test_enumerate_nested_array() {
     let nested_array = SymbolicValue::Array(vec![
-        Rc::new(SymbolicValue::Array(vec![
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
+        Arc::new(SymbolicValue::Array(vec![
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(1))),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
         ])),
-        Rc::new(SymbolicValue::Array(vec![
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
-            Rc::new(SymbolicValue::ConstantInt(BigInt::from(4))),
+        Arc::new(SymbolicValue::Array(vec![
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(4))),
         ])),
     ]);
 
@@ -250,10 +257,10 @@ fn test_enumerate_nested_array() {
 #[test]
 fn test_enumerate_deeply_nested_array() {
     let deeply_nested_array =
-        SymbolicValue::Array(vec![Rc::new(SymbolicValue::Array(vec![Rc::new(
+        SymbolicValue::Array(vec![Arc::new(SymbolicValue::Array(vec![Arc::new(
             SymbolicValue::Array(vec![
-                Rc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
-                Rc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
+                Arc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
             ]),
         )]))]);
 
@@ -291,3 +298,75 @@ fn test_enumerate_empty_array() {
 
     assert_eq!(result.len(), 0);
 }
+
+fn assert_send_sync<T: Send + Sync>() {}
+
+#[test]
+fn test_symbolic_types_are_send_and_sync() {
+    assert_send_sync::<SymbolicName>();
+    assert_send_sync::<SymbolicValue>();
+    assert_send_sync::<SymbolicTrace>();
+    assert_send_sync::<SymbolicLibrary>();
+}
+
+#[test]
+fn test_frozen_symbolic_trace_shared_among_threads() {
+    let index = SymbolicName::new(2, Arc::new(Vec::new()), None);
+    let element = SymbolicName::new(
+        1,
+        Arc::new(Vec::new()),
+        Some(vec![SymbolicAccess::ArrayAccess(SymbolicValue::Variable(
+            index.clone(),
+        ))]),
+    );
+    let trace = freeze_symbolic_trace(vec![Arc::new(SymbolicValue::AssignEq(
+        Arc::new(SymbolicValue::Variable(element.clone())),
+        Arc::new(SymbolicValue::Variable(index.clone())),
+    ))]);
+
+    let hash_of = |value: &SymbolicValue| {
+        let mut hasher = DefaultHasher::new();
+        value.hash(&mut hasher);
+        hasher.finish()
+    };
+    let expected_hash = hash_of(&trace[0]);
+
+    let handles: Vec<_> = (0..4)
+        .map(|_| {
+            let shared_trace = Arc::clone(&trace);
+            thread::spawn(move || {
+                let mut hasher = DefaultHasher::new();
+                shared_trace[0].hash(&mut hasher);
+                hasher.finish()
+            })
+        })
+        .collect();
+    for handle in handles {
+        assert_eq!(handle.join().unwrap(), expected_hash);
+    }
+
+    // Names without cached hashes still compare equal to the frozen ones.
+    assert_eq!(
+        *trace[0],
+        SymbolicValue::AssignEq(
+            Arc::new(SymbolicValue::Variable(element)),
+            Arc::new(SymbolicValue::Variable(index)),
+        )
+    );
+}
+
+#[test]
+fn test_scoped_function_counter() {
+    let mut symbolic_library = SymbolicLibrary::default();
+    symbolic_library.function_counter.insert(0, 3);
+
+    let result = symbolic_library.with_scoped_function_counter(|library| {
+        library.function_counter.insert(0, 5);
+        library.function_counter.insert(1, 1);
+        library.function_counter[&0]
+    });
+
+    assert_eq!(result, 5);
+    assert_eq!(symbolic_library.function_counter.len(), 1);
+    assert_eq!(symbolic_library.function_counter[&0], 3);
+}
@@ -38,6 +38,7 @@ pub fn prepare_symbolic_library(
         id2name: FxHashMap::default(),
         function_library: FxHashMap::default(),
         function_counter: FxHashMap::default(),
+        component_summaries: FxHashMap::default(),
     };
 
     let whitelist = FxHashSet::default();
@@ -1,7 +1,8 @@
-use std::rc::Rc;
+use std::sync::Arc;
 
 use num_bigint_dig::BigInt;
 use num_traits::{One, Zero};
+use rustc_hash::FxHashSet;
 
 use program_structure::ast::ExpressionInfixOpcode;
 
@@ -9,6 +10,8 @@ use zkfuzz::executor::debug_ast::DebuggableExpressionInfixOpcode;
 use zkfuzz::executor::symbolic_value::{get_coefficient_of_polynomials, get_degree_polynomial};
 use zkfuzz::executor::symbolic_value::{OwnerName, SymbolicName, SymbolicValue};
 use zkfuzz::executor::utils::solve_quadratic_modulus_equation;
+use zkfuzz::mutator::mutation_utils::QuadraticRootCache;
+use zkfuzz::mutator::utils::gather_constraint_polynomials;
 
 // A dummy owner to use for creating SymbolicNames.
 fn dummy_owner() -> OwnerName {
@@ -22,7 +25,7 @@ fn dummy_owner() -> OwnerName {
 // Helper to construct a SymbolicName with a given id.
 // (Use different ids to simulate different variable names.)
 fn make_symbolic_name(id: usize) -> SymbolicName {
-    SymbolicName::new(id, Rc::new(vec![dummy_owner()]), None)
+    SymbolicName::new(id, Arc::new(vec![dummy_owner()]), None)
 }
 
 #[test]
@@ -52,9 +55,9 @@ fn test_get_degree_addition() {
     let expr_left = SymbolicValue::Variable(target.clone()); // degree 1
     let expr_right = SymbolicValue::ConstantInt(BigInt::from(5)); // degree 0
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
     let degree = get_degree_polynomial(&expr, &target);
     assert_eq!(degree, 1);
@@ -69,9 +72,9 @@ fn test_get_degree_subtraction() {
     let expr_left = SymbolicValue::ConstantInt(BigInt::from(5)); // degree 0
     let expr_right = SymbolicValue::Variable(target.clone()); // degree 1
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Sub),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
     let degree = get_degree_polynomial(&expr, &target);
     assert_eq!(degree, 1);
@@ -85,9 +88,9 @@ fn test_get_degree_multiplication() {
     let expr_left = SymbolicValue::Variable(target.clone());
     let expr_right = SymbolicValue::Variable(target.clone());
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
     let degree = get_degree_polynomial(&expr, &target);
     assert_eq!(degree, 2);
@@ -102,9 +105,9 @@ fn test_get_degree_unknown_operator_non_zero() {
     let expr_left = SymbolicValue::Variable(target.clone()); // degree 1
     let expr_right = SymbolicValue::ConstantInt(BigInt::from(5)); // degree 0
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Div),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
     let degree = get_degree_polynomial(&expr, &target);
     assert_eq!(degree, std::usize::MAX);
@@ -128,10 +131,10 @@ fn test_get_coefficient_constant() {
     let target = make_symbolic_name(100); // target name is irrelevant here
 
     let result = get_coefficient_of_polynomials(&expr, &target, &BigInt::from(7));
-    let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+    let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
 
     let expected = [
-        Rc::new(SymbolicValue::ConstantInt(BigInt::from(5))),
+        Arc::new(SymbolicValue::ConstantInt(BigInt::from(5))),
         zero.clone(),
         zero.clone(),
     ];
@@ -146,8 +149,8 @@ fn test_get_coefficient_variable_match() {
     let expr = SymbolicValue::Variable(target.clone());
 
     let result = get_coefficient_of_polynomials(&expr, &target, &BigInt::from(7));
-    let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
-    let one = Rc::new(SymbolicValue::ConstantInt(BigInt::one()));
+    let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+    let one = Arc::new(SymbolicValue::ConstantInt(BigInt::one()));
 
     let expected = [zero.clone(), one, zero.clone()];
     assert_eq!(result, expected);
@@ -161,8 +164,8 @@ fn test_get_coefficient_variable_no_match() {
     let expr = SymbolicValue::Variable(other);
 
     let result = get_coefficient_of_polynomials(&expr, &target, &BigInt::from(7));
-    let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
-    let expected = [Rc::new(expr), zero.clone(), zero.clone()];
+    let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+    let expected = [Arc::new(expr), zero.clone(), zero.clone()];
     assert_eq!(result, expected);
 }
 
@@ -182,16 +185,16 @@ fn test_get_coefficient_addition() {
     let expr_right = SymbolicValue::Variable(target.clone());
 
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
 
     let result = get_coefficient_of_polynomials(&expr, &target, &BigInt::from(7));
 
-    let expected_const = Rc::new(SymbolicValue::ConstantInt(BigInt::from(3)));
-    let expected_linear = Rc::new(SymbolicValue::ConstantInt(BigInt::one()));
-    let expected_quadratic = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+    let expected_const = Arc::new(SymbolicValue::ConstantInt(BigInt::from(3)));
+    let expected_linear = Arc::new(SymbolicValue::ConstantInt(BigInt::one()));
+    let expected_quadratic = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
 
     let expected = [expected_const, expected_linear, expected_quadratic];
     assert_eq!(result, expected);
@@ -213,16 +216,16 @@ fn test_get_coefficient_subtraction() {
     let expr_right = SymbolicValue::ConstantInt(BigInt::from(2));
 
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Sub),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
 
     let result = get_coefficient_of_polynomials(&expr, &target, &BigInt::from(7));
-    let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+    let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
 
-    let expected_const = Rc::new(SymbolicValue::ConstantInt(BigInt::from(5)));
-    let expected_linear = Rc::new(SymbolicValue::ConstantInt(BigInt::one()));
+    let expected_const = Arc::new(SymbolicValue::ConstantInt(BigInt::from(5)));
+    let expected_linear = Arc::new(SymbolicValue::ConstantInt(BigInt::one()));
     let expected_quadratic = zero.clone();
 
     let expected = [expected_const, expected_linear, expected_quadratic];
@@ -252,27 +255,27 @@ fn test_get_coefficient_multiplication() {
     // We build the expected trees accordingly.
     let target = make_symbolic_name(1);
     let expr_left = SymbolicValue::BinaryOp(
-        Rc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
+        Arc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-        Rc::new(SymbolicValue::Variable(target.clone())),
+        Arc::new(SymbolicValue::Variable(target.clone())),
     );
     let expr_right = SymbolicValue::BinaryOp(
-        Rc::new(SymbolicValue::ConstantInt(BigInt::from(4))),
+        Arc::new(SymbolicValue::ConstantInt(BigInt::from(4))),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Add),
-        Rc::new(SymbolicValue::Variable(target.clone())),
+        Arc::new(SymbolicValue::Variable(target.clone())),
     );
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
 
     let result = get_coefficient_of_polynomials(&expr, &target, &BigInt::from(7));
 
     // Now, following the multiplication branch:
-    let expected_c0 = Rc::new(SymbolicValue::ConstantInt(BigInt::from(5)));
-    let expected_c1 = Rc::new(SymbolicValue::ConstantInt(BigInt::from(0)));
-    let expected_c2 = Rc::new(SymbolicValue::ConstantInt(BigInt::from(1)));
+    let expected_c0 = Arc::new(SymbolicValue::ConstantInt(BigInt::from(5)));
+    let expected_c1 = Arc::new(SymbolicValue::ConstantInt(BigInt::from(0)));
+    let expected_c2 = Arc::new(SymbolicValue::ConstantInt(BigInt::from(1)));
 
     let expected = [expected_c0, expected_c1, expected_c2];
     assert_eq!(result, expected);
@@ -287,14 +290,14 @@ fn test_get_coefficient_unknown_operator() {
     let expr_right = SymbolicValue::ConstantInt(BigInt::from(3));
 
     let expr = SymbolicValue::BinaryOp(
-        Rc::new(expr_left),
+        Arc::new(expr_left),
         DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Div),
-        Rc::new(expr_right),
+        Arc::new(expr_right),
     );
     let result = get_coefficient_of_polynomials(&expr, &target, &BigInt::from(7));
-    let zero = Rc::new(SymbolicValue::ConstantInt(BigInt::zero()));
+    let zero = Arc::new(SymbolicValue::ConstantInt(BigInt::zero()));
 
-    let expected = [Rc::new(expr.clone()), zero.clone(), zero.clone()];
+    let expected = [Arc::new(expr.clone()), zero.clone(), zero.clone()];
     assert_eq!(result, expected);
 }
 
@@ -376,3 +379,79 @@ fn test_quadratic_no_solution() {
     let modulus = BigInt::from(11);
     assert_eq!(solve_quadratic_modulus_equation(&coeffs, &modulus), None);
 }
+
+#[test]
+fn test_quadratic_root_cache_evicts_least_recently_used() {
+    let coeffs = |c: i32| [BigInt::from(c), BigInt::one(), BigInt::zero()];
+    let mut cache = QuadraticRootCache::new(2);
+    cache.insert(coeffs(1), BigInt::from(10));
+    cache.insert(coeffs(2), BigInt::from(20));
+    assert_eq!(cache.get(&coeffs(1)), Some(BigInt::from(10)));
+
+    // The root of `coeffs(2)` is the least recently used one.
+    cache.insert(coeffs(3), BigInt::from(30));
+    assert_eq!(cache.len(), 2);
+    assert_eq!(cache.get(&coeffs(2)), None);
+    assert_eq!(
+        cache
+            .iter()
+            .map(|(_, root)| root.clone())
+            .collect::<Vec<_>>(),
+        vec![BigInt::from(10), BigInt::from(30)]
+    );
+}
+
+#[test]
+fn test_gather_constraint_polynomials() {
+    // Over GF(7), the constraints are x * x === 2, x < 3, and y === 1, where only x is a
+    // target. The first one is the polynomial x^2 - 2 = x^2 + 5 over x, and the other ones
+    // have no polynomial.
+    let prime = BigInt::from(7);
+    let x = make_symbolic_name(1);
+    let y = make_symbolic_name(2);
+    let square = SymbolicValue::BinaryOp(
+        Arc::new(SymbolicValue::Variable(x.clone())),
+        DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Mul),
+        Arc::new(SymbolicValue::Variable(x.clone())),
+    );
+    let constraints = vec![
+        Arc::new(SymbolicValue::AssignEq(
+            Arc::new(square),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(2))),
+        )),
+        Arc::new(SymbolicValue::BinaryOp(
+            Arc::new(SymbolicValue::Variable(x.clone())),
+            DebuggableExpressionInfixOpcode(ExpressionInfixOpcode::Lesser),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::from(3))),
+        )),
+        Arc::new(SymbolicValue::AssignEq(
+            Arc::new(SymbolicValue::Variable(y.clone())),
+            Arc::new(SymbolicValue::ConstantInt(BigInt::one())),
+        )),
+    ];
+    let targets: FxHashSet<SymbolicName> = [x.clone()].into_iter().collect();
+
+    let polys = gather_constraint_polynomials(&constraints, &targets, &prime);
+    assert_eq!(polys.len(), 3);
+    assert!(polys[1].is_empty());
+    assert!(polys[2].is_empty());
+    assert_eq!(polys[0].len(), 1);
+    let (var_name, coefs) = &polys[0][0];
+    assert_eq!(*var_name, x);
+    let coefficients: Vec<BigInt> = coefs
+        .iter()
+        .map(|coef| match coef.as_ref() {
+            SymbolicValue::ConstantInt(c) => c.clone(),
+            _ => panic!("The coefficients should be constants"),
+        })
+        .collect();
+    assert_eq!(
+        coefficients,
+        vec![BigInt::from(5), BigInt::zero(), BigInt::one()]
+    );
+
+    let root =
+        solve_quadratic_modulus_equation(&[BigInt::from(5), BigInt::zero(), BigInt::one()], &prime)
+            .unwrap();
+    assert_eq!((&root * &root) % &prime, BigInt::from(2));
+}